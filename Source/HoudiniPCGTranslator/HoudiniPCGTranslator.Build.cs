@@ -38,7 +38,12 @@ public class HoudiniPCGTranslator : ModuleRules
                 "HoudiniEngine",
                 "GeometryCore",
                 "PCG",
-                "PCGGeometryScriptInterop"
+                "PCGGeometryScriptInterop",
+                "HoudiniPCGTranslatorRuntime",
+                "Projects",
+                "UnrealEd",
+                "AssetRegistry",
+                "Json"
             }
 			);
 		
@@ -7,7 +7,12 @@
 #include "HoudiniAttribute.h"
 #include "HoudiniEngineUtils.h"
 
+#include "HoudiniInputPCGDataAsset.h"
+#include "HoudiniOutputPCGDataAsset.h"
 #include "HoudiniPCGCommon.h"
+#include "HoudiniPCGUtils.h"
+
+#include "HAL/IConsoleManager.h"
 
 #include "PCGComponent.h"
 
@@ -46,25 +51,290 @@ bool FHoudiniPCGComponentInputBuilder::IsValidInput(const UActorComponent* Compo
 }
 
 
+static TAutoConsoleVariable<FString> CVarHoudiniPCGInputAttributeFilter(
+	TEXT("HoudiniPCG.InputAttributeFilter"),
+	TEXT(""),
+	TEXT("Default attribute pattern of PCG data inputs, e.g., \"height* seed ^_*\", empty means all. ")
+	TEXT("Native point properties are only filtered by patterns naming them, e.g., \"^$Density ^$Color\". ")
+	TEXT("PCG components could override it by a component tag \"HoudiniPCGAttributes:<Pattern>\""));
+
+FHoudiniPCGAttributeFilter::FHoudiniPCGAttributeFilter(const FString& PatternStr)
+{
+	TArray<FString> Tokens;
+	PatternStr.ParseIntoArrayWS(Tokens, TEXT(","));
+	for (const FString& Token : Tokens)
+	{
+		if (!Token.StartsWith(TEXT("^")))
+			Patterns.Emplace(Token, true);
+		else if (Token.Len() >= 2)
+			Patterns.Emplace(Token.RightChop(1), false);
+	}
+}
+
+FHoudiniPCGAttributeFilter FHoudiniPCGAttributeFilter::GetDefault()
+{
+	return FHoudiniPCGAttributeFilter(CVarHoudiniPCGInputAttributeFilter.GetValueOnAnyThread());
+}
+
+bool FHoudiniPCGAttributeFilter::Matches(const FString& Name) const
+{
+	return MatchesPatterns(Name, false);
+}
+
+bool FHoudiniPCGAttributeFilter::MatchesProperty(const FString& Name) const
+{
+	return MatchesPatterns(Name, true);
+}
+
+bool FHoudiniPCGAttributeFilter::MatchesPatterns(const FString& Name, const bool& bProperty) const
+{
+	bool bMatched = true;
+	bool bFirstPattern = true;
+	for (const TPair<FString, bool>& Pattern : Patterns)
+	{
+		if (Pattern.Key.StartsWith(TEXT("$")) != bProperty)  // Attribute patterns never filter native properties, and vice versa
+			continue;
+
+		if (bFirstPattern)  // Start from all if the first pattern excludes, e.g., "^_*", otherwise from none
+		{
+			bMatched = !Pattern.Value;
+			bFirstPattern = false;
+		}
+		if (Name.MatchesWildcard(Pattern.Key, ESearchCase::CaseSensitive))
+			bMatched = Pattern.Value;
+	}
+	return bMatched;
+}
+
+
 
 
 namespace HoudiniPCGDataInputUtils
 {
 	template<typename StrValueType>
 	static bool HapiUploadStringAttribValue(const UPCGMetadata* MetaData, const FName& AttribName,
-		const int32& NodeId, HAPI_AttributeInfo& AttribInfo, TFunctionRef<FString(const StrValueType&)> ConvertFunc);
+		const HAPI_Session* Session, const int32& NodeId, HAPI_AttributeInfo& AttribInfo, const TArray<int32>& PointIndices, TFunctionRef<FString(const StrValueType&)> ConvertFunc);
 
 	template<typename ValueType, typename HapiValueType, int TupleSize, HAPI_StorageType Storage, HAPI_AttributeTypeInfo AttribType,
 		typename SetUniqueAttribValueHapi, typename SetAttribValueHapi>
 	static bool HapiUploadNumericAttribValue(const UPCGMetadata* MetaData, const FName& AttribName,
-		const int32& NodeId, HAPI_AttributeInfo& AttribInfo, TFunctionRef<void(const ValueType&, TArray<HapiValueType>&)> ConvertFunc,
+		const HAPI_Session* Session, const int32& NodeId, HAPI_AttributeInfo& AttribInfo, const TArray<int32>& PointIndices, TFunctionRef<void(const ValueType&, TArray<HapiValueType>&)> ConvertFunc,
 		SetUniqueAttribValueHapi SetUniqueAttribValueHapiFunc, SetAttribValueHapi SetAttribValueHapiFunc);
+
+	static void FilterAttributes(const FHoudiniPCGAttributeFilter& AttribFilter, TArray<FName>& InOutAttribNames, TArray<EPCGMetadataTypes>& InOutAttribTypes);
+
+	// Deterministic subset of points to upload while previewing, return false if all points should be uploaded.
+	// Points are picked by the hash of their seed and position, NOT their indices, so that the subset is stable across re-uploads
+	static bool GatherPreviewPointIndices(const int32& NumPoints, TFunctionRef<int32(const int32&)> GetSeedFunc,
+		TFunctionRef<FVector(const int32&)> GetPositionFunc, TArray<int32>& OutPointIndices);
+}
+
+static void HoudiniPCGDataInputUtils::FilterAttributes(const FHoudiniPCGAttributeFilter& AttribFilter, TArray<FName>& InOutAttribNames, TArray<EPCGMetadataTypes>& InOutAttribTypes)
+{
+	if (AttribFilter.IsEmpty())
+		return;
+
+	for (int32 AttribIdx = InOutAttribNames.Num() - 1; AttribIdx >= 0; --AttribIdx)
+	{
+		if (!AttribFilter.Matches(InOutAttribNames[AttribIdx].ToString()))
+		{
+			InOutAttribNames.RemoveAt(AttribIdx);
+			InOutAttribTypes.RemoveAt(AttribIdx);
+		}
+	}
+}
+
+static TAutoConsoleVariable<float> CVarHoudiniPCGInputPreviewRatio(
+	TEXT("HoudiniPCG.InputPreviewRatio"),
+	1.0f,
+	TEXT("Ratio of points uploaded by PCG data inputs while HoudiniPCG.PreviewOutput = 1, 1 means all. ")
+	TEXT("Inputs are always uploaded in full when previews are off, and by headless cooks"),
+	FConsoleVariableDelegate::CreateLambda([](IConsoleVariable*) { FHoudiniPCGComponentInput::MarkInputsChanged(true); }));
+
+static TAutoConsoleVariable<float> CVarHoudiniPCGInputPreviewGridSize(
+	TEXT("HoudiniPCG.InputPreviewGridSize"),
+	0.0f,
+	TEXT("Keep at most one point per grid cell of this size (in cm) in PCG data inputs while HoudiniPCG.PreviewOutput = 1, 0 means no grid"),
+	FConsoleVariableDelegate::CreateLambda([](IConsoleVariable*) { FHoudiniPCGComponentInput::MarkInputsChanged(true); }));
+
+bool FHoudiniPCGComponentInput::IsPreviewDecimationEnabled()
+{
+	return (CVarHoudiniPCGInputPreviewRatio.GetValueOnAnyThread() < 1.0f) || (CVarHoudiniPCGInputPreviewGridSize.GetValueOnAnyThread() > 0.0f);
+}
+
+bool FHoudiniPCGComponentInput::ShouldDecimatePreview()
+{
+	return FHoudiniPCGDataAssetOutputBuilder::IsPreviewEnabled() && IsPreviewDecimationEnabled();  // Outputs of this cook will only be previews
+}
+
+// Game thread only, inputs are removed once deleted
+static TArray<TWeakPtr<FHoudiniPCGComponentInput>> GHoudiniPCGComponentInputs;
+static TArray<TWeakObjectPtr<UHoudiniInputPCGDataAsset>> GHoudiniPCGDataAssetInputs;
+
+void FHoudiniPCGComponentInput::RecordUpload(const TSharedPtr<FHoudiniPCGComponentInput>& CompInput)
+{
+	GHoudiniPCGComponentInputs.RemoveAll([](const TWeakPtr<FHoudiniPCGComponentInput>& RecordedCompInput) { return !RecordedCompInput.IsValid(); });
+	GHoudiniPCGComponentInputs.AddUnique(CompInput);
+}
+
+void FHoudiniPCGComponentInput::RecordUpload(UHoudiniInputPCGDataAsset* Holder)
+{
+	GHoudiniPCGDataAssetInputs.RemoveAll([](const TWeakObjectPtr<UHoudiniInputPCGDataAsset>& RecordedHolder) { return !RecordedHolder.IsValid(); });
+	GHoudiniPCGDataAssetInputs.AddUnique(Holder);
+}
+
+bool FHoudiniPCGComponentInput::HasDecimatedInputs(const UObject* Node)
+{
+	for (const TWeakPtr<FHoudiniPCGComponentInput>& RecordedCompInput : GHoudiniPCGComponentInputs)
+	{
+		const TSharedPtr<FHoudiniPCGComponentInput> CompInput = RecordedCompInput.Pin();
+		if (CompInput && CompInput->bDecimated && (!Node || (CompInput->OwnerInput.IsValid() && CompInput->OwnerInput->IsIn(Node))))
+			return true;
+	}
+
+	for (const TWeakObjectPtr<UHoudiniInputPCGDataAsset>& Holder : GHoudiniPCGDataAssetInputs)
+	{
+		if (Holder.IsValid() && Holder->IsDecimated() && (!Node || Holder->IsIn(Node)))
+			return true;
+	}
+
+	return false;
+}
+
+void FHoudiniPCGComponentInput::MarkInputsChanged(const bool& bDecimationChanged, const UObject* Node)
+{
+	const bool bDecimate = ShouldDecimatePreview();
+	auto ShouldReuploadLambda = [&](const bool& bWasDecimated, const UObject* Owner)
+		{
+			return ((bWasDecimated != bDecimate) || (bWasDecimated && bDecimationChanged)) && (!Node || (Owner && Owner->IsIn(Node)));
+		};
+
+	for (const TWeakPtr<FHoudiniPCGComponentInput>& RecordedCompInput : GHoudiniPCGComponentInputs)
+	{
+		const TSharedPtr<FHoudiniPCGComponentInput> CompInput = RecordedCompInput.Pin();
+		if (!CompInput || !ShouldReuploadLambda(CompInput->bDecimated, CompInput->OwnerInput.Get()))
+			continue;
+
+		for (const TWeakObjectPtr<const UPCGComponent>& PCGComp : CompInput->Components)  // World inputs upload again when their components changed
+		{
+			if (PCGComp.IsValid())
+			{
+				FPropertyChangedEvent PropertyChangedEvent(nullptr);
+				FCoreUObjectDelegates::OnObjectPropertyChanged.Broadcast(const_cast<UPCGComponent*>(PCGComp.Get()), PropertyChangedEvent);
+			}
+		}
+	}
+
+	for (const TWeakObjectPtr<UHoudiniInputPCGDataAsset>& Holder : GHoudiniPCGDataAssetInputs)
+	{
+		if (Holder.IsValid() && ShouldReuploadLambda(Holder->IsDecimated(), Holder.Get()))
+			Holder->RequestReupload();
+	}
+}
+
+static bool HoudiniPCGDataInputUtils::GatherPreviewPointIndices(const int32& NumPoints, TFunctionRef<int32(const int32&)> GetSeedFunc,
+	TFunctionRef<FVector(const int32&)> GetPositionFunc, TArray<int32>& OutPointIndices)
+{
+	const float Ratio = FMath::Clamp(CVarHoudiniPCGInputPreviewRatio.GetValueOnAnyThread(), 0.0f, 1.0f);
+	const double GridSize = CVarHoudiniPCGInputPreviewGridSize.GetValueOnAnyThread();
+	if (Ratio >= 1.0f && GridSize <= 0.0)
+		return false;
+
+	TRACE_CPUPROFILER_EVENT_SCOPE(HoudiniPCGGatherPreviewPoints);
+
+	const uint32 RatioThreshold = uint32(double(Ratio) * MAX_uint32);
+	TArray<uint32> Hashes; Hashes.SetNumUninitialized(NumPoints);
+	TArray<FIntVector> Cells; if (GridSize > 0.0) Cells.SetNumUninitialized(NumPoints);
+	TArray<bool> Keeps; Keeps.SetNumUninitialized(NumPoints);
+	const FHoudiniPCGTransientBytesScope TransientBytesScope(true, Hashes.GetAllocatedSize() + Cells.GetAllocatedSize() + Keeps.GetAllocatedSize());
+
+	FHoudiniPCGUtils::ParallelForBatch(NumPoints, [&](const int32& StartIdx, const int32& EndIdx)
+		{
+			for (int32 PointIdx = StartIdx; PointIdx < EndIdx; ++PointIdx)
+			{
+				const FVector Position = GetPositionFunc(PointIdx);
+				const FIntVector Quantized(FMath::FloorToInt32(Position.X), FMath::FloorToInt32(Position.Y), FMath::FloorToInt32(Position.Z));  // Ignore float noise below 1cm
+				const uint32 Hash = MurmurFinalize32(HashCombineFast(::GetTypeHash(GetSeedFunc(PointIdx)), ::GetTypeHash(Quantized)));
+				Hashes[PointIdx] = Hash;
+				Keeps[PointIdx] = (Ratio >= 1.0f) || (Hash < RatioThreshold);
+				if (!Cells.IsEmpty())
+					Cells[PointIdx] = FIntVector(FMath::FloorToInt32(Position.X / GridSize),
+						FMath::FloorToInt32(Position.Y / GridSize), FMath::FloorToInt32(Position.Z / GridSize));
+			}
+		});
+
+	if (!Cells.IsEmpty())  // Keep the point with the min hash in each cell, so that the winner of a cell does NOT depend on point order
+	{
+		auto IsBetterLambda = [&Hashes](const int32& PointIdx, const int32& CellPointIdx)  // Ties go to the lower index, same in any batch order
+			{
+				return (Hashes[PointIdx] < Hashes[CellPointIdx]) || ((Hashes[PointIdx] == Hashes[CellPointIdx]) && (PointIdx < CellPointIdx));
+			};
+
+		TArray<TMap<FIntVector, int32>> BatchCellPointIdxMaps;  // Winners of each batch, then merged, so that only cells, rather than points, are visited serially
+		BatchCellPointIdxMaps.SetNum(FMath::DivideAndRoundUp(NumPoints, HOUDINI_PCG_PARALLEL_BATCH_SIZE));
+		FHoudiniPCGUtils::ParallelForBatch(NumPoints, [&](const int32& StartIdx, const int32& EndIdx)
+			{
+				TMap<FIntVector, int32>& CellPointIdxMap = BatchCellPointIdxMaps[StartIdx / HOUDINI_PCG_PARALLEL_BATCH_SIZE];
+				for (int32 PointIdx = StartIdx; PointIdx < EndIdx; ++PointIdx)
+				{
+					if (!Keeps[PointIdx])
+						continue;
+
+					int32& CellPointIdx = CellPointIdxMap.FindOrAdd(Cells[PointIdx], PointIdx);
+					if (IsBetterLambda(PointIdx, CellPointIdx))
+						CellPointIdx = PointIdx;
+				}
+			});
+
+		TMap<FIntVector, int32> CellPointIdxMap = MoveTemp(BatchCellPointIdxMaps[0]);
+		for (int32 BatchIdx = 1; BatchIdx < BatchCellPointIdxMaps.Num(); ++BatchIdx)
+		{
+			for (const TPair<FIntVector, int32>& BatchCellPointIdx : BatchCellPointIdxMaps[BatchIdx])
+			{
+				int32& CellPointIdx = CellPointIdxMap.FindOrAdd(BatchCellPointIdx.Key, BatchCellPointIdx.Value);
+				if (IsBetterLambda(BatchCellPointIdx.Value, CellPointIdx))
+					CellPointIdx = BatchCellPointIdx.Value;
+			}
+			BatchCellPointIdxMaps[BatchIdx].Empty();
+		}
+
+		FHoudiniPCGUtils::ParallelForBatch(NumPoints, [&](const int32& StartIdx, const int32& EndIdx)
+			{
+				for (int32 PointIdx = StartIdx; PointIdx < EndIdx; ++PointIdx)
+				{
+					if (Keeps[PointIdx])
+						Keeps[PointIdx] = (CellPointIdxMap.FindChecked(Cells[PointIdx]) == PointIdx);
+				}
+			});
+	}
+
+	OutPointIndices.Reset();
+	for (int32 PointIdx = 0; PointIdx < NumPoints; ++PointIdx)
+	{
+		if (Keeps[PointIdx])
+			OutPointIndices.Add(PointIdx);
+	}
+
+	if (OutPointIndices.IsEmpty())  // Keep at least one point, so that the input node and its attributes still exist
+	{
+		int32 MinHashPointIdx = 0;
+		for (int32 PointIdx = 1; PointIdx < NumPoints; ++PointIdx)
+		{
+			if (Hashes[PointIdx] < Hashes[MinHashPointIdx])
+				MinHashPointIdx = PointIdx;
+		}
+		OutPointIndices.Add(MinHashPointIdx);
+	}
+
+	return true;
 }
 
 template<typename StrValueType>
 static bool HoudiniPCGDataInputUtils::HapiUploadStringAttribValue(const UPCGMetadata* MetaData, const FName& AttribName,
-	const int32& NodeId, HAPI_AttributeInfo& AttribInfo, TFunctionRef<FString(const StrValueType&)> ConvertFunc)
+	const HAPI_Session* Session, const int32& NodeId, HAPI_AttributeInfo& AttribInfo, const TArray<int32>& PointIndices, TFunctionRef<FString(const StrValueType&)> ConvertFunc)
 {
+	LLM_SCOPE_BYTAG(HoudiniPCG_MetadataConversion);
+
 	if (const FPCGMetadataAttribute<StrValueType>* Attrib = MetaData->GetConstTypedAttribute<StrValueType>(AttribName))
 	{
 		const std::string AttribNameStr = HAPI_ATTRIB_PREFIX_UNREAL_PCG_ATTRIBUTE + std::string(TCHAR_TO_UTF8(*AttribName.ToString()));
@@ -74,58 +344,30 @@ static bool HoudiniPCGDataInputUtils::HapiUploadStringAttribValue(const UPCGMeta
 			AttribInfo.tupleSize = 1;
 			AttribInfo.storage = HAPI_STORAGETYPE_STRING;
 
-			HAPI_SESSION_FAIL_RETURN(FHoudiniApi::AddAttribute(FHoudiniEngine::Get().GetSession(), NodeId, 0,
+			HAPI_SESSION_FAIL_RETURN(FHoudiniApi::AddAttribute(Session, NodeId, 0,
 				AttribNameStr.c_str(), &AttribInfo));
 
-			HAPI_SESSION_FAIL_RETURN(FHoudiniApi::SetAttributeStringUniqueData(FHoudiniEngine::Get().GetSession(), NodeId, 0,
+			HAPI_SESSION_FAIL_RETURN(FHoudiniApi::SetAttributeStringUniqueData(Session, NodeId, 0,
 				AttribNameStr.c_str(), &AttribInfo, TCHAR_TO_UTF8(*ConvertFunc(Attrib->GetValue(PCGDefaultValueKey))), 1, 0, AttribInfo.count));
 		}
 		else
 		{
-#if ((ENGINE_MAJOR_VERSION == 5) && (ENGINE_MINOR_VERSION >= 5)) || (ENGINE_MAJOR_VERSION > 5)
-			TArray<const PCGMetadataEntryKey> EntryKeys;
-#else
-			TArray<PCGMetadataEntryKey> EntryKeys;
-#endif
-			for (PCGMetadataEntryKey EntryKey = 0; EntryKey < AttribInfo.count; ++EntryKey)
-				EntryKeys.Add(EntryKey);
-			TArray<PCGMetadataValueKey> ValueKeys;
-			Attrib->GetValueKeys(EntryKeys, ValueKeys);
-			TMap<PCGMetadataValueKey, std::string> KeyValueMap;
-			std::string DefaultValue;
-			{
-				TArray<PCGMetadataValueKey> UniqueKeys = TSet<PCGMetadataValueKey>(ValueKeys).Array();
-				const bool bHasDefaultValue = (UniqueKeys.RemoveAll([](const PCGMetadataValueKey& Key) { return (Key < 0); }) >= 1);
-				if (!UniqueKeys.IsEmpty())
-				{
-					TArray<StrValueType> UniqueValues;
-					UniqueValues.SetNum(UniqueKeys.Num());
-#if ((ENGINE_MAJOR_VERSION == 5) && (ENGINE_MINOR_VERSION >= 5)) || (ENGINE_MAJOR_VERSION > 5)
-					Attrib->GetValues(UniqueKeys, UniqueValues);
-#else
-					for (int32 UniqueIdx = 0; UniqueIdx < UniqueKeys.Num(); ++UniqueIdx)
-						UniqueValues[UniqueIdx] = Attrib->GetValue(UniqueKeys[UniqueIdx]);
-#endif
-					for (int32 UniqueIdx = 0; UniqueIdx < UniqueKeys.Num(); ++UniqueIdx)
-						KeyValueMap.Add(UniqueKeys[UniqueIdx], std::string(TCHAR_TO_UTF8(*ConvertFunc(UniqueValues[UniqueIdx]))));
-				}
-
-				if (bHasDefaultValue)
-					DefaultValue = TCHAR_TO_UTF8(*ConvertFunc(Attrib->GetValue(PCGDefaultValueKey)));
-			}
-
+			TArray<std::string> UniqueStrs;
 			TArray<const char*> StrValues;
-			for (const PCGMetadataValueKey& ValueKey : ValueKeys)
-				StrValues.Add((ValueKey < 0) ? DefaultValue.c_str() : KeyValueMap[ValueKey].c_str());
+			FHoudiniPCGUtils::GatherStringAttribValues<StrValueType>(Attrib, AttribInfo.count, PointIndices, ConvertFunc, UniqueStrs, StrValues);
+			const FHoudiniPCGTransientBytesScope TransientBytesScope(true, UniqueStrs.GetAllocatedSize() + StrValues.GetAllocatedSize());
 
 			AttribInfo.tupleSize = 1;
 			AttribInfo.storage = HAPI_STORAGETYPE_STRING;
 
-			HAPI_SESSION_FAIL_RETURN(FHoudiniApi::AddAttribute(FHoudiniEngine::Get().GetSession(), NodeId, 0,
+			HAPI_SESSION_FAIL_RETURN(FHoudiniApi::AddAttribute(Session, NodeId, 0,
 				AttribNameStr.c_str(), &AttribInfo));
 
-			HAPI_SESSION_FAIL_RETURN(FHoudiniApi::SetAttributeStringData(FHoudiniEngine::Get().GetSession(), NodeId, 0,
-				AttribNameStr.c_str(), &AttribInfo, StrValues.GetData(), 0, AttribInfo.count));
+			{
+				HOUDINI_PCG_HAPI_CALL_SCOPE(true, StrValues.Num() * sizeof(const char*));
+				HAPI_SESSION_FAIL_RETURN(FHoudiniApi::SetAttributeStringData(Session, NodeId, 0,
+					AttribNameStr.c_str(), &AttribInfo, StrValues.GetData(), 0, AttribInfo.count));
+			}
 		}
 	}
 	return true;
@@ -134,9 +376,11 @@ static bool HoudiniPCGDataInputUtils::HapiUploadStringAttribValue(const UPCGMeta
 template<typename ValueType, typename HapiValueType, int TupleSize, HAPI_StorageType Storage, HAPI_AttributeTypeInfo AttribType,
 	typename SetUniqueAttribValueHapi, typename SetAttribValueHapi>
 static bool HoudiniPCGDataInputUtils::HapiUploadNumericAttribValue(const UPCGMetadata* MetaData, const FName& AttribName,
-	const int32& NodeId, HAPI_AttributeInfo& AttribInfo, TFunctionRef<void(const ValueType&, TArray<HapiValueType>&)> ConvertFunc,
+	const HAPI_Session* Session, const int32& NodeId, HAPI_AttributeInfo& AttribInfo, const TArray<int32>& PointIndices, TFunctionRef<void(const ValueType&, TArray<HapiValueType>&)> ConvertFunc,
 	SetUniqueAttribValueHapi SetUniqueAttribValueHapiFunc, SetAttribValueHapi SetAttribValueHapiFunc)
 {
+	LLM_SCOPE_BYTAG(HoudiniPCG_MetadataConversion);
+
 	if (const FPCGMetadataAttribute<ValueType>* Attrib = MetaData->GetConstTypedAttribute<ValueType>(AttribName))
 	{
 		const std::string AttribNameStr = HAPI_ATTRIB_PREFIX_UNREAL_PCG_ATTRIBUTE + std::string(TCHAR_TO_UTF8(*AttribName.ToString()));
@@ -149,41 +393,33 @@ static bool HoudiniPCGDataInputUtils::HapiUploadNumericAttribValue(const UPCGMet
 			AttribInfo.storage = Storage;
 			AttribInfo.typeInfo = AttribType;
 
-			HAPI_SESSION_FAIL_RETURN(FHoudiniApi::AddAttribute(FHoudiniEngine::Get().GetSession(), NodeId, 0,
+			HAPI_SESSION_FAIL_RETURN(FHoudiniApi::AddAttribute(Session, NodeId, 0,
 				AttribNameStr.c_str(), &AttribInfo));
 
-			HAPI_SESSION_FAIL_RETURN(SetUniqueAttribValueHapiFunc(FHoudiniEngine::Get().GetSession(), NodeId, 0,
-				AttribNameStr.c_str(), &AttribInfo, DefaultValues.GetData(), 1, 0, AttribInfo.count));
+			{
+				HOUDINI_PCG_HAPI_CALL_SCOPE(true, DefaultValues.Num() * sizeof(HapiValueType));
+				HAPI_SESSION_FAIL_RETURN(SetUniqueAttribValueHapiFunc(Session, NodeId, 0,
+					AttribNameStr.c_str(), &AttribInfo, DefaultValues.GetData(), 1, 0, AttribInfo.count));
+			}
 		}
 		else
 		{
-#if ((ENGINE_MAJOR_VERSION == 5) && (ENGINE_MINOR_VERSION >= 5)) || (ENGINE_MAJOR_VERSION > 5)
-			TArray<const PCGMetadataEntryKey> EntryKeys;
-#else
-			TArray<PCGMetadataEntryKey> EntryKeys;
-#endif
-			for (PCGMetadataEntryKey EntryKey = 0; EntryKey < AttribInfo.count; ++EntryKey)
-				EntryKeys.Add(EntryKey);
-			TArray<PCGMetadataValueKey> ValueKeys;
-			Attrib->GetValueKeys(EntryKeys, ValueKeys);
 			TArray<HapiValueType> Values;
-			for (const PCGMetadataValueKey& ValueKey : ValueKeys)
-			{
-				if (ValueKey < 0)
-					Values.Append(DefaultValues);
-				else
-					ConvertFunc(Attrib->GetValue(ValueKey), Values);
-			}
+			FHoudiniPCGUtils::GatherAttribValues<ValueType, HapiValueType>(Attrib, AttribInfo.count, PointIndices, ConvertFunc, Values);
+			const FHoudiniPCGTransientBytesScope TransientBytesScope(true, Values.GetAllocatedSize());
 
 			AttribInfo.tupleSize = TupleSize;
 			AttribInfo.storage = Storage;
 			AttribInfo.typeInfo = AttribType;
 
-			HAPI_SESSION_FAIL_RETURN(FHoudiniApi::AddAttribute(FHoudiniEngine::Get().GetSession(), NodeId, 0,
+			HAPI_SESSION_FAIL_RETURN(FHoudiniApi::AddAttribute(Session, NodeId, 0,
 				AttribNameStr.c_str(), &AttribInfo));
 
-			HAPI_SESSION_FAIL_RETURN(SetAttribValueHapiFunc(FHoudiniEngine::Get().GetSession(), NodeId, 0,
-				AttribNameStr.c_str(), &AttribInfo, Values.GetData(), 0, AttribInfo.count));
+			{
+				HOUDINI_PCG_HAPI_CALL_SCOPE(true, Values.Num() * sizeof(HapiValueType));
+				HAPI_SESSION_FAIL_RETURN(SetAttribValueHapiFunc(Session, NodeId, 0,
+					AttribNameStr.c_str(), &AttribInfo, Values.GetData(), 0, AttribInfo.count));
+			}
 		}
 	}
 	return true;
@@ -192,66 +428,92 @@ static bool HoudiniPCGDataInputUtils::HapiUploadNumericAttribValue(const UPCGMet
 using namespace HoudiniPCGDataInputUtils;
 
 bool FHoudiniPCGComponentInput::HapiRetrieveData(UHoudiniInput* Input, const UObject* InputObject,
-	const FPCGDataCollection& Data, TArray<int32>& InOutNodeIds, int32& InOutDataIdx)
+	const FPCGDataCollection& Data, TArray<int32>& InOutNodeIds, int32& InOutDataIdx, const FHoudiniPCGAttributeFilter& AttribFilter)
+{
+	return HapiUploadData(Input->GetGeoNodeId(), Input->GetSettings().bImportRotAndScale,
+		[Input](const int32& NodeId) { return Input->HapiConnectToMergeNode(NodeId); }, InputObject, Data, InOutNodeIds, InOutDataIdx, AttribFilter,
+		ShouldDecimatePreview());
+}
+
+bool FHoudiniPCGComponentInput::HapiUploadData(const int32& ParentNodeId, const bool& bInImportRotAndScale, TFunctionRef<bool(const int32&)> ConnectFunc,
+	const UObject* InputObject, const FPCGDataCollection& Data, TArray<int32>& InOutNodeIds, int32& InOutDataIdx, const FHoudiniPCGAttributeFilter& AttribFilter,
+	const bool& bDecimatePreview, const HAPI_Session* InSession)
 {
 	TRACE_CPUPROFILER_EVENT_SCOPE(HoudiniInputPCGData);
+	LLM_SCOPE_BYTAG(HoudiniPCG_InputStaging);
+
+	const HAPI_Session* Session = InSession ? InSession : FHoudiniEngine::Get().GetSession();
+
+	const FHoudiniPCGCookStatsScope CookStatsScope(true);  // Each upload resets stats, unless the caller has entered a scope around all inputs of the cook
 
 	// TODO: should use my shared memory input API like other input translators in my houdini engine, to import data faster
 	// TODO: UE5.6 MetaData Domain
 
+	const FString InputName = InputObject ? InputObject->GetName() : TEXT("PCG");
+	const bool bUploadObjectPath = InputObject && !InputObject->IsA<AActor>();
+
+	const FHoudiniPCGAttributeFilter Filter = AttribFilter.IsEmpty() ? FHoudiniPCGAttributeFilter::GetDefault() : AttribFilter;
+	const bool bUploadDensity = Filter.MatchesProperty(TEXT("$Density"));
+	const bool bUploadColor = Filter.MatchesProperty(TEXT("$Color"));
+
 	HAPI_AttributeInfo AttribInfo;
 	for (const FPCGTaggedData& TaggedData : Data.TaggedData)
 	{
 #if ((ENGINE_MAJOR_VERSION == 5) && (ENGINE_MINOR_VERSION >= 6)) || (ENGINE_MAJOR_VERSION > 5)
 		if (const UPCGPointArrayData* PointData = Cast<UPCGPointArrayData>(TaggedData.Data))
 		{
-			const int32 NumPoints = PointData->GetNumPoints();
-			if (NumPoints <= 0)
+			const int32 NumSrcPoints = PointData->GetNumPoints();
+			if (NumSrcPoints <= 0)
 				continue;
 
+			HOUDINI_PCG_STAGE_SCOPE(InputPoints, NumSrcPoints);
+
+			TConstPCGValueRange<FTransform> Transforms = PointData->GetConstTransformValueRange();
+			TArray<int32> PointIndices;  // Empty means all points
+			if (bDecimatePreview)
+			{
+				TConstPCGValueRange<int32> Seeds = PointData->GetConstSeedValueRange();
+				GatherPreviewPointIndices(NumSrcPoints,
+					[&Seeds](const int32& PointIdx) { return Seeds.IsEmpty() ? 0 : Seeds[PointIdx]; },
+					[&Transforms](const int32& PointIdx) { return Transforms.IsEmpty() ? FVector::ZeroVector : Transforms[PointIdx].GetLocation(); },
+					PointIndices);
+			}
+			const int32 NumPoints = PointIndices.IsEmpty() ? NumSrcPoints : PointIndices.Num();
+
 			int32 NodeId = InOutNodeIds.IsValidIndex(InOutDataIdx) ? InOutNodeIds[InOutDataIdx] : -1;
 			const bool bCreateNewNode = (NodeId < 0);
 			if (bCreateNewNode)
-				HAPI_SESSION_FAIL_RETURN(FHoudiniApi::CreateNode(FHoudiniEngine::Get().GetSession(), Input->GetGeoNodeId(), "null",
-					TCHAR_TO_UTF8(*FString::Printf(TEXT("%s_%s_%08X"), *InputObject->GetName(), *TaggedData.Data->GetName(), FPlatformTime::Cycles())),
+				HAPI_SESSION_FAIL_RETURN(FHoudiniApi::CreateNode(Session, ParentNodeId, "null",
+					TCHAR_TO_UTF8(*FString::Printf(TEXT("%s_%s_%08X"), *InputName, *TaggedData.Data->GetName(), FPlatformTime::Cycles())),
 					false, &NodeId))
 			//else
-			//	HAPI_SESSION_FAIL_RETURN(FHoudiniApi::RevertGeo(FHoudiniEngine::Get().GetSession(), NodeId));  // Why this can NOT revert geo after next commit?
+			//	HAPI_SESSION_FAIL_RETURN(FHoudiniApi::RevertGeo(Session, NodeId));  // Why this can NOT revert geo after next commit?
 
 			{
-				TConstPCGValueRange<FTransform> Transforms = PointData->GetConstTransformValueRange();
 				TArray<float> PosData; if (!Transforms.IsEmpty()) PosData.SetNumUninitialized(NumPoints * 3); else PosData.SetNumZeroed(NumPoints * 3);
 				TArray<float> RotData; if (!Transforms.IsEmpty()) RotData.SetNumUninitialized(NumPoints * 4);
 				TArray<float> ScaleData; if (!Transforms.IsEmpty()) ScaleData.SetNumUninitialized(NumPoints * 3);
 				TConstPCGValueRange<float> Densities = PointData->GetConstDensityValueRange();
-				TArray<float> DensityData; if (!Densities.IsEmpty()) DensityData.SetNumUninitialized(NumPoints);
+				TArray<float> DensityData; if (bUploadDensity && !Densities.IsEmpty()) DensityData.SetNumUninitialized(NumPoints);
 				TConstPCGValueRange<FVector4> Colors = PointData->GetConstColorValueRange();
-				TArray<float> ColorData; if (!Colors.IsEmpty()) ColorData.SetNumUninitialized(NumPoints * 3);
-				TArray<float> AlphaData; if (!Colors.IsEmpty()) AlphaData.SetNumUninitialized(NumPoints);
+				TArray<float> ColorData; if (bUploadColor && !Colors.IsEmpty()) ColorData.SetNumUninitialized(NumPoints * 3);
+				TArray<float> AlphaData; if (bUploadColor && !Colors.IsEmpty()) AlphaData.SetNumUninitialized(NumPoints);
+				const FHoudiniPCGTransientBytesScope TransientBytesScope(true, PosData.GetAllocatedSize() + RotData.GetAllocatedSize() + ScaleData.GetAllocatedSize() +
+					DensityData.GetAllocatedSize() + ColorData.GetAllocatedSize() + AlphaData.GetAllocatedSize());
+
+				if (!Transforms.IsEmpty())
+					FHoudiniPCGUtils::ConvertTransformsToHoudini(NumPoints, [&Transforms, &PointIndices](const int32& PointIdx) -> const FTransform&
+						{ return Transforms[PointIndices.IsEmpty() ? PointIdx : PointIndices[PointIdx]]; },
+						PosData.GetData(), RotData.GetData(), ScaleData.GetData());
 
 				for (int32 PointIdx = 0; PointIdx < NumPoints; ++PointIdx)
 				{
-					if (!Transforms.IsEmpty())
+					const int32 SrcPointIdx = PointIndices.IsEmpty() ? PointIdx : PointIndices[PointIdx];
+					if (!DensityData.IsEmpty())
+						DensityData[PointIdx] = Densities[SrcPointIdx];
+					if (!ColorData.IsEmpty())
 					{
-						const FTransform& Transform = Transforms[PointIdx];
-						{
-							const FVector3f Pos = FVector3f(Transform.GetLocation() * POSITION_SCALE_TO_HOUDINI);
-							PosData[PointIdx * 3] = Pos.X; PosData[PointIdx * 3 + 1] = Pos.Z; PosData[PointIdx * 3 + 2] = Pos.Y;
-						}
-						{
-							const FQuat Rot = Transform.GetRotation();
-							RotData[PointIdx * 4] = Rot.X; RotData[PointIdx * 4 + 1] = Rot.Z; RotData[PointIdx * 4 + 2] = Rot.Y; RotData[PointIdx * 4 + 3] = -Rot.W;
-						}
-						{
-							const FVector Scale = Transform.GetScale3D();
-							ScaleData[PointIdx * 3] = Scale.X; ScaleData[PointIdx * 3 + 1] = Scale.Z; ScaleData[PointIdx * 3 + 2] = Scale.Y;
-						}
-					}
-					if (!Densities.IsEmpty())
-						DensityData[PointIdx] = Densities[PointIdx];
-					if (!Colors.IsEmpty())
-					{
-						const FVector4f Color = FVector4f(Colors[PointIdx]);
+						const FVector4f Color = FVector4f(Colors[SrcPointIdx]);
 						ColorData[PointIdx * 3] = Color.X; ColorData[PointIdx * 3 + 1] = Color.Y; ColorData[PointIdx * 3 + 2] = Color.Z;
 						AlphaData[PointIdx] = Color.W;
 					}
@@ -262,7 +524,7 @@ bool FHoudiniPCGComponentInput::HapiRetrieveData(UHoudiniInput* Input, const UOb
 				PartInfo.type = HAPI_PARTTYPE_MESH;
 				PartInfo.pointCount = NumPoints;
 
-				HAPI_SESSION_FAIL_RETURN(FHoudiniApi::SetPartInfo(FHoudiniEngine::Get().GetSession(), NodeId, 0, &PartInfo));
+				HAPI_SESSION_FAIL_RETURN(FHoudiniApi::SetPartInfo(Session, NodeId, 0, &PartInfo));
 				AttribInfo.count = PartInfo.pointCount;
 				AttribInfo.owner = HAPI_ATTROWNER_POINT;
 				{
@@ -270,11 +532,14 @@ bool FHoudiniPCGComponentInput::HapiRetrieveData(UHoudiniInput* Input, const UOb
 					AttribInfo.tupleSize = 3;
 					AttribInfo.storage = HAPI_STORAGETYPE_FLOAT;
 
-					HAPI_SESSION_FAIL_RETURN(FHoudiniApi::AddAttribute(FHoudiniEngine::Get().GetSession(), NodeId, 0,
+					HAPI_SESSION_FAIL_RETURN(FHoudiniApi::AddAttribute(Session, NodeId, 0,
 						HAPI_ATTRIB_POSITION, &AttribInfo));
 
-					HAPI_SESSION_FAIL_RETURN(FHoudiniApi::SetAttributeFloatData(FHoudiniEngine::Get().GetSession(), NodeId, 0,
-						HAPI_ATTRIB_POSITION, &AttribInfo, PosData.GetData(), 0, AttribInfo.count));
+					{
+						HOUDINI_PCG_HAPI_CALL_SCOPE(true, AttribInfo.count * AttribInfo.tupleSize * sizeof(float));
+						HAPI_SESSION_FAIL_RETURN(FHoudiniApi::SetAttributeFloatData(Session, NodeId, 0,
+							HAPI_ATTRIB_POSITION, &AttribInfo, PosData.GetData(), 0, AttribInfo.count));
+					}
 				}
 				if (!RotData.IsEmpty())
 				{
@@ -282,11 +547,14 @@ bool FHoudiniPCGComponentInput::HapiRetrieveData(UHoudiniInput* Input, const UOb
 					AttribInfo.tupleSize = 4;
 					AttribInfo.storage = HAPI_STORAGETYPE_FLOAT;
 
-					HAPI_SESSION_FAIL_RETURN(FHoudiniApi::AddAttribute(FHoudiniEngine::Get().GetSession(), NodeId, 0,
+					HAPI_SESSION_FAIL_RETURN(FHoudiniApi::AddAttribute(Session, NodeId, 0,
 						HAPI_ATTRIB_ROT, &AttribInfo));
 
-					HAPI_SESSION_FAIL_RETURN(FHoudiniApi::SetAttributeFloatData(FHoudiniEngine::Get().GetSession(), NodeId, 0,
-						HAPI_ATTRIB_ROT, &AttribInfo, RotData.GetData(), 0, AttribInfo.count));
+					{
+						HOUDINI_PCG_HAPI_CALL_SCOPE(true, AttribInfo.count * AttribInfo.tupleSize * sizeof(float));
+						HAPI_SESSION_FAIL_RETURN(FHoudiniApi::SetAttributeFloatData(Session, NodeId, 0,
+							HAPI_ATTRIB_ROT, &AttribInfo, RotData.GetData(), 0, AttribInfo.count));
+					}
 				}
 				if (!ScaleData.IsEmpty())
 				{
@@ -294,11 +562,14 @@ bool FHoudiniPCGComponentInput::HapiRetrieveData(UHoudiniInput* Input, const UOb
 					AttribInfo.tupleSize = 3;
 					AttribInfo.storage = HAPI_STORAGETYPE_FLOAT;
 
-					HAPI_SESSION_FAIL_RETURN(FHoudiniApi::AddAttribute(FHoudiniEngine::Get().GetSession(), NodeId, 0,
+					HAPI_SESSION_FAIL_RETURN(FHoudiniApi::AddAttribute(Session, NodeId, 0,
 						HAPI_ATTRIB_SCALE, &AttribInfo));
 
-					HAPI_SESSION_FAIL_RETURN(FHoudiniApi::SetAttributeFloatData(FHoudiniEngine::Get().GetSession(), NodeId, 0,
-						HAPI_ATTRIB_SCALE, &AttribInfo, ScaleData.GetData(), 0, AttribInfo.count));
+					{
+						HOUDINI_PCG_HAPI_CALL_SCOPE(true, AttribInfo.count * AttribInfo.tupleSize * sizeof(float));
+						HAPI_SESSION_FAIL_RETURN(FHoudiniApi::SetAttributeFloatData(Session, NodeId, 0,
+							HAPI_ATTRIB_SCALE, &AttribInfo, ScaleData.GetData(), 0, AttribInfo.count));
+					}
 				}
 				if (!DensityData.IsEmpty())
 				{
@@ -306,11 +577,14 @@ bool FHoudiniPCGComponentInput::HapiRetrieveData(UHoudiniInput* Input, const UOb
 					AttribInfo.tupleSize = 1;
 					AttribInfo.storage = HAPI_STORAGETYPE_FLOAT;
 
-					HAPI_SESSION_FAIL_RETURN(FHoudiniApi::AddAttribute(FHoudiniEngine::Get().GetSession(), NodeId, 0,
+					HAPI_SESSION_FAIL_RETURN(FHoudiniApi::AddAttribute(Session, NodeId, 0,
 						HAPI_ATTRIB_DENSITY, &AttribInfo));
 
-					HAPI_SESSION_FAIL_RETURN(FHoudiniApi::SetAttributeFloatData(FHoudiniEngine::Get().GetSession(), NodeId, 0,
-						HAPI_ATTRIB_DENSITY, &AttribInfo, DensityData.GetData(), 0, AttribInfo.count));
+					{
+						HOUDINI_PCG_HAPI_CALL_SCOPE(true, AttribInfo.count * AttribInfo.tupleSize * sizeof(float));
+						HAPI_SESSION_FAIL_RETURN(FHoudiniApi::SetAttributeFloatData(Session, NodeId, 0,
+							HAPI_ATTRIB_DENSITY, &AttribInfo, DensityData.GetData(), 0, AttribInfo.count));
+					}
 				}
 				if (!ColorData.IsEmpty())
 				{
@@ -318,11 +592,14 @@ bool FHoudiniPCGComponentInput::HapiRetrieveData(UHoudiniInput* Input, const UOb
 					AttribInfo.tupleSize = 3;
 					AttribInfo.storage = HAPI_STORAGETYPE_FLOAT;
 
-					HAPI_SESSION_FAIL_RETURN(FHoudiniApi::AddAttribute(FHoudiniEngine::Get().GetSession(), NodeId, 0,
+					HAPI_SESSION_FAIL_RETURN(FHoudiniApi::AddAttribute(Session, NodeId, 0,
 						HAPI_ATTRIB_COLOR, &AttribInfo));
 
-					HAPI_SESSION_FAIL_RETURN(FHoudiniApi::SetAttributeFloatData(FHoudiniEngine::Get().GetSession(), NodeId, 0,
-						HAPI_ATTRIB_COLOR, &AttribInfo, ColorData.GetData(), 0, AttribInfo.count));
+					{
+						HOUDINI_PCG_HAPI_CALL_SCOPE(true, AttribInfo.count * AttribInfo.tupleSize * sizeof(float));
+						HAPI_SESSION_FAIL_RETURN(FHoudiniApi::SetAttributeFloatData(Session, NodeId, 0,
+							HAPI_ATTRIB_COLOR, &AttribInfo, ColorData.GetData(), 0, AttribInfo.count));
+					}
 				}
 				if (!AlphaData.IsEmpty())
 				{
@@ -330,65 +607,72 @@ bool FHoudiniPCGComponentInput::HapiRetrieveData(UHoudiniInput* Input, const UOb
 					AttribInfo.tupleSize = 1;
 					AttribInfo.storage = HAPI_STORAGETYPE_FLOAT;
 
-					HAPI_SESSION_FAIL_RETURN(FHoudiniApi::AddAttribute(FHoudiniEngine::Get().GetSession(), NodeId, 0,
+					HAPI_SESSION_FAIL_RETURN(FHoudiniApi::AddAttribute(Session, NodeId, 0,
 						HAPI_ALPHA, &AttribInfo));
 
-					HAPI_SESSION_FAIL_RETURN(FHoudiniApi::SetAttributeFloatData(FHoudiniEngine::Get().GetSession(), NodeId, 0,
-						HAPI_ALPHA, &AttribInfo, AlphaData.GetData(), 0, AttribInfo.count));
+					{
+						HOUDINI_PCG_HAPI_CALL_SCOPE(true, AttribInfo.count * AttribInfo.tupleSize * sizeof(float));
+						HAPI_SESSION_FAIL_RETURN(FHoudiniApi::SetAttributeFloatData(Session, NodeId, 0,
+							HAPI_ALPHA, &AttribInfo, AlphaData.GetData(), 0, AttribInfo.count));
+					}
 				}
 			}
 
 			TArray<FName> AttribNames;
 			TArray<EPCGMetadataTypes> AttribTypes;
 			PointData->Metadata->GetAttributes(AttribNames, AttribTypes);
+			FilterAttributes(Filter, AttribNames, AttribTypes);
+			FHoudiniPCGCookStats::AddAttributes(true, AttribNames.Num());
 			for (int32 AttribIdx = 0; AttribIdx < AttribNames.Num(); ++AttribIdx)
 			{
+				HOUDINI_PCG_STAGE_SCOPE(InputAttributes, NumPoints);
+
 				const FName& AttribName = AttribNames[AttribIdx];
 				switch (AttribTypes[AttribIdx])
 				{
 				case EPCGMetadataTypes::Float:
 					if (!HapiUploadNumericAttribValue<float, float, 1, HAPI_STORAGETYPE_FLOAT, HAPI_ATTRIBUTE_TYPE_NONE>(
-						PointData->Metadata, AttribName, NodeId, AttribInfo, [](const float& SrcValue, TArray<float>& DstValues) { DstValues.Add(SrcValue); },
+						PointData->Metadata, AttribName, Session, NodeId, AttribInfo, PointIndices, [](const float& SrcValue, TArray<float>& DstValues) { DstValues.Add(SrcValue); },
 						FHoudiniApi::SetAttributeFloatUniqueData, FHoudiniApi::SetAttributeFloatData)) return false;
 					break;
 				case EPCGMetadataTypes::Double:
 					if (!HapiUploadNumericAttribValue<double, double, 1, HAPI_STORAGETYPE_FLOAT64, HAPI_ATTRIBUTE_TYPE_NONE>(
-						PointData->Metadata, AttribName, NodeId, AttribInfo, [](const double& SrcValue, TArray<double>& DstValues) { DstValues.Add(SrcValue); },
+						PointData->Metadata, AttribName, Session, NodeId, AttribInfo, PointIndices, [](const double& SrcValue, TArray<double>& DstValues) { DstValues.Add(SrcValue); },
 						FHoudiniApi::SetAttributeFloat64UniqueData, FHoudiniApi::SetAttributeFloat64Data)) return false;
 					break;
 				case EPCGMetadataTypes::Integer32:
 					if (!HapiUploadNumericAttribValue<int32, int, 1, HAPI_STORAGETYPE_INT, HAPI_ATTRIBUTE_TYPE_NONE>(
-						PointData->Metadata, AttribName, NodeId, AttribInfo, [](const int32& SrcValue, TArray<int>& DstValues) { DstValues.Add(SrcValue); },
+						PointData->Metadata, AttribName, Session, NodeId, AttribInfo, PointIndices, [](const int32& SrcValue, TArray<int>& DstValues) { DstValues.Add(SrcValue); },
 						FHoudiniApi::SetAttributeIntUniqueData, FHoudiniApi::SetAttributeIntData)) return false;
 					break;
 				case EPCGMetadataTypes::Integer64:
 					if (!HapiUploadNumericAttribValue<int64, HAPI_Int64, 1, HAPI_STORAGETYPE_INT64, HAPI_ATTRIBUTE_TYPE_NONE>(
-						PointData->Metadata, AttribName, NodeId, AttribInfo, [](const int64& SrcValue, TArray<HAPI_Int64>& DstValues) { DstValues.Add(SrcValue); },
+						PointData->Metadata, AttribName, Session, NodeId, AttribInfo, PointIndices, [](const int64& SrcValue, TArray<HAPI_Int64>& DstValues) { DstValues.Add(SrcValue); },
 						FHoudiniApi::SetAttributeInt64UniqueData, FHoudiniApi::SetAttributeInt64Data)) return false;
 					break;
 				case EPCGMetadataTypes::Vector2:
 					if (!HapiUploadNumericAttribValue<FVector2d, float, 2, HAPI_STORAGETYPE_FLOAT, HAPI_ATTRIBUTE_TYPE_NONE>(
-						PointData->Metadata, AttribName, NodeId, AttribInfo, [](const FVector2d& SrcValue, TArray<float>& DstValues) { DstValues.Add(SrcValue.X); DstValues.Add(SrcValue.Y); },
+						PointData->Metadata, AttribName, Session, NodeId, AttribInfo, PointIndices, [](const FVector2d& SrcValue, TArray<float>& DstValues) { DstValues.Add(SrcValue.X); DstValues.Add(SrcValue.Y); },
 						FHoudiniApi::SetAttributeFloatUniqueData, FHoudiniApi::SetAttributeFloatData)) return false;
 					break;
 				case EPCGMetadataTypes::Vector:
 					if (!HapiUploadNumericAttribValue<FVector, float, 3, HAPI_STORAGETYPE_FLOAT, HAPI_ATTRIBUTE_TYPE_NONE>(
-						PointData->Metadata, AttribName, NodeId, AttribInfo, [](const FVector& SrcValue, TArray<float>& DstValues) { DstValues.Add(SrcValue.X); DstValues.Add(SrcValue.Y); DstValues.Add(SrcValue.Z); },
+						PointData->Metadata, AttribName, Session, NodeId, AttribInfo, PointIndices, [](const FVector& SrcValue, TArray<float>& DstValues) { DstValues.Add(SrcValue.X); DstValues.Add(SrcValue.Y); DstValues.Add(SrcValue.Z); },
 						FHoudiniApi::SetAttributeFloatUniqueData, FHoudiniApi::SetAttributeFloatData)) return false;
 					break;
 				case EPCGMetadataTypes::Vector4:
 					if (!HapiUploadNumericAttribValue<FVector4, float, 4, HAPI_STORAGETYPE_FLOAT, HAPI_ATTRIBUTE_TYPE_NONE>(
-						PointData->Metadata, AttribName, NodeId, AttribInfo, [](const FVector4& SrcValue, TArray<float>& DstValues) { DstValues.Add(SrcValue.X); DstValues.Add(SrcValue.Y); DstValues.Add(SrcValue.Z); DstValues.Add(SrcValue.W); },
+						PointData->Metadata, AttribName, Session, NodeId, AttribInfo, PointIndices, [](const FVector4& SrcValue, TArray<float>& DstValues) { DstValues.Add(SrcValue.X); DstValues.Add(SrcValue.Y); DstValues.Add(SrcValue.Z); DstValues.Add(SrcValue.W); },
 						FHoudiniApi::SetAttributeFloatUniqueData, FHoudiniApi::SetAttributeFloatData)) return false;
 					break;
 				case EPCGMetadataTypes::Quaternion:
 					if (!HapiUploadNumericAttribValue<FQuat, float, 4, HAPI_STORAGETYPE_FLOAT, HAPI_ATTRIBUTE_TYPE_QUATERNION>(
-						PointData->Metadata, AttribName, NodeId, AttribInfo, [](const FQuat& SrcValue, TArray<float>& DstValues) { DstValues.Add(SrcValue.X); DstValues.Add(SrcValue.Z); DstValues.Add(SrcValue.Y); DstValues.Add(-SrcValue.W); },
+						PointData->Metadata, AttribName, Session, NodeId, AttribInfo, PointIndices, [](const FQuat& SrcValue, TArray<float>& DstValues) { DstValues.Add(SrcValue.X); DstValues.Add(SrcValue.Z); DstValues.Add(SrcValue.Y); DstValues.Add(-SrcValue.W); },
 						FHoudiniApi::SetAttributeFloatUniqueData, FHoudiniApi::SetAttributeFloatData)) return false;
 					break;
 				case EPCGMetadataTypes::Transform:
 					if (!HapiUploadNumericAttribValue<FTransform, float, 16, HAPI_STORAGETYPE_FLOAT, HAPI_ATTRIBUTE_TYPE_MATRIX>(
-						PointData->Metadata, AttribName, NodeId, AttribInfo, [](const FTransform& SrcValue, TArray<float>& DstValues)
+						PointData->Metadata, AttribName, Session, NodeId, AttribInfo, PointIndices, [](const FTransform& SrcValue, TArray<float>& DstValues)
 						{
 							const FMatrix44f UnrealXform = FMatrix44f(SrcValue.ToMatrixWithScale());
 
@@ -417,50 +701,54 @@ bool FHoudiniPCGComponentInput::HapiRetrieveData(UHoudiniInput* Input, const UOb
 						FHoudiniApi::SetAttributeFloatUniqueData, FHoudiniApi::SetAttributeFloatData)) return false;
 					break;
 				case EPCGMetadataTypes::String:
-					HOUDINI_FAIL_RETURN(HapiUploadStringAttribValue<FString>(PointData->Metadata, AttribName, NodeId, AttribInfo,
+					HOUDINI_FAIL_RETURN(HapiUploadStringAttribValue<FString>(PointData->Metadata, AttribName, Session, NodeId, AttribInfo, PointIndices,
 						[](const FString& Value) { return Value; }));
 					break;
 				case EPCGMetadataTypes::Boolean:
 					if (!HapiUploadNumericAttribValue<bool, uint8, 1, HAPI_STORAGETYPE_UINT8, HAPI_ATTRIBUTE_TYPE_NONE>(
-						PointData->Metadata, AttribName, NodeId, AttribInfo, [](const bool& SrcValue, TArray<uint8>& DstValues) { DstValues.Add(uint8(SrcValue)); },
+						PointData->Metadata, AttribName, Session, NodeId, AttribInfo, PointIndices, [](const bool& SrcValue, TArray<uint8>& DstValues) { DstValues.Add(uint8(SrcValue)); },
 						FHoudiniApi::SetAttributeUInt8UniqueData, FHoudiniApi::SetAttributeUInt8Data)) return false;
 					break;
 				case EPCGMetadataTypes::Rotator:
 					if (!HapiUploadNumericAttribValue<FRotator, float, 3, HAPI_STORAGETYPE_FLOAT, HAPI_ATTRIBUTE_TYPE_NONE>(
-						PointData->Metadata, AttribName, NodeId, AttribInfo, [](const FRotator& SrcValue, TArray<float>& DstValues) { DstValues.Add(SrcValue.Roll); DstValues.Add(SrcValue.Yaw); DstValues.Add(SrcValue.Pitch); },
+						PointData->Metadata, AttribName, Session, NodeId, AttribInfo, PointIndices, [](const FRotator& SrcValue, TArray<float>& DstValues) { DstValues.Add(SrcValue.Roll); DstValues.Add(SrcValue.Yaw); DstValues.Add(SrcValue.Pitch); },
 						FHoudiniApi::SetAttributeFloatUniqueData, FHoudiniApi::SetAttributeFloatData)) return false;
 					break;
 				case EPCGMetadataTypes::Name:
-					HOUDINI_FAIL_RETURN(HapiUploadStringAttribValue<FName>(PointData->Metadata, AttribName, NodeId, AttribInfo,
+					HOUDINI_FAIL_RETURN(HapiUploadStringAttribValue<FName>(PointData->Metadata, AttribName, Session, NodeId, AttribInfo, PointIndices,
 						[](const FName& Value) { return Value.ToString(); }));
 					break;
 				case EPCGMetadataTypes::SoftObjectPath:
-					HOUDINI_FAIL_RETURN(HapiUploadStringAttribValue<FSoftObjectPath>(PointData->Metadata, AttribName, NodeId, AttribInfo,
+					HOUDINI_FAIL_RETURN(HapiUploadStringAttribValue<FSoftObjectPath>(PointData->Metadata, AttribName, Session, NodeId, AttribInfo, PointIndices,
 						[](const FSoftObjectPath& Value) { return Value.ToString(); }));
 					break;
 				case EPCGMetadataTypes::SoftClassPath:
-					HOUDINI_FAIL_RETURN(HapiUploadStringAttribValue<FSoftClassPath>(PointData->Metadata, AttribName, NodeId, AttribInfo,
+					HOUDINI_FAIL_RETURN(HapiUploadStringAttribValue<FSoftClassPath>(PointData->Metadata, AttribName, Session, NodeId, AttribInfo, PointIndices,
 						[](const FSoftClassPath& Value) { return Value.ToString(); }));
 					break;
 				}
 			}
 
-			if (!InputObject->IsA<AActor>())  // s@unreal_object_path
+			if (bUploadObjectPath)  // s@unreal_object_path
 			{
 				AttribInfo.tupleSize = 1;
 				AttribInfo.storage = HAPI_STORAGETYPE_STRING;
 
-				HAPI_SESSION_FAIL_RETURN(FHoudiniApi::AddAttribute(FHoudiniEngine::Get().GetSession(), NodeId, 0,
+				HAPI_SESSION_FAIL_RETURN(FHoudiniApi::AddAttribute(Session, NodeId, 0,
 					HAPI_ATTRIB_UNREAL_OBJECT_PATH, &AttribInfo));
 
-				HAPI_SESSION_FAIL_RETURN(FHoudiniApi::SetAttributeStringUniqueData(FHoudiniEngine::Get().GetSession(), NodeId, 0,
+				HAPI_SESSION_FAIL_RETURN(FHoudiniApi::SetAttributeStringUniqueData(Session, NodeId, 0,
 					HAPI_ATTRIB_UNREAL_OBJECT_PATH, &AttribInfo, TCHAR_TO_UTF8(*FHoudiniEngineUtils::GetAssetReference(InputObject)), 1, 0, AttribInfo.count));
 			}
 
-			HAPI_SESSION_FAIL_RETURN(FHoudiniApi::CommitGeo(FHoudiniEngine::Get().GetSession(), NodeId));
+			{
+				HOUDINI_PCG_STAGE_SCOPE(InputCommit, 1);
+				HOUDINI_PCG_HAPI_CALL_SCOPE(true, 0);
+				HAPI_SESSION_FAIL_RETURN(FHoudiniApi::CommitGeo(Session, NodeId));
+			}
 			if (bCreateNewNode)
 			{
-				HOUDINI_FAIL_RETURN(Input->HapiConnectToMergeNode(NodeId));
+				HOUDINI_FAIL_RETURN(ConnectFunc(NodeId));
 				InOutNodeIds.Add(NodeId);
 			}
 
@@ -473,49 +761,57 @@ bool FHoudiniPCGComponentInput::HapiRetrieveData(UHoudiniInput* Input, const UOb
 			if (Points.IsEmpty())
 				continue;
 
+			HOUDINI_PCG_STAGE_SCOPE(InputPoints, Points.Num());
+
+			TArray<int32> PointIndices;  // Empty means all points
+			if (bDecimatePreview)
+				GatherPreviewPointIndices(Points.Num(),
+					[&Points](const int32& PointIdx) { return Points[PointIdx].Seed; },
+					[&Points](const int32& PointIdx) { return Points[PointIdx].Transform.GetLocation(); },
+					PointIndices);
+			const int32 NumPoints = PointIndices.IsEmpty() ? Points.Num() : PointIndices.Num();
+
 			int32 NodeId = InOutNodeIds.IsValidIndex(InOutDataIdx) ? InOutNodeIds[InOutDataIdx] : -1;
 			const bool bCreateNewNode = (NodeId < 0);
 			if (bCreateNewNode)
-				HAPI_SESSION_FAIL_RETURN(FHoudiniApi::CreateNode(FHoudiniEngine::Get().GetSession(), Input->GetGeoNodeId(), "null",
-					TCHAR_TO_UTF8(*FString::Printf(TEXT("%s_%s_%08X"), *InputObject->GetName(), *TaggedData.Data->GetName(), FPlatformTime::Cycles())),
+				HAPI_SESSION_FAIL_RETURN(FHoudiniApi::CreateNode(Session, ParentNodeId, "null",
+					TCHAR_TO_UTF8(*FString::Printf(TEXT("%s_%s_%08X"), *InputName, *TaggedData.Data->GetName(), FPlatformTime::Cycles())),
 					false, &NodeId))
 			//else
-			//	HAPI_SESSION_FAIL_RETURN(FHoudiniApi::RevertGeo(FHoudiniEngine::Get().GetSession(), NodeId));  // Why this can NOT revert geo after next commit?
+			//	HAPI_SESSION_FAIL_RETURN(FHoudiniApi::RevertGeo(Session, NodeId));  // Why this can NOT revert geo after next commit?
 
 			{
-				TArray<float> PosData; PosData.SetNumUninitialized(Points.Num() * 3);
-				TArray<float> RotData; RotData.SetNumUninitialized(Points.Num() * 4);
-				TArray<float> ScaleData; ScaleData.SetNumUninitialized(Points.Num() * 3);
-				TArray<float> DensityData; DensityData.SetNumUninitialized(Points.Num());
-				TArray<float> ColorData; ColorData.SetNumUninitialized(Points.Num() * 3);
-				TArray<float> AlphaData; AlphaData.SetNumUninitialized(Points.Num());
-
-				for (int32 PointIdx = 0; PointIdx < Points.Num(); ++PointIdx)
+				TArray<float> PosData; PosData.SetNumUninitialized(NumPoints * 3);
+				TArray<float> RotData; RotData.SetNumUninitialized(NumPoints * 4);
+				TArray<float> ScaleData; ScaleData.SetNumUninitialized(NumPoints * 3);
+				TArray<float> DensityData; if (bUploadDensity) DensityData.SetNumUninitialized(NumPoints);
+				TArray<float> ColorData; if (bUploadColor) ColorData.SetNumUninitialized(NumPoints * 3);
+				TArray<float> AlphaData; if (bUploadColor) AlphaData.SetNumUninitialized(NumPoints);
+				const FHoudiniPCGTransientBytesScope TransientBytesScope(true, PosData.GetAllocatedSize() + RotData.GetAllocatedSize() + ScaleData.GetAllocatedSize() +
+					DensityData.GetAllocatedSize() + ColorData.GetAllocatedSize() + AlphaData.GetAllocatedSize());
+
+				FHoudiniPCGUtils::ConvertTransformsToHoudini(NumPoints, [&Points, &PointIndices](const int32& PointIdx) -> const FTransform&
+					{ return Points[PointIndices.IsEmpty() ? PointIdx : PointIndices[PointIdx]].Transform; },
+					PosData.GetData(), RotData.GetData(), ScaleData.GetData());
+
+				for (int32 PointIdx = 0; PointIdx < NumPoints; ++PointIdx)
 				{
-					const FPCGPoint& Point = Points[PointIdx];
-					{
-						const FVector3f Pos = FVector3f(Point.Transform.GetLocation() * POSITION_SCALE_TO_HOUDINI);
-						PosData[PointIdx * 3] = Pos.X; PosData[PointIdx * 3 + 1] = Pos.Z; PosData[PointIdx * 3 + 2] = Pos.Y;
-					}
-					{
-						const FQuat Rot = Point.Transform.GetRotation();
-						RotData[PointIdx * 4] = Rot.X; RotData[PointIdx * 4 + 1] = Rot.Z; RotData[PointIdx * 4 + 2] = Rot.Y; RotData[PointIdx * 4 + 3] = -Rot.W;
-					}
+					const FPCGPoint& Point = Points[PointIndices.IsEmpty() ? PointIdx : PointIndices[PointIdx]];
+					if (!DensityData.IsEmpty())
+						DensityData[PointIdx] = Point.Density;
+					if (!ColorData.IsEmpty())
 					{
-						const FVector Scale = Point.Transform.GetScale3D();
-						ScaleData[PointIdx * 3] = Scale.X; ScaleData[PointIdx * 3 + 1] = Scale.Z; ScaleData[PointIdx * 3 + 2] = Scale.Y;
+						ColorData[PointIdx * 3] = Point.Color.X; ColorData[PointIdx * 3 + 1] = Point.Color.Y; ColorData[PointIdx * 3 + 2] = Point.Color.Z;
+						AlphaData[PointIdx] = Point.Color.W;
 					}
-					DensityData[PointIdx] = Point.Density;
-					ColorData[PointIdx * 3] = Point.Color.X; ColorData[PointIdx * 3 + 1] = Point.Color.Y; ColorData[PointIdx * 3 + 2] = Point.Color.Z;
-					AlphaData[PointIdx] = Point.Color.W;
 				}
 
 				HAPI_PartInfo PartInfo;
 				FHoudiniApi::PartInfo_Init(&PartInfo);
 				PartInfo.type = HAPI_PARTTYPE_MESH;
-				PartInfo.pointCount = Points.Num();
+				PartInfo.pointCount = NumPoints;
 
-				HAPI_SESSION_FAIL_RETURN(FHoudiniApi::SetPartInfo(FHoudiniEngine::Get().GetSession(), NodeId, 0, &PartInfo));
+				HAPI_SESSION_FAIL_RETURN(FHoudiniApi::SetPartInfo(Session, NodeId, 0, &PartInfo));
 				AttribInfo.count = PartInfo.pointCount;
 				AttribInfo.owner = HAPI_ATTROWNER_POINT;
 				{
@@ -523,120 +819,145 @@ bool FHoudiniPCGComponentInput::HapiRetrieveData(UHoudiniInput* Input, const UOb
 					AttribInfo.tupleSize = 3;
 					AttribInfo.storage = HAPI_STORAGETYPE_FLOAT;
 
-					HAPI_SESSION_FAIL_RETURN(FHoudiniApi::AddAttribute(FHoudiniEngine::Get().GetSession(), NodeId, 0,
+					HAPI_SESSION_FAIL_RETURN(FHoudiniApi::AddAttribute(Session, NodeId, 0,
 						HAPI_ATTRIB_POSITION, &AttribInfo));
 
-					HAPI_SESSION_FAIL_RETURN(FHoudiniApi::SetAttributeFloatData(FHoudiniEngine::Get().GetSession(), NodeId, 0,
-						HAPI_ATTRIB_POSITION, &AttribInfo, PosData.GetData(), 0, AttribInfo.count));
+					{
+						HOUDINI_PCG_HAPI_CALL_SCOPE(true, AttribInfo.count * AttribInfo.tupleSize * sizeof(float));
+						HAPI_SESSION_FAIL_RETURN(FHoudiniApi::SetAttributeFloatData(Session, NodeId, 0,
+							HAPI_ATTRIB_POSITION, &AttribInfo, PosData.GetData(), 0, AttribInfo.count));
+					}
 				}
 				{
 					// p@rot
 					AttribInfo.tupleSize = 4;
 					AttribInfo.storage = HAPI_STORAGETYPE_FLOAT;
 
-					HAPI_SESSION_FAIL_RETURN(FHoudiniApi::AddAttribute(FHoudiniEngine::Get().GetSession(), NodeId, 0,
+					HAPI_SESSION_FAIL_RETURN(FHoudiniApi::AddAttribute(Session, NodeId, 0,
 						HAPI_ATTRIB_ROT, &AttribInfo));
 
-					HAPI_SESSION_FAIL_RETURN(FHoudiniApi::SetAttributeFloatData(FHoudiniEngine::Get().GetSession(), NodeId, 0,
-						HAPI_ATTRIB_ROT, &AttribInfo, RotData.GetData(), 0, AttribInfo.count));
+					{
+						HOUDINI_PCG_HAPI_CALL_SCOPE(true, AttribInfo.count * AttribInfo.tupleSize * sizeof(float));
+						HAPI_SESSION_FAIL_RETURN(FHoudiniApi::SetAttributeFloatData(Session, NodeId, 0,
+							HAPI_ATTRIB_ROT, &AttribInfo, RotData.GetData(), 0, AttribInfo.count));
+					}
 				}
 				{
 					// v@scale
 					AttribInfo.tupleSize = 3;
 					AttribInfo.storage = HAPI_STORAGETYPE_FLOAT;
 
-					HAPI_SESSION_FAIL_RETURN(FHoudiniApi::AddAttribute(FHoudiniEngine::Get().GetSession(), NodeId, 0,
+					HAPI_SESSION_FAIL_RETURN(FHoudiniApi::AddAttribute(Session, NodeId, 0,
 						HAPI_ATTRIB_SCALE, &AttribInfo));
 
-					HAPI_SESSION_FAIL_RETURN(FHoudiniApi::SetAttributeFloatData(FHoudiniEngine::Get().GetSession(), NodeId, 0,
-						HAPI_ATTRIB_SCALE, &AttribInfo, ScaleData.GetData(), 0, AttribInfo.count));
+					{
+						HOUDINI_PCG_HAPI_CALL_SCOPE(true, AttribInfo.count * AttribInfo.tupleSize * sizeof(float));
+						HAPI_SESSION_FAIL_RETURN(FHoudiniApi::SetAttributeFloatData(Session, NodeId, 0,
+							HAPI_ATTRIB_SCALE, &AttribInfo, ScaleData.GetData(), 0, AttribInfo.count));
+					}
 				}
+				if (!DensityData.IsEmpty())
 				{
 					// f@density
 					AttribInfo.tupleSize = 1;
 					AttribInfo.storage = HAPI_STORAGETYPE_FLOAT;
 
-					HAPI_SESSION_FAIL_RETURN(FHoudiniApi::AddAttribute(FHoudiniEngine::Get().GetSession(), NodeId, 0,
+					HAPI_SESSION_FAIL_RETURN(FHoudiniApi::AddAttribute(Session, NodeId, 0,
 						HAPI_ATTRIB_DENSITY, &AttribInfo));
 
-					HAPI_SESSION_FAIL_RETURN(FHoudiniApi::SetAttributeFloatData(FHoudiniEngine::Get().GetSession(), NodeId, 0,
-						HAPI_ATTRIB_DENSITY, &AttribInfo, DensityData.GetData(), 0, AttribInfo.count));
+					{
+						HOUDINI_PCG_HAPI_CALL_SCOPE(true, AttribInfo.count * AttribInfo.tupleSize * sizeof(float));
+						HAPI_SESSION_FAIL_RETURN(FHoudiniApi::SetAttributeFloatData(Session, NodeId, 0,
+							HAPI_ATTRIB_DENSITY, &AttribInfo, DensityData.GetData(), 0, AttribInfo.count));
+					}
 				}
+				if (!ColorData.IsEmpty())
 				{
 					// v@Cd
 					AttribInfo.tupleSize = 3;
 					AttribInfo.storage = HAPI_STORAGETYPE_FLOAT;
 
-					HAPI_SESSION_FAIL_RETURN(FHoudiniApi::AddAttribute(FHoudiniEngine::Get().GetSession(), NodeId, 0,
+					HAPI_SESSION_FAIL_RETURN(FHoudiniApi::AddAttribute(Session, NodeId, 0,
 						HAPI_ATTRIB_COLOR, &AttribInfo));
 
-					HAPI_SESSION_FAIL_RETURN(FHoudiniApi::SetAttributeFloatData(FHoudiniEngine::Get().GetSession(), NodeId, 0,
-						HAPI_ATTRIB_COLOR, &AttribInfo, ColorData.GetData(), 0, AttribInfo.count));
+					{
+						HOUDINI_PCG_HAPI_CALL_SCOPE(true, AttribInfo.count * AttribInfo.tupleSize * sizeof(float));
+						HAPI_SESSION_FAIL_RETURN(FHoudiniApi::SetAttributeFloatData(Session, NodeId, 0,
+							HAPI_ATTRIB_COLOR, &AttribInfo, ColorData.GetData(), 0, AttribInfo.count));
+					}
 				}
+				if (!AlphaData.IsEmpty())
 				{
 					// f@Alpha
 					AttribInfo.tupleSize = 1;
 					AttribInfo.storage = HAPI_STORAGETYPE_FLOAT;
 
-					HAPI_SESSION_FAIL_RETURN(FHoudiniApi::AddAttribute(FHoudiniEngine::Get().GetSession(), NodeId, 0,
+					HAPI_SESSION_FAIL_RETURN(FHoudiniApi::AddAttribute(Session, NodeId, 0,
 						HAPI_ALPHA, &AttribInfo));
 
-					HAPI_SESSION_FAIL_RETURN(FHoudiniApi::SetAttributeFloatData(FHoudiniEngine::Get().GetSession(), NodeId, 0,
-						HAPI_ALPHA, &AttribInfo, AlphaData.GetData(), 0, AttribInfo.count));
+					{
+						HOUDINI_PCG_HAPI_CALL_SCOPE(true, AttribInfo.count * AttribInfo.tupleSize * sizeof(float));
+						HAPI_SESSION_FAIL_RETURN(FHoudiniApi::SetAttributeFloatData(Session, NodeId, 0,
+							HAPI_ALPHA, &AttribInfo, AlphaData.GetData(), 0, AttribInfo.count));
+					}
 				}
 			}
 
 			TArray<FName> AttribNames;
 			TArray<EPCGMetadataTypes> AttribTypes;
 			PointData->Metadata->GetAttributes(AttribNames, AttribTypes);
+			FilterAttributes(Filter, AttribNames, AttribTypes);
+			FHoudiniPCGCookStats::AddAttributes(true, AttribNames.Num());
 			for (int32 AttribIdx = 0; AttribIdx < AttribNames.Num(); ++AttribIdx)
 			{
+				HOUDINI_PCG_STAGE_SCOPE(InputAttributes, NumPoints);
+
 				const FName& AttribName = AttribNames[AttribIdx];
 				switch (AttribTypes[AttribIdx])
 				{
 				case EPCGMetadataTypes::Float:
 					if (!HapiUploadNumericAttribValue<float, float, 1, HAPI_STORAGETYPE_FLOAT, HAPI_ATTRIBUTE_TYPE_NONE>(
-						PointData->Metadata, AttribName, NodeId, AttribInfo, [](const float& SrcValue, TArray<float>& DstValues) { DstValues.Add(SrcValue); },
+						PointData->Metadata, AttribName, Session, NodeId, AttribInfo, PointIndices, [](const float& SrcValue, TArray<float>& DstValues) { DstValues.Add(SrcValue); },
 						FHoudiniApi::SetAttributeFloatUniqueData, FHoudiniApi::SetAttributeFloatData)) return false;
 					break;
 				case EPCGMetadataTypes::Double:
 					if (!HapiUploadNumericAttribValue<double, double, 1, HAPI_STORAGETYPE_FLOAT64, HAPI_ATTRIBUTE_TYPE_NONE>(
-						PointData->Metadata, AttribName, NodeId, AttribInfo, [](const double& SrcValue, TArray<double>& DstValues) { DstValues.Add(SrcValue); },
+						PointData->Metadata, AttribName, Session, NodeId, AttribInfo, PointIndices, [](const double& SrcValue, TArray<double>& DstValues) { DstValues.Add(SrcValue); },
 						FHoudiniApi::SetAttributeFloat64UniqueData, FHoudiniApi::SetAttributeFloat64Data)) return false;
 					break;
 				case EPCGMetadataTypes::Integer32:
 					if (!HapiUploadNumericAttribValue<int32, int, 1, HAPI_STORAGETYPE_INT, HAPI_ATTRIBUTE_TYPE_NONE>(
-						PointData->Metadata, AttribName, NodeId, AttribInfo, [](const int32& SrcValue, TArray<int>& DstValues) { DstValues.Add(SrcValue); },
+						PointData->Metadata, AttribName, Session, NodeId, AttribInfo, PointIndices, [](const int32& SrcValue, TArray<int>& DstValues) { DstValues.Add(SrcValue); },
 						FHoudiniApi::SetAttributeIntUniqueData, FHoudiniApi::SetAttributeIntData)) return false;
 					break;
 				case EPCGMetadataTypes::Integer64:
 					if (!HapiUploadNumericAttribValue<int64, HAPI_Int64, 1, HAPI_STORAGETYPE_INT64, HAPI_ATTRIBUTE_TYPE_NONE>(
-						PointData->Metadata, AttribName, NodeId, AttribInfo, [](const int64& SrcValue, TArray<HAPI_Int64>& DstValues) { DstValues.Add(SrcValue); },
+						PointData->Metadata, AttribName, Session, NodeId, AttribInfo, PointIndices, [](const int64& SrcValue, TArray<HAPI_Int64>& DstValues) { DstValues.Add(SrcValue); },
 						FHoudiniApi::SetAttributeInt64UniqueData, FHoudiniApi::SetAttributeInt64Data)) return false;
 					break;
 				case EPCGMetadataTypes::Vector2:
 					if (!HapiUploadNumericAttribValue<FVector2d, float, 2, HAPI_STORAGETYPE_FLOAT, HAPI_ATTRIBUTE_TYPE_NONE>(
-						PointData->Metadata, AttribName, NodeId, AttribInfo, [](const FVector2d& SrcValue, TArray<float>& DstValues) { DstValues.Add(SrcValue.X); DstValues.Add(SrcValue.Y); },
+						PointData->Metadata, AttribName, Session, NodeId, AttribInfo, PointIndices, [](const FVector2d& SrcValue, TArray<float>& DstValues) { DstValues.Add(SrcValue.X); DstValues.Add(SrcValue.Y); },
 						FHoudiniApi::SetAttributeFloatUniqueData, FHoudiniApi::SetAttributeFloatData)) return false;
 					break;
 				case EPCGMetadataTypes::Vector:
 					if (!HapiUploadNumericAttribValue<FVector, float, 3, HAPI_STORAGETYPE_FLOAT, HAPI_ATTRIBUTE_TYPE_NONE>(
-						PointData->Metadata, AttribName, NodeId, AttribInfo, [](const FVector& SrcValue, TArray<float>& DstValues) { DstValues.Add(SrcValue.X); DstValues.Add(SrcValue.Y); DstValues.Add(SrcValue.Z); },
+						PointData->Metadata, AttribName, Session, NodeId, AttribInfo, PointIndices, [](const FVector& SrcValue, TArray<float>& DstValues) { DstValues.Add(SrcValue.X); DstValues.Add(SrcValue.Y); DstValues.Add(SrcValue.Z); },
 						FHoudiniApi::SetAttributeFloatUniqueData, FHoudiniApi::SetAttributeFloatData)) return false;
 					break;
 				case EPCGMetadataTypes::Vector4:
 					if (!HapiUploadNumericAttribValue<FVector4, float, 4, HAPI_STORAGETYPE_FLOAT, HAPI_ATTRIBUTE_TYPE_NONE>(
-						PointData->Metadata, AttribName, NodeId, AttribInfo, [](const FVector4& SrcValue, TArray<float>& DstValues) { DstValues.Add(SrcValue.X); DstValues.Add(SrcValue.Y); DstValues.Add(SrcValue.Z); DstValues.Add(SrcValue.W); },
+						PointData->Metadata, AttribName, Session, NodeId, AttribInfo, PointIndices, [](const FVector4& SrcValue, TArray<float>& DstValues) { DstValues.Add(SrcValue.X); DstValues.Add(SrcValue.Y); DstValues.Add(SrcValue.Z); DstValues.Add(SrcValue.W); },
 						FHoudiniApi::SetAttributeFloatUniqueData, FHoudiniApi::SetAttributeFloatData)) return false;
 					break;
 				case EPCGMetadataTypes::Quaternion:
 					if (!HapiUploadNumericAttribValue<FQuat, float, 4, HAPI_STORAGETYPE_FLOAT, HAPI_ATTRIBUTE_TYPE_QUATERNION>(
-						PointData->Metadata, AttribName, NodeId, AttribInfo, [](const FQuat& SrcValue, TArray<float>& DstValues) { DstValues.Add(SrcValue.X); DstValues.Add(SrcValue.Z); DstValues.Add(SrcValue.Y); DstValues.Add(-SrcValue.W); },
+						PointData->Metadata, AttribName, Session, NodeId, AttribInfo, PointIndices, [](const FQuat& SrcValue, TArray<float>& DstValues) { DstValues.Add(SrcValue.X); DstValues.Add(SrcValue.Z); DstValues.Add(SrcValue.Y); DstValues.Add(-SrcValue.W); },
 						FHoudiniApi::SetAttributeFloatUniqueData, FHoudiniApi::SetAttributeFloatData)) return false;
 					break;
 				case EPCGMetadataTypes::Transform:
 					if (!HapiUploadNumericAttribValue<FTransform, float, 16, HAPI_STORAGETYPE_FLOAT, HAPI_ATTRIBUTE_TYPE_MATRIX>(
-						PointData->Metadata, AttribName, NodeId, AttribInfo, [](const FTransform& SrcValue, TArray<float>& DstValues)
+						PointData->Metadata, AttribName, Session, NodeId, AttribInfo, PointIndices, [](const FTransform& SrcValue, TArray<float>& DstValues)
 						{
 							const FMatrix44f UnrealXform = FMatrix44f(SrcValue.ToMatrixWithScale());
 
@@ -665,50 +986,54 @@ bool FHoudiniPCGComponentInput::HapiRetrieveData(UHoudiniInput* Input, const UOb
 						FHoudiniApi::SetAttributeFloatUniqueData, FHoudiniApi::SetAttributeFloatData)) return false;
 					break;
 				case EPCGMetadataTypes::String:
-					HOUDINI_FAIL_RETURN(HapiUploadStringAttribValue<FString>(PointData->Metadata, AttribName, NodeId, AttribInfo,
+					HOUDINI_FAIL_RETURN(HapiUploadStringAttribValue<FString>(PointData->Metadata, AttribName, Session, NodeId, AttribInfo, PointIndices,
 						[](const FString& Value) { return Value; }));
 					break;
 				case EPCGMetadataTypes::Boolean:
 					if (!HapiUploadNumericAttribValue<bool, uint8, 1, HAPI_STORAGETYPE_UINT8, HAPI_ATTRIBUTE_TYPE_NONE>(
-						PointData->Metadata, AttribName, NodeId, AttribInfo, [](const bool& SrcValue, TArray<uint8>& DstValues) { DstValues.Add(uint8(SrcValue)); },
+						PointData->Metadata, AttribName, Session, NodeId, AttribInfo, PointIndices, [](const bool& SrcValue, TArray<uint8>& DstValues) { DstValues.Add(uint8(SrcValue)); },
 						FHoudiniApi::SetAttributeUInt8UniqueData, FHoudiniApi::SetAttributeUInt8Data)) return false;
 					break;
 				case EPCGMetadataTypes::Rotator:
 					if (!HapiUploadNumericAttribValue<FRotator, float, 3, HAPI_STORAGETYPE_FLOAT, HAPI_ATTRIBUTE_TYPE_NONE>(
-						PointData->Metadata, AttribName, NodeId, AttribInfo, [](const FRotator& SrcValue, TArray<float>& DstValues) { DstValues.Add(SrcValue.Roll); DstValues.Add(SrcValue.Yaw); DstValues.Add(SrcValue.Pitch); },
+						PointData->Metadata, AttribName, Session, NodeId, AttribInfo, PointIndices, [](const FRotator& SrcValue, TArray<float>& DstValues) { DstValues.Add(SrcValue.Roll); DstValues.Add(SrcValue.Yaw); DstValues.Add(SrcValue.Pitch); },
 						FHoudiniApi::SetAttributeFloatUniqueData, FHoudiniApi::SetAttributeFloatData)) return false;
 					break;
 				case EPCGMetadataTypes::Name:
-					HOUDINI_FAIL_RETURN(HapiUploadStringAttribValue<FName>(PointData->Metadata, AttribName, NodeId, AttribInfo,
+					HOUDINI_FAIL_RETURN(HapiUploadStringAttribValue<FName>(PointData->Metadata, AttribName, Session, NodeId, AttribInfo, PointIndices,
 						[](const FName& Value) { return Value.ToString(); }));
 					break;
 				case EPCGMetadataTypes::SoftObjectPath:
-					HOUDINI_FAIL_RETURN(HapiUploadStringAttribValue<FSoftObjectPath>(PointData->Metadata, AttribName, NodeId, AttribInfo,
+					HOUDINI_FAIL_RETURN(HapiUploadStringAttribValue<FSoftObjectPath>(PointData->Metadata, AttribName, Session, NodeId, AttribInfo, PointIndices,
 						[](const FSoftObjectPath& Value) { return Value.ToString(); }));
 					break;
 				case EPCGMetadataTypes::SoftClassPath:
-					HOUDINI_FAIL_RETURN(HapiUploadStringAttribValue<FSoftClassPath>(PointData->Metadata, AttribName, NodeId, AttribInfo,
+					HOUDINI_FAIL_RETURN(HapiUploadStringAttribValue<FSoftClassPath>(PointData->Metadata, AttribName, Session, NodeId, AttribInfo, PointIndices,
 						[](const FSoftClassPath& Value) { return Value.ToString(); }));
 					break;
 				}
 			}
 
-			if (!InputObject->IsA<AActor>())  // s@unreal_object_path
+			if (bUploadObjectPath)  // s@unreal_object_path
 			{
 				AttribInfo.tupleSize = 1;
 				AttribInfo.storage = HAPI_STORAGETYPE_STRING;
 
-				HAPI_SESSION_FAIL_RETURN(FHoudiniApi::AddAttribute(FHoudiniEngine::Get().GetSession(), NodeId, 0,
+				HAPI_SESSION_FAIL_RETURN(FHoudiniApi::AddAttribute(Session, NodeId, 0,
 					HAPI_ATTRIB_UNREAL_OBJECT_PATH, &AttribInfo));
 
-				HAPI_SESSION_FAIL_RETURN(FHoudiniApi::SetAttributeStringUniqueData(FHoudiniEngine::Get().GetSession(), NodeId, 0,
+				HAPI_SESSION_FAIL_RETURN(FHoudiniApi::SetAttributeStringUniqueData(Session, NodeId, 0,
 					HAPI_ATTRIB_UNREAL_OBJECT_PATH, &AttribInfo, TCHAR_TO_UTF8(*FHoudiniEngineUtils::GetAssetReference(InputObject)), 1, 0, AttribInfo.count));
 			}
 
-			HAPI_SESSION_FAIL_RETURN(FHoudiniApi::CommitGeo(FHoudiniEngine::Get().GetSession(), NodeId));
+			{
+				HOUDINI_PCG_STAGE_SCOPE(InputCommit, 1);
+				HOUDINI_PCG_HAPI_CALL_SCOPE(true, 0);
+				HAPI_SESSION_FAIL_RETURN(FHoudiniApi::CommitGeo(Session, NodeId));
+			}
 			if (bCreateNewNode)
 			{
-				HOUDINI_FAIL_RETURN(Input->HapiConnectToMergeNode(NodeId));
+				HOUDINI_FAIL_RETURN(ConnectFunc(NodeId));
 				InOutNodeIds.Add(NodeId);
 			}
 
@@ -724,14 +1049,16 @@ bool FHoudiniPCGComponentInput::HapiRetrieveData(UHoudiniInput* Input, const UOb
 			if (Points.IsEmpty())
 				continue;
 
+			HOUDINI_PCG_STAGE_SCOPE(InputSplines, Points.Num());
+
 			int32 NodeId = InOutNodeIds.IsValidIndex(InOutDataIdx) ? InOutNodeIds[InOutDataIdx] : -1;
 			const bool bCreateNewNode = (NodeId < 0);
 			if (bCreateNewNode)
-				HAPI_SESSION_FAIL_RETURN(FHoudiniApi::CreateNode(FHoudiniEngine::Get().GetSession(), Input->GetGeoNodeId(), "null",
-					TCHAR_TO_UTF8(*FString::Printf(TEXT("%s_%s_%08X"), *InputObject->GetName(), *TaggedData.Data->GetName(), FPlatformTime::Cycles())),
+				HAPI_SESSION_FAIL_RETURN(FHoudiniApi::CreateNode(Session, ParentNodeId, "null",
+					TCHAR_TO_UTF8(*FString::Printf(TEXT("%s_%s_%08X"), *InputName, *TaggedData.Data->GetName(), FPlatformTime::Cycles())),
 					false, &NodeId))
 			//else
-			//	HAPI_SESSION_FAIL_RETURN(FHoudiniApi::RevertGeo(FHoudiniEngine::Get().GetSession(), NodeId));  // Why this can NOT revert geo after next commit?
+			//	HAPI_SESSION_FAIL_RETURN(FHoudiniApi::RevertGeo(Session, NodeId));  // Why this can NOT revert geo after next commit?
 
 			const FTransform& Transform = SplineData->SplineStruct.Transform;
 #if ((ENGINE_MAJOR_VERSION == 5) && (ENGINE_MINOR_VERSION >= 6)) || (ENGINE_MAJOR_VERSION > 5)
@@ -741,37 +1068,17 @@ bool FHoudiniPCGComponentInput::HapiRetrieveData(UHoudiniInput* Input, const UOb
 			const TArray<FInterpCurvePointQuat>& Rots = SplineData->SplineStruct.SplineCurves.Rotation.Points;
 			const TArray<FInterpCurvePointVector>& Scales = SplineData->SplineStruct.SplineCurves.Scale.Points;
 #endif
-			const bool bImportRotAndScale = (Input->GetSettings().bImportRotAndScale && !Rots.IsEmpty() && !Scales.IsEmpty());
-			TArray<float> PosData; PosData.Reserve(Points.Num() * 3);
-			TArray<float> ArriveTangentData; ArriveTangentData.Reserve(Points.Num() * 3);
-			TArray<float> LeaveTangentData; LeaveTangentData.Reserve(Points.Num() * 3);
-			TArray<float> RotData; if (bImportRotAndScale) RotData.Reserve(Points.Num() * 4);
-			TArray<float> ScaleData; if (bImportRotAndScale) ScaleData.Reserve(Points.Num() * 3);
-			for (int32 PointIdx = 0; PointIdx < Points.Num(); ++PointIdx)
-			{
-				const FInterpCurvePointVector& Point = Points[PointIdx];
-				{
-					const FVector3f Pos = FVector3f(Transform.TransformPosition(Point.OutVal) * POSITION_SCALE_TO_HOUDINI);
-					PosData.Add(Pos.X);
-					PosData.Add(Pos.Z);
-					PosData.Add(Pos.Y);
-				}
-				{
-					const FVector3f Tangent = FVector3f(Transform.TransformVector(Point.ArriveTangent));
-					ArriveTangentData.Add(Tangent.X); ArriveTangentData.Add(Tangent.Z); ArriveTangentData.Add(Tangent.Y);
-				}
-				{
-					const FVector3f Tangent = FVector3f(Transform.TransformVector(Point.LeaveTangent));
-					LeaveTangentData.Add(Tangent.X); LeaveTangentData.Add(Tangent.Z); LeaveTangentData.Add(Tangent.Y);
-				}
-				if (bImportRotAndScale)
-				{
-					const FQuat4f Rot = Rots.IsValidIndex(PointIdx) ? FQuat4f(Transform.TransformRotation(Rots[PointIdx].OutVal)) : FQuat4f::Identity;
-					const FVector3f Scale = Scales.IsValidIndex(PointIdx) ? FVector3f(Transform.GetScale3D() * Scales[PointIdx].OutVal) : FVector3f::OneVector;
-					RotData.Add(Rot.X); RotData.Add(Rot.Z); RotData.Add(Rot.Y); RotData.Add(-Rot.W);
-					ScaleData.Add(Scale.X); ScaleData.Add(Scale.Z); ScaleData.Add(Scale.Y);
-				}
-			}
+			const bool bImportRotAndScale = (bInImportRotAndScale && !Rots.IsEmpty() && !Scales.IsEmpty());
+			TArray<float> PosData;
+			TArray<float> ArriveTangentData;
+			TArray<float> LeaveTangentData;
+			TArray<float> RotData;
+			TArray<float> ScaleData;
+			FHoudiniPCGUtils::ConvertSplineToHoudini(Transform, Points, bImportRotAndScale ? TConstArrayView<FInterpCurvePointQuat>(Rots) : TConstArrayView<FInterpCurvePointQuat>(),
+				bImportRotAndScale ? TConstArrayView<FInterpCurvePointVector>(Scales) : TConstArrayView<FInterpCurvePointVector>(),
+				PosData, ArriveTangentData, LeaveTangentData, RotData, ScaleData);
+			const FHoudiniPCGTransientBytesScope TransientBytesScope(true, PosData.GetAllocatedSize() + ArriveTangentData.GetAllocatedSize() +
+				LeaveTangentData.GetAllocatedSize() + RotData.GetAllocatedSize() + ScaleData.GetAllocatedSize());
 
 			HAPI_PartInfo PartInfo;
 			FHoudiniApi::PartInfo_Init(&PartInfo);
@@ -780,7 +1087,7 @@ bool FHoudiniPCGComponentInput::HapiRetrieveData(UHoudiniInput* Input, const UOb
 			PartInfo.vertexCount = Points.Num();
 			PartInfo.pointCount = Points.Num();
 
-			HAPI_SESSION_FAIL_RETURN(FHoudiniApi::SetPartInfo(FHoudiniEngine::Get().GetSession(), NodeId, 0, &PartInfo));
+			HAPI_SESSION_FAIL_RETURN(FHoudiniApi::SetPartInfo(Session, NodeId, 0, &PartInfo));
 			AttribInfo.count = PartInfo.pointCount;
 			AttribInfo.owner = HAPI_ATTROWNER_POINT;
 			{
@@ -788,11 +1095,14 @@ bool FHoudiniPCGComponentInput::HapiRetrieveData(UHoudiniInput* Input, const UOb
 				AttribInfo.tupleSize = 3;
 				AttribInfo.storage = HAPI_STORAGETYPE_FLOAT;
 
-				HAPI_SESSION_FAIL_RETURN(FHoudiniApi::AddAttribute(FHoudiniEngine::Get().GetSession(), NodeId, 0,
+				HAPI_SESSION_FAIL_RETURN(FHoudiniApi::AddAttribute(Session, NodeId, 0,
 					HAPI_ATTRIB_POSITION, &AttribInfo));
 
-				HAPI_SESSION_FAIL_RETURN(FHoudiniApi::SetAttributeFloatData(FHoudiniEngine::Get().GetSession(), NodeId, 0,
-					HAPI_ATTRIB_POSITION, &AttribInfo, PosData.GetData(), 0, AttribInfo.count));
+				{
+					HOUDINI_PCG_HAPI_CALL_SCOPE(true, AttribInfo.count * AttribInfo.tupleSize * sizeof(float));
+					HAPI_SESSION_FAIL_RETURN(FHoudiniApi::SetAttributeFloatData(Session, NodeId, 0,
+						HAPI_ATTRIB_POSITION, &AttribInfo, PosData.GetData(), 0, AttribInfo.count));
+				}
 			}
 
 			{
@@ -801,10 +1111,10 @@ bool FHoudiniPCGComponentInput::HapiRetrieveData(UHoudiniInput* Input, const UOb
 				CurveInfo.curveType = HAPI_CURVETYPE_LINEAR;
 				CurveInfo.curveCount = PartInfo.faceCount;
 				CurveInfo.vertexCount = PartInfo.vertexCount;
-				HAPI_SESSION_FAIL_RETURN(FHoudiniApi::SetCurveInfo(FHoudiniEngine::Get().GetSession(), NodeId, 0, &CurveInfo));
+				HAPI_SESSION_FAIL_RETURN(FHoudiniApi::SetCurveInfo(Session, NodeId, 0, &CurveInfo));
 
 				HAPI_SESSION_FAIL_RETURN(FHoudiniApi::SetCurveCounts(
-					FHoudiniEngine::Get().GetSession(), NodeId, 0, &PartInfo.pointCount, 0, PartInfo.faceCount));
+					Session, NodeId, 0, &PartInfo.pointCount, 0, PartInfo.faceCount));
 			}
 
 			{
@@ -812,11 +1122,14 @@ bool FHoudiniPCGComponentInput::HapiRetrieveData(UHoudiniInput* Input, const UOb
 				AttribInfo.tupleSize = 3;
 				AttribInfo.storage = HAPI_STORAGETYPE_FLOAT;
 
-				HAPI_SESSION_FAIL_RETURN(FHoudiniApi::AddAttribute(FHoudiniEngine::Get().GetSession(), NodeId, 0,
+				HAPI_SESSION_FAIL_RETURN(FHoudiniApi::AddAttribute(Session, NodeId, 0,
 					HAPI_ATTRIB_UNREAL_SPLINE_POINT_ARRIVE_TANGENT, &AttribInfo));
 
-				HAPI_SESSION_FAIL_RETURN(FHoudiniApi::SetAttributeFloatData(FHoudiniEngine::Get().GetSession(), NodeId, 0,
-					HAPI_ATTRIB_UNREAL_SPLINE_POINT_ARRIVE_TANGENT, &AttribInfo, ArriveTangentData.GetData(), 0, AttribInfo.count));
+				{
+					HOUDINI_PCG_HAPI_CALL_SCOPE(true, AttribInfo.count * AttribInfo.tupleSize * sizeof(float));
+					HAPI_SESSION_FAIL_RETURN(FHoudiniApi::SetAttributeFloatData(Session, NodeId, 0,
+						HAPI_ATTRIB_UNREAL_SPLINE_POINT_ARRIVE_TANGENT, &AttribInfo, ArriveTangentData.GetData(), 0, AttribInfo.count));
+				}
 			}
 
 			{
@@ -824,11 +1137,14 @@ bool FHoudiniPCGComponentInput::HapiRetrieveData(UHoudiniInput* Input, const UOb
 				AttribInfo.tupleSize = 3;
 				AttribInfo.storage = HAPI_STORAGETYPE_FLOAT;
 
-				HAPI_SESSION_FAIL_RETURN(FHoudiniApi::AddAttribute(FHoudiniEngine::Get().GetSession(), NodeId, 0,
+				HAPI_SESSION_FAIL_RETURN(FHoudiniApi::AddAttribute(Session, NodeId, 0,
 					HAPI_ATTRIB_UNREAL_SPLINE_POINT_LEAVE_TANGENT, &AttribInfo));
 
-				HAPI_SESSION_FAIL_RETURN(FHoudiniApi::SetAttributeFloatData(FHoudiniEngine::Get().GetSession(), NodeId, 0,
-					HAPI_ATTRIB_UNREAL_SPLINE_POINT_LEAVE_TANGENT, &AttribInfo, LeaveTangentData.GetData(), 0, AttribInfo.count));
+				{
+					HOUDINI_PCG_HAPI_CALL_SCOPE(true, AttribInfo.count * AttribInfo.tupleSize * sizeof(float));
+					HAPI_SESSION_FAIL_RETURN(FHoudiniApi::SetAttributeFloatData(Session, NodeId, 0,
+						HAPI_ATTRIB_UNREAL_SPLINE_POINT_LEAVE_TANGENT, &AttribInfo, LeaveTangentData.GetData(), 0, AttribInfo.count));
+				}
 			}
 
 			if (bImportRotAndScale)
@@ -837,21 +1153,27 @@ bool FHoudiniPCGComponentInput::HapiRetrieveData(UHoudiniInput* Input, const UOb
 				AttribInfo.tupleSize = 4;
 				AttribInfo.storage = HAPI_STORAGETYPE_FLOAT;
 
-				HAPI_SESSION_FAIL_RETURN(FHoudiniApi::AddAttribute(FHoudiniEngine::Get().GetSession(), NodeId, 0,
+				HAPI_SESSION_FAIL_RETURN(FHoudiniApi::AddAttribute(Session, NodeId, 0,
 					HAPI_ATTRIB_ROT, &AttribInfo));
 
-				HAPI_SESSION_FAIL_RETURN(FHoudiniApi::SetAttributeFloatData(FHoudiniEngine::Get().GetSession(), NodeId, 0,
-					HAPI_ATTRIB_ROT, &AttribInfo, RotData.GetData(), 0, AttribInfo.count));
+				{
+					HOUDINI_PCG_HAPI_CALL_SCOPE(true, AttribInfo.count * AttribInfo.tupleSize * sizeof(float));
+					HAPI_SESSION_FAIL_RETURN(FHoudiniApi::SetAttributeFloatData(Session, NodeId, 0,
+						HAPI_ATTRIB_ROT, &AttribInfo, RotData.GetData(), 0, AttribInfo.count));
+				}
 
 				// v@scale
 				AttribInfo.tupleSize = 3;
 				AttribInfo.storage = HAPI_STORAGETYPE_FLOAT;
 
-				HAPI_SESSION_FAIL_RETURN(FHoudiniApi::AddAttribute(FHoudiniEngine::Get().GetSession(), NodeId, 0,
+				HAPI_SESSION_FAIL_RETURN(FHoudiniApi::AddAttribute(Session, NodeId, 0,
 					HAPI_ATTRIB_SCALE, &AttribInfo));
 
-				HAPI_SESSION_FAIL_RETURN(FHoudiniApi::SetAttributeFloatData(FHoudiniEngine::Get().GetSession(), NodeId, 0,
-					HAPI_ATTRIB_SCALE, &AttribInfo, ScaleData.GetData(), 0, AttribInfo.count));
+				{
+					HOUDINI_PCG_HAPI_CALL_SCOPE(true, AttribInfo.count * AttribInfo.tupleSize * sizeof(float));
+					HAPI_SESSION_FAIL_RETURN(FHoudiniApi::SetAttributeFloatData(Session, NodeId, 0,
+						HAPI_ATTRIB_SCALE, &AttribInfo, ScaleData.GetData(), 0, AttribInfo.count));
+				}
 			}
 
 			{
@@ -860,7 +1182,7 @@ bool FHoudiniPCGComponentInput::HapiRetrieveData(UHoudiniInput* Input, const UOb
 				AttribInfo.owner = HAPI_ATTROWNER_PRIM;
 				AttribInfo.count = PartInfo.faceCount;
 				AttribInfo.totalArrayElements = TaggedData.Tags.Num();
-				HAPI_SESSION_FAIL_RETURN(FHoudiniApi::AddAttribute(FHoudiniEngine::Get().GetSession(), NodeId, 0,
+				HAPI_SESSION_FAIL_RETURN(FHoudiniApi::AddAttribute(Session, NodeId, 0,
 					HAPI_ATTRIB_UNREAL_PCG_TAGS, &AttribInfo));
 
 				static const char* SpareStr = "";
@@ -872,30 +1194,34 @@ bool FHoudiniPCGComponentInput::HapiRetrieveData(UHoudiniInput* Input, const UOb
 					Tags.Add(TagStr.c_str());
 
 				const int NumTags = Tags.Num();
-				HAPI_SESSION_FAIL_RETURN(FHoudiniApi::SetAttributeStringArrayData(FHoudiniEngine::Get().GetSession(), NodeId, 0,
+				HAPI_SESSION_FAIL_RETURN(FHoudiniApi::SetAttributeStringArrayData(Session, NodeId, 0,
 					HAPI_ATTRIB_UNREAL_PCG_TAGS, &AttribInfo, Tags.IsEmpty() ? &SpareStr : Tags.GetData(), NumTags, &NumTags, 0, 1));
 
 				AttribInfo.totalArrayElements = 0;
 			}
 
-			if (!InputObject->IsA<AActor>())  // s@unreal_object_path
+			if (bUploadObjectPath)  // s@unreal_object_path
 			{
 				AttribInfo.tupleSize = 1;
 				AttribInfo.storage = HAPI_STORAGETYPE_STRING;
 				AttribInfo.owner = HAPI_ATTROWNER_PRIM;
 				AttribInfo.count = PartInfo.faceCount;
 
-				HAPI_SESSION_FAIL_RETURN(FHoudiniApi::AddAttribute(FHoudiniEngine::Get().GetSession(), NodeId, 0,
+				HAPI_SESSION_FAIL_RETURN(FHoudiniApi::AddAttribute(Session, NodeId, 0,
 					HAPI_ATTRIB_UNREAL_OBJECT_PATH, &AttribInfo));
 
-				HAPI_SESSION_FAIL_RETURN(FHoudiniApi::SetAttributeStringUniqueData(FHoudiniEngine::Get().GetSession(), NodeId, 0,
+				HAPI_SESSION_FAIL_RETURN(FHoudiniApi::SetAttributeStringUniqueData(Session, NodeId, 0,
 					HAPI_ATTRIB_UNREAL_OBJECT_PATH, &AttribInfo, TCHAR_TO_UTF8(*FHoudiniEngineUtils::GetAssetReference(InputObject)), 1, 0, AttribInfo.count));
 			}
 
-			HAPI_SESSION_FAIL_RETURN(FHoudiniApi::CommitGeo(FHoudiniEngine::Get().GetSession(), NodeId));
+			{
+				HOUDINI_PCG_STAGE_SCOPE(InputCommit, 1);
+				HOUDINI_PCG_HAPI_CALL_SCOPE(true, 0);
+				HAPI_SESSION_FAIL_RETURN(FHoudiniApi::CommitGeo(Session, NodeId));
+			}
 			if (bCreateNewNode)
 			{
-				HOUDINI_FAIL_RETURN(Input->HapiConnectToMergeNode(NodeId));
+				HOUDINI_FAIL_RETURN(ConnectFunc(NodeId));
 				InOutNodeIds.Add(NodeId);
 			}
 
@@ -911,14 +1237,16 @@ bool FHoudiniPCGComponentInput::HapiRetrieveData(UHoudiniInput* Input, const UOb
 			if (!DM)
 				continue;
 
+			HOUDINI_PCG_STAGE_SCOPE(InputMeshes, DM->VertexCount());
+
 			int32 NodeId = InOutNodeIds.IsValidIndex(InOutDataIdx) ? InOutNodeIds[InOutDataIdx] : -1;
 			const bool bCreateNewNode = (NodeId < 0);
 			if (bCreateNewNode)
-				HAPI_SESSION_FAIL_RETURN(FHoudiniApi::CreateNode(FHoudiniEngine::Get().GetSession(), Input->GetGeoNodeId(), "null",
-					TCHAR_TO_UTF8(*FString::Printf(TEXT("%s_%s_%08X"), *InputObject->GetName(), *TaggedData.Data->GetName(), FPlatformTime::Cycles())),
+				HAPI_SESSION_FAIL_RETURN(FHoudiniApi::CreateNode(Session, ParentNodeId, "null",
+					TCHAR_TO_UTF8(*FString::Printf(TEXT("%s_%s_%08X"), *InputName, *TaggedData.Data->GetName(), FPlatformTime::Cycles())),
 					false, &NodeId))
 			//else
-			//	HAPI_SESSION_FAIL_RETURN(FHoudiniApi::RevertGeo(FHoudiniEngine::Get().GetSession(), NodeId));  // Why this can NOT revert geo after next commit?
+			//	HAPI_SESSION_FAIL_RETURN(FHoudiniApi::RevertGeo(Session, NodeId));  // Why this can NOT revert geo after next commit?
 
 			HAPI_PartInfo PartInfo;
 			FHoudiniApi::PartInfo_Init(&PartInfo);
@@ -927,57 +1255,57 @@ bool FHoudiniPCGComponentInput::HapiRetrieveData(UHoudiniInput* Input, const UOb
 			PartInfo.vertexCount = PartInfo.faceCount * 3;
 			PartInfo.pointCount = DM->VertexCount();
 
-			HAPI_SESSION_FAIL_RETURN(FHoudiniApi::SetPartInfo(FHoudiniEngine::Get().GetSession(), NodeId, 0, &PartInfo));
+			HAPI_SESSION_FAIL_RETURN(FHoudiniApi::SetPartInfo(Session, NodeId, 0, &PartInfo));
 
-			{  // @P
-				TArray<float> PosData;
-				for (int PointId = 0; PointId < PartInfo.pointCount; ++PointId)
-				{
-					const FVector3f Position = FVector3f(DM->GetVertexRef(PointId) * POSITION_SCALE_TO_HOUDINI);
-					PosData.Add(Position.X);
-					PosData.Add(Position.Z);
-					PosData.Add(Position.Y);
-				}
+			TArray<float> PosData;
+			TArray<int32> Vertices;
+			FHoudiniPCGUtils::ConvertDynamicMeshToHoudini(*DM, PosData, Vertices);
+			const FHoudiniPCGTransientBytesScope TransientBytesScope(true, PosData.GetAllocatedSize() + Vertices.GetAllocatedSize());
 
+			{  // @P
 				AttribInfo.count = PartInfo.pointCount;
 				AttribInfo.owner = HAPI_ATTROWNER_POINT;
 				AttribInfo.tupleSize = 3;
 				AttribInfo.storage = HAPI_STORAGETYPE_FLOAT;
 
-				HAPI_SESSION_FAIL_RETURN(FHoudiniApi::AddAttribute(FHoudiniEngine::Get().GetSession(), NodeId, 0,
+				HAPI_SESSION_FAIL_RETURN(FHoudiniApi::AddAttribute(Session, NodeId, 0,
 					HAPI_ATTRIB_POSITION, &AttribInfo));
 
-				HAPI_SESSION_FAIL_RETURN(FHoudiniApi::SetAttributeFloatData(FHoudiniEngine::Get().GetSession(), NodeId, 0,
-					HAPI_ATTRIB_POSITION, &AttribInfo, PosData.GetData(), 0, AttribInfo.count));
+				{
+					HOUDINI_PCG_HAPI_CALL_SCOPE(true, AttribInfo.count * AttribInfo.tupleSize * sizeof(float));
+					HAPI_SESSION_FAIL_RETURN(FHoudiniApi::SetAttributeFloatData(Session, NodeId, 0,
+						HAPI_ATTRIB_POSITION, &AttribInfo, PosData.GetData(), 0, AttribInfo.count));
+				}
 			}
 
 			if (PartInfo.faceCount >= 1)  // Sometimes maybe dynamic mesh only has points
 			{
-				TArray<int32> FaceCounts; FaceCounts.SetNumUninitialized(PartInfo.faceCount);
-				TArray<int32> Vertices; Vertices.SetNumUninitialized(PartInfo.vertexCount);
+				TArray<int32> FaceCounts; FaceCounts.Init(3, PartInfo.faceCount);
+				const FHoudiniPCGTransientBytesScope FaceCountsBytesScope(true, FaceCounts.GetAllocatedSize());
 
-				for (int TriId = 0; TriId < PartInfo.faceCount; ++TriId)
 				{
-					const UE::Geometry::FIndex3i Triangle = DM->GetTriangle(TriId);
-					Vertices[TriId * 3] = Triangle.C;
-					Vertices[TriId * 3 + 1] = Triangle.B;
-					Vertices[TriId * 3 + 2] = Triangle.A;
-					FaceCounts[TriId] = 3;
+					HOUDINI_PCG_HAPI_CALL_SCOPE(true, Vertices.Num() * sizeof(int32));
+					HAPI_SESSION_FAIL_RETURN(FHoudiniApi::SetVertexList(Session, NodeId, 0,
+						Vertices.GetData(), 0, Vertices.Num()));
 				}
 
-				HAPI_SESSION_FAIL_RETURN(FHoudiniApi::SetVertexList(FHoudiniEngine::Get().GetSession(), NodeId, 0,
-					Vertices.GetData(), 0, Vertices.Num()));
-
-				HAPI_SESSION_FAIL_RETURN(FHoudiniApi::SetFaceCounts(FHoudiniEngine::Get().GetSession(), NodeId, 0,
-					FaceCounts.GetData(), 0, FaceCounts.Num()));
+				{
+					HOUDINI_PCG_HAPI_CALL_SCOPE(true, FaceCounts.Num() * sizeof(int32));
+					HAPI_SESSION_FAIL_RETURN(FHoudiniApi::SetFaceCounts(Session, NodeId, 0,
+						FaceCounts.GetData(), 0, FaceCounts.Num()));
+				}
 			}
 
 			// TODO: Retrieve all attributes v@N, v@uv, s@unreal_material, etc.
 
-			HAPI_SESSION_FAIL_RETURN(FHoudiniApi::CommitGeo(FHoudiniEngine::Get().GetSession(), NodeId));
+			{
+				HOUDINI_PCG_STAGE_SCOPE(InputCommit, 1);
+				HOUDINI_PCG_HAPI_CALL_SCOPE(true, 0);
+				HAPI_SESSION_FAIL_RETURN(FHoudiniApi::CommitGeo(Session, NodeId));
+			}
 			if (bCreateNewNode)
 			{
-				HOUDINI_FAIL_RETURN(Input->HapiConnectToMergeNode(NodeId));
+				HOUDINI_FAIL_RETURN(ConnectFunc(NodeId));
 				InOutNodeIds.Add(NodeId);
 			}
 
@@ -1004,13 +1332,31 @@ bool FHoudiniPCGComponentInputBuilder::HapiUpload(UHoudiniInput* Input, const bo
 
 	TArray<int32>& NodeIds = CompInput->NodeIds;
 
+	CompInput->OwnerInput = Input;
+	CompInput->Components.Empty();
+	CompInput->bDecimated = FHoudiniPCGComponentInput::ShouldDecimatePreview();
+	FHoudiniPCGComponentInput::RecordUpload(CompInput);
+
 	int32 NumDatas = 0;
 	for (const int32& CompIdx : ComponentIndices)
 	{
 		if (const UPCGComponent* PCGComp = Cast<UPCGComponent>(Components[CompIdx]))
 		{
+			CompInput->Components.Add(PCGComp);
+
+			FHoudiniPCGAttributeFilter AttribFilter;
+			for (const FName& Tag : PCGComp->ComponentTags)  // "HoudiniPCGAttributes:<Pattern>"
+			{
+				const FString TagStr = Tag.ToString();
+				if (TagStr.StartsWith(TEXT("HoudiniPCGAttributes:")))
+				{
+					AttribFilter = FHoudiniPCGAttributeFilter(TagStr.RightChop(21));
+					break;
+				}
+			}
+
 			HOUDINI_FAIL_RETURN(FHoudiniPCGComponentInput::HapiRetrieveData(Input,
-				PCGComp->GetOuter(), PCGComp->GetGeneratedGraphOutput(), NodeIds, NumDatas));
+				PCGComp->GetOuter(), PCGComp->GetGeneratedGraphOutput(), NodeIds, NumDatas, AttribFilter));
 		}
 	}
 
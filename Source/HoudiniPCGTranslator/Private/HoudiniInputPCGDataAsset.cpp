@@ -8,6 +8,8 @@
 #include "HoudiniEngineUtils.h"
 
 #include "HoudiniInputPCGComponent.h"
+#include "HoudiniOutputPCGDataAsset.h"
+#include "HoudiniPCGTranslator.h"
 
 #include "PCGDataAsset.h"
 
@@ -47,8 +49,14 @@ bool UHoudiniInputPCGDataAsset::HapiUpload()
 	if (!IsValid(PCGDA))
 		return HapiDestroy();
 
-	int32 NumDatas = 0;
-	HOUDINI_FAIL_RETURN(FHoudiniPCGComponentInput::HapiRetrieveData(GetInput(), PCGDA, PCGDA->Data, NodeIds, NumDatas));
+	// Upload the preview output if any, but keep s@unreal_object_path of the asset
+	const UPCGDataAsset* PreviewPCGDA = FHoudiniPCGTranslator::Get().GetOutputBuilder()->FindPreview(PCGDataAsset.ToSoftObjectPath());
+
+	bDecimated = FHoudiniPCGComponentInput::ShouldDecimatePreview();
+	FHoudiniPCGComponentInput::RecordUpload(this);
+
+	int32 NumDatas = 0;  // Attributes are always filtered by "HoudiniPCG.InputAttributeFilter", as the input panel of HoudiniEngine could NOT show a pattern per holder
+	HOUDINI_FAIL_RETURN(FHoudiniPCGComponentInput::HapiRetrieveData(GetInput(), PCGDA, PreviewPCGDA ? PreviewPCGDA->Data : PCGDA->Data, NodeIds, NumDatas));
 
 	for (int32 NodeIdx = NodeIds.Num() - 1; NodeIdx >= NumDatas; --NodeIdx)
 	{
@@ -78,6 +86,7 @@ bool UHoudiniInputPCGDataAsset::HapiDestroy()
 	}
 
 	Invalidate();
+	bDecimated = false;
 
 	return true;
 }
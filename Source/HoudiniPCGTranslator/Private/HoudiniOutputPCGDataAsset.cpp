@@ -7,10 +7,23 @@
 #include "HoudiniAttribute.h"
 #include "HoudiniEngineUtils.h"
 #include "HoudiniOutputUtils.h"
-
-#include "StaticMeshCompiler.h"
-
+#include "HoudiniNode.h"
+
+#include "Engine/StaticMesh.h"
+#include "Algo/BinarySearch.h"
+#include "Algo/Unique.h"
+#include "Hash/CityHash.h"
+#include "Async/ParallelFor.h"
+#include "Misc/PackageName.h"
+#include "HAL/IConsoleManager.h"
+#include "Tasks/Task.h"
+#include "Misc/ScopeExit.h"
+
+#include "HoudiniInputPCGComponent.h"
 #include "HoudiniPCGCommon.h"
+#include "HoudiniPCGUtils.h"
+#include "HoudiniPCGCompactDataAsset.h"
+#include "HoudiniPCGTranslator.h"
 
 #include "PCGDataAsset.h"
 #if ((ENGINE_MAJOR_VERSION == 5) && (ENGINE_MINOR_VERSION >= 6)) || (ENGINE_MAJOR_VERSION > 5)
@@ -22,34 +35,323 @@
 #if ((ENGINE_MAJOR_VERSION == 5) && (ENGINE_MINOR_VERSION >= 5)) || (ENGINE_MAJOR_VERSION > 5)
 #include "Data/PCGDynamicMeshData.h"
 #include "UDynamicMesh.h"
+#include "DynamicMesh/DynamicMeshAttributeSet.h"
+#include "Materials/MaterialInterface.h"
 #endif
 
 
+DEFINE_LOG_CATEGORY_STATIC(LogHoudiniPCGOutput, Log, All);
+
+struct FHoudiniAttribNameKeyFuncs : TDefaultMapKeyFuncs<std::string, int32, false>
+{
+	static FORCEINLINE uint32 GetKeyHash(const std::string& Key) { return CityHash32(Key.data(), Key.size()); }
+};
+
+class FHoudiniPCGPartSchema  // Attribute names, owners and infos of a part, retrieved once and shared by HapiIsPartValid and HapiRetrieve
+{
+protected:
+	const HAPI_Session Session;  // Copied, so that prefetch workers never read the session of the builder or HoudiniEngine
+	int32 NodeId = -1;
+	int32 PartId = -1;
+
+	struct FAttribEntry
+	{
+		uint8 OwnerMask = 0;
+		uint8 InfoMask = 0;  // Whether Infos[Owner] has been retrieved
+		HAPI_AttributeInfo Infos[HAPI_ATTROWNER_MAX];
+	};
+	TArray<FAttribEntry> Entries;
+	TMap<std::string, int32, FDefaultSetAllocator, FHoudiniAttribNameKeyFuncs> NameEntryMap;  // AttribName -> index of Entries
+
+	FORCEINLINE const FAttribEntry* FindEntry(const char* AttribName) const
+	{
+		const int32* FoundEntryIdxPtr = NameEntryMap.Find(AttribName);
+		return FoundEntryIdxPtr ? &Entries[*FoundEntryIdxPtr] : nullptr;
+	}
+
+	struct FPrefetchedFloatData
+	{
+		const char* AttribName = nullptr;  // HAPI_ATTRIB_* literals
+		int32 TupleSize = 0;
+		int32 Stride = 0;
+		TArray<float> Data;
+	};
+	TArray<FPrefetchedFloatData> PrefetchedFloatDatas;  // Retrieved by a worker while game thread is constructing the previous part
+
+	struct FPrefetchedAttribData
+	{
+		int32 AttribIdx = -1;  // Index of AttribNames
+		HAPI_StorageType Storage = HAPI_STORAGETYPE_INVALID;
+		TArray<uint8> Data;  // Raw houdini values
+	};
+	TArray<FPrefetchedAttribData> PrefetchedAttribDatas;  // unreal_pcg_attribute_*, also retrieved by the worker
+	int64 PrefetchedBytes = 0;  // Counted to transient bytes of the cook until this schema released
+
+public:
+	FHoudiniPCGPartSchema(const HAPI_Session& InSession) : Session(InSession) {}
+
+	~FHoudiniPCGPartSchema() { FHoudiniPCGCookStats::AddTransientBytes(false, -PrefetchedBytes); }
+
+	TArray<std::string> AttribNames;  // Sorted by owner, same as FHoudiniEngineUtils::HapiGetAttributeNames
+
+	FORCEINLINE const HAPI_Session* GetSession() const { return &Session; }
+
+	bool HapiInit(const int32& InNodeId, const HAPI_PartInfo& PartInfo);
+
+	HAPI_AttributeOwner QueryAttributeOwner(const char* AttribName) const;  // Same as FHoudiniEngineUtils::QueryAttributeOwner, vertex > point > prim > detail
+
+	FORCEINLINE bool IsAttributeExists(const char* AttribName, const HAPI_AttributeOwner& Owner) const
+	{
+		const FAttribEntry* Entry = FindEntry(AttribName);
+		return Entry && (Owner >= 0) && (Owner < HAPI_ATTROWNER_MAX) && (Entry->OwnerMask & (1 << Owner));
+	}
+
+	bool HapiGetAttributeInfo(const char* AttribName, const HAPI_AttributeOwner& Owner, HAPI_AttributeInfo& OutAttribInfo);  // Cached, OutAttribInfo.exists will be false if not found
+
+	void SetAttributeInfo(const char* AttribName, const HAPI_AttributeOwner& Owner, const HAPI_AttributeInfo& AttribInfo);  // Info retrieved before, avoid retrieve again
+
+	// -------- Rather than FHoudiniEngineUtils::HapiGet*AttributeData, which always address the session of HoudiniEngine, OutData will be empty if attrib NOT found on Owner --------
+	bool HapiGetFloatData(const char* AttribName, const HAPI_AttributeOwner& Owner, const int32& TupleSize, TArray<float>& OutData);  // Numeric attrib with at least TupleSize
+
+	bool HapiGetInt8Data(const char* AttribName, const HAPI_AttributeOwner& Owner, TArray<int8>& OutData);  // Numeric attrib, first component only
+
+	bool HapiGetStringValue(const char* AttribName, FString& OutValue);  // First element on the owner that QueryAttributeOwner returns, empty if NOT found
+
+	FORCEINLINE void AddPrefetchedFloatData(const char* AttribName, const int32& TupleSize, TArray<float>&& Data, const int32& Stride)
+	{
+		const int64 NumBytes = Data.GetAllocatedSize();
+		PrefetchedBytes += NumBytes;
+		FHoudiniPCGCookStats::AddTransientBytes(false, NumBytes);
+		PrefetchedFloatDatas.Add(FPrefetchedFloatData{ AttribName, TupleSize, Stride, MoveTemp(Data) });
+	}
+
+	bool FindPrefetchedFloatData(const char* AttribName, const int32& TupleSize, TConstArrayView<float>& OutData, int32& OutStride) const;  // Viewed rather than copied, valid until this schema released
+
+	FORCEINLINE void AddPrefetchedAttribData(const int32& AttribIdx, const HAPI_StorageType& Storage, TArray<uint8>&& Data)
+	{
+		const int64 NumBytes = Data.GetAllocatedSize();
+		PrefetchedBytes += NumBytes;
+		FHoudiniPCGCookStats::AddTransientBytes(false, NumBytes);
+		PrefetchedAttribDatas.Add(FPrefetchedAttribData{ AttribIdx, Storage, MoveTemp(Data) });
+	}
+
+	const uint8* FindPrefetchedAttribData(const int32& AttribIdx, const HAPI_StorageType& Storage, const int64& NumBytes) const;  // nullptr if not prefetched or size mismatched
+};
+
+bool FHoudiniPCGPartSchema::HapiInit(const int32& InNodeId, const HAPI_PartInfo& PartInfo)
+{
+	HOUDINI_PCG_STAGE_SCOPE(OutputSchema, 1);
+
+	NodeId = InNodeId;
+	PartId = PartInfo.id;
+
+	TArray<HAPI_StringHandle> AttribNameSHs;  // Names of all owners are converted by a single call
+	for (int32 Owner = HAPI_ATTROWNER_VERTEX; Owner < HAPI_ATTROWNER_MAX; ++Owner)
+	{
+		const int32& NumOwnerAttribs = PartInfo.attributeCounts[Owner];
+		if (NumOwnerAttribs <= 0)
+			continue;
+
+		const int32 StartIdx = AttribNameSHs.AddUninitialized(NumOwnerAttribs);
+		HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetAttributeNames(&Session, NodeId, PartId, HAPI_AttributeOwner(Owner),
+			AttribNameSHs.GetData() + StartIdx, NumOwnerAttribs));
+	}
+	HOUDINI_FAIL_RETURN(FHoudiniPCGUtils::HapiConvertStringHandles(&Session, AttribNameSHs, AttribNames));
+
+	NameEntryMap.Reserve(AttribNames.Num());
+	int32 AttribIdx = 0;
+	for (int32 Owner = HAPI_ATTROWNER_VERTEX; Owner < HAPI_ATTROWNER_MAX; ++Owner)
+	{
+		for (int32 OwnerAttribIdx = 0; OwnerAttribIdx < PartInfo.attributeCounts[Owner]; ++OwnerAttribIdx, ++AttribIdx)
+		{
+			int32& EntryIdx = NameEntryMap.FindOrAdd(AttribNames[AttribIdx], -1);
+			if (EntryIdx < 0)
+				EntryIdx = Entries.AddDefaulted();
+			Entries[EntryIdx].OwnerMask |= (1 << Owner);
+		}
+	}
+
+	return true;
+}
+
+HAPI_AttributeOwner FHoudiniPCGPartSchema::QueryAttributeOwner(const char* AttribName) const
+{
+	if (const FAttribEntry* Entry = FindEntry(AttribName))
+	{
+		for (int32 Owner = HAPI_ATTROWNER_VERTEX; Owner < HAPI_ATTROWNER_MAX; ++Owner)
+		{
+			if (Entry->OwnerMask & (1 << Owner))
+				return HAPI_AttributeOwner(Owner);
+		}
+	}
+
+	return HAPI_ATTROWNER_INVALID;
+}
+
+bool FHoudiniPCGPartSchema::HapiGetAttributeInfo(const char* AttribName, const HAPI_AttributeOwner& Owner, HAPI_AttributeInfo& OutAttribInfo)
+{
+	const int32* FoundEntryIdxPtr = NameEntryMap.Find(AttribName);
+	if (!FoundEntryIdxPtr || (Owner < 0) || (Owner >= HAPI_ATTROWNER_MAX) || !(Entries[*FoundEntryIdxPtr].OwnerMask & (1 << Owner)))
+	{
+		FMemory::Memzero(OutAttribInfo);  // exists = false
+		return true;
+	}
+
+	FAttribEntry& Entry = Entries[*FoundEntryIdxPtr];
+	if (!(Entry.InfoMask & (1 << Owner)))
+	{
+		HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetAttributeInfo(&Session, NodeId, PartId,
+			AttribName, Owner, &Entry.Infos[Owner]));
+		Entry.InfoMask |= (1 << Owner);
+	}
+	OutAttribInfo = Entry.Infos[Owner];
+
+	return true;
+}
+
+bool FHoudiniPCGPartSchema::FindPrefetchedFloatData(const char* AttribName, const int32& TupleSize, TConstArrayView<float>& OutData, int32& OutStride) const
+{
+	for (const FPrefetchedFloatData& Prefetched : PrefetchedFloatDatas)
+	{
+		if ((Prefetched.TupleSize == TupleSize) && (FCStringAnsi::Strcmp(Prefetched.AttribName, AttribName) == 0))
+		{
+			OutData = Prefetched.Data;
+			OutStride = Prefetched.Stride;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+const uint8* FHoudiniPCGPartSchema::FindPrefetchedAttribData(const int32& AttribIdx, const HAPI_StorageType& Storage, const int64& NumBytes) const
+{
+	for (const FPrefetchedAttribData& Prefetched : PrefetchedAttribDatas)
+	{
+		if ((Prefetched.AttribIdx == AttribIdx) && (Prefetched.Storage == Storage))
+			return (Prefetched.Data.Num() == NumBytes) ? Prefetched.Data.GetData() : nullptr;
+	}
+
+	return nullptr;
+}
+
+void FHoudiniPCGPartSchema::SetAttributeInfo(const char* AttribName, const HAPI_AttributeOwner& Owner, const HAPI_AttributeInfo& AttribInfo)
+{
+	const int32* FoundEntryIdxPtr = NameEntryMap.Find(AttribName);
+	if (FoundEntryIdxPtr && (Owner >= 0) && (Owner < HAPI_ATTROWNER_MAX))
+	{
+		FAttribEntry& Entry = Entries[*FoundEntryIdxPtr];
+		Entry.Infos[Owner] = AttribInfo;
+		Entry.InfoMask |= (1 << Owner);
+	}
+}
+
+static FORCEINLINE bool IsNumericStorage(const HAPI_StorageType& Storage)  // NOT array, HAPI converts between numeric storages when retrieving
+{
+	return (Storage >= HAPI_STORAGETYPE_INT) && (Storage <= HAPI_STORAGETYPE_INT16) && (Storage != HAPI_STORAGETYPE_STRING);
+}
+
+bool FHoudiniPCGPartSchema::HapiGetFloatData(const char* AttribName, const HAPI_AttributeOwner& Owner, const int32& TupleSize, TArray<float>& OutData)
+{
+	OutData.Reset();
+
+	HAPI_AttributeInfo AttribInfo;
+	HOUDINI_FAIL_RETURN(HapiGetAttributeInfo(AttribName, Owner, AttribInfo));
+	if (!AttribInfo.exists || (AttribInfo.count <= 0) || !IsNumericStorage(AttribInfo.storage) || (AttribInfo.tupleSize < TupleSize))
+		return true;
+
+	AttribInfo.tupleSize = TupleSize;  // HAPI returns the leading components only
+	OutData.SetNumUninitialized(AttribInfo.count * TupleSize);
+	HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetAttributeFloatData(&Session, NodeId, PartId,
+		AttribName, &AttribInfo, -1, OutData.GetData(), 0, AttribInfo.count));
+
+	return true;
+}
+
+bool FHoudiniPCGPartSchema::HapiGetInt8Data(const char* AttribName, const HAPI_AttributeOwner& Owner, TArray<int8>& OutData)
+{
+	OutData.Reset();
+
+	HAPI_AttributeInfo AttribInfo;
+	HOUDINI_FAIL_RETURN(HapiGetAttributeInfo(AttribName, Owner, AttribInfo));
+	if (!AttribInfo.exists || (AttribInfo.count <= 0) || !IsNumericStorage(AttribInfo.storage))
+		return true;
+
+	AttribInfo.tupleSize = 1;
+	TArray<int32> IntData;
+	IntData.SetNumUninitialized(AttribInfo.count);
+	HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetAttributeIntData(&Session, NodeId, PartId,
+		AttribName, &AttribInfo, -1, IntData.GetData(), 0, AttribInfo.count));
+
+	OutData.SetNumUninitialized(IntData.Num());
+	for (int32 ElemIdx = 0; ElemIdx < IntData.Num(); ++ElemIdx)
+		OutData[ElemIdx] = int8(IntData[ElemIdx]);
+
+	return true;
+}
+
+bool FHoudiniPCGPartSchema::HapiGetStringValue(const char* AttribName, FString& OutValue)
+{
+	OutValue.Empty();
+
+	HAPI_AttributeInfo AttribInfo;
+	HOUDINI_FAIL_RETURN(HapiGetAttributeInfo(AttribName, QueryAttributeOwner(AttribName), AttribInfo));
+	if (!AttribInfo.exists || (AttribInfo.count <= 0) || (AttribInfo.storage != HAPI_STORAGETYPE_STRING))
+		return true;
+
+	HAPI_StringHandle SH = -1;
+	AttribInfo.tupleSize = 1;
+	HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetAttributeStringData(&Session, NodeId, PartId,
+		AttribName, &AttribInfo, &SH, 0, 1));
+
+	TArray<FString> Values;
+	HOUDINI_FAIL_RETURN(FHoudiniPCGUtils::HapiConvertStringHandles(&Session, TConstArrayView<HAPI_StringHandle>(&SH, 1), Values));
+	OutValue = Values[0];
+
+	return true;
+}
+
+
+const HAPI_Session* FHoudiniPCGDataAssetOutputBuilder::GetSession() const
+{
+	return Session ? Session : FHoudiniEngine::Get().GetSession();
+}
+
 bool FHoudiniPCGDataAssetOutputBuilder::HapiIsPartValid(const int32& NodeId, const HAPI_PartInfo& PartInfo, bool& bOutIsValid, bool& bOutShouldHoldByOutput)
 {
 	bOutShouldHoldByOutput = false;  // Only output to content as assets
 	bOutIsValid = false;
 
+	LLM_SCOPE_BYTAG(HoudiniPCG_Cache);
+
 #if ((ENGINE_MAJOR_VERSION == 5) && (ENGINE_MINOR_VERSION >= 5)) || (ENGINE_MAJOR_VERSION > 5)
 	if ((PartInfo.type == HAPI_PARTTYPE_MESH) || (PartInfo.type == HAPI_PARTTYPE_CURVE))  // Can output point cloud, splines, or dynamic mesh data
 #else
 	if (((PartInfo.type == HAPI_PARTTYPE_MESH) && (PartInfo.faceCount <= 0)) || (PartInfo.type == HAPI_PARTTYPE_CURVE))  // Can output point cloud or spline data
 #endif
 	{
+		const HAPI_Session* Session = GetSession();
 		const int32& PartId = PartInfo.id;
 
 		HAPI_AttributeInfo AttribInfo;
-		HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetAttributeInfo(FHoudiniEngine::Get().GetSession(), NodeId, PartId,
+		HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetAttributeInfo(Session, NodeId, PartId,
 			HAPI_ATTRIB_UNREAL_OUTPUT_PCG_DATA_ASSET, HAPI_ATTROWNER_DETAIL, &AttribInfo));
 
 		if (AttribInfo.exists && !FHoudiniEngineUtils::IsArray(AttribInfo.storage) &&
 			FHoudiniEngineUtils::ConvertStorageType(AttribInfo.storage) == EHoudiniStorageType::Int)  // Currently only support i@unreal_output_pcg_data_asset = 1 on detail
 		{
 			int bIsPCGDataAsset = 0;
-			HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetAttributeIntData(FHoudiniEngine::Get().GetSession(), NodeId, PartId,
+			HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetAttributeIntData(Session, NodeId, PartId,
 				HAPI_ATTRIB_UNREAL_OUTPUT_PCG_DATA_ASSET, &AttribInfo, 1, &bIsPCGDataAsset, 0, 1));
 
 			bOutIsValid = bool(bIsPCGDataAsset);
+			if (bOutIsValid)  // Build schema here, so that HapiRetrieve need NOT retrieve attribute names and infos again
+			{
+				const TSharedPtr<FHoudiniPCGPartSchema> Schema = MakeShared<FHoudiniPCGPartSchema>(*Session);
+				HOUDINI_FAIL_RETURN(Schema->HapiInit(NodeId, PartInfo));
+				Schema->SetAttributeInfo(HAPI_ATTRIB_UNREAL_OUTPUT_PCG_DATA_ASSET, HAPI_ATTROWNER_DETAIL, AttribInfo);
+				PartSchemas.FindOrAdd(TPair<int32, int32>(NodeId, PartId)) = Schema;
+			}
 			return true;
 		}
 	}
@@ -57,604 +359,1990 @@ bool FHoudiniPCGDataAssetOutputBuilder::HapiIsPartValid(const int32& NodeId, con
 	return true;
 }
 
-namespace HoudiniPCGDataOutputUtils
+class FHoudiniPCGOutputScratch  // Buffers reused by all parts and attributes during a single cook, to avoid large transient allocations
 {
-	template<typename HapiValueType, typename ValueType, typename GetAttribValueHapi>
-	static bool HapiCreateNumericPCGAttribute(const int32& NodeId, const int32& PartId, HAPI_AttributeInfo& AttribInfo,
-		const std::string& AttribNameStr, GetAttribValueHapi GetAttribValueHapiFunc,
-		UPCGMetadata* Metadata, const FName& AttribName, const ValueType& DefaultValue, TArray<PCGMetadataEntryKey>& EntryKeys);
+protected:
+	TArray<uint8, TAlignedHeapAllocator<32>> HapiBuffer;  // Raw data retrieved from houdini
+	TArray<uint8, TAlignedHeapAllocator<32>> ValueBuffer;  // Data converted to PCG value type
+	TArray<uint8, TAlignedHeapAllocator<32>> GatherBuffer;  // Values gathered for a single bucket of a split part
+	TArray<PCGMetadataEntryKey> IdentityEntryKeys;  // IdentityEntryKeys[Idx] == Idx
+	TArray<int64> ParentEntryKeys;  // All -1, entries have no parent
+	int64 AllocatedBytes = 0;  // Counted to transient bytes of the cook
+
+	void UpdateAllocatedBytes()
+	{
+		const int64 NewAllocatedBytes = HapiBuffer.GetAllocatedSize() + ValueBuffer.GetAllocatedSize() + GatherBuffer.GetAllocatedSize() +
+			IdentityEntryKeys.GetAllocatedSize() + ParentEntryKeys.GetAllocatedSize();
+		if (NewAllocatedBytes != AllocatedBytes)
+		{
+			FHoudiniPCGCookStats::AddTransientBytes(false, NewAllocatedBytes - AllocatedBytes);
+			AllocatedBytes = NewAllocatedBytes;
+		}
+	}
 
-	template<typename HapiValueType, typename ValueType, typename GetAttribValueHapi>
-	static bool HapiCreateNumericPCGAttribute(const int32& NodeId, const int32& PartId, HAPI_AttributeInfo& AttribInfo,
-		const std::string& AttribNameStr, GetAttribValueHapi GetAttribValueHapiFunc, TFunctionRef<ValueType(const TArray<HapiValueType>&, const int32&)> ConvertFunc,
-		UPCGMetadata* Metadata, const FName& AttribName, const ValueType& DefaultValue, TArray<PCGMetadataEntryKey>& EntryKeys);
+	template<typename ValueType>
+	FORCEINLINE ValueType* GetBuffer(TArray<uint8, TAlignedHeapAllocator<32>>& Buffer, const int32& Num)
+	{
+		const int32 PrevMax = Buffer.Max();
+		Buffer.SetNumUninitialized(Num * sizeof(ValueType), EAllowShrinking::No);
+		if (Buffer.Max() != PrevMax)
+			UpdateAllocatedBytes();
+		return (ValueType*)Buffer.GetData();
+	}
 
-	static bool HapiGetTags(const int32& NodeId, const int32& PartId, const HAPI_AttributeOwner& TagsOwner, TSet<FString>& OutTags);
-}
+public:
+	~FHoudiniPCGOutputScratch() { FHoudiniPCGCookStats::AddTransientBytes(false, -AllocatedBytes); }
 
-template<typename HapiValueType, typename ValueType, typename GetAttribValueHapi>
-static bool HoudiniPCGDataOutputUtils::HapiCreateNumericPCGAttribute(const int32& NodeId, const int32& PartId, HAPI_AttributeInfo& AttribInfo,
-	const std::string& AttribNameStr, GetAttribValueHapi GetAttribValueHapiFunc,
-	UPCGMetadata* Metadata, const FName& AttribName, const ValueType& DefaultValue, TArray<PCGMetadataEntryKey>& EntryKeys)
+	template<typename HapiValueType>
+	FORCEINLINE HapiValueType* GetHapiBuffer(const int32& Num) { return GetBuffer<HapiValueType>(HapiBuffer, Num); }
+
+	template<typename ValueType>
+	FORCEINLINE ValueType* GetValueBuffer(const int32& Num) { return GetBuffer<ValueType>(ValueBuffer, Num); }
+
+	template<typename ValueType>
+	FORCEINLINE ValueType* GetGatherBuffer(const int32& Num) { return GetBuffer<ValueType>(GatherBuffer, Num); }
+
+	TArrayView<const PCGMetadataEntryKey> GetIdentityEntryKeys(const int32& Num)
+	{
+		const int32 NumPrevKeys = IdentityEntryKeys.Num();
+		if (NumPrevKeys < Num)
+		{
+			IdentityEntryKeys.SetNumUninitialized(Num);
+			for (PCGMetadataEntryKey EntryKey = NumPrevKeys; EntryKey < Num; ++EntryKey)
+				IdentityEntryKeys[EntryKey] = EntryKey;
+			UpdateAllocatedBytes();
+		}
+		return MakeArrayView(IdentityEntryKeys.GetData(), Num);
+	}
+
+	TArrayView<const int64> GetParentEntryKeys(const int32& Num)
+	{
+		if (ParentEntryKeys.Num() < Num)
+		{
+			ParentEntryKeys.Init(-1, Num);
+			UpdateAllocatedBytes();
+		}
+		return MakeArrayView(ParentEntryKeys.GetData(), Num);
+	}
+};
+
+struct FHoudiniPCGStringIndices  // String handles of an attribute, mapped to FHoudiniPCGStringCache
+{
+	TArray<int32> LocalIndices;  // LocalIndices[ElemIdx] is the index of UniqueSlots
+	TArray<int32> UniqueSlots;  // Slots of unique handles in FHoudiniPCGStringCache
+};
+
+#if ((ENGINE_MAJOR_VERSION == 5) && (ENGINE_MINOR_VERSION >= 6)) || (ENGINE_MAJOR_VERSION > 5)
+typedef FPCGMetadataDomain FHoudiniPCGMetadata;
+#else
+typedef UPCGMetadata FHoudiniPCGMetadata;
+#endif
+
+struct FHoudiniPCGAttributeTarget  // Values [StartIdx, StartIdx + Num) of a houdini attribute will be written to entries [0, Num) of Metadata
+{
+	FHoudiniPCGAttributeTarget(FHoudiniPCGMetadata* InMetadata, const int32& InStartIdx, const int32& InNum, const bool& bInDefaultValueOnly = false,
+		const int32* InElemIndices = nullptr) :
+		Metadata(InMetadata), StartIdx(InStartIdx), Num(InNum), bDefaultValueOnly(bInDefaultValueOnly), ElemIndices(InElemIndices) {}
+
+	FHoudiniPCGMetadata* Metadata = nullptr;
+	int32 StartIdx = 0;
+	int32 Num = 0;
+	bool bDefaultValueOnly = false;  // Value of StartIdx will be the default value of attribute, used when the data has no data domain
+	const int32* ElemIndices = nullptr;  // If set, values of ElemIndices[StartIdx, StartIdx + Num) will be gathered, used when a part is split into buckets
+
+	FORCEINLINE int32 GetElemIdx(const int32& EntryIdx) const { return ElemIndices ? ElemIndices[StartIdx + EntryIdx] : (StartIdx + EntryIdx); }
+};
+
+struct FHoudiniPCGStringAttribute  // Will be created after all strings of the part have been converted
+{
+	FName Name;
+	FHoudiniPCGStringIndices Indices;
+	TArray<FHoudiniPCGAttributeTarget> Targets;
+};
+
+struct FHoudiniPCGPartitionIndex  // Cells output as separate assets, will be written to the index asset as one point per cell
+{
+	double GridSize = 0.0;
+	TMap<FIntPoint, FString> CellObjectPaths;
+};
+
+class FHoudiniPCGStringCache  // HAPI_StringHandle -> FString/FSoftObjectPath during a single cook, handles of a part will be converted by a single batched call
 {
-	if (EntryKeys.IsEmpty())
+protected:
+	const HAPI_Session* Session = nullptr;  // Handles are only valid in the session they come from
+	TMap<HAPI_StringHandle, int32> HandleSlots;  // Only be looked up once per unique handle of an attribute, elements are mapped by flat tables
+	TArray<FString> Strings;
+	TArray<FSoftObjectPath> ObjectPaths;  // Lazily converted from Strings
+	TBitArray<> ObjectPathMask;
+
+	TArray<HAPI_StringHandle> PendingHandles;  // Handles have NOT been converted yet
+	TArray<int32> PendingSlots;
+
+	int32 FindOrAddSlot(const HAPI_StringHandle& SH)
 	{
-		EntryKeys.SetNumUninitialized(AttribInfo.count);
-		for (PCGMetadataEntryKey EntryKey = 0; EntryKey < AttribInfo.count; ++EntryKey)
-			EntryKeys[EntryKey] = EntryKey;
+		if (const int32* FoundSlotPtr = HandleSlots.Find(SH))
+			return *FoundSlotPtr;
+
+		const int32 Slot = Strings.AddDefaulted();
+		ObjectPaths.AddDefaulted();
+		ObjectPathMask.Add(false);
+		HandleSlots.Add(SH, Slot);
+		PendingHandles.Add(SH);
+		PendingSlots.Add(Slot);
+		return Slot;
 	}
-	TArray<HapiValueType> Data;
-	Data.SetNumUninitialized(AttribInfo.count * AttribInfo.tupleSize);
-	HAPI_SESSION_FAIL_RETURN(GetAttribValueHapiFunc(FHoudiniEngine::Get().GetSession(), NodeId, PartId,
-		AttribNameStr.c_str(), &AttribInfo, -1, Data.GetData(), 0, AttribInfo.count));
-	FPCGMetadataAttribute<ValueType>* Attrib = Metadata->CreateAttribute<ValueType>(AttribName, DefaultValue, true, true);
-	Attrib->SetValues(EntryKeys, TArrayView<ValueType>((ValueType*)Data.GetData(), AttribInfo.count));
 
-	return true;
+public:
+	FHoudiniPCGStringCache(const HAPI_Session* InSession) : Session(InSession) {}
+
+	// Strings will NOT be available until HapiConvertPending
+	void AddHandles(const TConstArrayView<HAPI_StringHandle>& SHs, FHoudiniPCGStringIndices& OutIndices);
+
+	bool HapiConvertPending();
+
+	FORCEINLINE const FString& GetString(const int32& Slot) const { return Strings[Slot]; }
+
+	const FSoftObjectPath& GetObjectPath(const int32& Slot);  // NOT thread-safe, should be called before parallel loops
+
+	void GetObjectPaths(TArray<FSoftObjectPath>& OutObjectPaths) const;  // Only strings that have been used as object paths
+};
+
+void FHoudiniPCGStringCache::AddHandles(const TConstArrayView<HAPI_StringHandle>& SHs, FHoudiniPCGStringIndices& OutIndices)
+{
+	LLM_SCOPE_BYTAG(HoudiniPCG_Cache);
+
+	OutIndices.LocalIndices.SetNumUninitialized(SHs.Num());
+	OutIndices.UniqueSlots.Reset();
+	if (SHs.IsEmpty())
+		return;
+
+	HAPI_StringHandle MinSH = SHs[0];
+	HAPI_StringHandle MaxSH = SHs[0];
+	for (const HAPI_StringHandle& SH : SHs)
+	{
+		MinSH = FMath::Min(MinSH, SH);
+		MaxSH = FMath::Max(MaxSH, SH);
+	}
+
+	if ((int64(MaxSH) - int64(MinSH)) < FMath::Max(int64(SHs.Num()) * 4, int64(65536)))  // Handles are dense, so use a flat table indexed by handle
+	{
+		TArray<int32> LocalTable;
+		LocalTable.Init(-1, MaxSH - MinSH + 1);
+		for (int32 ElemIdx = 0; ElemIdx < SHs.Num(); ++ElemIdx)
+		{
+			int32& LocalIdx = LocalTable[SHs[ElemIdx] - MinSH];
+			if (LocalIdx < 0)
+				LocalIdx = OutIndices.UniqueSlots.Add(FindOrAddSlot(SHs[ElemIdx]));
+			OutIndices.LocalIndices[ElemIdx] = LocalIdx;
+		}
+	}
+	else  // Sparse handles, binary search in sorted unique handles
+	{
+		TArray<HAPI_StringHandle> UniqueSHs(SHs);
+		UniqueSHs.Sort();
+		UniqueSHs.SetNum(Algo::Unique(UniqueSHs));
+		for (const HAPI_StringHandle& SH : UniqueSHs)
+			OutIndices.UniqueSlots.Add(FindOrAddSlot(SH));
+
+		FHoudiniPCGUtils::ParallelForBatch(SHs.Num(), [&](const int32& StartIdx, const int32& EndIdx)
+			{
+				for (int32 ElemIdx = StartIdx; ElemIdx < EndIdx; ++ElemIdx)
+					OutIndices.LocalIndices[ElemIdx] = Algo::BinarySearch(UniqueSHs, SHs[ElemIdx]);
+			});
+	}
 }
 
-template<typename HapiValueType, typename ValueType, typename GetAttribValueHapi>
-static bool HoudiniPCGDataOutputUtils::HapiCreateNumericPCGAttribute(const int32& NodeId, const int32& PartId, HAPI_AttributeInfo& AttribInfo,
-	const std::string& AttribNameStr, GetAttribValueHapi GetAttribValueHapiFunc, TFunctionRef<ValueType(const TArray<HapiValueType>&, const int32&)> ConvertFunc,
-	UPCGMetadata* Metadata, const FName& AttribName, const ValueType& DefaultValue, TArray<PCGMetadataEntryKey>& EntryKeys)
-{
-	if (EntryKeys.IsEmpty())
-	{
-		EntryKeys.SetNumUninitialized(AttribInfo.count);
-		for (PCGMetadataEntryKey EntryKey = 0; EntryKey < AttribInfo.count; ++EntryKey)
-			EntryKeys[EntryKey] = EntryKey;
-	}
-	TArray<HapiValueType> Data;
-	Data.SetNumUninitialized(AttribInfo.count * AttribInfo.tupleSize);
-	HAPI_SESSION_FAIL_RETURN(GetAttribValueHapiFunc(FHoudiniEngine::Get().GetSession(), NodeId, PartId,
-		AttribNameStr.c_str(), &AttribInfo, -1, Data.GetData(), 0, AttribInfo.count));
-	TArray<ValueType> PCGData;
-	PCGData.SetNumUninitialized(AttribInfo.count);
-	for (int32 ElemIdx = 0; ElemIdx < AttribInfo.count; ++ElemIdx)
-		PCGData[ElemIdx] = ConvertFunc(Data, ElemIdx * AttribInfo.tupleSize);
-	FPCGMetadataAttribute<ValueType>* Attrib = Metadata->CreateAttribute<ValueType>(AttribName, DefaultValue, true, true);
-	Attrib->SetValues(EntryKeys, PCGData);
+bool FHoudiniPCGStringCache::HapiConvertPending()
+{
+	LLM_SCOPE_BYTAG(HoudiniPCG_Cache);
+
+	if (PendingHandles.IsEmpty())
+		return true;
+
+	TArray<FString> PendingStrs;
+	{
+		HOUDINI_PCG_HAPI_CALL_SCOPE(false, PendingHandles.Num() * sizeof(HAPI_StringHandle));
+		HOUDINI_FAIL_RETURN(FHoudiniPCGUtils::HapiConvertStringHandles(Session, PendingHandles, PendingStrs));
+	}
+	for (int32 PendingIdx = 0; PendingIdx < PendingSlots.Num(); ++PendingIdx)
+		Strings[PendingSlots[PendingIdx]] = MoveTemp(PendingStrs[PendingIdx]);
+
+	PendingHandles.Reset();
+	PendingSlots.Reset();
 
 	return true;
 }
 
-static bool HoudiniPCGDataOutputUtils::HapiGetTags(const int32& NodeId, const int32& PartId, const HAPI_AttributeOwner& TagsOwner, TSet<FString>& OutTags)
+const FSoftObjectPath& FHoudiniPCGStringCache::GetObjectPath(const int32& Slot)
 {
-	if (TagsOwner != HAPI_ATTROWNER_INVALID)
+	if (!ObjectPathMask[Slot])
 	{
-		HAPI_AttributeInfo AttribInfo;
-		HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetAttributeInfo(FHoudiniEngine::Get().GetSession(), NodeId, PartId,
-			HAPI_ATTRIB_UNREAL_PCG_TAGS, TagsOwner, &AttribInfo));
+		const FString& Str = Strings[Slot];
+		int32 SplitIdx = -1;
+		if (Str.FindChar(TCHAR(';'), SplitIdx))  // UHoudiniParameterAsset could import ref str with asset info(unreal_ref = import_info), which will append after ';'
+			ObjectPaths[Slot] = Str.Left(SplitIdx);
+		else
+			ObjectPaths[Slot] = Str;
+		ObjectPathMask[Slot] = true;
+	}
 
-		if (AttribInfo.exists && FHoudiniEngineUtils::ConvertStorageType(AttribInfo.storage) == EHoudiniStorageType::String)
+	return ObjectPaths[Slot];
+}
+
+void FHoudiniPCGStringCache::GetObjectPaths(TArray<FSoftObjectPath>& OutObjectPaths) const
+{
+	for (TConstSetBitIterator<> MaskIter(ObjectPathMask); MaskIter; ++MaskIter)
+		OutObjectPaths.Add(ObjectPaths[MaskIter.GetIndex()]);
+}
+
+struct FHoudiniCurveAttributeIndexer  // Same as FHoudiniOutputUtils::CurveAttributeEntryIdx, but resolve owner only once for hot loops
+{
+	FHoudiniCurveAttributeIndexer(const HAPI_AttributeOwner& Owner) :
+		VertexStride(((Owner == HAPI_ATTROWNER_VERTEX) || (Owner == HAPI_ATTROWNER_POINT)) ? 1 : 0), CurveStride((Owner == HAPI_ATTROWNER_PRIM) ? 1 : 0) {}
+
+	int32 VertexStride = 0;
+	int32 CurveStride = 0;
+
+	FORCEINLINE int32 operator()(const int32& VtxIdx, const int32& CurveIdx) const { return VtxIdx * VertexStride + CurveIdx * CurveStride; }
+};
+
+struct FHoudiniPCGTagsAttribute  // s@unreal_pcg_tags or s[]@unreal_pcg_tags, resolved by FHoudiniPCGStringCache
+{
+	HAPI_AttributeOwner Owner = HAPI_ATTROWNER_INVALID;
+	bool bIsArray = false;
+	FHoudiniPCGStringIndices Indices;
+	TArray<int32> ArrayOffsets;  // Only for array, tags of ElemIdx are in [ArrayOffsets[ElemIdx], ArrayOffsets[ElemIdx + 1])
+
+	// Only retrieve the first element if bFirstElementOnly, as tags of the whole data
+	bool HapiRetrieve(const HAPI_Session* Session, const int32& NodeId, const int32& PartId, const HAPI_AttributeOwner& TagsOwner, const bool& bFirstElementOnly,
+		FHoudiniPCGStringCache& StringCache);
+
+	void GetTags(const FHoudiniPCGStringCache& StringCache, const int32& ElemIdx, TSet<FString>& OutTags) const;
+};
+
+bool FHoudiniPCGTagsAttribute::HapiRetrieve(const HAPI_Session* Session, const int32& NodeId, const int32& PartId, const HAPI_AttributeOwner& TagsOwner, const bool& bFirstElementOnly,
+	FHoudiniPCGStringCache& StringCache)
+{
+	if (TagsOwner == HAPI_ATTROWNER_INVALID)
+		return true;
+
+	HAPI_AttributeInfo AttribInfo;
+	HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetAttributeInfo(Session, NodeId, PartId,
+		HAPI_ATTRIB_UNREAL_PCG_TAGS, TagsOwner, &AttribInfo));
+
+	if (!AttribInfo.exists || (FHoudiniEngineUtils::ConvertStorageType(AttribInfo.storage) != EHoudiniStorageType::String) || (AttribInfo.count <= 0))
+		return true;
+
+	Owner = TagsOwner;
+	bIsArray = FHoudiniEngineUtils::IsArray(AttribInfo.storage);
+	const int32 NumElems = bFirstElementOnly ? 1 : AttribInfo.count;
+	TArray<HAPI_StringHandle> SHs;
+	if (bIsArray)
+	{
+		if (AttribInfo.totalArrayElements >= 1)
 		{
-			if (FHoudiniEngineUtils::IsArray(AttribInfo.storage))
-			{
-				if (AttribInfo.totalArrayElements >= 1)
-				{
-					TArray<HAPI_StringHandle> SHs;
-					SHs.SetNumUninitialized(AttribInfo.totalArrayElements);
-					int ArrayLen = 0;
-					HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetAttributeStringArrayData(FHoudiniEngine::Get().GetSession(), NodeId, PartId,
-						HAPI_ATTRIB_UNREAL_PCG_TAGS, &AttribInfo, SHs.GetData(), AttribInfo.totalArrayElements, &ArrayLen, 0, 1));
-					SHs.SetNum(ArrayLen);
-					TArray<FString> Tags;
-					HOUDINI_FAIL_RETURN(FHoudiniEngineUtils::HapiConvertStringHandles(SHs, Tags));
-					OutTags = TSet<FString>(Tags);
-				}
-			}
-			else
+			SHs.SetNumUninitialized(AttribInfo.totalArrayElements);
+			ArrayOffsets.SetNumUninitialized(NumElems + 1);
+			ArrayOffsets[0] = 0;
 			{
-				HAPI_StringHandle SH = 0;
-				HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetAttributeStringData(FHoudiniEngine::Get().GetSession(), NodeId, PartId,
-					HAPI_ATTRIB_UNREAL_PCG_TAGS, &AttribInfo, &SH, 0, 1));
-				FString Tag;
-				FHoudiniEngineUtils::HapiConvertStringHandle(SH, Tag);
-				if (!Tag.IsEmpty())
-					OutTags.Add(Tag);
+				HOUDINI_PCG_HAPI_CALL_SCOPE(false, AttribInfo.totalArrayElements * sizeof(HAPI_StringHandle));
+				HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetAttributeStringArrayData(Session, NodeId, PartId,
+					HAPI_ATTRIB_UNREAL_PCG_TAGS, &AttribInfo, SHs.GetData(), AttribInfo.totalArrayElements, ArrayOffsets.GetData() + 1, 0, NumElems));
 			}
+			for (int32 ElemIdx = 1; ElemIdx <= NumElems; ++ElemIdx)  // Sizes to offsets
+				ArrayOffsets[ElemIdx] += ArrayOffsets[ElemIdx - 1];
+			SHs.SetNum(ArrayOffsets.Last());
+		}
+	}
+	else
+	{
+		SHs.SetNumUninitialized(NumElems);
+		{
+			HOUDINI_PCG_HAPI_CALL_SCOPE(false, NumElems * sizeof(HAPI_StringHandle));
+			HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetAttributeStringData(Session, NodeId, PartId,
+				HAPI_ATTRIB_UNREAL_PCG_TAGS, &AttribInfo, SHs.GetData(), 0, NumElems));
 		}
 	}
+
+	StringCache.AddHandles(SHs, Indices);
+
 	return true;
 }
 
-using namespace HoudiniPCGDataOutputUtils;
+void FHoudiniPCGTagsAttribute::GetTags(const FHoudiniPCGStringCache& StringCache, const int32& ElemIdx, TSet<FString>& OutTags) const
+{
+	auto AddTagLambda = [&](const int32& TagIdx)
+		{
+			const FString& Tag = StringCache.GetString(Indices.UniqueSlots[Indices.LocalIndices[TagIdx]]);
+			if (!Tag.IsEmpty())
+				OutTags.Add(Tag);
+		};
 
+	if (bIsArray)
+	{
+		if (ArrayOffsets.IsValidIndex(ElemIdx + 1))
+		{
+			for (int32 TagIdx = ArrayOffsets[ElemIdx]; TagIdx < ArrayOffsets[ElemIdx + 1]; ++TagIdx)
+				AddTagLambda(TagIdx);
+		}
+	}
+	else if (Indices.LocalIndices.IsValidIndex(ElemIdx))
+		AddTagLambda(ElemIdx);
+}
 
-bool FHoudiniPCGDataAssetOutputBuilder::HapiRetrieve(AHoudiniNode* Node, const FString& OutputName, const HAPI_GeoInfo& GeoInfo, const TArray<HAPI_PartInfo>& PartInfos)
+class FHoudiniPCGPointBuckets  // Points of a part grouped by split keys, each bucket will be output as a separate point data
 {
-	TRACE_CPUPROFILER_EVENT_SCOPE(HoudiniOutputPCGDataAsset);
+protected:
+	TArray<int32> PointBucketIndices;  // Empty if only a single bucket
+	TArray<int32> PointLocalIndices;  // Index of point in its bucket, empty if only a single bucket
+	TArray<int32> SortedPointIndices;  // Points of bucket are in [BucketOffsets[BucketIdx], BucketOffsets[BucketIdx + 1]), empty if only a single bucket
+	TArray<int32> BucketOffsets;
+	TArray<TPair<const TArray<int32>*, int32>> KeyColumns;  // { LocalIndices, NumKeys }, only valid until Build
 
-	const int32& NodeId = GeoInfo.nodeId;
+public:
+	// LocalIndices[PointIdx] is in [0, NumKeys), such as FHoudiniPCGStringIndices::LocalIndices, will be ignored if empty
+	FORCEINLINE void AddKeys(const TArray<int32>& LocalIndices, const int32& NumKeys) { KeyColumns.Emplace(&LocalIndices, NumKeys); }
 
-	TArray<UPCGDataAsset*> PCGDAs;  // One single asset may contains multiple data objects
-	for (const HAPI_PartInfo& PartInfo : PartInfos)
-	{
-		const int32& PartId = PartInfo.id;
+	// Points with the same keys will be in the same bucket
+	void Build(const int32& PointCount);
 
-		TArray<std::string> AttribNames;
-		HOUDINI_FAIL_RETURN(FHoudiniEngineUtils::HapiGetAttributeNames(NodeId, PartId, PartInfo.attributeCounts, AttribNames));
-		
-		FString ObjectPath;
-		HOUDINI_FAIL_RETURN(FHoudiniEngineUtils::HapiGetStringAttributeValue(NodeId, PartId,
-			AttribNames, PartInfo.attributeCounts, HAPI_ATTRIB_UNREAL_OBJECT_PATH, ObjectPath));
-		if (IS_ASSET_PATH_INVALID(ObjectPath))
-			ObjectPath = FHoudiniOutputUtils::GetCookFolderPath(Node) + TEXT("PCGDA_") + OutputName + TEXT("_") + FString::FromInt(PartId);
+	// Reorder points in each bucket along a Morton curve over the part bounds, so that nearby points are adjacent in PCG datas. MUST be called after Build
+	void SortSpatially(const int32& PointCount, TFunctionRef<FVector(const int32&)> GetPositionFunc);
 
-		UPCGDataAsset* PCGDA = FHoudiniEngineUtils::FindOrCreateAsset<UPCGDataAsset>(ObjectPath);
-		if (!PCGDAs.Contains(PCGDA))  // If first time to create, then clear previous data
-		{
-			PCGDA->Data.Reset();
-			PCGDA->Data.DataCrcs.Empty();
-			PCGDAs.Add(PCGDA);
-		}
+	FORCEINLINE int32 Num() const { return BucketOffsets.Num() - 1; }
 
-		if ((PartInfo.type == HAPI_PARTTYPE_MESH) && (PartInfo.faceCount <= 0))  // Point cloud
-		{
-			FPCGTaggedData TaggedData;
-#if ((ENGINE_MAJOR_VERSION == 5) && (ENGINE_MINOR_VERSION >= 6)) || (ENGINE_MAJOR_VERSION > 5)
-			UPCGPointArrayData* PointData = NewObject<UPCGPointArrayData>(PCGDA);
-			TaggedData.Data = PointData;
+	FORCEINLINE int32 GetBucketIdx(const int32& PointIdx) const { return PointBucketIndices.IsEmpty() ? 0 : PointBucketIndices[PointIdx]; }
 
-			HOUDINI_FAIL_RETURN(HapiGetTags(NodeId, PartId,
-				FHoudiniEngineUtils::QueryAttributeOwner(AttribNames, PartInfo.attributeCounts, HAPI_ATTRIB_UNREAL_PCG_TAGS), TaggedData.Tags));
+	FORCEINLINE int32 GetLocalIdx(const int32& PointIdx) const { return PointLocalIndices.IsEmpty() ? PointIdx : PointLocalIndices[PointIdx]; }
 
-			const int32& PointCount = PartInfo.pointCount;
-			PointData->SetNumPoints(PointCount);
-			{  // Transform
-				TArray<HAPI_Transform> HapiTransforms;
-				HapiTransforms.SetNumUninitialized(PointCount);
-				if (PartInfo.instancedPartCount >= 1)
-					HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetInstancerPartTransforms(FHoudiniEngine::Get().GetSession(), NodeId, PartId,
-						HAPI_SRT, HapiTransforms.GetData(), 0, PointCount))
-				else
-					HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetInstanceTransformsOnPart(FHoudiniEngine::Get().GetSession(), NodeId, PartId,
-						HAPI_SRT, HapiTransforms.GetData(), 0, PointCount))
+	FORCEINLINE int32 GetBucketPointCount(const int32& BucketIdx) const { return BucketOffsets[BucketIdx + 1] - BucketOffsets[BucketIdx]; }
 
-				TPCGValueRange<FTransform> Transforms = PointData->GetTransformValueRange();
-				for (int32 PointIdx = 0; PointIdx < PointCount; ++PointIdx)
-				{
-					const HAPI_Transform& HapiTransform = HapiTransforms[PointIdx];
-					FTransform& Transform = Transforms[PointIdx];
-					Transform.SetLocation(FVector(HapiTransform.position[0], HapiTransform.position[2], HapiTransform.position[1]) * POSITION_SCALE_TO_UNREAL_F);
-					Transform.SetRotation(FQuat(HapiTransform.rotationQuaternion[0], HapiTransform.rotationQuaternion[2], HapiTransform.rotationQuaternion[1], -HapiTransform.rotationQuaternion[3]));
-					Transform.SetScale3D(FVector(HapiTransform.scale[0], HapiTransform.scale[2], HapiTransform.scale[1]));
-				}
-			}
+	FORCEINLINE int32 GetFirstPointIdx(const int32& BucketIdx) const { return SortedPointIndices.IsEmpty() ? 0 : SortedPointIndices[BucketOffsets[BucketIdx]]; }
+
+	FORCEINLINE FHoudiniPCGAttributeTarget MakeTarget(FHoudiniPCGMetadata* Metadata, const int32& BucketIdx) const
+	{
+		return FHoudiniPCGAttributeTarget(Metadata, BucketOffsets[BucketIdx], GetBucketPointCount(BucketIdx), false,
+			SortedPointIndices.IsEmpty() ? nullptr : SortedPointIndices.GetData());
+	}
+};
+
+void FHoudiniPCGPointBuckets::Build(const int32& PointCount)
+{
+	PointBucketIndices.Reset();
+	PointLocalIndices.Reset();
+	SortedPointIndices.Reset();
 
-			if (FHoudiniEngineUtils::IsAttributeExists(AttribNames, PartInfo.attributeCounts, HAPI_ATTRIB_DENSITY, HAPI_ATTROWNER_POINT))  // f@density
+	// -------- Keys to bucket indices, combine key columns one by one, so that combined keys never overflow --------
+	int32 NumBuckets = 1;
+	for (const TPair<const TArray<int32>*, int32>& KeyColumn : KeyColumns)
+	{
+		const TArray<int32>& LocalIndices = *KeyColumn.Key;
+		const int32& NumKeys = KeyColumn.Value;
+		if ((NumKeys <= 1) || (LocalIndices.Num() != PointCount))
+			continue;
+
+		const bool bFirstColumn = PointBucketIndices.IsEmpty();
+		if (bFirstColumn)
+			PointBucketIndices.SetNumUninitialized(PointCount);
+		auto GetKeyLambda = [&](const int32& PointIdx) -> int64
 			{
-				HAPI_AttributeOwner Owner = HAPI_ATTROWNER_POINT;
-				TArray<float> Data;
-				HOUDINI_FAIL_RETURN(FHoudiniEngineUtils::HapiGetFloatAttributeData(NodeId, PartId, HAPI_ATTRIB_DENSITY, 1, Data, Owner));
-				TPCGValueRange<float> Densities = PointData->GetDensityValueRange();
-				for (int32 PointIdx = 0; PointIdx < PointCount; ++PointIdx)
-					Densities[PointIdx] = Data[PointIdx];
-			}
+				return (bFirstColumn ? 0 : int64(PointBucketIndices[PointIdx])) * NumKeys + LocalIndices[PointIdx];
+			};
 
+		const int64 NumCombinedKeys = int64(NumBuckets) * NumKeys;
+		NumBuckets = 0;
+		if (NumCombinedKeys <= PointCount)  // Dense keys, buckets are in the order of first appearance
+		{
+			TArray<int32> KeyBuckets;
+			KeyBuckets.Init(-1, int32(NumCombinedKeys));
+			for (int32 PointIdx = 0; PointIdx < PointCount; ++PointIdx)
 			{
-				TArray<float> ColorData;
-				if (FHoudiniEngineUtils::IsAttributeExists(AttribNames, PartInfo.attributeCounts, HAPI_ATTRIB_COLOR, HAPI_ATTROWNER_POINT))  // v@Cd
-				{
-					HAPI_AttributeOwner Owner = HAPI_ATTROWNER_POINT;
-					HOUDINI_FAIL_RETURN(FHoudiniEngineUtils::HapiGetFloatAttributeData(NodeId, PartId, HAPI_ATTRIB_COLOR, 3, ColorData, Owner));
-				}
-				TArray<float> AlphaData;
-				if (FHoudiniEngineUtils::IsAttributeExists(AttribNames, PartInfo.attributeCounts, HAPI_ALPHA, HAPI_ATTROWNER_POINT))  // f@Alpha
+				int32& BucketIdx = KeyBuckets[int32(GetKeyLambda(PointIdx))];
+				if (BucketIdx < 0)
+					BucketIdx = NumBuckets++;
+				PointBucketIndices[PointIdx] = BucketIdx;
+			}
+		}
+		else  // Sparse combinations, buckets are in the order of keys
+		{
+			TArray<int64> Keys;
+			Keys.SetNumUninitialized(PointCount);
+			FHoudiniPCGUtils::ParallelForBatch(PointCount, [&](const int32& StartIdx, const int32& EndIdx)
 				{
-					HAPI_AttributeOwner Owner = HAPI_ATTROWNER_POINT;
-					HOUDINI_FAIL_RETURN(FHoudiniEngineUtils::HapiGetFloatAttributeData(NodeId, PartId, HAPI_ALPHA, 1, AlphaData, Owner));
-				}
-				if (!ColorData.IsEmpty() && !AlphaData.IsEmpty())
+					for (int32 PointIdx = StartIdx; PointIdx < EndIdx; ++PointIdx)
+						Keys[PointIdx] = GetKeyLambda(PointIdx);
+				});
+			TArray<int64> UniqueKeys(Keys);
+			UniqueKeys.Sort();
+			UniqueKeys.SetNum(Algo::Unique(UniqueKeys));
+			NumBuckets = UniqueKeys.Num();
+			FHoudiniPCGUtils::ParallelForBatch(PointCount, [&](const int32& StartIdx, const int32& EndIdx)
 				{
-					TPCGValueRange<FVector4> Colors = PointData->GetColorValueRange();
-					for (int32 PointIdx = 0; PointIdx < PointCount; ++PointIdx)
+					for (int32 PointIdx = StartIdx; PointIdx < EndIdx; ++PointIdx)
+						PointBucketIndices[PointIdx] = Algo::BinarySearch(UniqueKeys, Keys[PointIdx]);
+				});
+		}
+	}
+	KeyColumns.Reset();
+
+	if (NumBuckets <= 1)
+	{
+		PointBucketIndices.Reset();
+		BucketOffsets = { 0, PointCount };
+		return;
+	}
+
+	// -------- Counting sort, stable, so that points keep their houdini order in each bucket --------
+	// Each batch counts its own points, then scatters them from its own offsets, fall back to a single batch if there are too many buckets
+	const int32 NumBatches = (int64(FMath::DivideAndRoundUp(PointCount, HOUDINI_PCG_PARALLEL_BATCH_SIZE)) * NumBuckets <= PointCount) ?
+		FMath::DivideAndRoundUp(PointCount, HOUDINI_PCG_PARALLEL_BATCH_SIZE) : 1;
+	auto ForEachBatchLambda = [&](TFunctionRef<void(const int32& BatchIdx, const int32& StartIdx, const int32& EndIdx)> BatchFunc)
+		{
+			if (NumBatches <= 1)
+				BatchFunc(0, 0, PointCount);
+			else
+				FHoudiniPCGUtils::ParallelForBatch(PointCount, [&](const int32& StartIdx, const int32& EndIdx)
 					{
-						FVector4& Color = Colors[PointIdx];
-						if (!ColorData.IsEmpty())
-						{
-							Color.X = ColorData[PointIdx * 3];
-							Color.Y = ColorData[PointIdx * 3 + 1];
-							Color.Z = ColorData[PointIdx * 3 + 2];
-						}
-						if (!AlphaData.IsEmpty())
-							Color.W = AlphaData[PointIdx];
-					}
-				}
+						BatchFunc(StartIdx / HOUDINI_PCG_PARALLEL_BATCH_SIZE, StartIdx, EndIdx);
+					});
+		};
+
+	TArray<int32> BatchOffsets;  // BatchOffsets[BatchIdx * NumBuckets + BucketIdx]
+	BatchOffsets.SetNumZeroed(NumBatches * NumBuckets);
+	ForEachBatchLambda([&](const int32& BatchIdx, const int32& StartIdx, const int32& EndIdx)
+		{
+			int32* Counts = BatchOffsets.GetData() + BatchIdx * NumBuckets;
+			for (int32 PointIdx = StartIdx; PointIdx < EndIdx; ++PointIdx)
+				++Counts[PointBucketIndices[PointIdx]];
+		});
+
+	BucketOffsets.SetNumUninitialized(NumBuckets + 1);
+	int32 Offset = 0;
+	for (int32 BucketIdx = 0; BucketIdx < NumBuckets; ++BucketIdx)
+	{
+		BucketOffsets[BucketIdx] = Offset;
+		for (int32 BatchIdx = 0; BatchIdx < NumBatches; ++BatchIdx)  // Counts to local offsets
+		{
+			int32& BatchOffset = BatchOffsets[BatchIdx * NumBuckets + BucketIdx];
+			const int32 Count = BatchOffset;
+			BatchOffset = Offset - BucketOffsets[BucketIdx];
+			Offset += Count;
+		}
+	}
+	BucketOffsets[NumBuckets] = Offset;
+
+	PointLocalIndices.SetNumUninitialized(PointCount);
+	SortedPointIndices.SetNumUninitialized(PointCount);
+	ForEachBatchLambda([&](const int32& BatchIdx, const int32& StartIdx, const int32& EndIdx)
+		{
+			int32* LocalOffsets = BatchOffsets.GetData() + BatchIdx * NumBuckets;
+			for (int32 PointIdx = StartIdx; PointIdx < EndIdx; ++PointIdx)
+			{
+				const int32& BucketIdx = PointBucketIndices[PointIdx];
+				const int32 LocalIdx = LocalOffsets[BucketIdx]++;
+				PointLocalIndices[PointIdx] = LocalIdx;
+				SortedPointIndices[BucketOffsets[BucketIdx] + LocalIdx] = PointIdx;
+			}
+		});
+}
+
+static FORCEINLINE uint64 SpreadMortonBits(uint64 Value)  // 21 bits, each followed by two zero bits
+{
+	Value &= 0x1FFFFF;
+	Value = (Value | (Value << 32)) & 0x1F00000000FFFF;
+	Value = (Value | (Value << 16)) & 0x1F0000FF0000FF;
+	Value = (Value | (Value << 8)) & 0x100F00F00F00F00F;
+	Value = (Value | (Value << 4)) & 0x10C30C30C30C30C3;
+	Value = (Value | (Value << 2)) & 0x1249249249249249;
+	return Value;
+}
+
+void FHoudiniPCGPointBuckets::SortSpatially(const int32& PointCount, TFunctionRef<FVector(const int32&)> GetPositionFunc)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(HoudiniPCGSortPointsSpatially);
+
+	if (PointCount <= 1)
+		return;
+
+	if (SortedPointIndices.IsEmpty())  // Single bucket, points are in houdini order
+	{
+		SortedPointIndices.SetNumUninitialized(PointCount);
+		for (int32 PointIdx = 0; PointIdx < PointCount; ++PointIdx)
+			SortedPointIndices[PointIdx] = PointIdx;
+		PointLocalIndices.SetNumUninitialized(PointCount);
+	}
+
+	// -------- Part bounds, each batch bounds its own points --------
+	TArray<FBox> BatchBounds;
+	BatchBounds.Init(FBox(ForceInit), FMath::DivideAndRoundUp(PointCount, HOUDINI_PCG_PARALLEL_BATCH_SIZE));
+	FHoudiniPCGUtils::ParallelForBatch(PointCount, [&](const int32& StartIdx, const int32& EndIdx)
+		{
+			FBox& Bounds = BatchBounds[StartIdx / HOUDINI_PCG_PARALLEL_BATCH_SIZE];
+			for (int32 PointIdx = StartIdx; PointIdx < EndIdx; ++PointIdx)
+				Bounds += GetPositionFunc(PointIdx);
+		});
+	FBox PartBounds(ForceInit);
+	for (const FBox& Bounds : BatchBounds)
+		PartBounds += Bounds;
+
+	// -------- Morton codes, a shared grid keeps the order of points in different buckets consistent --------
+	const FVector CellScale = FVector(double(0x1FFFFF)) / PartBounds.GetSize().ComponentMax(FVector(UE_DOUBLE_KINDA_SMALL_NUMBER));
+	TArray<uint64> Codes;
+	Codes.SetNumUninitialized(PointCount);
+	const FHoudiniPCGTransientBytesScope TransientBytesScope(false, Codes.GetAllocatedSize());
+	FHoudiniPCGUtils::ParallelForBatch(PointCount, [&](const int32& StartIdx, const int32& EndIdx)
+		{
+			for (int32 PointIdx = StartIdx; PointIdx < EndIdx; ++PointIdx)
+			{
+				const FVector Cell = ((GetPositionFunc(PointIdx) - PartBounds.Min) * CellScale).BoundToBox(FVector::ZeroVector, FVector(double(0x1FFFFF)));
+				Codes[PointIdx] = SpreadMortonBits(uint64(Cell.X)) | (SpreadMortonBits(uint64(Cell.Y)) << 1) | (SpreadMortonBits(uint64(Cell.Z)) << 2);
 			}
+		});
+
+	// -------- Sort each bucket, ties keep houdini order so that the result is deterministic --------
+	const int32 NumBuckets = Num();
+	ParallelFor(NumBuckets, [&](int32 BucketIdx)
+		{
+			MakeArrayView(SortedPointIndices.GetData() + BucketOffsets[BucketIdx], GetBucketPointCount(BucketIdx)).Sort(
+				[&Codes](const int32& A, const int32& B) { return (Codes[A] < Codes[B]) || ((Codes[A] == Codes[B]) && (A < B)); });
+		}, (NumBuckets <= 1) ? EParallelForFlags::ForceSingleThread : EParallelForFlags::Unbalanced);
+
+	FHoudiniPCGUtils::ParallelForBatch(PointCount, [&](const int32& StartIdx, const int32& EndIdx)
+		{
+			for (int32 SortedIdx = StartIdx; SortedIdx < EndIdx; ++SortedIdx)
+			{
+				const int32& PointIdx = SortedPointIndices[SortedIdx];
+				PointLocalIndices[PointIdx] = SortedIdx - BucketOffsets[GetBucketIdx(PointIdx)];
+			}
+		});
+}
+
+namespace HoudiniPCGDataOutputUtils
+{
+	template<typename HapiValueType, typename ValueType, typename GetAttribValueHapi>
+	static bool HapiCreateNumericPCGAttribute(const int32& NodeId, const int32& PartId, const FHoudiniPCGPartSchema& Schema, const int32& AttribIdx,
+		HAPI_AttributeInfo& AttribInfo, const std::string& AttribNameStr, GetAttribValueHapi GetAttribValueHapiFunc,
+		const TArray<FHoudiniPCGAttributeTarget>& Targets, const FName& AttribName, const ValueType& DefaultValue, FHoudiniPCGOutputScratch& Scratch);
+
+	template<typename HapiValueType, typename ValueType, typename GetAttribValueHapi>
+	static bool HapiCreateNumericPCGAttribute(const int32& NodeId, const int32& PartId, const FHoudiniPCGPartSchema& Schema, const int32& AttribIdx,
+		HAPI_AttributeInfo& AttribInfo, const std::string& AttribNameStr, GetAttribValueHapi GetAttribValueHapiFunc, TFunctionRef<ValueType(const HapiValueType*, const int32&)> ConvertFunc,
+		const TArray<FHoudiniPCGAttributeTarget>& Targets, const FName& AttribName, const ValueType& DefaultValue, FHoudiniPCGOutputScratch& Scratch);
+
+	template<typename ValueType>
+	static void SetPCGAttributeValues(const TArray<FHoudiniPCGAttributeTarget>& Targets, const FName& AttribName, const ValueType& DefaultValue,
+		const ValueType* Values, FHoudiniPCGOutputScratch& Scratch);
+
+	template<typename ValueType>
+	static void CreateStringPCGAttribute(const FHoudiniPCGStringAttribute& StringAttrib, TFunctionRef<ValueType(const int32&)> GetValueFunc,
+		FHoudiniPCGOutputScratch& Scratch);
+
+	static void CreateStringPCGAttribute(const FHoudiniPCGStringAttribute& StringAttrib, FHoudiniPCGStringCache& StringCache,
+		FHoudiniPCGOutputScratch& Scratch);
+
+	static FHoudiniPCGMetadata* GetElementsMetadata(UPCGMetadata* Metadata);
+
+	static FHoudiniPCGAttributeTarget MakeDataTarget(UPCGMetadata* Metadata, const int32& ElemIdx);  // Data domain if supported, otherwise default value
+
+	// Retrieve all unreal_pcg_attribute_* on Owner, string attributes will be appended to OutStringAttribs
+	static bool HapiRetrievePCGAttributes(const int32& NodeId, const HAPI_PartInfo& PartInfo, FHoudiniPCGPartSchema& Schema,
+		const HAPI_AttributeOwner& Owner, const TArray<FHoudiniPCGAttributeTarget>& Targets,
+		FHoudiniPCGOutputScratch& Scratch, FHoudiniPCGStringCache& StringCache, TArray<FHoudiniPCGStringAttribute>& OutStringAttribs);
+
+	// OutStride will be TupleSize on point, 0 on detail, and OutData will be empty if attrib not found or NOT match TupleSize
+	static bool HapiRetrievePointFloatData(const int32& NodeId, const HAPI_PartInfo& PartInfo, FHoudiniPCGPartSchema& Schema,
+		const char* AttribName, const int32& TupleSize, TArray<float>& OutData, int32& OutStride);
+
+	// Same as HapiRetrievePointFloatData, but views the data prefetched by Schema if any, otherwise retrieves to OutStorage, so both MUST outlive OutData
+	static bool HapiGetPointFloatData(const int32& NodeId, const HAPI_PartInfo& PartInfo, FHoudiniPCGPartSchema& Schema,
+		const char* AttribName, const int32& TupleSize, TArray<float>& OutStorage, TConstArrayView<float>& OutData, int32& OutStride);
+
+	// s@AttribName on points, OutIndices will be empty if attrib not found, strings will NOT be available until StringCache.HapiConvertPending
+	static bool HapiRetrievePointStringIndices(const int32& NodeId, const HAPI_PartInfo& PartInfo, FHoudiniPCGPartSchema& Schema, const char* AttribName,
+		FHoudiniPCGOutputScratch& Scratch, FHoudiniPCGStringCache& StringCache, FHoudiniPCGStringIndices& OutIndices);
+
+	// f@unreal_pcg_partition_grid_size and i@unreal_pcg_partition_cell_assets on detail, OutGridSize will be 0 if NOT tiled
+	static bool HapiGetPartitionSettings(const int32& NodeId, const int32& PartId, FHoudiniPCGPartSchema& Schema, double& OutGridSize, bool& bOutCellAssets);
+
+	// Retrieve raw attributes that HapiRetrievePointTransforms will use into Schema, run on a worker, so Schema must NOT be accessed by others until finished
+	static void HapiPrefetchPointTransformData(const int32& NodeId, const HAPI_PartInfo& PartInfo, FHoudiniPCGPartSchema& Schema);
+
+	// Retrieve raw numeric unreal_pcg_attribute_* on points, prims and detail into Schema, that HapiRetrievePCGAttributes will use, also run on a worker
+	static void HapiPrefetchPCGAttributeData(const int32& NodeId, const HAPI_PartInfo& PartInfo, FHoudiniPCGPartSchema& Schema);
+
+	// Same as PCG 2D grid, OutCellIndices[ElemIdx] is the index of OutCells, cells are sorted
+	static void BinToPartitionCells(const int32& NumElems, TFunctionRef<FVector2D(const int32&)> GetPositionFunc, const double& GridSize,
+		TArray<int32>& OutCellIndices, TArray<FIntPoint>& OutCells);
+
+	static FString GetPartitionCellName(const FIntPoint& Cell);  // As both the tag and the asset name suffix
+
+	static FString GetPartitionCellObjectPath(const FString& IndexObjectPath, const FIntPoint& Cell);
+
+	static FString GetAssetObjectPath(const FString& ObjectPath);  // "/Game/Foo" or "/Game/Foo.Foo" -> "/Game/Foo.Foo", as the key of previews
+
+	// One point per cell, bounds are the cell, and s@DataAsset is the cell asset
+	static UPCGData* CreatePartitionIndexData(UObject* Outer, const FHoudiniPCGPartitionIndex& PartitionIndex);
+
+	// Build transforms from raw @P, p@orient, p@rot, f@pscale, v@scale, v@N and v@up, bOutRetrieved will be false if houdini should evaluate them (trans, pivot, etc.)
+	static bool HapiRetrievePointTransforms(const int32& NodeId, const HAPI_PartInfo& PartInfo, FHoudiniPCGPartSchema& Schema,
+		TFunctionRef<FTransform&(const int32&)> GetTransformFunc, bool& bOutRetrieved);
+
+#if ((ENGINE_MAJOR_VERSION == 5) && (ENGINE_MINOR_VERSION >= 5)) || (ENGINE_MAJOR_VERSION > 5)
+	// Elements are per houdini vertex if bOnVertex, otherwise per point
+	template<typename ElementValueType, typename OverlayType>
+	static void SetDynamicMeshOverlay(OverlayType* Overlay, const bool& bOnVertex, const TArray<int32>& Vertices, const TArray<int32>& PointRemap,
+		const TArray<UE::Geometry::FIndex3i>& TriVertices, const TArray<int32>& TriIds, TFunctionRef<ElementValueType(const int32&)> GetValueFunc);
+
+	// Fan triangulate all polygons, and retrieve v@N, v@uv, v@Cd, f@Alpha and s@unreal_material, tags should be retrieved before, as StringCache will be converted here
+	static bool HapiRetrieveDynamicMesh(const int32& NodeId, const HAPI_PartInfo& PartInfo, FHoudiniPCGPartSchema& Schema,
+		FHoudiniPCGStringCache& StringCache, UE::Geometry::FDynamicMesh3& OutDM, TArray<UMaterialInterface*>& OutMaterials);
+#endif
+}
+
+template<typename HapiValueType, typename ValueType, typename GetAttribValueHapi>
+static bool HoudiniPCGDataOutputUtils::HapiCreateNumericPCGAttribute(const int32& NodeId, const int32& PartId, const FHoudiniPCGPartSchema& Schema, const int32& AttribIdx,
+	HAPI_AttributeInfo& AttribInfo, const std::string& AttribNameStr, GetAttribValueHapi GetAttribValueHapiFunc,
+	const TArray<FHoudiniPCGAttributeTarget>& Targets, const FName& AttribName, const ValueType& DefaultValue, FHoudiniPCGOutputScratch& Scratch)
+{
+	static_assert(sizeof(HapiValueType) * (sizeof(ValueType) / sizeof(HapiValueType)) == sizeof(ValueType), "PCG value MUST be a tuple of houdini values");
+
+	const HapiValueType* Data = (const HapiValueType*)Schema.FindPrefetchedAttribData(AttribIdx, AttribInfo.storage,
+		int64(AttribInfo.count) * AttribInfo.tupleSize * sizeof(HapiValueType));
+	if (!Data)
+	{
+		HapiValueType* HapiData = Scratch.GetHapiBuffer<HapiValueType>(AttribInfo.count * AttribInfo.tupleSize);
+		HOUDINI_PCG_HAPI_CALL_SCOPE(false, AttribInfo.count * AttribInfo.tupleSize * sizeof(HapiValueType));
+		HAPI_SESSION_FAIL_RETURN(GetAttribValueHapiFunc(Schema.GetSession(), NodeId, PartId,
+			AttribNameStr.c_str(), &AttribInfo, -1, HapiData, 0, AttribInfo.count));
+		Data = HapiData;
+	}
+	SetPCGAttributeValues<ValueType>(Targets, AttribName, DefaultValue, (const ValueType*)Data, Scratch);
+
+	return true;
+}
+
+template<typename HapiValueType, typename ValueType, typename GetAttribValueHapi>
+static bool HoudiniPCGDataOutputUtils::HapiCreateNumericPCGAttribute(const int32& NodeId, const int32& PartId, const FHoudiniPCGPartSchema& Schema, const int32& AttribIdx,
+	HAPI_AttributeInfo& AttribInfo, const std::string& AttribNameStr, GetAttribValueHapi GetAttribValueHapiFunc, TFunctionRef<ValueType(const HapiValueType*, const int32&)> ConvertFunc,
+	const TArray<FHoudiniPCGAttributeTarget>& Targets, const FName& AttribName, const ValueType& DefaultValue, FHoudiniPCGOutputScratch& Scratch)
+{
+	const HapiValueType* Data = (const HapiValueType*)Schema.FindPrefetchedAttribData(AttribIdx, AttribInfo.storage,
+		int64(AttribInfo.count) * AttribInfo.tupleSize * sizeof(HapiValueType));
+	if (!Data)
+	{
+		HapiValueType* HapiData = Scratch.GetHapiBuffer<HapiValueType>(AttribInfo.count * AttribInfo.tupleSize);
+		HOUDINI_PCG_HAPI_CALL_SCOPE(false, AttribInfo.count * AttribInfo.tupleSize * sizeof(HapiValueType));
+		HAPI_SESSION_FAIL_RETURN(GetAttribValueHapiFunc(Schema.GetSession(), NodeId, PartId,
+			AttribNameStr.c_str(), &AttribInfo, -1, HapiData, 0, AttribInfo.count));
+		Data = HapiData;
+	}
+	ValueType* PCGData = Scratch.GetValueBuffer<ValueType>(AttribInfo.count);
+	FHoudiniPCGUtils::ParallelForBatch(AttribInfo.count, [&](const int32& StartIdx, const int32& EndIdx)
+		{
+			for (int32 ElemIdx = StartIdx; ElemIdx < EndIdx; ++ElemIdx)
+				PCGData[ElemIdx] = ConvertFunc(Data, ElemIdx * AttribInfo.tupleSize);
+		});
+	SetPCGAttributeValues<ValueType>(Targets, AttribName, DefaultValue, PCGData, Scratch);
+
+	return true;
+}
+
+template<typename ValueType>
+static void HoudiniPCGDataOutputUtils::SetPCGAttributeValues(const TArray<FHoudiniPCGAttributeTarget>& Targets, const FName& AttribName, const ValueType& DefaultValue,
+	const ValueType* Values, FHoudiniPCGOutputScratch& Scratch)
+{
+	LLM_SCOPE_BYTAG(HoudiniPCG_PCGData);
+
+	for (const FHoudiniPCGAttributeTarget& Target : Targets)
+	{
+		if (Target.Metadata->HasAttribute(AttribName))  // Attribs on lower owner take precedence
+			continue;
+
+		if (Target.bDefaultValueOnly)
+		{
+			Target.Metadata->CreateAttribute<ValueType>(AttribName, Values[Target.GetElemIdx(0)], true, true);
+			continue;
+		}
+
+		const ValueType* TargetValues = Values + Target.StartIdx;
+		if (Target.ElemIndices)  // Elements of this target are scattered, gather them first
+		{
+			ValueType* GatheredValues = Scratch.GetGatherBuffer<ValueType>(Target.Num);
+			FHoudiniPCGUtils::ParallelForBatch(Target.Num, [&](const int32& StartIdx, const int32& EndIdx)
+				{
+					for (int32 EntryIdx = StartIdx; EntryIdx < EndIdx; ++EntryIdx)
+						GatheredValues[EntryIdx] = Values[Target.ElemIndices[Target.StartIdx + EntryIdx]];
+				});
+			TargetValues = GatheredValues;
+		}
+
+		FPCGMetadataAttribute<ValueType>* Attrib = Target.Metadata->CreateAttribute<ValueType>(AttribName, DefaultValue, true, true);
+		Attrib->SetValues(Scratch.GetIdentityEntryKeys(Target.Num), TArrayView<const ValueType>(TargetValues, Target.Num));
+	}
+}
+
+template<typename ValueType>
+static void HoudiniPCGDataOutputUtils::CreateStringPCGAttribute(const FHoudiniPCGStringAttribute& StringAttrib, TFunctionRef<ValueType(const int32&)> GetValueFunc,
+	FHoudiniPCGOutputScratch& Scratch)
+{
+	LLM_SCOPE_BYTAG(HoudiniPCG_PCGData);
+
+	const TArray<int32>& LocalIndices = StringAttrib.Indices.LocalIndices;
+	const TArray<int32>& UniqueSlots = StringAttrib.Indices.UniqueSlots;
+	TArray<PCGMetadataValueKey> UniqueValueKeys;
+	for (const FHoudiniPCGAttributeTarget& Target : StringAttrib.Targets)
+	{
+		if (Target.Metadata->HasAttribute(StringAttrib.Name))  // Attribs on lower owner take precedence
+			continue;
+
+		if (Target.bDefaultValueOnly)
+		{
+			Target.Metadata->CreateAttribute<ValueType>(StringAttrib.Name, GetValueFunc(UniqueSlots[LocalIndices[Target.GetElemIdx(0)]]), true, true);
+			continue;
+		}
+
+		FPCGMetadataAttribute<ValueType>* Attrib = Target.Metadata->CreateAttribute<ValueType>(StringAttrib.Name, ValueType(), true, true);
+		PCGMetadataValueKey* ValueKeys = Scratch.GetValueBuffer<PCGMetadataValueKey>(Target.Num);
+		if (Target.Num < UniqueSlots.Num())  // Only a few elements, such as a single spline
+		{
+			for (int32 ElemIdx = 0; ElemIdx < Target.Num; ++ElemIdx)
+				ValueKeys[ElemIdx] = Attrib->AddValue(GetValueFunc(UniqueSlots[LocalIndices[Target.GetElemIdx(ElemIdx)]]));
+		}
+		else  // Only add values for unique strings, then map elements to value keys
+		{
+			UniqueValueKeys.SetNumUninitialized(UniqueSlots.Num());
+			for (int32 UniqueIdx = 0; UniqueIdx < UniqueSlots.Num(); ++UniqueIdx)
+				UniqueValueKeys[UniqueIdx] = Attrib->AddValue(GetValueFunc(UniqueSlots[UniqueIdx]));
+
+			FHoudiniPCGUtils::ParallelForBatch(Target.Num, [&](const int32& StartIdx, const int32& EndIdx)
+				{
+					for (int32 ElemIdx = StartIdx; ElemIdx < EndIdx; ++ElemIdx)
+						ValueKeys[ElemIdx] = UniqueValueKeys[LocalIndices[Target.GetElemIdx(ElemIdx)]];
+				});
+		}
+		Attrib->SetValuesFromValueKeys(Scratch.GetIdentityEntryKeys(Target.Num), TArrayView<const PCGMetadataValueKey>(ValueKeys, Target.Num));
+	}
+}
+
+static void HoudiniPCGDataOutputUtils::CreateStringPCGAttribute(const FHoudiniPCGStringAttribute& StringAttrib, FHoudiniPCGStringCache& StringCache,
+	FHoudiniPCGOutputScratch& Scratch)
+{
+	if (StringAttrib.Indices.UniqueSlots.IsEmpty())
+		return;
+
+	if (!IS_ASSET_PATH_INVALID(StringCache.GetString(StringAttrib.Indices.UniqueSlots[0])))  // SoftObjectPath
+		CreateStringPCGAttribute<FSoftObjectPath>(StringAttrib, [&](const int32& Slot) { return StringCache.GetObjectPath(Slot); }, Scratch);
+	else  // String
+		CreateStringPCGAttribute<FString>(StringAttrib, [&](const int32& Slot) { return StringCache.GetString(Slot); }, Scratch);
+}
+
+static FHoudiniPCGMetadata* HoudiniPCGDataOutputUtils::GetElementsMetadata(UPCGMetadata* Metadata)
+{
+#if ((ENGINE_MAJOR_VERSION == 5) && (ENGINE_MINOR_VERSION >= 6)) || (ENGINE_MAJOR_VERSION > 5)
+	return Metadata->GetMetadataDomain(EPCGMetadataDomainFlag::Elements);
 #else
-			UPCGPointData* PointData = NewObject<UPCGPointData>(PCGDA);
-			TaggedData.Data = PointData;
+	return Metadata;
+#endif
+}
+
+static FHoudiniPCGAttributeTarget HoudiniPCGDataOutputUtils::MakeDataTarget(UPCGMetadata* Metadata, const int32& ElemIdx)
+{
+#if ((ENGINE_MAJOR_VERSION == 5) && (ENGINE_MINOR_VERSION >= 6)) || (ENGINE_MAJOR_VERSION > 5)
+	if (FPCGMetadataDomain* DataDomain = Metadata->GetMetadataDomain(EPCGMetadataDomainFlag::Data))
+	{
+		if (DataDomain->GetItemCountForChild() <= 0)  // Data domain only has a single entry
+			DataDomain->AddEntry();
+		return FHoudiniPCGAttributeTarget(DataDomain, ElemIdx, 1);
+	}
+#endif
+	return FHoudiniPCGAttributeTarget(GetElementsMetadata(Metadata), ElemIdx, 1, true);
+}
 
-			HOUDINI_FAIL_RETURN(HapiGetTags(NodeId, PartId,
-				FHoudiniEngineUtils::QueryAttributeOwner(AttribNames, PartInfo.attributeCounts, HAPI_ATTRIB_UNREAL_PCG_TAGS), TaggedData.Tags));
+static bool HoudiniPCGDataOutputUtils::HapiRetrievePointFloatData(const int32& NodeId, const HAPI_PartInfo& PartInfo, FHoudiniPCGPartSchema& Schema,
+	const char* AttribName, const int32& TupleSize, TArray<float>& OutData, int32& OutStride)
+{
+	OutStride = 0;
 
-			const int32& PointCount = PartInfo.pointCount;
+	const HAPI_AttributeOwner Owner = Schema.QueryAttributeOwner(AttribName);
+	if ((Owner != HAPI_ATTROWNER_POINT) && (Owner != HAPI_ATTROWNER_DETAIL))  // Point cloud has no vertices or prims
+		return true;
 
-			TArray<FPCGPoint>& Points = PointData->GetMutablePoints();
-			Points.SetNum(PointCount);
-			{  // Transform
-				TArray<HAPI_Transform> HapiTransforms;
-				HapiTransforms.SetNumUninitialized(PointCount);
-				if (PartInfo.instancedPartCount >= 1)
-					HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetInstancerPartTransforms(FHoudiniEngine::Get().GetSession(), NodeId, PartId,
-						HAPI_SRT, HapiTransforms.GetData(), 0, PointCount))
-				else
-					HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetInstanceTransformsOnPart(FHoudiniEngine::Get().GetSession(), NodeId, PartId,
-						HAPI_SRT, HapiTransforms.GetData(), 0, PointCount))
+	HAPI_AttributeInfo AttribInfo;
+	HOUDINI_FAIL_RETURN(Schema.HapiGetAttributeInfo(AttribName, Owner, AttribInfo));
+	if (!AttribInfo.exists || (AttribInfo.tupleSize != TupleSize) ||
+		((AttribInfo.storage != HAPI_STORAGETYPE_FLOAT) && (AttribInfo.storage != HAPI_STORAGETYPE_FLOAT64)))
+		return true;
+
+	OutData.SetNumUninitialized(AttribInfo.count * TupleSize);
+	{
+		HOUDINI_PCG_HAPI_CALL_SCOPE(false, AttribInfo.count * AttribInfo.tupleSize * sizeof(float));
+		HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetAttributeFloatData(Schema.GetSession(), NodeId, PartInfo.id,
+			AttribName, &AttribInfo, -1, OutData.GetData(), 0, AttribInfo.count));
+	}
+	OutStride = (Owner == HAPI_ATTROWNER_POINT) ? TupleSize : 0;
+
+	return true;
+}
+
+static bool HoudiniPCGDataOutputUtils::HapiGetPointFloatData(const int32& NodeId, const HAPI_PartInfo& PartInfo, FHoudiniPCGPartSchema& Schema,
+	const char* AttribName, const int32& TupleSize, TArray<float>& OutStorage, TConstArrayView<float>& OutData, int32& OutStride)
+{
+	if (Schema.FindPrefetchedFloatData(AttribName, TupleSize, OutData, OutStride))
+		return true;
+
+	HOUDINI_FAIL_RETURN(HapiRetrievePointFloatData(NodeId, PartInfo, Schema, AttribName, TupleSize, OutStorage, OutStride));
+	OutData = OutStorage;
+	return true;
+}
+
+static void HoudiniPCGDataOutputUtils::HapiPrefetchPointTransformData(const int32& NodeId, const HAPI_PartInfo& PartInfo, FHoudiniPCGPartSchema& Schema)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(HoudiniPCGPrefetchPointTransformData);
+
+	// Same conditions as HapiRetrievePointTransforms, failures are ignored here, as game thread will retrieve again and report them
+	for (const char* HoudiniOnlyAttribName : { HAPI_ATTRIB_TRANS, HAPI_ATTRIB_PIVOT, HAPI_ATTRIB_TRANSFORM })
+	{
+		if (Schema.QueryAttributeOwner(HoudiniOnlyAttribName) != HAPI_ATTROWNER_INVALID)
+			return;
+	}
+
+	auto PrefetchLambda = [&](const char* AttribName, const int32& TupleSize) -> bool
+		{
+			TArray<float> Data;
+			int32 Stride = 0;
+			if (!HapiRetrievePointFloatData(NodeId, PartInfo, Schema, AttribName, TupleSize, Data, Stride))
+				return false;
 
-				for (int32 PointIdx = 0; PointIdx < PointCount; ++PointIdx)
+			const bool bFound = !Data.IsEmpty();
+			Schema.AddPrefetchedFloatData(AttribName, TupleSize, MoveTemp(Data), Stride);  // Also record NOT found, so that game thread need NOT query again
+			return bFound;
+		};
+
+	if (!PrefetchLambda(HAPI_ATTRIB_POSITION, 3))
+		return;
+
+	if (!PrefetchLambda(HAPI_ATTRIB_ORIENT, 4))  // N and up are only used when p@orient not exists
+	{
+		if (PrefetchLambda(HAPI_ATTRIB_NORMAL, 3))
+			PrefetchLambda(HAPI_ATTRIB_UP, 3);
+	}
+	PrefetchLambda(HAPI_ATTRIB_ROT, 4);
+	PrefetchLambda(HAPI_ATTRIB_PSCALE, 1);
+	PrefetchLambda(HAPI_ATTRIB_SCALE, 3);
+}
+
+static void HoudiniPCGDataOutputUtils::HapiPrefetchPCGAttributeData(const int32& NodeId, const HAPI_PartInfo& PartInfo, FHoudiniPCGPartSchema& Schema)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(HoudiniPCGPrefetchPCGAttributeData);
+
+	// Failures are ignored here, as game thread will retrieve again and report them
+	int32 AttribIdx = PartInfo.attributeCounts[HAPI_ATTROWNER_VERTEX];  // Vertex attributes will NOT be converted to PCG attributes
+	for (const HAPI_AttributeOwner Owner : { HAPI_ATTROWNER_POINT, HAPI_ATTROWNER_PRIM, HAPI_ATTROWNER_DETAIL })
+	{
+		for (int32 OwnerAttribIdx = 0; OwnerAttribIdx < PartInfo.attributeCounts[Owner]; ++OwnerAttribIdx, ++AttribIdx)
+		{
+			const std::string& AttribNameStr = Schema.AttribNames[AttribIdx];
+			if (!AttribNameStr.starts_with(HAPI_ATTRIB_PREFIX_UNREAL_PCG_ATTRIBUTE))
+				continue;
+
+			HAPI_AttributeInfo AttribInfo;
+			if (!Schema.HapiGetAttributeInfo(AttribNameStr.c_str(), Owner, AttribInfo) || !AttribInfo.exists || (AttribInfo.count <= 0))
+				continue;
+
+			TArray<uint8> Data;
+			auto HapiGetDataLambda = [&](auto GetAttribValueHapiFunc, auto* TypedNull) -> bool
 				{
-					const HAPI_Transform& HapiTransform = HapiTransforms[PointIdx];
-					FTransform& Transform = Points[PointIdx].Transform;
-					Transform.SetLocation(FVector(HapiTransform.position[0], HapiTransform.position[2], HapiTransform.position[1]) * POSITION_SCALE_TO_UNREAL_F);
-					Transform.SetRotation(FQuat(HapiTransform.rotationQuaternion[0], HapiTransform.rotationQuaternion[2], HapiTransform.rotationQuaternion[1], -HapiTransform.rotationQuaternion[3]));
-					Transform.SetScale3D(FVector(HapiTransform.scale[0], HapiTransform.scale[2], HapiTransform.scale[1]));
-					Points[PointIdx].MetadataEntry = PointIdx;  // Must add entry for attribute reader
-				}
+					using HapiValueType = std::remove_pointer_t<decltype(TypedNull)>;
+					Data.SetNumUninitialized(AttribInfo.count * AttribInfo.tupleSize * sizeof(HapiValueType));
+					HOUDINI_PCG_HAPI_CALL_SCOPE(false, Data.Num());
+					return GetAttribValueHapiFunc(Schema.GetSession(), NodeId, PartInfo.id,
+						AttribNameStr.c_str(), &AttribInfo, -1, (HapiValueType*)Data.GetData(), 0, AttribInfo.count) == HAPI_RESULT_SUCCESS;
+				};
+
+			bool bSucceeded = false;
+			switch (AttribInfo.storage)  // Same as HapiRetrievePCGAttributes, strings are NOT prefetched, as handles must be converted by game thread
+			{
+			case HAPI_STORAGETYPE_INT: bSucceeded = HapiGetDataLambda(FHoudiniApi::GetAttributeIntData, (int32*)nullptr); break;
+			case HAPI_STORAGETYPE_INT64: bSucceeded = HapiGetDataLambda(FHoudiniApi::GetAttributeInt64Data, (HAPI_Int64*)nullptr); break;
+			case HAPI_STORAGETYPE_FLOAT: bSucceeded = HapiGetDataLambda(FHoudiniApi::GetAttributeFloatData, (float*)nullptr); break;
+			case HAPI_STORAGETYPE_FLOAT64: bSucceeded = HapiGetDataLambda(FHoudiniApi::GetAttributeFloat64Data, (double*)nullptr); break;
+			case HAPI_STORAGETYPE_UINT8: if (AttribInfo.tupleSize == 1) { bSucceeded = HapiGetDataLambda(FHoudiniApi::GetAttributeUInt8Data, (uint8*)nullptr); } break;
+			case HAPI_STORAGETYPE_INT8: if (AttribInfo.tupleSize == 1) { bSucceeded = HapiGetDataLambda(FHoudiniApi::GetAttributeInt8Data, (int8*)nullptr); } break;
+			case HAPI_STORAGETYPE_INT16: if (AttribInfo.tupleSize == 1) { bSucceeded = HapiGetDataLambda(FHoudiniApi::GetAttributeInt16Data, (int16*)nullptr); } break;
+			default: break;
 			}
 
-			if (FHoudiniEngineUtils::IsAttributeExists(AttribNames, PartInfo.attributeCounts, HAPI_ATTRIB_DENSITY, HAPI_ATTROWNER_POINT))  // f@density
+			if (bSucceeded)
+				Schema.AddPrefetchedAttribData(AttribIdx, AttribInfo.storage, MoveTemp(Data));
+		}
+	}
+}
+
+static bool HoudiniPCGDataOutputUtils::HapiRetrievePointStringIndices(const int32& NodeId, const HAPI_PartInfo& PartInfo, FHoudiniPCGPartSchema& Schema, const char* AttribName,
+	FHoudiniPCGOutputScratch& Scratch, FHoudiniPCGStringCache& StringCache, FHoudiniPCGStringIndices& OutIndices)
+{
+	OutIndices.LocalIndices.Reset();
+	OutIndices.UniqueSlots.Reset();
+
+	HAPI_AttributeInfo AttribInfo;
+	HOUDINI_FAIL_RETURN(Schema.HapiGetAttributeInfo(AttribName, HAPI_ATTROWNER_POINT, AttribInfo));
+	if (!AttribInfo.exists || (AttribInfo.count <= 0) || (AttribInfo.storage != HAPI_STORAGETYPE_STRING))
+		return true;
+
+	HAPI_StringHandle* SHs = Scratch.GetHapiBuffer<HAPI_StringHandle>(AttribInfo.count);
+	{
+		HOUDINI_PCG_HAPI_CALL_SCOPE(false, AttribInfo.count * sizeof(HAPI_StringHandle));
+		HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetAttributeStringData(Schema.GetSession(), NodeId, PartInfo.id,
+			AttribName, &AttribInfo, SHs, 0, AttribInfo.count));
+	}
+	StringCache.AddHandles(TConstArrayView<HAPI_StringHandle>(SHs, AttribInfo.count), OutIndices);
+
+	return true;
+}
+
+static bool HoudiniPCGDataOutputUtils::HapiGetPartitionSettings(const int32& NodeId, const int32& PartId, FHoudiniPCGPartSchema& Schema, double& OutGridSize, bool& bOutCellAssets)
+{
+	OutGridSize = 0.0;
+	bOutCellAssets = false;
+
+	if (!Schema.IsAttributeExists(HAPI_ATTRIB_UNREAL_PCG_PARTITION_GRID_SIZE, HAPI_ATTROWNER_DETAIL))
+		return true;
+
+	TArray<float> GridSizeData;
+	HOUDINI_FAIL_RETURN(Schema.HapiGetFloatData(HAPI_ATTRIB_UNREAL_PCG_PARTITION_GRID_SIZE, HAPI_ATTROWNER_DETAIL, 1, GridSizeData));
+	if (GridSizeData.IsEmpty() || (GridSizeData[0] <= 0.0f))
+		return true;
+
+	OutGridSize = GridSizeData[0];
+	if (Schema.IsAttributeExists(HAPI_ATTRIB_UNREAL_PCG_PARTITION_CELL_ASSETS, HAPI_ATTROWNER_DETAIL))
+	{
+		TArray<int8> CellAssetsData;
+		HOUDINI_FAIL_RETURN(Schema.HapiGetInt8Data(HAPI_ATTRIB_UNREAL_PCG_PARTITION_CELL_ASSETS, HAPI_ATTROWNER_DETAIL, CellAssetsData));
+		bOutCellAssets = !CellAssetsData.IsEmpty() && (CellAssetsData[0] >= 1);
+	}
+
+	return true;
+}
+
+static void HoudiniPCGDataOutputUtils::BinToPartitionCells(const int32& NumElems, TFunctionRef<FVector2D(const int32&)> GetPositionFunc, const double& GridSize,
+	TArray<int32>& OutCellIndices, TArray<FIntPoint>& OutCells)
+{
+	TArray<int64> CellKeys;  // Packed cell coords, so that could be sorted
+	CellKeys.SetNumUninitialized(NumElems);
+	FHoudiniPCGUtils::ParallelForBatch(NumElems, [&](const int32& StartIdx, const int32& EndIdx)
+		{
+			for (int32 ElemIdx = StartIdx; ElemIdx < EndIdx; ++ElemIdx)
 			{
-				HAPI_AttributeOwner Owner = HAPI_ATTROWNER_POINT;
-				TArray<float> Data;
-				HOUDINI_FAIL_RETURN(FHoudiniEngineUtils::HapiGetFloatAttributeData(NodeId, PartId, HAPI_ATTRIB_DENSITY, 1, Data, Owner));
-				for (int32 PointIdx = 0; PointIdx < PointCount; ++PointIdx)
-					Points[PointIdx].Density = Data[PointIdx];
+				const FVector2D Position = GetPositionFunc(ElemIdx);
+				CellKeys[ElemIdx] = (int64(FMath::FloorToInt32(Position.X / GridSize)) << 32) | int64(uint32(FMath::FloorToInt32(Position.Y / GridSize)));
 			}
+		});
+
+	TArray<int64> UniqueCellKeys(CellKeys);
+	UniqueCellKeys.Sort();
+	UniqueCellKeys.SetNum(Algo::Unique(UniqueCellKeys));
+	OutCells.SetNumUninitialized(UniqueCellKeys.Num());
+	for (int32 CellIdx = 0; CellIdx < UniqueCellKeys.Num(); ++CellIdx)
+		OutCells[CellIdx] = FIntPoint(int32(UniqueCellKeys[CellIdx] >> 32), int32(uint32(UniqueCellKeys[CellIdx] & 0xFFFFFFFF)));
 
+	OutCellIndices.SetNumUninitialized(NumElems);
+	FHoudiniPCGUtils::ParallelForBatch(NumElems, [&](const int32& StartIdx, const int32& EndIdx)
+		{
+			for (int32 ElemIdx = StartIdx; ElemIdx < EndIdx; ++ElemIdx)
+				OutCellIndices[ElemIdx] = Algo::BinarySearch(UniqueCellKeys, CellKeys[ElemIdx]);
+		});
+}
+
+static FString HoudiniPCGDataOutputUtils::GetPartitionCellName(const FIntPoint& Cell)
+{
+	return FString::Printf(TEXT("Cell_%d_%d"), Cell.X, Cell.Y);
+}
+
+static FString HoudiniPCGDataOutputUtils::GetPartitionCellObjectPath(const FString& IndexObjectPath, const FIntPoint& Cell)
+{
+	const FString PackageName = FPackageName::ObjectPathToPackageName(IndexObjectPath) + TEXT("_") + GetPartitionCellName(Cell);
+	return PackageName + TEXT(".") + FPackageName::GetShortName(PackageName);
+}
+
+static FString HoudiniPCGDataOutputUtils::GetAssetObjectPath(const FString& ObjectPath)
+{
+	const FString PackageName = FPackageName::ObjectPathToPackageName(ObjectPath);
+	return PackageName + TEXT(".") + FPackageName::GetShortName(PackageName);
+}
+
+static UPCGData* HoudiniPCGDataOutputUtils::CreatePartitionIndexData(UObject* Outer, const FHoudiniPCGPartitionIndex& PartitionIndex)
+{
+	LLM_SCOPE_BYTAG(HoudiniPCG_PCGData);
+
+	const int32 NumCells = PartitionIndex.CellObjectPaths.Num();
+	const double& GridSize = PartitionIndex.GridSize;
+	const FVector BoundsExtent(GridSize * 0.5, GridSize * 0.5, HALF_WORLD_MAX);  // 2D grid, so cells are unbounded in Z
+
+#if ((ENGINE_MAJOR_VERSION == 5) && (ENGINE_MINOR_VERSION >= 6)) || (ENGINE_MAJOR_VERSION > 5)
+	UPCGPointArrayData* PointData = NewObject<UPCGPointArrayData>(Outer);
+	PointData->SetNumPoints(NumCells);
+	TPCGValueRange<FTransform> Transforms = PointData->GetTransformValueRange();
+	TPCGValueRange<FVector> BoundsMins = PointData->GetBoundsMinValueRange();
+	TPCGValueRange<FVector> BoundsMaxs = PointData->GetBoundsMaxValueRange();
+	TPCGValueRange<int64> Entries = PointData->GetMetadataEntryValueRange();
+#else
+	UPCGPointData* PointData = NewObject<UPCGPointData>(Outer);
+	TArray<FPCGPoint>& Points = PointData->GetMutablePoints();
+	Points.SetNum(NumCells);
+#endif
+	FPCGMetadataAttribute<FSoftObjectPath>* DataAssetAttrib = PointData->Metadata->CreateAttribute<FSoftObjectPath>(TEXT("DataAsset"), FSoftObjectPath(), false, true);
+	FPCGMetadataAttribute<FString>* CellAttrib = PointData->Metadata->CreateAttribute<FString>(TEXT("Cell"), FString(), false, true);
+
+	int32 PointIdx = 0;
+	for (const TPair<FIntPoint, FString>& CellObjectPath : PartitionIndex.CellObjectPaths)
+	{
+		const FIntPoint& Cell = CellObjectPath.Key;
+		const FTransform Transform(FVector((Cell.X + 0.5) * GridSize, (Cell.Y + 0.5) * GridSize, 0.0));
+		const PCGMetadataEntryKey EntryKey = PointData->Metadata->AddEntry();
+#if ((ENGINE_MAJOR_VERSION == 5) && (ENGINE_MINOR_VERSION >= 6)) || (ENGINE_MAJOR_VERSION > 5)
+		Transforms[PointIdx] = Transform;
+		BoundsMins[PointIdx] = -BoundsExtent;
+		BoundsMaxs[PointIdx] = BoundsExtent;
+		Entries[PointIdx] = EntryKey;
+#else
+		FPCGPoint& Point = Points[PointIdx];
+		Point.Transform = Transform;
+		Point.BoundsMin = -BoundsExtent;
+		Point.BoundsMax = BoundsExtent;
+		Point.MetadataEntry = EntryKey;
+#endif
+		DataAssetAttrib->SetValue(EntryKey, FSoftObjectPath(CellObjectPath.Value));
+		CellAttrib->SetValue(EntryKey, GetPartitionCellName(Cell));
+		++PointIdx;
+	}
+
+	return PointData;
+}
+
+static bool HoudiniPCGDataOutputUtils::HapiRetrievePointTransforms(const int32& NodeId, const HAPI_PartInfo& PartInfo, FHoudiniPCGPartSchema& Schema,
+	TFunctionRef<FTransform&(const int32&)> GetTransformFunc, bool& bOutRetrieved)
+{
+	bOutRetrieved = false;
+
+	// These attributes need houdini to evaluate the full instance matrix
+	for (const char* HoudiniOnlyAttribName : { HAPI_ATTRIB_TRANS, HAPI_ATTRIB_PIVOT, HAPI_ATTRIB_TRANSFORM })
+	{
+		if (Schema.QueryAttributeOwner(HoudiniOnlyAttribName) != HAPI_ATTROWNER_INVALID)
+			return true;
+	}
+
+	FHoudiniPCGTransformData Data;
+	TArray<float> Storages[7];  // Attributes NOT prefetched, Data views them or the prefetched ones of Schema
+	HOUDINI_FAIL_RETURN(HapiGetPointFloatData(NodeId, PartInfo, Schema, HAPI_ATTRIB_POSITION, 3, Storages[0], Data.PositionData, Data.PositionStride));
+	if (Data.PositionStride != 3)
+		return true;
+
+	HOUDINI_FAIL_RETURN(HapiGetPointFloatData(NodeId, PartInfo, Schema, HAPI_ATTRIB_ORIENT, 4, Storages[1], Data.OrientData, Data.OrientStride));
+
+	if (Data.OrientData.IsEmpty())  // N and up are only used when p@orient not exists
+	{
+		HOUDINI_FAIL_RETURN(HapiGetPointFloatData(NodeId, PartInfo, Schema, HAPI_ATTRIB_NORMAL, 3, Storages[2], Data.NormalData, Data.NormalStride));
+		if (Data.NormalData.IsEmpty() &&  // Houdini will treat v@v as N, so just let houdini evaluate it
+			(Schema.QueryAttributeOwner(HAPI_ATTRIB_VELOCITY) != HAPI_ATTROWNER_INVALID))
+			return true;
+
+		if (!Data.NormalData.IsEmpty())
+			HOUDINI_FAIL_RETURN(HapiGetPointFloatData(NodeId, PartInfo, Schema, HAPI_ATTRIB_UP, 3, Storages[3], Data.UpData, Data.UpStride));
+	}
+
+	HOUDINI_FAIL_RETURN(HapiGetPointFloatData(NodeId, PartInfo, Schema, HAPI_ATTRIB_ROT, 4, Storages[4], Data.RotData, Data.RotStride));
+
+	HOUDINI_FAIL_RETURN(HapiGetPointFloatData(NodeId, PartInfo, Schema, HAPI_ATTRIB_PSCALE, 1, Storages[5], Data.PScaleData, Data.PScaleStride));
+
+	HOUDINI_FAIL_RETURN(HapiGetPointFloatData(NodeId, PartInfo, Schema, HAPI_ATTRIB_SCALE, 3, Storages[6], Data.ScaleData, Data.ScaleStride));
+
+	FHoudiniPCGUtils::ConvertTransformsToUnreal(PartInfo.pointCount, Data, GetTransformFunc);
+
+	bOutRetrieved = true;
+
+	return true;
+}
+
+static bool HoudiniPCGDataOutputUtils::HapiRetrievePCGAttributes(const int32& NodeId, const HAPI_PartInfo& PartInfo, FHoudiniPCGPartSchema& Schema,
+	const HAPI_AttributeOwner& Owner, const TArray<FHoudiniPCGAttributeTarget>& Targets,
+	FHoudiniPCGOutputScratch& Scratch, FHoudiniPCGStringCache& StringCache, TArray<FHoudiniPCGStringAttribute>& OutStringAttribs)
+{
+	if (Targets.IsEmpty())
+		return true;
+
+	HOUDINI_PCG_STAGE_SCOPE(OutputAttributes, 0);
+	LLM_SCOPE_BYTAG(HoudiniPCG_MetadataConversion);
+
+	const int32& PartId = PartInfo.id;
+	int32 StartAttribIdx = 0;  // Schema.AttribNames are sorted by owner
+	for (int32 PrevOwner = HAPI_ATTROWNER_VERTEX; PrevOwner < Owner; ++PrevOwner)
+		StartAttribIdx += PartInfo.attributeCounts[PrevOwner];
+
+	for (int32 AttribIdx = StartAttribIdx; AttribIdx < StartAttribIdx + PartInfo.attributeCounts[Owner]; ++AttribIdx)
+	{
+		const std::string& AttribNameStr = Schema.AttribNames[AttribIdx];
+		if (AttribNameStr.starts_with(HAPI_ATTRIB_PREFIX_UNREAL_PCG_ATTRIBUTE))
+		{
+			const FName AttribName(AttribNameStr.c_str() + strlen(HAPI_ATTRIB_PREFIX_UNREAL_PCG_ATTRIBUTE));
+			if (AttribName.IsNone())
+				continue;
+
+			HAPI_AttributeInfo AttribInfo;
+			HOUDINI_FAIL_RETURN(Schema.HapiGetAttributeInfo(AttribNameStr.c_str(), Owner, AttribInfo));
+			HoudiniPCGStageScope.AddElems(AttribInfo.count);
+			FHoudiniPCGCookStats::AddAttributes(false, 1);
+
+			switch (AttribInfo.storage)
 			{
-				TArray<float> ColorData;
-				if (FHoudiniEngineUtils::IsAttributeExists(AttribNames, PartInfo.attributeCounts, HAPI_ATTRIB_COLOR, HAPI_ATTROWNER_POINT))  // v@Cd
+			case HAPI_STORAGETYPE_INT:
+			{
+				switch (AttribInfo.tupleSize)
 				{
-					HAPI_AttributeOwner Owner = HAPI_ATTROWNER_POINT;
-					HOUDINI_FAIL_RETURN(FHoudiniEngineUtils::HapiGetFloatAttributeData(NodeId, PartId, HAPI_ATTRIB_COLOR, 3, ColorData, Owner));
+				case 1: if (!HapiCreateNumericPCGAttribute<int32, int32>(NodeId, PartId, Schema, AttribIdx, AttribInfo,
+					AttribNameStr, FHoudiniApi::GetAttributeIntData, Targets, AttribName, 0, Scratch)) { return false; } break;
+				case 2: if (!HapiCreateNumericPCGAttribute<int32, FVector2d>(NodeId, PartId, Schema, AttribIdx, AttribInfo,
+					AttribNameStr, FHoudiniApi::GetAttributeIntData,
+					[](const int32* Data, const int32& ValueIdx) { return FVector2d(Data[ValueIdx], Data[ValueIdx + 1]); },
+					Targets, AttribName, FVector2d::ZeroVector, Scratch)) { return false; } break;
+				case 3: if (!HapiCreateNumericPCGAttribute<int32, FVector>(NodeId, PartId, Schema, AttribIdx, AttribInfo,
+					AttribNameStr, FHoudiniApi::GetAttributeIntData,
+					[](const int32* Data, const int32& ValueIdx) { return FVector(Data[ValueIdx], Data[ValueIdx + 1], Data[ValueIdx + 2]); },
+					Targets, AttribName, FVector::ZeroVector, Scratch)) { return false; } break;
+				case 4: if (!HapiCreateNumericPCGAttribute<int32, FVector4>(NodeId, PartId, Schema, AttribIdx, AttribInfo,
+					AttribNameStr, FHoudiniApi::GetAttributeIntData,
+					[](const int32* Data, const int32& ValueIdx) { return FVector4(Data[ValueIdx], Data[ValueIdx + 1], Data[ValueIdx + 2], Data[ValueIdx + 3]); },
+					Targets, AttribName, FVector4::Zero(), Scratch)) { return false; } break;
 				}
-				TArray<float> AlphaData;
-				if (FHoudiniEngineUtils::IsAttributeExists(AttribNames, PartInfo.attributeCounts, HAPI_ALPHA, HAPI_ATTROWNER_POINT))  // f@Alpha
+			}
+			break;
+			case HAPI_STORAGETYPE_INT64:
+			{
+				switch (AttribInfo.tupleSize)
 				{
-					HAPI_AttributeOwner Owner = HAPI_ATTROWNER_POINT;
-					HOUDINI_FAIL_RETURN(FHoudiniEngineUtils::HapiGetFloatAttributeData(NodeId, PartId, HAPI_ALPHA, 1, AlphaData, Owner));
+				case 1: if (!HapiCreateNumericPCGAttribute<HAPI_Int64, int64>(NodeId, PartId, Schema, AttribIdx, AttribInfo,
+					AttribNameStr, FHoudiniApi::GetAttributeInt64Data, Targets, AttribName, 0, Scratch)) { return false; } break;
+				case 2: if (!HapiCreateNumericPCGAttribute<HAPI_Int64, FVector2d>(NodeId, PartId, Schema, AttribIdx, AttribInfo,
+					AttribNameStr, FHoudiniApi::GetAttributeInt64Data,
+					[](const HAPI_Int64* Data, const int32& ValueIdx) { return FVector2d(Data[ValueIdx], Data[ValueIdx + 1]); },
+					Targets, AttribName, FVector2d::ZeroVector, Scratch)) { return false; } break;
+				case 3: if (!HapiCreateNumericPCGAttribute<HAPI_Int64, FVector>(NodeId, PartId, Schema, AttribIdx, AttribInfo,
+					AttribNameStr, FHoudiniApi::GetAttributeInt64Data,
+					[](const HAPI_Int64* Data, const int32& ValueIdx) { return FVector(Data[ValueIdx], Data[ValueIdx + 1], Data[ValueIdx + 2]); },
+					Targets, AttribName, FVector::ZeroVector, Scratch)) { return false; } break;
+				case 4: if (!HapiCreateNumericPCGAttribute<HAPI_Int64, FVector4>(NodeId, PartId, Schema, AttribIdx, AttribInfo,
+					AttribNameStr, FHoudiniApi::GetAttributeInt64Data,
+					[](const HAPI_Int64* Data, const int32& ValueIdx) { return FVector4(Data[ValueIdx], Data[ValueIdx + 1], Data[ValueIdx + 2], Data[ValueIdx + 3]); },
+					Targets, AttribName, FVector4::Zero(), Scratch)) { return false; } break;
 				}
-				if (!ColorData.IsEmpty() && !AlphaData.IsEmpty())
+			}
+			break;
+			case HAPI_STORAGETYPE_FLOAT:
+			{
+				switch (AttribInfo.tupleSize)
 				{
-					for (int32 PointIdx = 0; PointIdx < PointCount; ++PointIdx)
+				case 1: if (!HapiCreateNumericPCGAttribute<float, float>(NodeId, PartId, Schema, AttribIdx, AttribInfo,
+					AttribNameStr, FHoudiniApi::GetAttributeFloatData, Targets, AttribName, 0, Scratch)) { return false; } break;
+				case 2: if (!HapiCreateNumericPCGAttribute<float, FVector2d>(NodeId, PartId, Schema, AttribIdx, AttribInfo,
+					AttribNameStr, FHoudiniApi::GetAttributeFloatData,
+					[](const float* Data, const int32& ValueIdx) { return FVector2d(Data[ValueIdx], Data[ValueIdx + 1]); },
+					Targets, AttribName, FVector2d::ZeroVector, Scratch)) { return false; } break;
+				case 3:
+				{
+					switch (AttribInfo.typeInfo)
 					{
-						FVector4& Color = Points[PointIdx].Color;
-						if (!ColorData.IsEmpty())
-						{
-							Color.X = ColorData[PointIdx * 3];
-							Color.Y = ColorData[PointIdx * 3 + 1];
-							Color.Z = ColorData[PointIdx * 3 + 2];
-						}
-						if (!AlphaData.IsEmpty())
-							Color.W = AlphaData[PointIdx];
+					case HAPI_ATTRIBUTE_TYPE_POINT: if (!HapiCreateNumericPCGAttribute<float, FVector>(NodeId, PartId, Schema, AttribIdx, AttribInfo,
+							AttribNameStr, FHoudiniApi::GetAttributeFloatData,
+							[](const float* Data, const int32& ValueIdx) { return FVector(Data[ValueIdx], Data[ValueIdx + 2], Data[ValueIdx + 1]) * POSITION_SCALE_TO_UNREAL; },
+							Targets, AttribName, FVector::ZeroVector, Scratch)) { return false; } break;
+					default: if (!HapiCreateNumericPCGAttribute<float, FVector>(NodeId, PartId, Schema, AttribIdx, AttribInfo,
+						AttribNameStr, FHoudiniApi::GetAttributeFloatData,
+						[](const float* Data, const int32& ValueIdx) { return FVector(Data[ValueIdx], Data[ValueIdx + 1], Data[ValueIdx + 2]); },
+						Targets, AttribName, FVector::ZeroVector, Scratch)) { return false; } break;
+					}
+				}
+				break;
+				case 4: 
+				{
+					switch (AttribInfo.typeInfo)
+					{
+					case HAPI_ATTRIBUTE_TYPE_QUATERNION: if (!HapiCreateNumericPCGAttribute<float, FQuat>(NodeId, PartId, Schema, AttribIdx, AttribInfo,
+						AttribNameStr, FHoudiniApi::GetAttributeFloatData,
+						[](const float* Data, const int32& ValueIdx) { return FQuat(Data[ValueIdx], Data[ValueIdx + 2], Data[ValueIdx + 1], -Data[ValueIdx + 3]); },
+						Targets, AttribName, FQuat::Identity, Scratch)) { return false; } break;
+					default: if (!HapiCreateNumericPCGAttribute<float, FVector4>(NodeId, PartId, Schema, AttribIdx, AttribInfo,
+						AttribNameStr, FHoudiniApi::GetAttributeFloatData,
+						[](const float* Data, const int32& ValueIdx) { return FVector4(Data[ValueIdx], Data[ValueIdx + 1], Data[ValueIdx + 2], Data[ValueIdx + 3]); },
+						Targets, AttribName, FVector4::Zero(), Scratch)) { return false; } break;
 					}
 				}
+				break;
+				case 16: if (!HapiCreateNumericPCGAttribute<float, FTransform>(NodeId, PartId, Schema, AttribIdx, AttribInfo,
+					AttribNameStr, FHoudiniApi::GetAttributeFloatData,
+					[](const float* Data, const int32& ValueIdx)
+					{
+						const FMatrix44f& UnrealXform = *((const FMatrix44f*)(Data + ValueIdx));
+
+						FMatrix44f HoudiniXform;
+						HoudiniXform.M[0][0] = UnrealXform.M[0][0];
+						HoudiniXform.M[0][1] = UnrealXform.M[0][2];
+						HoudiniXform.M[0][2] = UnrealXform.M[0][1];
+						HoudiniXform.M[0][3] = UnrealXform.M[0][3];
+
+						HoudiniXform.M[1][0] = UnrealXform.M[2][0];
+						HoudiniXform.M[1][1] = UnrealXform.M[2][2];
+						HoudiniXform.M[1][2] = UnrealXform.M[2][1];
+						HoudiniXform.M[1][3] = UnrealXform.M[2][3];
+
+						HoudiniXform.M[2][0] = UnrealXform.M[1][0];
+						HoudiniXform.M[2][1] = UnrealXform.M[1][2];
+						HoudiniXform.M[2][2] = UnrealXform.M[1][1];
+						HoudiniXform.M[2][3] = UnrealXform.M[1][3];
+
+						HoudiniXform.M[3][0] = UnrealXform.M[3][0] * POSITION_SCALE_TO_UNREAL_F;
+						HoudiniXform.M[3][1] = UnrealXform.M[3][2] * POSITION_SCALE_TO_UNREAL_F;
+						HoudiniXform.M[3][2] = UnrealXform.M[3][1] * POSITION_SCALE_TO_UNREAL_F;
+						HoudiniXform.M[3][3] = UnrealXform.M[3][3];
+						return FTransform(FTransform3f(HoudiniXform));
+					},
+					Targets, AttribName, FTransform::Identity, Scratch)) { return false; } break;
+				}
 			}
-#endif
-			{  // TODO: check whether this is necessary
-#if ((ENGINE_MAJOR_VERSION == 5) && (ENGINE_MINOR_VERSION >= 6)) || (ENGINE_MAJOR_VERSION > 5)
-				TPCGValueRange<int64> Entries = PointData->GetMetadataEntryValueRange();
-				TArray<int64> ParentEntryKeys;
-				for (int32 PointIdx = 0; PointIdx < PointCount; ++PointIdx)
+			break;
+			case HAPI_STORAGETYPE_FLOAT64:
+			{
+				switch (AttribInfo.tupleSize)
 				{
-					ParentEntryKeys.Add(-1);
-					Entries[PointIdx] = int64(PointIdx);
+				case 1: if (!HapiCreateNumericPCGAttribute<double, double>(NodeId, PartId, Schema, AttribIdx, AttribInfo,
+					AttribNameStr, FHoudiniApi::GetAttributeFloat64Data, Targets, AttribName, 0.0, Scratch)) { return false; } break;
+				case 2: if (!HapiCreateNumericPCGAttribute<double, FVector2d>(NodeId, PartId, Schema, AttribIdx, AttribInfo,
+					AttribNameStr, FHoudiniApi::GetAttributeFloat64Data, Targets, AttribName, FVector2d::ZeroVector, Scratch)) { return false; } break;
+				case 3: if (!HapiCreateNumericPCGAttribute<double, FVector>(NodeId, PartId, Schema, AttribIdx, AttribInfo,
+					AttribNameStr, FHoudiniApi::GetAttributeFloat64Data, Targets, AttribName, FVector::ZeroVector, Scratch)) { return false; } break;
+				case 4: if (!HapiCreateNumericPCGAttribute<double, FVector4>(NodeId, PartId, Schema, AttribIdx, AttribInfo,
+					AttribNameStr, FHoudiniApi::GetAttributeFloat64Data, Targets, AttribName, FVector4::Zero(), Scratch)) { return false; } break;
+				case 16: if (!HapiCreateNumericPCGAttribute<double, FTransform>(NodeId, PartId, Schema, AttribIdx, AttribInfo,
+					AttribNameStr, FHoudiniApi::GetAttributeFloat64Data,
+					[](const double* Data, const int32& ValueIdx)
+					{
+						const FMatrix& UnrealXform = *((const FMatrix*)(Data + ValueIdx));
+
+						FMatrix HoudiniXform;
+						HoudiniXform.M[0][0] = UnrealXform.M[0][0];
+						HoudiniXform.M[0][1] = UnrealXform.M[0][2];
+						HoudiniXform.M[0][2] = UnrealXform.M[0][1];
+						HoudiniXform.M[0][3] = UnrealXform.M[0][3];
+
+						HoudiniXform.M[1][0] = UnrealXform.M[2][0];
+						HoudiniXform.M[1][1] = UnrealXform.M[2][2];
+						HoudiniXform.M[1][2] = UnrealXform.M[2][1];
+						HoudiniXform.M[1][3] = UnrealXform.M[2][3];
+
+						HoudiniXform.M[2][0] = UnrealXform.M[1][0];
+						HoudiniXform.M[2][1] = UnrealXform.M[1][2];
+						HoudiniXform.M[2][2] = UnrealXform.M[1][1];
+						HoudiniXform.M[2][3] = UnrealXform.M[1][3];
+
+						HoudiniXform.M[3][0] = UnrealXform.M[3][0] * POSITION_SCALE_TO_UNREAL;
+						HoudiniXform.M[3][1] = UnrealXform.M[3][2] * POSITION_SCALE_TO_UNREAL;
+						HoudiniXform.M[3][2] = UnrealXform.M[3][1] * POSITION_SCALE_TO_UNREAL;
+						HoudiniXform.M[3][3] = UnrealXform.M[3][3];
+						return FTransform(HoudiniXform);
+					},
+					Targets, AttribName, FTransform::Identity, Scratch)) { return false; } break;
 				}
-				PointData->Metadata->GetMetadataDomain(EPCGMetadataDomainFlag::Elements)->AddEntries(ParentEntryKeys);
-#elif ((ENGINE_MAJOR_VERSION == 5) && (ENGINE_MINOR_VERSION >= 5)) || (ENGINE_MAJOR_VERSION > 5)
-				TArray<int64> ParentEntryKeys;
-				for (int32 PointIdx = 0; PointIdx < PointCount; ++PointIdx)
-					ParentEntryKeys.Add(-1);
-				PointData->Metadata->AddEntries(ParentEntryKeys);
-#else
-				for (int32 PointIdx = 0; PointIdx < PointCount; ++PointIdx)
-					PointData->Metadata->AddEntry(-1);
+			}
+			break;
+			case HAPI_STORAGETYPE_STRING:
+			{
+				HAPI_StringHandle* SHs = Scratch.GetHapiBuffer<HAPI_StringHandle>(AttribInfo.count);
+				{
+					HOUDINI_PCG_HAPI_CALL_SCOPE(false, AttribInfo.count * sizeof(HAPI_StringHandle));
+					HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetAttributeStringData(Schema.GetSession(), NodeId, PartId,
+						AttribNameStr.c_str(), &AttribInfo, SHs, 0, AttribInfo.count));
+				}
+				FHoudiniPCGStringAttribute& StringAttrib = OutStringAttribs.AddDefaulted_GetRef();
+				StringAttrib.Name = AttribName;
+				StringAttrib.Targets = Targets;
+				StringCache.AddHandles(TConstArrayView<HAPI_StringHandle>(SHs, AttribInfo.count), StringAttrib.Indices);
+			}
+			break;
+			case HAPI_STORAGETYPE_UINT8: if (AttribInfo.tupleSize == 1)
+			{
+				if (!HapiCreateNumericPCGAttribute<uint8, bool>(NodeId, PartId, Schema, AttribIdx, AttribInfo,
+				AttribNameStr, FHoudiniApi::GetAttributeUInt8Data,
+				[](const uint8* Data, const int32& ValueIdx) { return bool(Data[ValueIdx]); },
+				Targets, AttribName, false, Scratch)) { return false; }
+			}
+			break;
+			case HAPI_STORAGETYPE_INT8: if (AttribInfo.tupleSize == 1)
+			{
+				if (!HapiCreateNumericPCGAttribute<int8, bool>(NodeId, PartId, Schema, AttribIdx, AttribInfo,
+				AttribNameStr, FHoudiniApi::GetAttributeInt8Data,
+				[](const int8* Data, const int32& ValueIdx) { return bool(Data[ValueIdx]); },
+				Targets, AttribName, false, Scratch)) { return false; }
+			}
+			break;
+			case HAPI_STORAGETYPE_INT16: if (AttribInfo.tupleSize == 1)
+			{
+				if (!HapiCreateNumericPCGAttribute<int16, int32>(NodeId, PartId, Schema, AttribIdx, AttribInfo,
+				AttribNameStr, FHoudiniApi::GetAttributeInt16Data,
+				[](const int16* Data, const int32& ValueIdx) { return int32(Data[ValueIdx]); },
+				Targets, AttribName, false, Scratch)) { return false; }
+			}
+			break;
+			case HAPI_STORAGETYPE_DICTIONARY:
+				break;
+			}
+		}
+	}
+
+	return true;
+}
+
+#if ((ENGINE_MAJOR_VERSION == 5) && (ENGINE_MINOR_VERSION >= 5)) || (ENGINE_MAJOR_VERSION > 5)
+template<typename ElementValueType, typename OverlayType>
+static void HoudiniPCGDataOutputUtils::SetDynamicMeshOverlay(OverlayType* Overlay, const bool& bOnVertex, const TArray<int32>& Vertices, const TArray<int32>& PointRemap,
+	const TArray<UE::Geometry::FIndex3i>& TriVertices, const TArray<int32>& TriIds, TFunctionRef<ElementValueType(const int32&)> GetValueFunc)
+{
+	TArray<int32> ElemIds;  // Houdini vertex or point idx -> overlay element id
+	if (bOnVertex)
+	{
+		ElemIds.SetNumUninitialized(Vertices.Num());
+		for (int32 VtxIdx = 0; VtxIdx < Vertices.Num(); ++VtxIdx)
+			ElemIds[VtxIdx] = Overlay->AppendElement(GetValueFunc(VtxIdx));
+	}
+	else
+	{
+		ElemIds.Init(-1, PointRemap.Num());
+		for (int32 PointIdx = 0; PointIdx < PointRemap.Num(); ++PointIdx)
+		{
+			if (PointRemap[PointIdx] >= 0)  // Only points referenced by triangles
+				ElemIds[PointIdx] = Overlay->AppendElement(GetValueFunc(PointIdx));
+		}
+	}
+
+	for (int32 TriIdx = 0; TriIdx < TriVertices.Num(); ++TriIdx)
+	{
+		if (TriIds[TriIdx] < 0)
+			continue;
+
+		const UE::Geometry::FIndex3i& TriVtx = TriVertices[TriIdx];
+		Overlay->SetTriangle(TriIds[TriIdx], bOnVertex ? UE::Geometry::FIndex3i(ElemIds[TriVtx.A], ElemIds[TriVtx.B], ElemIds[TriVtx.C]) :
+			UE::Geometry::FIndex3i(ElemIds[Vertices[TriVtx.A]], ElemIds[Vertices[TriVtx.B]], ElemIds[Vertices[TriVtx.C]]));
+	}
+}
+
+static bool HoudiniPCGDataOutputUtils::HapiRetrieveDynamicMesh(const int32& NodeId, const HAPI_PartInfo& PartInfo, FHoudiniPCGPartSchema& Schema,
+	FHoudiniPCGStringCache& StringCache, UE::Geometry::FDynamicMesh3& OutDM, TArray<UMaterialInterface*>& OutMaterials)
+{
+	const int32& PartId = PartInfo.id;
+
+	HAPI_AttributeInfo AttribInfo;
+
+	// -------- Retrieve mesh data --------
+	TArray<float> PositionData;
+	PositionData.SetNumUninitialized(PartInfo.pointCount * 3);
+
+	HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetAttributeInfo(Schema.GetSession(), NodeId, PartId,
+		HAPI_ATTRIB_POSITION, HAPI_ATTROWNER_POINT, &AttribInfo));
+
+	{
+		HOUDINI_PCG_HAPI_CALL_SCOPE(false, PartInfo.pointCount * 3 * sizeof(float));
+		HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetAttributeFloatData(Schema.GetSession(), NodeId, PartId,
+			HAPI_ATTRIB_POSITION, &AttribInfo, -1, PositionData.GetData(), 0, PartInfo.pointCount));
+	}
+
+	TArray<int32> Vertices;
+	Vertices.SetNumUninitialized(PartInfo.vertexCount);
+	HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetVertexList(Schema.GetSession(), NodeId, PartId,
+		Vertices.GetData(), 0, PartInfo.vertexCount));
+
+	TArray<int32> FaceCounts;
+	FaceCounts.SetNumUninitialized(PartInfo.faceCount);
+	HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetFaceCounts(Schema.GetSession(), NodeId, PartId,
+		FaceCounts.GetData(), 0, PartInfo.faceCount));
+
+	// -------- Fan triangulation, a polygon with n vertices will be split into n - 2 triangles --------
+	TArray<int32> FaceVtxStarts;
+	FaceVtxStarts.SetNumUninitialized(PartInfo.faceCount);
+	TArray<int32> FaceTriStarts;
+	FaceTriStarts.SetNumUninitialized(PartInfo.faceCount);
+	int32 NumTris = 0;
+	{
+		int32 CurrVtxIdx = 0;
+		for (int32 FaceIdx = 0; FaceIdx < PartInfo.faceCount; ++FaceIdx)
+		{
+			FaceVtxStarts[FaceIdx] = CurrVtxIdx;
+			FaceTriStarts[FaceIdx] = NumTris;
+			CurrVtxIdx += FaceCounts[FaceIdx];
+			NumTris += FMath::Max(FaceCounts[FaceIdx] - 2, 0);
+		}
+	}
+
+	TArray<UE::Geometry::FIndex3i> TriVertices;  // Houdini vertex indices of each triangle, already in unreal winding order
+	TriVertices.SetNumUninitialized(NumTris);
+	TArray<int32> TriFaces;  // Houdini prim idx of each triangle
+	TriFaces.SetNumUninitialized(NumTris);
+	FHoudiniPCGUtils::ParallelForBatch(PartInfo.faceCount, [&](const int32& StartIdx, const int32& EndIdx)
+		{
+			for (int32 FaceIdx = StartIdx; FaceIdx < EndIdx; ++FaceIdx)
+			{
+				const int32& StartVtxIdx = FaceVtxStarts[FaceIdx];
+				int32 TriIdx = FaceTriStarts[FaceIdx];
+				for (int32 FanIdx = 1; FanIdx < FaceCounts[FaceIdx] - 1; ++FanIdx)
+				{
+					TriVertices[TriIdx] = UE::Geometry::FIndex3i(StartVtxIdx + FanIdx + 1, StartVtxIdx + FanIdx, StartVtxIdx);
+					TriFaces[TriIdx] = FaceIdx;
+					++TriIdx;
+				}
+			}
+		});
+
+	// -------- Append vertices, only points referenced by faces --------
+	LLM_SCOPE_BYTAG(HoudiniPCG_PCGData);  // Vertices, triangles and overlays will be moved into PCG data
+	TArray<int32> PointRemap;  // Houdini point idx -> dynamic mesh vertex id, -1 means unused
+	PointRemap.Init(-1, PartInfo.pointCount);
+	for (const int32& PointIdx : Vertices)
+		PointRemap[PointIdx] = 0;
+	for (int32 PointIdx = 0; PointIdx < PartInfo.pointCount; ++PointIdx)
+	{
+		if (PointRemap[PointIdx] >= 0)
+			PointRemap[PointIdx] = OutDM.AppendVertex(POSITION_SCALE_TO_UNREAL *
+				FVector3d(PositionData[PointIdx * 3], PositionData[PointIdx * 3 + 2], PositionData[PointIdx * 3 + 1]));
+	}
+
+	// -------- Append triangles --------
+	TArray<int32> TriIds;  // Negative means failed to append
+	TriIds.SetNumUninitialized(NumTris);
+	for (int32 TriIdx = 0; TriIdx < NumTris; ++TriIdx)
+	{
+		const UE::Geometry::FIndex3i& TriVtx = TriVertices[TriIdx];
+		const UE::Geometry::FIndex3i Triangle(PointRemap[Vertices[TriVtx.A]], PointRemap[Vertices[TriVtx.B]], PointRemap[Vertices[TriVtx.C]]);
+		if ((Triangle.A == Triangle.B) || (Triangle.B == Triangle.C) || (Triangle.C == Triangle.A))  // Skip degenerated triangle
+			TriIds[TriIdx] = UE::Geometry::FDynamicMesh3::InvalidID;
+		else
+			TriIds[TriIdx] = OutDM.AppendTriangle(Triangle, 0);
+	}
+
+	// -------- Attributes --------
+	HAPI_AttributeOwner NormalOwner = Schema.QueryAttributeOwner(HAPI_ATTRIB_NORMAL);
+	TArray<float> NormalData;
+	if ((NormalOwner == HAPI_ATTROWNER_VERTEX) || (NormalOwner == HAPI_ATTROWNER_POINT))
+		HOUDINI_FAIL_RETURN(Schema.HapiGetFloatData(HAPI_ATTRIB_NORMAL, NormalOwner, 3, NormalData));
+
+	HAPI_AttributeOwner UVOwner = Schema.QueryAttributeOwner(HAPI_ATTRIB_UV);
+	TArray<float> UVData;
+	if ((UVOwner == HAPI_ATTROWNER_VERTEX) || (UVOwner == HAPI_ATTROWNER_POINT))
+		HOUDINI_FAIL_RETURN(Schema.HapiGetFloatData(HAPI_ATTRIB_UV, UVOwner, 2, UVData));
+
+	HAPI_AttributeOwner ColorOwner = Schema.QueryAttributeOwner(HAPI_ATTRIB_COLOR);
+	TArray<float> ColorData;
+	TArray<float> AlphaData;
+	if ((ColorOwner == HAPI_ATTROWNER_VERTEX) || (ColorOwner == HAPI_ATTROWNER_POINT))
+	{
+		HOUDINI_FAIL_RETURN(Schema.HapiGetFloatData(HAPI_ATTRIB_COLOR, ColorOwner, 3, ColorData));
+		if (!ColorData.IsEmpty() && Schema.IsAttributeExists(HAPI_ALPHA, ColorOwner))  // Alpha must on the same owner of Cd
+		{
+			HOUDINI_FAIL_RETURN(Schema.HapiGetFloatData(HAPI_ALPHA, ColorOwner, 1, AlphaData));
+		}
+	}
+
+	const HAPI_AttributeOwner MaterialOwner = Schema.QueryAttributeOwner(HAPI_ATTRIB_UNREAL_MATERIAL);
+	FHoudiniPCGStringIndices MaterialIndices;
+	if ((MaterialOwner == HAPI_ATTROWNER_PRIM) || (MaterialOwner == HAPI_ATTROWNER_DETAIL))
+	{
+		HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetAttributeInfo(Schema.GetSession(), NodeId, PartId,
+			HAPI_ATTRIB_UNREAL_MATERIAL, MaterialOwner, &AttribInfo));
+		if (AttribInfo.exists && (AttribInfo.storage == HAPI_STORAGETYPE_STRING))
+		{
+			TArray<HAPI_StringHandle> SHs;
+			SHs.SetNumUninitialized(AttribInfo.count);
+			{
+				HOUDINI_PCG_HAPI_CALL_SCOPE(false, AttribInfo.count * sizeof(HAPI_StringHandle));
+				HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetAttributeStringData(Schema.GetSession(), NodeId, PartId,
+					HAPI_ATTRIB_UNREAL_MATERIAL, &AttribInfo, SHs.GetData(), 0, AttribInfo.count));
+			}
+			StringCache.AddHandles(SHs, MaterialIndices);
+		}
+	}
+	HOUDINI_FAIL_RETURN(StringCache.HapiConvertPending());  // Convert tags and materials in one call
+
+	if (NormalData.IsEmpty() && UVData.IsEmpty() && ColorData.IsEmpty() && MaterialIndices.UniqueSlots.IsEmpty())
+		return true;
+
+	OutDM.EnableAttributes();
+	UE::Geometry::FDynamicMeshAttributeSet* Attributes = OutDM.Attributes();
+	if (!NormalData.IsEmpty())
+		SetDynamicMeshOverlay<FVector3f>(Attributes->PrimaryNormals(), NormalOwner == HAPI_ATTROWNER_VERTEX, Vertices, PointRemap, TriVertices, TriIds,
+			[&](const int32& ElemIdx) { return FVector3f(NormalData[ElemIdx * 3], NormalData[ElemIdx * 3 + 2], NormalData[ElemIdx * 3 + 1]); });
+
+	if (!UVData.IsEmpty())
+		SetDynamicMeshOverlay<FVector2f>(Attributes->PrimaryUV(), UVOwner == HAPI_ATTROWNER_VERTEX, Vertices, PointRemap, TriVertices, TriIds,
+			[&](const int32& ElemIdx) { return FVector2f(UVData[ElemIdx * 2], 1.0f - UVData[ElemIdx * 2 + 1]); });
+
+	if (!ColorData.IsEmpty())
+	{
+		Attributes->EnablePrimaryColors();
+		SetDynamicMeshOverlay<FVector4f>(Attributes->PrimaryColors(), ColorOwner == HAPI_ATTROWNER_VERTEX, Vertices, PointRemap, TriVertices, TriIds,
+			[&](const int32& ElemIdx) { return FVector4f(ColorData[ElemIdx * 3], ColorData[ElemIdx * 3 + 1], ColorData[ElemIdx * 3 + 2],
+				AlphaData.IsEmpty() ? 1.0f : AlphaData[ElemIdx]); });
+	}
+
+	if (!MaterialIndices.UniqueSlots.IsEmpty())  // Unique materials are slots, so local indices are material ids
+	{
+		for (const int32& Slot : MaterialIndices.UniqueSlots)
+			OutMaterials.Add(Cast<UMaterialInterface>(StringCache.GetObjectPath(Slot).TryLoad()));
+
+		Attributes->EnableMaterialID();
+		UE::Geometry::FDynamicMeshMaterialAttribute* MaterialIDs = Attributes->GetMaterialID();
+		for (int32 TriIdx = 0; TriIdx < NumTris; ++TriIdx)
+		{
+			if (TriIds[TriIdx] >= 0)
+				MaterialIDs->SetValue(TriIds[TriIdx], MaterialIndices.LocalIndices[(MaterialOwner == HAPI_ATTROWNER_PRIM) ? TriFaces[TriIdx] : 0]);
+		}
+	}
+
+	return true;
+}
 #endif
+
+using namespace HoudiniPCGDataOutputUtils;
+
+
+static TAutoConsoleVariable<bool> CVarHoudiniPCGOutputPrefetch(
+	TEXT("HoudiniPCG.OutputPrefetch"),
+	true,
+	TEXT("Retrieve raw transforms and numeric attributes of the next part on a worker, while game thread is converting the current part, ")
+	TEXT("HAPI calls are still serialized by the session, compare \"HoudiniPCG.DumpCookStats\" with this on and off to see whether the overlap helps"));
+
+static TAutoConsoleVariable<bool> CVarHoudiniPCGOutputSpatialSort(
+	TEXT("HoudiniPCG.OutputSpatialSort"),
+	false,
+	TEXT("Sort output points of each PCG data in Morton order, and build their octrees and bounds before notifying, ")
+	TEXT("compact assets will also rebuild them right after loaded, so that the first spatial query in PCG graphs need NOT to wait"));
+
+bool FHoudiniPCGDataAssetOutputBuilder::HapiRetrievePCGDatas(const int32& NodeId, const FString& DefaultObjectPathPrefix, const TArray<HAPI_PartInfo>& PartInfos,
+	TMap<FString, TObjectPtr<UPCGDataAsset>>* TransientPCGDAs, TArray<UPCGDataAsset*>& OutPCGDAs, TArray<FSoftObjectPath>& OutObjectPaths)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(HoudiniOutputPCGDataAsset);
+	LLM_SCOPE_BYTAG(HoudiniPCG_OutputScratch);
+
+	const FHoudiniPCGCookStatsScope CookStatsScope(false);  // Schemas built by HapiIsPartValid are NOT counted
+
+	const HAPI_Session* Session = GetSession();
+
+	const bool bSpatialSort = CVarHoudiniPCGOutputSpatialSort.GetValueOnGameThread();
+	const bool bPrefetch = CVarHoudiniPCGOutputPrefetch.GetValueOnGameThread();
+
+	FHoudiniPCGOutputScratch Scratch;
+	FHoudiniPCGStringCache StringCache(Session);  // Many parts may share the same strings, such as asset paths
+
+	TArray<TPair<UPCGDataAsset*, FPCGTaggedData>> PendingDatas;  // Will be added to assets after crcs computed in parallel
+	auto FindOrCreatePCGDALambda = [&OutPCGDAs, TransientPCGDAs](const FString& ObjectPath, const bool& bCompact) -> UPCGDataAsset*
+		{
+			LLM_SCOPE_BYTAG(HoudiniPCG_PCGData);
+
+			UPCGDataAsset* PCGDA = nullptr;
+			if (TransientPCGDAs)  // Keep the class, so that previews could be baked as the same assets
+			{
+				TObjectPtr<UPCGDataAsset>& TransientPCGDA = TransientPCGDAs->FindOrAdd(GetAssetObjectPath(ObjectPath));
+				if (!TransientPCGDA)
+					TransientPCGDA = NewObject<UPCGDataAsset>(GetTransientPackage(),
+						bCompact ? UHoudiniPCGCompactDataAsset::StaticClass() : UPCGDataAsset::StaticClass(), NAME_None, RF_Transient);
+				PCGDA = TransientPCGDA;
 			}
-			TArray<PCGMetadataEntryKey> EntryKeys;
-			for (int32 AttribIdx = PartInfo.attributeCounts[HAPI_ATTROWNER_VERTEX];
-				AttribIdx < PartInfo.attributeCounts[HAPI_ATTROWNER_VERTEX] + PartInfo.attributeCounts[HAPI_ATTROWNER_POINT]; ++AttribIdx)
+			else
+				PCGDA = bCompact ? FHoudiniEngineUtils::FindOrCreateAsset<UHoudiniPCGCompactDataAsset>(ObjectPath) :
+					FHoudiniEngineUtils::FindOrCreateAsset<UPCGDataAsset>(ObjectPath);
+			if (!OutPCGDAs.Contains(PCGDA))  // If first time to create, then clear previous data
 			{
-				const std::string& AttribNameStr = AttribNames[AttribIdx];
-				if (AttribNameStr.starts_with(HAPI_ATTRIB_PREFIX_UNREAL_PCG_ATTRIBUTE))
+				PCGDA->Data.Reset();
+				PCGDA->Data.DataCrcs.Empty();
+				OutPCGDAs.Add(PCGDA);
+			}
+			return PCGDA;
+		};
+	TMap<FString, FHoudiniPCGPartitionIndex> PartitionIndices;  // Index object path -> cell assets, index assets will be written after all parts retrieved
+	auto FindOrCreateCellPCGDALambda = [&](const FString& IndexObjectPath, const FIntPoint& Cell, const double& GridSize, const bool& bCompact) -> UPCGDataAsset*
+		{
+			const FString CellObjectPath = GetPartitionCellObjectPath(IndexObjectPath, Cell);
+			FHoudiniPCGPartitionIndex& PartitionIndex = PartitionIndices.FindOrAdd(IndexObjectPath);
+			PartitionIndex.GridSize = GridSize;
+			PartitionIndex.CellObjectPaths.Add(Cell, CellObjectPath);
+			return FindOrCreatePCGDALambda(CellObjectPath, bCompact);
+		};
+
+	// -------- Pipeline: a worker retrieves raw transforms and attributes of the next part, while game thread converts the current part --------
+	TArray<TSharedPtr<FHoudiniPCGPartSchema>> PartSchemaPtrs;
+	for (const HAPI_PartInfo& PartInfo : PartInfos)  // Should have been built in HapiIsPartValid
+		PartSchemas.RemoveAndCopyValue(TPair<int32, int32>(NodeId, PartInfo.id), PartSchemaPtrs.AddDefaulted_GetRef());
+
+	for (auto SchemaIter = PartSchemas.CreateIterator(); SchemaIter; ++SchemaIter)  // Parts validated but NOT retrieved are stale, remove before any failure could return
+	{
+		if (SchemaIter->Key.Key == NodeId)
+			SchemaIter.RemoveCurrent();
+	}
+
+	for (int32 PartIdx = 0; PartIdx < PartInfos.Num(); ++PartIdx)
+	{
+		TSharedPtr<FHoudiniPCGPartSchema>& SchemaPtr = PartSchemaPtrs[PartIdx];
+		if (!SchemaPtr.IsValid())
+		{
+			SchemaPtr = MakeShared<FHoudiniPCGPartSchema>(*Session);
+			HOUDINI_FAIL_RETURN(SchemaPtr->HapiInit(NodeId, PartInfos[PartIdx]));
+		}
+	}
+
+	TArray<UE::Tasks::FTask> PrefetchTasks;
+	PrefetchTasks.SetNum(PartInfos.Num());
+	ON_SCOPE_EXIT  // A prefetch may still be running if failed, so that no HAPI call outlives this retrieval, e.g., on a session owned by HoudiniPCGBatchCook
+	{
+		for (UE::Tasks::FTask& PrefetchTask : PrefetchTasks)
+		{
+			if (PrefetchTask.IsValid())
+				PrefetchTask.Wait();
+		}
+	};
+	auto LaunchPrefetchLambda = [&](const int32& PartIdx)
+		{
+			if (!bPrefetch || !PartInfos.IsValidIndex(PartIdx))
+				return;
+
+			// Captured by value, as PartSchemaPtrs will be moved out when the part is converted
+			const HAPI_PartInfo& PartInfo = PartInfos[PartIdx];
+			PrefetchTasks[PartIdx] = UE::Tasks::Launch(UE_SOURCE_LOCATION, [NodeId, PartInfo, SchemaPtr = PartSchemaPtrs[PartIdx]]()
 				{
-					const FName AttribName(AttribNameStr.c_str() + strlen(HAPI_ATTRIB_PREFIX_UNREAL_PCG_ATTRIBUTE));
-					if (AttribName.IsNone())
-						continue;
+					LLM_SCOPE_BYTAG(HoudiniPCG_Cache);
+					if ((PartInfo.type == HAPI_PARTTYPE_MESH) && (PartInfo.faceCount <= 0) && (PartInfo.instancedPartCount <= 0))  // Only plain point clouds have raw transforms
+						HapiPrefetchPointTransformData(NodeId, PartInfo, *SchemaPtr);
+					HapiPrefetchPCGAttributeData(NodeId, PartInfo, *SchemaPtr);
+				});
+		};
+
+	LaunchPrefetchLambda(0);
+	for (int32 PartIdx = 0; PartIdx < PartInfos.Num(); ++PartIdx)
+	{
+		if (PrefetchTasks[PartIdx].IsValid())
+		{
+			HOUDINI_PCG_STAGE_SCOPE(OutputPrefetchWait, 1);  // Long wait means the conversion of the previous part is NOT enough to hide the retrieval
+			PrefetchTasks[PartIdx].Wait();
+		}
+		LaunchPrefetchLambda(PartIdx + 1);
 
-					HAPI_AttributeInfo AttribInfo;
-					HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetAttributeInfo(FHoudiniEngine::Get().GetSession(), NodeId, PartId,
-						AttribNameStr.c_str(), HAPI_ATTROWNER_POINT, &AttribInfo));
+		const HAPI_PartInfo& PartInfo = PartInfos[PartIdx];
+		const int32& PartId = PartInfo.id;
 
-					switch (AttribInfo.storage)
-					{
-					case HAPI_STORAGETYPE_INT:
-					{
-						switch (AttribInfo.tupleSize)
-						{
-						case 1: if (!HapiCreateNumericPCGAttribute<int32, int32>(NodeId, PartId, AttribInfo,
-							AttribNameStr, FHoudiniApi::GetAttributeIntData, PointData->Metadata, AttribName, 0, EntryKeys)) { return false; } break;
-						case 2: if (!HapiCreateNumericPCGAttribute<int32, FVector2d>(NodeId, PartId, AttribInfo,
-							AttribNameStr, FHoudiniApi::GetAttributeIntData,
-							[](const TArray<int32>& Data, const int32& ValueIdx) { return FVector2d(Data[ValueIdx], Data[ValueIdx + 1]); },
-							PointData->Metadata, AttribName, FVector2d::ZeroVector, EntryKeys)) { return false; } break;
-						case 3: if (!HapiCreateNumericPCGAttribute<int32, FVector>(NodeId, PartId, AttribInfo,
-							AttribNameStr, FHoudiniApi::GetAttributeIntData,
-							[](const TArray<int32>& Data, const int32& ValueIdx) { return FVector(Data[ValueIdx], Data[ValueIdx + 1], Data[ValueIdx + 2]); },
-							PointData->Metadata, AttribName, FVector::ZeroVector, EntryKeys)) { return false; } break;
-						case 4: if (!HapiCreateNumericPCGAttribute<int32, FVector4>(NodeId, PartId, AttribInfo,
-							AttribNameStr, FHoudiniApi::GetAttributeIntData,
-							[](const TArray<int32>& Data, const int32& ValueIdx) { return FVector4(Data[ValueIdx], Data[ValueIdx + 1], Data[ValueIdx + 2], Data[ValueIdx + 3]); },
-							PointData->Metadata, AttribName, FVector4::Zero(), EntryKeys)) { return false; } break;
-						}
-					}
-					break;
-					case HAPI_STORAGETYPE_INT64:
+		const TSharedPtr<FHoudiniPCGPartSchema> SchemaPtr = MoveTemp(PartSchemaPtrs[PartIdx]);  // Release prefetched data when this part finished
+		FHoudiniPCGPartSchema& Schema = *SchemaPtr;
+		const TArray<std::string>& AttribNames = Schema.AttribNames;
+		
+		const FString DefaultObjectPath = DefaultObjectPathPrefix + FString::FromInt(PartId);
+		FString ObjectPath;
+		HOUDINI_FAIL_RETURN(Schema.HapiGetStringValue(HAPI_ATTRIB_UNREAL_OBJECT_PATH, ObjectPath));
+		if (IS_ASSET_PATH_INVALID(ObjectPath))
+			ObjectPath = DefaultObjectPath;
+
+		bool bCompact = false;  // Quantize and compress points when saved
+		if (Schema.IsAttributeExists(HAPI_ATTRIB_UNREAL_PCG_COMPACT, HAPI_ATTROWNER_DETAIL))
+		{
+			TArray<int8> CompactData;
+			HOUDINI_FAIL_RETURN(Schema.HapiGetInt8Data(HAPI_ATTRIB_UNREAL_PCG_COMPACT, HAPI_ATTROWNER_DETAIL, CompactData));
+			bCompact = !CompactData.IsEmpty() && (CompactData[0] >= 1);
+		}
+
+		const bool bIsPointCloud = (PartInfo.type == HAPI_PARTTYPE_MESH) && (PartInfo.faceCount <= 0);
+		UPCGDataAsset* PCGDA = (bIsPointCloud && Schema.IsAttributeExists(HAPI_ATTRIB_UNREAL_OBJECT_PATH, HAPI_ATTROWNER_POINT)) ?
+			nullptr : FindOrCreatePCGDALambda(ObjectPath, bCompact);  // Point clouds will find assets by s@unreal_object_path of each point
+
+		double PartitionGridSize = 0.0;
+		bool bPartitionCellAssets = false;
+		HOUDINI_FAIL_RETURN(HapiGetPartitionSettings(NodeId, PartId, Schema, PartitionGridSize, bPartitionCellAssets));
+
+		if (bIsPointCloud)  // Point cloud
+		{
+			const int32& PointCount = PartInfo.pointCount;
+			HOUDINI_PCG_STAGE_SCOPE(OutputPoints, PointCount);
+
+			// -------- Split points by s@unreal_object_path and s@unreal_pcg_data_split on points --------
+			FHoudiniPCGStringIndices ObjectPathIndices;
+			HOUDINI_FAIL_RETURN(HapiRetrievePointStringIndices(NodeId, PartInfo, Schema, HAPI_ATTRIB_UNREAL_OBJECT_PATH, Scratch, StringCache, ObjectPathIndices));
+			FHoudiniPCGStringIndices SplitIndices;
+			HOUDINI_FAIL_RETURN(HapiRetrievePointStringIndices(NodeId, PartInfo, Schema, HAPI_ATTRIB_UNREAL_PCG_DATA_SPLIT, Scratch, StringCache, SplitIndices));
+			HOUDINI_FAIL_RETURN(StringCache.HapiConvertPending());  // Asset paths and split keys are needed before creating datas
+
+			TArray<float> PositionStorage;  // Only needed by partition and spatial sort, transforms are retrieved later
+			TConstArrayView<float> PositionData;
+			int32 PositionStride = 0;
+			if ((PartitionGridSize > 0.0) || bSpatialSort)
+				HOUDINI_FAIL_RETURN(HapiGetPointFloatData(NodeId, PartInfo, Schema, HAPI_ATTRIB_POSITION, 3, PositionStorage, PositionData, PositionStride));
+
+			TArray<int32> CellIndices;  // Tile points by partition grid cells
+			TArray<FIntPoint> Cells;
+			if ((PartitionGridSize > 0.0) && !PositionData.IsEmpty())
+				BinToPartitionCells(PointCount, [&](const int32& PointIdx)
 					{
-						switch (AttribInfo.tupleSize)
-						{
-						case 1: if (!HapiCreateNumericPCGAttribute<HAPI_Int64, int64>(NodeId, PartId, AttribInfo,
-							AttribNameStr, FHoudiniApi::GetAttributeInt64Data, PointData->Metadata, AttribName, 0, EntryKeys)) { return false; } break;
-						case 2: if (!HapiCreateNumericPCGAttribute<HAPI_Int64, FVector2d>(NodeId, PartId, AttribInfo,
-							AttribNameStr, FHoudiniApi::GetAttributeInt64Data,
-							[](const TArray<HAPI_Int64>& Data, const int32& ValueIdx) { return FVector2d(Data[ValueIdx], Data[ValueIdx + 1]); },
-							PointData->Metadata, AttribName, FVector2d::ZeroVector, EntryKeys)) { return false; } break;
-						case 3: if (!HapiCreateNumericPCGAttribute<HAPI_Int64, FVector>(NodeId, PartId, AttribInfo,
-							AttribNameStr, FHoudiniApi::GetAttributeInt64Data,
-							[](const TArray<HAPI_Int64>& Data, const int32& ValueIdx) { return FVector(Data[ValueIdx], Data[ValueIdx + 1], Data[ValueIdx + 2]); },
-							PointData->Metadata, AttribName, FVector::ZeroVector, EntryKeys)) { return false; } break;
-						case 4: if (!HapiCreateNumericPCGAttribute<HAPI_Int64, FVector4>(NodeId, PartId, AttribInfo,
-							AttribNameStr, FHoudiniApi::GetAttributeInt64Data,
-							[](const TArray<HAPI_Int64>& Data, const int32& ValueIdx) { return FVector4(Data[ValueIdx], Data[ValueIdx + 1], Data[ValueIdx + 2], Data[ValueIdx + 3]); },
-							PointData->Metadata, AttribName, FVector4::Zero(), EntryKeys)) { return false; } break;
-						}
-					}
-					break;
-					case HAPI_STORAGETYPE_FLOAT:
+						const float* P = PositionData.GetData() + PointIdx * PositionStride;
+						return FVector2D(P[0], P[2]) * POSITION_SCALE_TO_UNREAL;
+					}, PartitionGridSize, CellIndices, Cells);
+
+			FHoudiniPCGPointBuckets Buckets;
+			Buckets.AddKeys(ObjectPathIndices.LocalIndices, ObjectPathIndices.UniqueSlots.Num());
+			Buckets.AddKeys(SplitIndices.LocalIndices, SplitIndices.UniqueSlots.Num());
+			Buckets.AddKeys(CellIndices, Cells.Num());
+			Buckets.Build(PointCount);
+			if (bSpatialSort && !PositionData.IsEmpty())
+				Buckets.SortSpatially(PointCount, [&](const int32& PointIdx)
 					{
-						switch (AttribInfo.tupleSize)
-						{
-						case 1: if (!HapiCreateNumericPCGAttribute<float, float>(NodeId, PartId, AttribInfo,
-							AttribNameStr, FHoudiniApi::GetAttributeFloatData, PointData->Metadata, AttribName, 0, EntryKeys)) { return false; } break;
-						case 2: if (!HapiCreateNumericPCGAttribute<float, FVector2d>(NodeId, PartId, AttribInfo,
-							AttribNameStr, FHoudiniApi::GetAttributeFloatData,
-							[](const TArray<float>& Data, const int32& ValueIdx) { return FVector2d(Data[ValueIdx], Data[ValueIdx + 1]); },
-							PointData->Metadata, AttribName, FVector2d::ZeroVector, EntryKeys)) { return false; } break;
-						case 3:
-						{
-							switch (AttribInfo.typeInfo)
-							{
-							case HAPI_ATTRIBUTE_TYPE_POINT: if (!HapiCreateNumericPCGAttribute<float, FVector>(NodeId, PartId, AttribInfo,
-									AttribNameStr, FHoudiniApi::GetAttributeFloatData,
-									[](const TArray<float>& Data, const int32& ValueIdx) { return FVector(Data[ValueIdx], Data[ValueIdx + 2], Data[ValueIdx + 1]) * POSITION_SCALE_TO_UNREAL; },
-									PointData->Metadata, AttribName, FVector::ZeroVector, EntryKeys)) { return false; } break;
-							default: if (!HapiCreateNumericPCGAttribute<float, FVector>(NodeId, PartId, AttribInfo,
-								AttribNameStr, FHoudiniApi::GetAttributeFloatData,
-								[](const TArray<float>& Data, const int32& ValueIdx) { return FVector(Data[ValueIdx], Data[ValueIdx + 1], Data[ValueIdx + 2]); },
-								PointData->Metadata, AttribName, FVector::ZeroVector, EntryKeys)) { return false; } break;
-							}
-						}
-						break;
-						case 4: 
-						{
-							switch (AttribInfo.typeInfo)
-							{
-							case HAPI_ATTRIBUTE_TYPE_QUATERNION: if (!HapiCreateNumericPCGAttribute<float, FQuat>(NodeId, PartId, AttribInfo,
-								AttribNameStr, FHoudiniApi::GetAttributeFloatData,
-								[](const TArray<float>& Data, const int32& ValueIdx) { return FQuat(Data[ValueIdx], Data[ValueIdx + 2], Data[ValueIdx + 1], -Data[ValueIdx + 3]); },
-								PointData->Metadata, AttribName, FQuat::Identity, EntryKeys)) { return false; } break;
-							default: if (!HapiCreateNumericPCGAttribute<float, FVector4>(NodeId, PartId, AttribInfo,
-								AttribNameStr, FHoudiniApi::GetAttributeFloatData,
-								[](const TArray<float>& Data, const int32& ValueIdx) { return FVector4(Data[ValueIdx], Data[ValueIdx + 1], Data[ValueIdx + 2], Data[ValueIdx + 3]); },
-								PointData->Metadata, AttribName, FVector4::Zero(), EntryKeys)) { return false; } break;
-							}
-						}
-						break;
-						case 16: if (!HapiCreateNumericPCGAttribute<float, FTransform>(NodeId, PartId, AttribInfo,
-							AttribNameStr, FHoudiniApi::GetAttributeFloatData,
-							[](const TArray<float>& Data, const int32& ValueIdx)
-							{
-								const FMatrix44f& UnrealXform = *((FMatrix44f*)(Data.GetData() + ValueIdx));
-
-								FMatrix44f HoudiniXform;
-								HoudiniXform.M[0][0] = UnrealXform.M[0][0];
-								HoudiniXform.M[0][1] = UnrealXform.M[0][2];
-								HoudiniXform.M[0][2] = UnrealXform.M[0][1];
-								HoudiniXform.M[0][3] = UnrealXform.M[0][3];
-
-								HoudiniXform.M[1][0] = UnrealXform.M[2][0];
-								HoudiniXform.M[1][1] = UnrealXform.M[2][2];
-								HoudiniXform.M[1][2] = UnrealXform.M[2][1];
-								HoudiniXform.M[1][3] = UnrealXform.M[2][3];
-
-								HoudiniXform.M[2][0] = UnrealXform.M[1][0];
-								HoudiniXform.M[2][1] = UnrealXform.M[1][2];
-								HoudiniXform.M[2][2] = UnrealXform.M[1][1];
-								HoudiniXform.M[2][3] = UnrealXform.M[1][3];
-
-								HoudiniXform.M[3][0] = UnrealXform.M[3][0] * POSITION_SCALE_TO_UNREAL_F;
-								HoudiniXform.M[3][1] = UnrealXform.M[3][2] * POSITION_SCALE_TO_UNREAL_F;
-								HoudiniXform.M[3][2] = UnrealXform.M[3][1] * POSITION_SCALE_TO_UNREAL_F;
-								HoudiniXform.M[3][3] = UnrealXform.M[3][3];
-								return FTransform(FTransform3f(HoudiniXform));
-							},
-							PointData->Metadata, AttribName, FTransform::Identity, EntryKeys)) { return false; } break;
-						}
-					}
-					break;
-					case HAPI_STORAGETYPE_FLOAT64:
+						const float* P = PositionData.GetData() + PointIdx * PositionStride;
+						return FVector(P[0], P[2], P[1]);  // Only the order matters, so need NOT to scale
+					});
+			PositionData = TConstArrayView<float>();
+			PositionStorage.Empty();
+			const int32 NumBuckets = Buckets.Num();
+
+			FHoudiniPCGTagsAttribute TagsAttrib;  // Tags of the first point of each bucket
+			HOUDINI_FAIL_RETURN(TagsAttrib.HapiRetrieve(Session, NodeId, PartId,
+				Schema.QueryAttributeOwner(HAPI_ATTRIB_UNREAL_PCG_TAGS), NumBuckets <= 1, StringCache));
+
+			TArray<TPair<UPCGDataAsset*, FPCGTaggedData>> BucketDatas;
+#if ((ENGINE_MAJOR_VERSION == 5) && (ENGINE_MINOR_VERSION >= 6)) || (ENGINE_MAJOR_VERSION > 5)
+			TArray<UPCGPointArrayData*> PointDatas;
+#else
+			TArray<UPCGPointData*> PointDatas;
+			TArray<TArray<FPCGPoint>*> BucketPoints;
+#endif
+			for (int32 BucketIdx = 0; BucketIdx < NumBuckets; ++BucketIdx)
+			{
+				const int32 FirstPointIdx = Buckets.GetFirstPointIdx(BucketIdx);
+				FString BucketObjectPath = ObjectPath;
+				if (!ObjectPathIndices.UniqueSlots.IsEmpty())
+				{
+					BucketObjectPath = StringCache.GetString(ObjectPathIndices.UniqueSlots[ObjectPathIndices.LocalIndices[FirstPointIdx]]);
+					if (IS_ASSET_PATH_INVALID(BucketObjectPath))
+						BucketObjectPath = DefaultObjectPath;
+				}
+
+				UPCGDataAsset* BucketPCGDA = nullptr;
+				if (!Cells.IsEmpty() && bPartitionCellAssets)  // BucketObjectPath will be the index asset
+					BucketPCGDA = FindOrCreateCellPCGDALambda(BucketObjectPath, Cells[CellIndices[FirstPointIdx]], PartitionGridSize, bCompact);
+				else
+					BucketPCGDA = FindOrCreatePCGDALambda(BucketObjectPath, bCompact);
+
+				LLM_SCOPE_BYTAG(HoudiniPCG_PCGData);
+#if ((ENGINE_MAJOR_VERSION == 5) && (ENGINE_MINOR_VERSION >= 6)) || (ENGINE_MAJOR_VERSION > 5)
+				UPCGPointArrayData* PointData = NewObject<UPCGPointArrayData>(BucketPCGDA);
+				PointData->SetNumPoints(Buckets.GetBucketPointCount(BucketIdx));
+#else
+				UPCGPointData* PointData = NewObject<UPCGPointData>(BucketPCGDA);
+				TArray<FPCGPoint>& Points = PointData->GetMutablePoints();
+				Points.SetNum(Buckets.GetBucketPointCount(BucketIdx));
+				BucketPoints.Add(&Points);
+#endif
+				PointDatas.Add(PointData);
+
+				FPCGTaggedData TaggedData;
+				TaggedData.Data = PointData;
+				if (!SplitIndices.UniqueSlots.IsEmpty())  // Split key as tag
+				{
+					const FString& SplitKey = StringCache.GetString(SplitIndices.UniqueSlots[SplitIndices.LocalIndices[FirstPointIdx]]);
+					if (!SplitKey.IsEmpty())
+						TaggedData.Tags.Add(SplitKey);
+				}
+				if (!Cells.IsEmpty())  // Cell coords as tag
+					TaggedData.Tags.Add(GetPartitionCellName(Cells[CellIndices[FirstPointIdx]]));
+				BucketDatas.Emplace(BucketPCGDA, MoveTemp(TaggedData));
+			}
+
+			{  // Transform
+#if ((ENGINE_MAJOR_VERSION == 5) && (ENGINE_MINOR_VERSION >= 6)) || (ENGINE_MAJOR_VERSION > 5)
+				TArray<TPCGValueRange<FTransform>> Transforms;
+				for (UPCGPointArrayData* PointData : PointDatas)
+					Transforms.Add(PointData->GetTransformValueRange());
+				auto GetTransformLambda = [&](const int32& PointIdx) -> FTransform& { return Transforms[Buckets.GetBucketIdx(PointIdx)][Buckets.GetLocalIdx(PointIdx)]; };
+#else
+				auto GetTransformLambda = [&](const int32& PointIdx) -> FTransform& { return (*BucketPoints[Buckets.GetBucketIdx(PointIdx)])[Buckets.GetLocalIdx(PointIdx)].Transform; };
+#endif
+				bool bTransformsRetrieved = false;
+				if (PartInfo.instancedPartCount <= 0)  // Plain point cloud, build transforms from raw attributes rather than let houdini evaluate them per point
+					HOUDINI_FAIL_RETURN(HapiRetrievePointTransforms(NodeId, PartInfo, Schema, GetTransformLambda, bTransformsRetrieved));
+
+				if (!bTransformsRetrieved)
+				{
+					TArray<HAPI_Transform> HapiTransforms;
+					HapiTransforms.SetNumUninitialized(PointCount);
 					{
-						switch (AttribInfo.tupleSize)
+						HOUDINI_PCG_HAPI_CALL_SCOPE(false, PointCount * sizeof(HAPI_Transform));
+						if (PartInfo.instancedPartCount >= 1)
+							HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetInstancerPartTransforms(Session, NodeId, PartId,
+								HAPI_SRT, HapiTransforms.GetData(), 0, PointCount))
+						else
+							HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetInstanceTransformsOnPart(Session, NodeId, PartId,
+								HAPI_SRT, HapiTransforms.GetData(), 0, PointCount))
+					}
+
+					FHoudiniPCGUtils::ParallelForBatch(PointCount, [&](const int32& StartIdx, const int32& EndIdx)
 						{
-						case 1: if (!HapiCreateNumericPCGAttribute<double, double>(NodeId, PartId, AttribInfo,
-							AttribNameStr, FHoudiniApi::GetAttributeFloat64Data, PointData->Metadata, AttribName, 0.0, EntryKeys)) { return false; } break;
-						case 2: if (!HapiCreateNumericPCGAttribute<double, FVector2d>(NodeId, PartId, AttribInfo,
-							AttribNameStr, FHoudiniApi::GetAttributeFloat64Data, PointData->Metadata, AttribName, FVector2d::ZeroVector, EntryKeys)) { return false; } break;
-						case 3: if (!HapiCreateNumericPCGAttribute<double, FVector>(NodeId, PartId, AttribInfo,
-							AttribNameStr, FHoudiniApi::GetAttributeFloat64Data, PointData->Metadata, AttribName, FVector::ZeroVector, EntryKeys)) { return false; } break;
-						case 4: if (!HapiCreateNumericPCGAttribute<double, FVector4>(NodeId, PartId, AttribInfo,
-							AttribNameStr, FHoudiniApi::GetAttributeFloat64Data, PointData->Metadata, AttribName, FVector4::Zero(), EntryKeys)) { return false; } break;
-						case 16: if (!HapiCreateNumericPCGAttribute<double, FTransform>(NodeId, PartId, AttribInfo,
-							AttribNameStr, FHoudiniApi::GetAttributeFloat64Data,
-							[](const TArray<double>& Data, const int32& ValueIdx)
+							for (int32 PointIdx = StartIdx; PointIdx < EndIdx; ++PointIdx)
 							{
-								const FMatrix& UnrealXform = *((FMatrix*)(Data.GetData() + ValueIdx));
-
-								FMatrix HoudiniXform;
-								HoudiniXform.M[0][0] = UnrealXform.M[0][0];
-								HoudiniXform.M[0][1] = UnrealXform.M[0][2];
-								HoudiniXform.M[0][2] = UnrealXform.M[0][1];
-								HoudiniXform.M[0][3] = UnrealXform.M[0][3];
-
-								HoudiniXform.M[1][0] = UnrealXform.M[2][0];
-								HoudiniXform.M[1][1] = UnrealXform.M[2][2];
-								HoudiniXform.M[1][2] = UnrealXform.M[2][1];
-								HoudiniXform.M[1][3] = UnrealXform.M[2][3];
-
-								HoudiniXform.M[2][0] = UnrealXform.M[1][0];
-								HoudiniXform.M[2][1] = UnrealXform.M[1][2];
-								HoudiniXform.M[2][2] = UnrealXform.M[1][1];
-								HoudiniXform.M[2][3] = UnrealXform.M[1][3];
-
-								HoudiniXform.M[3][0] = UnrealXform.M[3][0] * POSITION_SCALE_TO_UNREAL;
-								HoudiniXform.M[3][1] = UnrealXform.M[3][2] * POSITION_SCALE_TO_UNREAL;
-								HoudiniXform.M[3][2] = UnrealXform.M[3][1] * POSITION_SCALE_TO_UNREAL;
-								HoudiniXform.M[3][3] = UnrealXform.M[3][3];
-								return FTransform(HoudiniXform);
-							},
-							PointData->Metadata, AttribName, FTransform::Identity, EntryKeys)) { return false; } break;
-						}
-					}
-					break;
-					case HAPI_STORAGETYPE_STRING:
+								const HAPI_Transform& HapiTransform = HapiTransforms[PointIdx];
+								FTransform& Transform = GetTransformLambda(PointIdx);
+								Transform.SetLocation(FVector(HapiTransform.position[0], HapiTransform.position[2], HapiTransform.position[1]) * POSITION_SCALE_TO_UNREAL_F);
+								Transform.SetRotation(FQuat(HapiTransform.rotationQuaternion[0], HapiTransform.rotationQuaternion[2], HapiTransform.rotationQuaternion[1], -HapiTransform.rotationQuaternion[3]));
+								Transform.SetScale3D(FVector(HapiTransform.scale[0], HapiTransform.scale[2], HapiTransform.scale[1]));
+							}
+						});
+				}
+			}
+
+			if (Schema.IsAttributeExists(HAPI_ATTRIB_DENSITY, HAPI_ATTROWNER_POINT))  // f@density
+			{
+				TArray<float> Data;
+				{
+					HOUDINI_PCG_HAPI_CALL_SCOPE(false, PointCount * sizeof(float));
+					HOUDINI_FAIL_RETURN(Schema.HapiGetFloatData(HAPI_ATTRIB_DENSITY, HAPI_ATTROWNER_POINT, 1, Data));
+				}
+#if ((ENGINE_MAJOR_VERSION == 5) && (ENGINE_MINOR_VERSION >= 6)) || (ENGINE_MAJOR_VERSION > 5)
+				TArray<TPCGValueRange<float>> Densities;
+				for (UPCGPointArrayData* PointData : PointDatas)
+					Densities.Add(PointData->GetDensityValueRange());
+#endif
+				FHoudiniPCGUtils::ParallelForBatch(PointCount, [&](const int32& StartIdx, const int32& EndIdx)
 					{
-						if (EntryKeys.IsEmpty())
-						{
-							EntryKeys.SetNumUninitialized(AttribInfo.count);
-							for (PCGMetadataEntryKey EntryKey = 0; EntryKey < AttribInfo.count; ++EntryKey)
-								EntryKeys[EntryKey] = EntryKey;
-						}
+						for (int32 PointIdx = StartIdx; PointIdx < EndIdx; ++PointIdx)
+#if ((ENGINE_MAJOR_VERSION == 5) && (ENGINE_MINOR_VERSION >= 6)) || (ENGINE_MAJOR_VERSION > 5)
+							Densities[Buckets.GetBucketIdx(PointIdx)][Buckets.GetLocalIdx(PointIdx)] = Data[PointIdx];
+#else
+							(*BucketPoints[Buckets.GetBucketIdx(PointIdx)])[Buckets.GetLocalIdx(PointIdx)].Density = Data[PointIdx];
+#endif
+					});
+			}
 
-						TArray<HAPI_StringHandle> SHs;
-						SHs.SetNumUninitialized(AttribInfo.count);
-						HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetAttributeStringData(FHoudiniEngine::Get().GetSession(), NodeId, PartId,
-							AttribNameStr.c_str(), &AttribInfo, SHs.GetData(), 0, AttribInfo.count));
-						TArray<HAPI_StringHandle> UniqueSHs = TSet<HAPI_StringHandle>(SHs).Array();
-						TArray<FString> UniqueStrs;
-						HOUDINI_FAIL_RETURN(FHoudiniEngineUtils::HapiConvertStringHandles(UniqueSHs, UniqueStrs));
-						if (!IS_ASSET_PATH_INVALID(UniqueStrs[0]))  // SoftObjectPath;
+			{
+				TArray<float> ColorData;
+				if (Schema.IsAttributeExists(HAPI_ATTRIB_COLOR, HAPI_ATTROWNER_POINT))  // v@Cd
+				{
+					HOUDINI_PCG_HAPI_CALL_SCOPE(false, PointCount * 3 * sizeof(float));
+					HOUDINI_FAIL_RETURN(Schema.HapiGetFloatData(HAPI_ATTRIB_COLOR, HAPI_ATTROWNER_POINT, 3, ColorData));
+				}
+				TArray<float> AlphaData;
+				if (Schema.IsAttributeExists(HAPI_ALPHA, HAPI_ATTROWNER_POINT))  // f@Alpha
+				{
+					HOUDINI_PCG_HAPI_CALL_SCOPE(false, PointCount * sizeof(float));
+					HOUDINI_FAIL_RETURN(Schema.HapiGetFloatData(HAPI_ALPHA, HAPI_ATTROWNER_POINT, 1, AlphaData));
+				}
+				if (!ColorData.IsEmpty() || !AlphaData.IsEmpty())
+				{
+#if ((ENGINE_MAJOR_VERSION == 5) && (ENGINE_MINOR_VERSION >= 6)) || (ENGINE_MAJOR_VERSION > 5)
+					TArray<TPCGValueRange<FVector4>> Colors;
+					for (UPCGPointArrayData* PointData : PointDatas)
+						Colors.Add(PointData->GetColorValueRange());
+#endif
+					FHoudiniPCGUtils::ParallelForBatch(PointCount, [&](const int32& StartIdx, const int32& EndIdx)
 						{
-							auto ConvertHoudiniStringToObjectPath = [](const FString& Str) -> FSoftObjectPath
+							for (int32 PointIdx = StartIdx; PointIdx < EndIdx; ++PointIdx)
+							{
+#if ((ENGINE_MAJOR_VERSION == 5) && (ENGINE_MINOR_VERSION >= 6)) || (ENGINE_MAJOR_VERSION > 5)
+								FVector4& Color = Colors[Buckets.GetBucketIdx(PointIdx)][Buckets.GetLocalIdx(PointIdx)];
+#else
+								FVector4& Color = (*BucketPoints[Buckets.GetBucketIdx(PointIdx)])[Buckets.GetLocalIdx(PointIdx)].Color;
+#endif
+								if (!ColorData.IsEmpty())
 								{
-									int32 SplitIdx = -1;
-									if (Str.FindChar(TCHAR(';'), SplitIdx))  // UHoudiniParameterAsset could import ref str with asset info(unreal_ref = import_info), which will append after ';'
-										return Str.Left(SplitIdx);
-									return Str;
-								};
-
-							FPCGMetadataAttribute<FSoftObjectPath>* Attrib = PointData->Metadata->CreateAttribute<FSoftObjectPath>(AttribName, FSoftObjectPath(), true, true);
-							TMap<HAPI_StringHandle, FSoftObjectPath> SHAssetMap;
-							for (int32 UniqueIdx = 0; UniqueIdx < UniqueSHs.Num(); ++UniqueIdx)
-								SHAssetMap.Add(UniqueSHs[UniqueIdx], ConvertHoudiniStringToObjectPath(UniqueStrs[UniqueIdx]));
-							TArray<FSoftObjectPath> Data;
-							for (const HAPI_StringHandle& SH : SHs)
-								Data.Add(SHAssetMap[SH]);
-							Attrib->SetValues(EntryKeys, Data);
-						}
-						else  // String
-						{
-							FPCGMetadataAttribute<FString>* Attrib = PointData->Metadata->CreateAttribute<FString>(AttribName, FString(), true, true);
-							TMap<HAPI_StringHandle, FString> SHAssetMap;
-							for (int32 UniqueIdx = 0; UniqueIdx < UniqueSHs.Num(); ++UniqueIdx)
-								SHAssetMap.Add(UniqueSHs[UniqueIdx], UniqueStrs[UniqueIdx]);
-							TArray<FString> Data;
-							for (const HAPI_StringHandle& SH : SHs)
-								Data.Add(SHAssetMap[SH]);
-							Attrib->SetValues(EntryKeys, Data);
-						}
-					}
-					break;
-					case HAPI_STORAGETYPE_UINT8: if (AttribInfo.tupleSize == 1)
-					{
-						if (!HapiCreateNumericPCGAttribute<uint8, bool>(NodeId, PartId, AttribInfo,
-						AttribNameStr, FHoudiniApi::GetAttributeUInt8Data,
-						[](const TArray<uint8>& Data, const int32& ValueIdx) { return bool(Data[ValueIdx]); },
-						PointData->Metadata, AttribName, false, EntryKeys)) { return false; }
-					}
-					break;
-					case HAPI_STORAGETYPE_INT8: if (AttribInfo.tupleSize == 1)
-					{
-						if (!HapiCreateNumericPCGAttribute<int8, bool>(NodeId, PartId, AttribInfo,
-						AttribNameStr, FHoudiniApi::GetAttributeInt8Data,
-						[](const TArray<int8>& Data, const int32& ValueIdx) { return bool(Data[ValueIdx]); },
-						PointData->Metadata, AttribName, false, EntryKeys)) { return false; }
-					}
-					break;
-					case HAPI_STORAGETYPE_INT16: if (AttribInfo.tupleSize == 1)
-					{
-						if (!HapiCreateNumericPCGAttribute<int16, int32>(NodeId, PartId, AttribInfo,
-						AttribNameStr, FHoudiniApi::GetAttributeInt16Data,
-						[](const TArray<int16>& Data, const int32& ValueIdx) { return int32(Data[ValueIdx]); },
-						PointData->Metadata, AttribName, false, EntryKeys)) { return false; }
-					}
-					break;
-					case HAPI_STORAGETYPE_DICTIONARY:
-						break;
-					}
+									Color.X = ColorData[PointIdx * 3];
+									Color.Y = ColorData[PointIdx * 3 + 1];
+									Color.Z = ColorData[PointIdx * 3 + 2];
+								}
+								if (!AlphaData.IsEmpty())
+									Color.W = AlphaData[PointIdx];
+							}
+						});
 				}
 			}
-#if ((ENGINE_MAJOR_VERSION == 5) && (ENGINE_MINOR_VERSION >= 5)) || (ENGINE_MAJOR_VERSION > 5)
-			PCGDA->Data.AddData(TaggedData, TaggedData.ComputeCrc(false));
+
+			TArray<FHoudiniPCGAttributeTarget> PointTargets;
+			TArray<FHoudiniPCGAttributeTarget> DetailTargets;
+			for (int32 BucketIdx = 0; BucketIdx < NumBuckets; ++BucketIdx)  // TODO: check whether entries are necessary
+			{
+				const int32 BucketPointCount = Buckets.GetBucketPointCount(BucketIdx);
+#if ((ENGINE_MAJOR_VERSION == 5) && (ENGINE_MINOR_VERSION >= 6)) || (ENGINE_MAJOR_VERSION > 5)
+				UPCGPointArrayData* PointData = PointDatas[BucketIdx];
+				TPCGValueRange<int64> Entries = PointData->GetMetadataEntryValueRange();
+#else
+				UPCGPointData* PointData = PointDatas[BucketIdx];
+				TArray<FPCGPoint>& Points = *BucketPoints[BucketIdx];
+#endif
+				FHoudiniPCGUtils::ParallelForBatch(BucketPointCount, [&](const int32& StartIdx, const int32& EndIdx)
+					{
+						for (int32 PointIdx = StartIdx; PointIdx < EndIdx; ++PointIdx)
+						{
+#if ((ENGINE_MAJOR_VERSION == 5) && (ENGINE_MINOR_VERSION >= 6)) || (ENGINE_MAJOR_VERSION > 5)
+							Entries[PointIdx] = int64(PointIdx);
+#else
+							Points[PointIdx].MetadataEntry = PointIdx;  // Must add entry for attribute reader
+#endif
+						}
+					});
+#if ((ENGINE_MAJOR_VERSION == 5) && (ENGINE_MINOR_VERSION >= 6)) || (ENGINE_MAJOR_VERSION > 5)
+				PointData->Metadata->GetMetadataDomain(EPCGMetadataDomainFlag::Elements)->AddEntries(Scratch.GetParentEntryKeys(BucketPointCount));
+#elif ((ENGINE_MAJOR_VERSION == 5) && (ENGINE_MINOR_VERSION >= 5)) || (ENGINE_MAJOR_VERSION > 5)
+				PointData->Metadata->AddEntries(Scratch.GetParentEntryKeys(BucketPointCount));
 #else
-			PCGDA->Data.AddData({ TaggedData }, { TaggedData.ComputeCrc(false) });
+				for (int32 PointIdx = 0; PointIdx < BucketPointCount; ++PointIdx)
+					PointData->Metadata->AddEntry(-1);
 #endif
+				PointTargets.Add(Buckets.MakeTarget(GetElementsMetadata(PointData->Metadata), BucketIdx));
+				DetailTargets.Add(MakeDataTarget(PointData->Metadata, 0));
+			}
+			TArray<FHoudiniPCGStringAttribute> StringAttribs;  // Will be created after all strings of this part have been converted
+			HOUDINI_FAIL_RETURN(HapiRetrievePCGAttributes(NodeId, PartInfo, Schema, HAPI_ATTROWNER_POINT,
+				PointTargets, Scratch, StringCache, StringAttribs));
+			HOUDINI_FAIL_RETURN(HapiRetrievePCGAttributes(NodeId, PartInfo, Schema, HAPI_ATTROWNER_DETAIL,
+				DetailTargets, Scratch, StringCache, StringAttribs));
+
+			HOUDINI_FAIL_RETURN(StringCache.HapiConvertPending());  // Convert tags and all string attributes of this part in one call
+			for (const FHoudiniPCGStringAttribute& StringAttrib : StringAttribs)
+				CreateStringPCGAttribute(StringAttrib, StringCache, Scratch);
+			for (int32 BucketIdx = 0; BucketIdx < NumBuckets; ++BucketIdx)
+			{
+				TPair<UPCGDataAsset*, FPCGTaggedData>& BucketData = BucketDatas[BucketIdx];
+				TagsAttrib.GetTags(StringCache, (TagsAttrib.Owner == HAPI_ATTROWNER_POINT) ? Buckets.GetFirstPointIdx(BucketIdx) : 0, BucketData.Value.Tags);
+				PendingDatas.Add(MoveTemp(BucketData));
+			}
 		}
 		else if (PartInfo.type == HAPI_PARTTYPE_CURVE)  // Curves
 		{
-			HAPI_AttributeInfo AttribInfo;
+			HOUDINI_PCG_STAGE_SCOPE(OutputSplines, PartInfo.pointCount);
 
-			TSharedPtr<FHoudiniAttribute> TagsAttrib;
-			{  // unreal_pcg_tags
-				// Prefer on prim
-				const HAPI_AttributeOwner TagsOwner = FHoudiniEngineUtils::IsAttributeExists(AttribNames, PartInfo.attributeCounts, HAPI_ATTRIB_UNREAL_PCG_TAGS, HAPI_ATTROWNER_PRIM) ?
-					HAPI_ATTROWNER_PRIM : FHoudiniEngineUtils::QueryAttributeOwner(AttribNames, PartInfo.attributeCounts, HAPI_ATTRIB_UNREAL_PCG_TAGS);
-				if (TagsOwner != HAPI_ATTROWNER_INVALID)
-				{
-					HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetAttributeInfo(FHoudiniEngine::Get().GetSession(), NodeId, PartId,
-						HAPI_ATTRIB_UNREAL_PCG_TAGS, TagsOwner, &AttribInfo));
-					if (AttribInfo.exists)
-					{
-						TagsAttrib = FHoudiniEngineUtils::IsArray(AttribInfo.storage) ?
-							MakeShared<FHoudiniArrayAttribute>(TEXT("")) : MakeShared<FHoudiniAttribute>(TEXT(""));
+			HAPI_AttributeInfo AttribInfo;
 
-						HOUDINI_FAIL_RETURN(TagsAttrib->HapiRetrieveData(NodeId, PartId, HAPI_ATTRIB_UNREAL_PCG_TAGS, AttribInfo));
-					}
-				}
-			}
+			FHoudiniPCGTagsAttribute TagsAttrib;  // Prefer on prim
+			HOUDINI_FAIL_RETURN(TagsAttrib.HapiRetrieve(Session, NodeId, PartId, Schema.IsAttributeExists(HAPI_ATTRIB_UNREAL_PCG_TAGS, HAPI_ATTROWNER_PRIM) ?
+				HAPI_ATTROWNER_PRIM : Schema.QueryAttributeOwner(HAPI_ATTRIB_UNREAL_PCG_TAGS), false, StringCache));
 
 			// -------- Retrieve vertex list --------
 			TArray<int32> CurveCounts;
 			CurveCounts.SetNumUninitialized(PartInfo.faceCount);
-			HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetCurveCounts(FHoudiniEngine::Get().GetSession(), NodeId, PartId,
+			HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetCurveCounts(Session, NodeId, PartId,
 				CurveCounts.GetData(), 0, PartInfo.faceCount));
 
 			// -------- Transforms --------
 			TArray<float> PositionData;
 			PositionData.SetNumUninitialized(PartInfo.pointCount * 3);
 
-			HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetAttributeInfo(FHoudiniEngine::Get().GetSession(), NodeId, PartId,
+			HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetAttributeInfo(Session, NodeId, PartId,
 				HAPI_ATTRIB_POSITION, HAPI_ATTROWNER_POINT, &AttribInfo));
 
-			HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetAttributeFloatData(FHoudiniEngine::Get().GetSession(), NodeId, PartId,
-				HAPI_ATTRIB_POSITION, &AttribInfo, -1, PositionData.GetData(), 0, PartInfo.pointCount));
+			{
+				HOUDINI_PCG_HAPI_CALL_SCOPE(false, PartInfo.pointCount * 3 * sizeof(float));
+				HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetAttributeFloatData(Session, NodeId, PartId,
+					HAPI_ATTRIB_POSITION, &AttribInfo, -1, PositionData.GetData(), 0, PartInfo.pointCount));
+			}
 
-			HAPI_AttributeOwner RotOwner = FHoudiniEngineUtils::QueryAttributeOwner(AttribNames, PartInfo.attributeCounts, HAPI_ATTRIB_ROT);
+			HAPI_AttributeOwner RotOwner = Schema.QueryAttributeOwner(HAPI_ATTRIB_ROT);
 			TArray<FQuat> Rots;
 			if (RotOwner != HAPI_ATTROWNER_INVALID)
 			{
-				HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetAttributeInfo(FHoudiniEngine::Get().GetSession(), NodeId, PartId,
+				HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetAttributeInfo(Session, NodeId, PartId,
 					HAPI_ATTRIB_ROT, RotOwner, &AttribInfo));
 
 				if (((AttribInfo.storage == HAPI_STORAGETYPE_FLOAT) || (AttribInfo.storage == HAPI_STORAGETYPE_FLOAT64)) &&
@@ -663,198 +2351,480 @@ bool FHoudiniPCGDataAssetOutputBuilder::HapiRetrieve(AHoudiniNode* Node, const F
 					TArray<float> RotData;
 					RotData.SetNumUninitialized(AttribInfo.count * AttribInfo.tupleSize);
 
-					HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetAttributeFloatData(FHoudiniEngine::Get().GetSession(), NodeId, PartId,
-						HAPI_ATTRIB_ROT, &AttribInfo, -1, RotData.GetData(), 0, AttribInfo.count));
-
-					Rots.SetNumUninitialized(AttribInfo.count);
-					if (AttribInfo.tupleSize == 4)
-					{
-						for (int32 ElemIdx = 0; ElemIdx < AttribInfo.count; ++ElemIdx)
-							Rots[ElemIdx] = FQuat(RotData[ElemIdx * 4], RotData[ElemIdx * 4 + 2], RotData[ElemIdx * 4 + 1], -RotData[ElemIdx * 4 + 3]);
-					}
-					else
 					{
-						for (int32 ElemIdx = 0; ElemIdx < AttribInfo.count; ++ElemIdx)
-							Rots[ElemIdx] = FRotator(FMath::RadiansToDegrees(RotData[ElemIdx * 3]), FMath::RadiansToDegrees(RotData[ElemIdx * 3 + 2]), FMath::RadiansToDegrees(RotData[ElemIdx * 3 + 1])).Quaternion();
+						HOUDINI_PCG_HAPI_CALL_SCOPE(false, AttribInfo.count * AttribInfo.tupleSize * sizeof(float));
+						HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetAttributeFloatData(Session, NodeId, PartId,
+							HAPI_ATTRIB_ROT, &AttribInfo, -1, RotData.GetData(), 0, AttribInfo.count));
 					}
+
+					Rots.SetNumUninitialized(AttribInfo.count);
+					FHoudiniPCGUtils::ParallelForBatch(AttribInfo.count, [&](const int32& StartIdx, const int32& EndIdx)
+						{
+							if (AttribInfo.tupleSize == 4)
+							{
+								for (int32 ElemIdx = StartIdx; ElemIdx < EndIdx; ++ElemIdx)
+									Rots[ElemIdx] = FQuat(RotData[ElemIdx * 4], RotData[ElemIdx * 4 + 2], RotData[ElemIdx * 4 + 1], -RotData[ElemIdx * 4 + 3]);
+							}
+							else
+							{
+								for (int32 ElemIdx = StartIdx; ElemIdx < EndIdx; ++ElemIdx)
+									Rots[ElemIdx] = FRotator(FMath::RadiansToDegrees(RotData[ElemIdx * 3]), FMath::RadiansToDegrees(RotData[ElemIdx * 3 + 2]), FMath::RadiansToDegrees(RotData[ElemIdx * 3 + 1])).Quaternion();
+							}
+						});
 				}
 				else
 					RotOwner = HAPI_ATTROWNER_INVALID;
 			}
 
-			HAPI_AttributeOwner ScaleOwner = FHoudiniEngineUtils::QueryAttributeOwner(AttribNames, PartInfo.attributeCounts, HAPI_ATTRIB_SCALE);
+			HAPI_AttributeOwner ScaleOwner = Schema.QueryAttributeOwner(HAPI_ATTRIB_SCALE);
 			TArray<float> ScaleData;
-			HOUDINI_FAIL_RETURN(FHoudiniEngineUtils::HapiGetFloatAttributeData(NodeId, PartId, HAPI_ATTRIB_SCALE, 3, ScaleData, ScaleOwner));
+			HOUDINI_FAIL_RETURN(Schema.HapiGetFloatData(HAPI_ATTRIB_SCALE, ScaleOwner, 3, ScaleData));
 
 			// -------- Curve Intrinsic --------
-			HAPI_AttributeOwner CurveClosedOwner = FHoudiniEngineUtils::QueryAttributeOwner(AttribNames, PartInfo.attributeCounts, HAPI_CURVE_CLOSED);
+			HAPI_AttributeOwner CurveClosedOwner = Schema.QueryAttributeOwner(HAPI_CURVE_CLOSED);
 			TArray<int8> CurveClosedData;
-			HOUDINI_FAIL_RETURN(FHoudiniEngineUtils::HapiGetEnumAttributeData(NodeId, PartId, HAPI_CURVE_CLOSED, CurveClosedData, CurveClosedOwner));
+			HOUDINI_FAIL_RETURN(Schema.HapiGetInt8Data(HAPI_CURVE_CLOSED, CurveClosedOwner, CurveClosedData));
 
-			HAPI_AttributeOwner ArriveTangentOwner = FHoudiniEngineUtils::QueryAttributeOwner(AttribNames, PartInfo.attributeCounts, HAPI_ATTRIB_UNREAL_SPLINE_POINT_ARRIVE_TANGENT);
+			HAPI_AttributeOwner ArriveTangentOwner = Schema.QueryAttributeOwner(HAPI_ATTRIB_UNREAL_SPLINE_POINT_ARRIVE_TANGENT);
 			TArray<float> ArriveTangentData;
-			HOUDINI_FAIL_RETURN(FHoudiniEngineUtils::HapiGetFloatAttributeData(NodeId, PartId, HAPI_ATTRIB_UNREAL_SPLINE_POINT_ARRIVE_TANGENT, 3, ArriveTangentData, ArriveTangentOwner));
+			HOUDINI_FAIL_RETURN(Schema.HapiGetFloatData(HAPI_ATTRIB_UNREAL_SPLINE_POINT_ARRIVE_TANGENT, ArriveTangentOwner, 3, ArriveTangentData));
 
-			HAPI_AttributeOwner LeaveTangentOwner = FHoudiniEngineUtils::QueryAttributeOwner(AttribNames, PartInfo.attributeCounts, HAPI_ATTRIB_UNREAL_SPLINE_POINT_LEAVE_TANGENT);
+			HAPI_AttributeOwner LeaveTangentOwner = Schema.QueryAttributeOwner(HAPI_ATTRIB_UNREAL_SPLINE_POINT_LEAVE_TANGENT);
 			TArray<float> LeaveTangentData;
-			HOUDINI_FAIL_RETURN(FHoudiniEngineUtils::HapiGetFloatAttributeData(NodeId, PartId, HAPI_ATTRIB_UNREAL_SPLINE_POINT_LEAVE_TANGENT, 3, LeaveTangentData, LeaveTangentOwner));
+			HOUDINI_FAIL_RETURN(Schema.HapiGetFloatData(HAPI_ATTRIB_UNREAL_SPLINE_POINT_LEAVE_TANGENT, LeaveTangentOwner, 3, LeaveTangentData));
 
 			// If has spline point tangents, then we just set to use ESplinePointType::CurveCustomTangent
 			HAPI_AttributeOwner CurveTypeOwner = (!ArriveTangentData.IsEmpty() && !LeaveTangentData.IsEmpty()) ? HAPI_ATTROWNER_INVALID :
-				FHoudiniEngineUtils::QueryAttributeOwner(AttribNames, PartInfo.attributeCounts, HAPI_CURVE_TYPE);
+				Schema.QueryAttributeOwner(HAPI_CURVE_TYPE);
 			TArray<int8> CurveTypeData;
-			HOUDINI_FAIL_RETURN(FHoudiniEngineUtils::HapiGetEnumAttributeData(NodeId, PartId, HAPI_CURVE_TYPE, CurveTypeData, CurveTypeOwner));
+			HOUDINI_FAIL_RETURN(Schema.HapiGetInt8Data(HAPI_CURVE_TYPE, CurveTypeOwner, CurveTypeData));
 
-			int32 CurrVtxIdx = 0;
-			int32 CurveIdx = 0;
-			for (const int32& VertexCount : CurveCounts)
+#if ((ENGINE_MAJOR_VERSION == 5) && (ENGINE_MINOR_VERSION >= 6)) || (ENGINE_MAJOR_VERSION > 5)
+			bool bHasPointAttribs = false;  // Point attribs will be written to spline control points metadata
+			for (int32 AttribIdx = PartInfo.attributeCounts[HAPI_ATTROWNER_VERTEX];
+				AttribIdx < PartInfo.attributeCounts[HAPI_ATTROWNER_VERTEX] + PartInfo.attributeCounts[HAPI_ATTROWNER_POINT]; ++AttribIdx)
 			{
-				FPCGTaggedData TaggedData;
-				UPCGSplineData* SplineData = NewObject<UPCGSplineData>(PCGDA);
-				TaggedData.Data = SplineData;
-
-				if (TagsAttrib.IsValid())
+				if (AttribNames[AttribIdx].starts_with(HAPI_ATTRIB_PREFIX_UNREAL_PCG_ATTRIBUTE))
 				{
-					TArray<FString> Tags = TagsAttrib->GetStringData(FHoudiniOutputUtils::CurveAttributeEntryIdx(TagsAttrib->GetOwner(), CurrVtxIdx, CurveIdx));
-					if (!Tags.IsEmpty())
-					{
-						if (FHoudiniEngineUtils::IsArray(TagsAttrib->GetStorage()))
-							TaggedData.Tags = TSet<FString>(Tags);
-						else if (!Tags[0].IsEmpty())
-							TaggedData.Tags.Add(Tags[0]);
-					}
+					bHasPointAttribs = true;
+					break;
 				}
+			}
+#endif
 
-				for (int32 VtxIdx = CurrVtxIdx; VtxIdx < CurrVtxIdx + VertexCount; ++VtxIdx)
+			const int32 NumCurves = CurveCounts.Num();
+			TArray<int32> CurveVtxStarts;
+			CurveVtxStarts.SetNumUninitialized(NumCurves);
+			int32 MaxVertexCount = 0;
+			{
+				int32 CurrVtxIdx = 0;
+				for (int32 CurveIdx = 0; CurveIdx < NumCurves; ++CurveIdx)
 				{
-					FSplinePoint Point;
-					Point.InputKey = VtxIdx - CurrVtxIdx;
-					Point.Position = FVector(PositionData[VtxIdx * 3], PositionData[VtxIdx * 3 + 2], PositionData[VtxIdx * 3 + 1]) * POSITION_SCALE_TO_UNREAL;
-					if (!Rots.IsEmpty())
-					{
-						Point.Rotation = Rots[FHoudiniOutputUtils::CurveAttributeEntryIdx(RotOwner, VtxIdx, CurveIdx)].Rotator();
-					}
-					if (!ScaleData.IsEmpty())
-					{
-						const int32 ValueIdx = FHoudiniOutputUtils::CurveAttributeEntryIdx(ScaleOwner, VtxIdx, CurveIdx) * 3;
-						Point.Scale = FVector(ScaleData[ValueIdx], ScaleData[ValueIdx + 2], ScaleData[ValueIdx + 1]);
-					}
-					if (!ArriveTangentData.IsEmpty())
-					{
-						const int32 ValueIdx = FHoudiniOutputUtils::CurveAttributeEntryIdx(ArriveTangentOwner, VtxIdx, CurveIdx) * 3;
-						Point.ArriveTangent = FVector(ArriveTangentData[ValueIdx], ArriveTangentData[ValueIdx + 2], ArriveTangentData[ValueIdx + 1]) * POSITION_SCALE_TO_UNREAL;
-					}
-					if (!LeaveTangentData.IsEmpty())
+					CurveVtxStarts[CurveIdx] = CurrVtxIdx;
+					MaxVertexCount = FMath::Max(MaxVertexCount, CurveCounts[CurveIdx]);
+					CurrVtxIdx += CurveCounts[CurveIdx];
+				}
+			}
+
+			// -------- Tile splines by the center of control point bounds --------
+			TArray<int32> CellIndices;
+			TArray<FIntPoint> Cells;
+			TArray<UPCGDataAsset*> CellPCGDAs;  // Only if output cells as separate assets
+			if (PartitionGridSize > 0.0)
+			{
+				BinToPartitionCells(NumCurves, [&](const int32& CurveIdx)
 					{
-						const int32 ValueIdx = FHoudiniOutputUtils::CurveAttributeEntryIdx(LeaveTangentOwner, VtxIdx, CurveIdx) * 3;
-						Point.LeaveTangent = FVector(LeaveTangentData[ValueIdx], LeaveTangentData[ValueIdx + 2], LeaveTangentData[ValueIdx + 1]) * POSITION_SCALE_TO_UNREAL;
-					}
-					Point.Type = (ArriveTangentData.IsEmpty() || LeaveTangentData.IsEmpty()) ?
-						((!CurveTypeData.IsEmpty() && (CurveTypeData[FHoudiniOutputUtils::CurveAttributeEntryIdx(CurveTypeOwner, VtxIdx, CurveIdx)] <= 0)) ?
-							ESplinePointType::Linear : ESplinePointType::Curve) : ESplinePointType::CurveCustomTangent;
+						FBox2D Bounds(ForceInit);
+						for (int32 VtxIdx = CurveVtxStarts[CurveIdx]; VtxIdx < CurveVtxStarts[CurveIdx] + CurveCounts[CurveIdx]; ++VtxIdx)
+							Bounds += FVector2D(PositionData[VtxIdx * 3], PositionData[VtxIdx * 3 + 2]);
+						return Bounds.GetCenter() * POSITION_SCALE_TO_UNREAL;
+					}, PartitionGridSize, CellIndices, Cells);
 
-					SplineData->SplineStruct.AddPoint(Point, false);
+				if (bPartitionCellAssets)
+				{
+					for (const FIntPoint& Cell : Cells)
+						CellPCGDAs.Add(FindOrCreateCellPCGDALambda(ObjectPath, Cell, PartitionGridSize, bCompact));
 				}
+			}
 
-				if (!CurveClosedData.IsEmpty())
+			// -------- Create all splines on game thread --------
+			LLM_SCOPE_BYTAG(HoudiniPCG_PCGData);
+			TArray<UPCGSplineData*> SplineDatas;
+			SplineDatas.SetNumUninitialized(NumCurves);
+			TArray<FHoudiniPCGAttributeTarget> PointTargets;
+			TArray<FHoudiniPCGAttributeTarget> PrimTargets;
+			TArray<FHoudiniPCGAttributeTarget> DetailTargets;
+			for (int32 CurveIdx = 0; CurveIdx < NumCurves; ++CurveIdx)
+			{
+				UPCGSplineData* SplineData = NewObject<UPCGSplineData>(CellPCGDAs.IsEmpty() ? PCGDA : CellPCGDAs[CellIndices[CurveIdx]]);
+				SplineDatas[CurveIdx] = SplineData;
+#if ((ENGINE_MAJOR_VERSION == 5) && (ENGINE_MINOR_VERSION >= 6)) || (ENGINE_MAJOR_VERSION > 5)
+				if (bHasPointAttribs)
 				{
-					SplineData->SplineStruct.bClosedLoop = bool(CurveClosedData[FHoudiniOutputUtils::CurveAttributeEntryIdx(CurveClosedOwner, CurrVtxIdx, CurveIdx)]);
+					PointTargets.Add(FHoudiniPCGAttributeTarget(GetElementsMetadata(SplineData->Metadata), CurveVtxStarts[CurveIdx], CurveCounts[CurveIdx]));
+					PointTargets.Last().Metadata->AddEntries(Scratch.GetParentEntryKeys(CurveCounts[CurveIdx]));
 				}
-				SplineData->SplineStruct.UpdateSpline();
-				SplineData->SplineStruct.Bounds = SplineData->SplineStruct.GetBounds();
-				SplineData->SplineStruct.LocalBounds = SplineData->SplineStruct.Bounds;
-#if ((ENGINE_MAJOR_VERSION == 5) && (ENGINE_MINOR_VERSION >= 5)) || (ENGINE_MAJOR_VERSION > 5)
-				PCGDA->Data.AddData(TaggedData, TaggedData.ComputeCrc(false));
+#endif
+				PrimTargets.Add(MakeDataTarget(SplineData->Metadata, CurveIdx));
+				DetailTargets.Add(MakeDataTarget(SplineData->Metadata, 0));
+			}
+
+			// -------- Fill spline curves, reparam tables and bounds in parallel --------
+			const FHoudiniCurveAttributeIndexer RotIndexer(RotOwner);
+			const FHoudiniCurveAttributeIndexer ScaleIndexer(ScaleOwner);
+			const FHoudiniCurveAttributeIndexer ArriveTangentIndexer(ArriveTangentOwner);
+			const FHoudiniCurveAttributeIndexer LeaveTangentIndexer(LeaveTangentOwner);
+			const FHoudiniCurveAttributeIndexer CurveTypeIndexer(CurveTypeOwner);
+			const FHoudiniCurveAttributeIndexer CurveClosedIndexer(CurveClosedOwner);
+#if ((ENGINE_MAJOR_VERSION == 5) && (ENGINE_MINOR_VERSION >= 6)) || (ENGINE_MAJOR_VERSION > 5)
+			const TArrayView<const PCGMetadataEntryKey> IdentityEntryKeys = Scratch.GetIdentityEntryKeys(bHasPointAttribs ? MaxVertexCount : 0);
+#endif
+			ParallelFor(NumCurves, [&](int32 CurveIdx)
+				{
+					LLM_SCOPE_BYTAG(HoudiniPCG_PCGData);
+
+					const int32& StartVtxIdx = CurveVtxStarts[CurveIdx];
+					const int32& VertexCount = CurveCounts[CurveIdx];
+					UPCGSplineData* SplineData = SplineDatas[CurveIdx];
+#if ((ENGINE_MAJOR_VERSION == 5) && (ENGINE_MINOR_VERSION >= 6)) || (ENGINE_MAJOR_VERSION > 5)
+					TArray<FSplinePoint> SplinePoints;
+					SplinePoints.SetNumUninitialized(VertexCount);
+#else
+					FSplineCurves& SplineCurves = SplineData->SplineStruct.SplineCurves;
+					SplineCurves.Position.Points.SetNumUninitialized(VertexCount);
+					SplineCurves.Rotation.Points.SetNumUninitialized(VertexCount);
+					SplineCurves.Scale.Points.SetNumUninitialized(VertexCount);
+#endif
+					for (int32 PointIdx = 0; PointIdx < VertexCount; ++PointIdx)
+					{
+						const int32 VtxIdx = StartVtxIdx + PointIdx;
+						const FVector Position = FVector(PositionData[VtxIdx * 3], PositionData[VtxIdx * 3 + 2], PositionData[VtxIdx * 3 + 1]) * POSITION_SCALE_TO_UNREAL;
+						const FQuat Rotation = Rots.IsEmpty() ? FQuat::Identity : Rots[RotIndexer(VtxIdx, CurveIdx)];
+						FVector Scale = FVector::OneVector;
+						if (!ScaleData.IsEmpty())
+						{
+							const int32 ValueIdx = ScaleIndexer(VtxIdx, CurveIdx) * 3;
+							Scale = FVector(ScaleData[ValueIdx], ScaleData[ValueIdx + 2], ScaleData[ValueIdx + 1]);
+						}
+						FVector ArriveTangent = FVector::ZeroVector;
+						if (!ArriveTangentData.IsEmpty())
+						{
+							const int32 ValueIdx = ArriveTangentIndexer(VtxIdx, CurveIdx) * 3;
+							ArriveTangent = FVector(ArriveTangentData[ValueIdx], ArriveTangentData[ValueIdx + 2], ArriveTangentData[ValueIdx + 1]) * POSITION_SCALE_TO_UNREAL;
+						}
+						FVector LeaveTangent = FVector::ZeroVector;
+						if (!LeaveTangentData.IsEmpty())
+						{
+							const int32 ValueIdx = LeaveTangentIndexer(VtxIdx, CurveIdx) * 3;
+							LeaveTangent = FVector(LeaveTangentData[ValueIdx], LeaveTangentData[ValueIdx + 2], LeaveTangentData[ValueIdx + 1]) * POSITION_SCALE_TO_UNREAL;
+						}
+						const ESplinePointType::Type PointType = (ArriveTangentData.IsEmpty() || LeaveTangentData.IsEmpty()) ?
+							((!CurveTypeData.IsEmpty() && (CurveTypeData[CurveTypeIndexer(VtxIdx, CurveIdx)] <= 0)) ?
+								ESplinePointType::Linear : ESplinePointType::Curve) : ESplinePointType::CurveCustomTangent;
+
+#if ((ENGINE_MAJOR_VERSION == 5) && (ENGINE_MINOR_VERSION >= 6)) || (ENGINE_MAJOR_VERSION > 5)
+						SplinePoints[PointIdx] = FSplinePoint(float(PointIdx), Position, ArriveTangent, LeaveTangent, Rotation.Rotator(), Scale, PointType);
+#else
+						// Same as FPCGSplineStruct::AddPoint, but points are already sorted by input key
+						SplineCurves.Position.Points[PointIdx] = FInterpCurvePoint<FVector>(float(PointIdx), Position, ArriveTangent, LeaveTangent,
+							(PointType == ESplinePointType::Linear) ? CIM_Linear : ((PointType == ESplinePointType::CurveCustomTangent) ? CIM_CurveUser : CIM_CurveAuto));
+						SplineCurves.Rotation.Points[PointIdx] = FInterpCurvePoint<FQuat>(float(PointIdx), Rotation, FQuat::Identity, FQuat::Identity, CIM_CurveAuto);
+						SplineCurves.Scale.Points[PointIdx] = FInterpCurvePoint<FVector>(float(PointIdx), Scale, FVector::ZeroVector, FVector::ZeroVector, CIM_CurveAuto);
+#endif
+					}
+
+					const bool bClosedLoop = CurveClosedData.IsEmpty() ? false : bool(CurveClosedData[CurveClosedIndexer(StartVtxIdx, CurveIdx)]);
+#if ((ENGINE_MAJOR_VERSION == 5) && (ENGINE_MINOR_VERSION >= 6)) || (ENGINE_MAJOR_VERSION > 5)
+					TArray<PCGMetadataEntryKey> EntryKeys;
+					if (bHasPointAttribs)
+						EntryKeys.Append(IdentityEntryKeys.GetData(), VertexCount);
+					SplineData->Initialize(SplinePoints, bClosedLoop, FTransform::Identity, MoveTemp(EntryKeys));  // Only touch this spline data, so could run on workers
 #else
-				PCGDA->Data.AddData({ TaggedData }, { TaggedData.ComputeCrc(false) });
+					SplineData->SplineStruct.bClosedLoop = bClosedLoop;
+					SplineData->SplineStruct.UpdateSpline();
 #endif
-				CurrVtxIdx += VertexCount;
-				++CurveIdx;
+					SplineData->SplineStruct.Bounds = SplineData->SplineStruct.GetBounds();
+					SplineData->SplineStruct.LocalBounds = SplineData->SplineStruct.Bounds;
+				}, (NumCurves <= 1) ? EParallelForFlags::ForceSingleThread : EParallelForFlags::Unbalanced);
+
+			// -------- PCG attributes --------
+			TArray<FHoudiniPCGStringAttribute> StringAttribs;
+			HOUDINI_FAIL_RETURN(HapiRetrievePCGAttributes(NodeId, PartInfo, Schema, HAPI_ATTROWNER_POINT, PointTargets, Scratch, StringCache, StringAttribs));
+			HOUDINI_FAIL_RETURN(HapiRetrievePCGAttributes(NodeId, PartInfo, Schema, HAPI_ATTROWNER_PRIM, PrimTargets, Scratch, StringCache, StringAttribs));
+			HOUDINI_FAIL_RETURN(HapiRetrievePCGAttributes(NodeId, PartInfo, Schema, HAPI_ATTROWNER_DETAIL, DetailTargets, Scratch, StringCache, StringAttribs));
+
+			HOUDINI_FAIL_RETURN(StringCache.HapiConvertPending());  // Convert tags and all string attributes of this part in one call
+			for (const FHoudiniPCGStringAttribute& StringAttrib : StringAttribs)
+				CreateStringPCGAttribute(StringAttrib, StringCache, Scratch);
+
+			const FHoudiniCurveAttributeIndexer TagsIndexer(TagsAttrib.Owner);
+			for (int32 CurveIdx = 0; CurveIdx < NumCurves; ++CurveIdx)
+			{
+				FPCGTaggedData TaggedData;
+				TaggedData.Data = SplineDatas[CurveIdx];
+				if (TagsAttrib.Owner != HAPI_ATTROWNER_INVALID)
+					TagsAttrib.GetTags(StringCache, TagsIndexer(CurveVtxStarts[CurveIdx], CurveIdx), TaggedData.Tags);
+				if (!Cells.IsEmpty())  // Cell coords as tag
+					TaggedData.Tags.Add(GetPartitionCellName(Cells[CellIndices[CurveIdx]]));
+				PendingDatas.Emplace(CellPCGDAs.IsEmpty() ? PCGDA : CellPCGDAs[CellIndices[CurveIdx]], MoveTemp(TaggedData));
 			}
 		}
 #if ((ENGINE_MAJOR_VERSION == 5) && (ENGINE_MINOR_VERSION >= 5)) || (ENGINE_MAJOR_VERSION > 5)
 		if ((PartInfo.type == HAPI_PARTTYPE_MESH) && (PartInfo.faceCount >= 1))  // Mesh
 		{
+			HOUDINI_PCG_STAGE_SCOPE(OutputMeshes, PartInfo.pointCount);
+
 			FPCGTaggedData TaggedData;
 			UPCGDynamicMeshData* DMData = NewObject<UPCGDynamicMeshData>(PCGDA);
 			TaggedData.Data = DMData;
 
-			HOUDINI_FAIL_RETURN(HapiGetTags(NodeId, PartId, FHoudiniEngineUtils::IsAttributeExists(AttribNames, PartInfo.attributeCounts, HAPI_ATTRIB_UNREAL_PCG_TAGS, HAPI_ATTROWNER_PRIM) ?
-				HAPI_ATTROWNER_PRIM : FHoudiniEngineUtils::QueryAttributeOwner(AttribNames, PartInfo.attributeCounts, HAPI_ATTRIB_UNREAL_PCG_TAGS), TaggedData.Tags));
-
-			HAPI_AttributeInfo AttribInfo;
+			{
+				FHoudiniPCGTagsAttribute TagsAttrib;  // Prefer on prim
+				HOUDINI_FAIL_RETURN(TagsAttrib.HapiRetrieve(Session, NodeId, PartId, Schema.IsAttributeExists(HAPI_ATTRIB_UNREAL_PCG_TAGS, HAPI_ATTROWNER_PRIM) ?
+					HAPI_ATTROWNER_PRIM : Schema.QueryAttributeOwner(HAPI_ATTRIB_UNREAL_PCG_TAGS), true, StringCache));
+
+				UE::Geometry::FDynamicMesh3 DM;
+				TArray<UMaterialInterface*> Materials;
+				HOUDINI_FAIL_RETURN(HapiRetrieveDynamicMesh(NodeId, PartInfo, Schema, StringCache, DM, Materials));
+				TagsAttrib.GetTags(StringCache, 0, TaggedData.Tags);
+				DMData->Initialize(MoveTemp(DM), Materials);
+			}
 
-			// TODO: should copy the code from my houdini engine to support full dynamic mesh attributes and materials
+			PendingDatas.Emplace(PCGDA, MoveTemp(TaggedData));
+		}
+#endif
+	}
 
-			// -------- Retrieve mesh data --------
-			TArray<float> PositionData;
-			PositionData.SetNumUninitialized(PartInfo.pointCount * 3);
+	for (const TPair<FString, FHoudiniPCGPartitionIndex>& PartitionIndex : PartitionIndices)  // Graphs could load the index first, then only load cells they need
+	{
+		UPCGDataAsset* IndexPCGDA = FindOrCreatePCGDALambda(PartitionIndex.Key, false);
+		FPCGTaggedData TaggedData;
+		TaggedData.Data = CreatePartitionIndexData(IndexPCGDA, PartitionIndex.Value);
+		TaggedData.Tags.Add(TEXT("PartitionIndex"));
+		PendingDatas.Emplace(IndexPCGDA, MoveTemp(TaggedData));
+	}
 
-			HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetAttributeInfo(FHoudiniEngine::Get().GetSession(), NodeId, PartId,
-				HAPI_ATTRIB_POSITION, HAPI_ATTROWNER_POINT, &AttribInfo));
+	// Full data crcs are derived from content rather than object uid, so that re-cook the identical geometry will hit the PCG graph cache
+	TArray<FPCGCrc> DataCrcs;
+	DataCrcs.SetNum(PendingDatas.Num());
+	{
+		HOUDINI_PCG_STAGE_SCOPE(OutputCrc, PendingDatas.Num());
+		ParallelFor(PendingDatas.Num(), [&](int32 DataIdx)
+			{
+				DataCrcs[DataIdx] = PendingDatas[DataIdx].Value.ComputeCrc(true);
+				if (bSpatialSort)  // Datas are complete now, so that consumers need NOT to build octrees on their first spatial query
+					UHoudiniPCGCompactDataAsset::PrebuildPointOctree(PendingDatas[DataIdx].Value.Data);
+			}, (PendingDatas.Num() <= 1) ? EParallelForFlags::ForceSingleThread : EParallelForFlags::Unbalanced);
+	}
 
-			HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetAttributeFloatData(FHoudiniEngine::Get().GetSession(), NodeId, PartId,
-				HAPI_ATTRIB_POSITION, &AttribInfo, -1, PositionData.GetData(), 0, PartInfo.pointCount));
+	for (int32 DataIdx = 0; DataIdx < PendingDatas.Num(); ++DataIdx)
+	{
+		const TPair<UPCGDataAsset*, FPCGTaggedData>& PendingData = PendingDatas[DataIdx];
+#if ((ENGINE_MAJOR_VERSION == 5) && (ENGINE_MINOR_VERSION >= 5)) || (ENGINE_MAJOR_VERSION > 5)
+		PendingData.Key->Data.AddData(PendingData.Value, DataCrcs[DataIdx]);
+#else
+		PendingData.Key->Data.AddData({ PendingData.Value }, { DataCrcs[DataIdx] });
+#endif
+	}
 
-			TArray<int32> Vertices;
-			Vertices.SetNumUninitialized(PartInfo.vertexCount);
-			HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetVertexList(FHoudiniEngine::Get().GetSession(), NodeId, PartId,
-				Vertices.GetData(), 0, PartInfo.vertexCount));
+	for (UPCGDataAsset* PCGDA : OutPCGDAs)  // Octrees are NOT serialized, so compact assets rebuild them after loaded
+	{
+		if (UHoudiniPCGCompactDataAsset* CompactPCGDA = Cast<UHoudiniPCGCompactDataAsset>(PCGDA))
+			CompactPCGDA->bPrebuildOctree = bSpatialSort;
+	}
 
-			FDynamicMesh3 DM;
+	StringCache.GetObjectPaths(OutObjectPaths);
 
-			TMap<int32, int> PointIdxMap;  // PointIdx map to dynamic mesh vertex idx
-			for (int32 TriIdx = 0; TriIdx < PartInfo.faceCount; ++TriIdx)
-			{
-				const FIntVector3 HoudiniPoints(Vertices[TriIdx * 3], Vertices[TriIdx * 3 + 1], Vertices[TriIdx * 3 + 2]);
-				if ((HoudiniPoints.X == HoudiniPoints.Y) || (HoudiniPoints.Y == HoudiniPoints.Z) || (HoudiniPoints.Z == HoudiniPoints.X))  // Skip degenerated triangle
-					continue;
+	return true;
+}
 
-				FIntVector3 IsNewPoints = FIntVector3::ZeroValue;
-				UE::Geometry::FIndex3i Triangle;
-				for (int32 TriVtxIdx = 0; TriVtxIdx < 3; ++TriVtxIdx)
-				{
-					const int32& GlobalPointIdx = HoudiniPoints[TriVtxIdx];  // This PointIdx is in global
-					int LocalPointIdx;
-					{
-						const int* FoundLocalPointIdxPtr = PointIdxMap.Find(GlobalPointIdx);
-						if (!FoundLocalPointIdxPtr)
-						{
-							LocalPointIdx = DM.AppendVertex(POSITION_SCALE_TO_UNREAL *
-								FVector3d(PositionData[GlobalPointIdx * 3], PositionData[GlobalPointIdx * 3 + 2], PositionData[GlobalPointIdx * 3 + 1]));
-							PointIdxMap.Add(GlobalPointIdx, LocalPointIdx);
-							IsNewPoints[TriVtxIdx] = 1;
-						}
-						else
-							LocalPointIdx = *FoundLocalPointIdxPtr;
-					}
+bool FHoudiniPCGDataAssetOutputBuilder::HapiRetrieve(AHoudiniNode* Node, const FString& OutputName, const HAPI_GeoInfo& GeoInfo, const TArray<HAPI_PartInfo>& PartInfos)
+{
+	const bool bPreview = Node && IsPreviewEnabled();  // Retrieval without a node is a headless bake, so always write assets
 
-					Triangle[2 - TriVtxIdx] = LocalPointIdx;
-				}
+	// Inputs are marked changed when previews turned off, if some were still NOT uploaded again, then never write outputs cooked from them to assets
+	if (!bPreview && Node && FHoudiniPCGComponentInput::HasDecimatedInputs(Node))
+	{
+		FHoudiniPCGComponentInput::MarkInputsChanged(false, Node);
+		UE_LOG(LogHoudiniPCGOutput, Warning, TEXT("%s: PCG inputs were decimated for previews, outputs skipped, recook to upload them in full"), *Node->GetName());
+		return true;
+	}
 
-				DM.AppendTriangle(Triangle.A, Triangle.B, Triangle.C, 0);
-			}
+	TArray<UPCGDataAsset*> PCGDAs;
+	TArray<FSoftObjectPath> ObjectPaths;
+	HOUDINI_FAIL_RETURN(HapiRetrievePCGDatas(GeoInfo.nodeId, (Node ? FHoudiniOutputUtils::GetCookFolderPath(Node) : DefaultCookFolderPath) + TEXT("PCGDA_") + OutputName + TEXT("_"),
+		PartInfos, bPreview ? &PreviewPCGDAs : nullptr, PCGDAs, ObjectPaths));
 
-			DMData->Initialize(UE::Geometry::FDynamicMesh3(DM));
+	if (bPreview)  // Only notify inputs that reference the loaded assets, to upload previews instead
+	{
+		if (FHoudiniPCGComponentInput::HasDecimatedInputs(Node))  // Recorded by PCG inputs of this node at their last upload
+			bPreviewsDecimated = true;
 
-			PCGDA->Data.AddData(TaggedData, TaggedData.ComputeCrc(false));
+		for (const TPair<FString, TObjectPtr<UPCGDataAsset>>& Preview : PreviewPCGDAs)
+		{
+			if (PCGDAs.Contains(Preview.Value))
+			{
+				if (UPCGDataAsset* PCGDA = FindObject<UPCGDataAsset>(nullptr, *Preview.Key))
+					FHoudiniEngineUtils::NotifyAssetChanged(PCGDA);
+			}
 		}
-#endif
+		return true;
 	}
 
+	// Only wait for static meshes referenced by these PCG datas, rather than finish all compilations in editor
 	for (UPCGDataAsset* PCGDA : PCGDAs)
 	{
 		PCGDA->Modify();
-		FHoudiniEngineUtils::NotifyAssetChanged(PCGDA);  // Notify all HDAs' PCGDataAsset input this asset has been modified
+		PendingNotifyAssets.FindOrAdd(PCGDA).Append(ObjectPaths);
+		PreviewPCGDAs.Remove(GetAssetObjectPath(PCGDA->GetPathName()));  // Superseded by this full cook, so inputs will load the asset again
+	}
+	if (PreviewPCGDAs.IsEmpty())
+		bPreviewsDecimated = false;
+
+	if (!PendingNotifyAssets.IsEmpty() && !NotifyTickerHandle.IsValid())  // Static mesh outputs of this cook may be created after, so notify at least one frame later
+		NotifyTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FHoudiniPCGDataAssetOutputBuilder::TickNotify));
+
+	return true;
+}
+
+bool FHoudiniPCGDataAssetOutputBuilder::HapiRetrieveTransient(const HAPI_GeoInfo& GeoInfo, const TArray<HAPI_PartInfo>& PartInfos, FPCGDataCollection& OutData)
+{
+	TMap<FString, TObjectPtr<UPCGDataAsset>> TransientPCGDAs;  // Containers only, datas are kept alive by their outers
+	TArray<UPCGDataAsset*> PCGDAs;
+	TArray<FSoftObjectPath> ObjectPaths;  // Nothing to notify, so need NOT to wait for the referenced static meshes
+	HOUDINI_FAIL_RETURN(HapiRetrievePCGDatas(GeoInfo.nodeId, TEXT("/Engine/Transient/PCGDA_"), PartInfos, &TransientPCGDAs, PCGDAs, ObjectPaths));
+
+	for (const UPCGDataAsset* PCGDA : PCGDAs)
+	{
+		OutData.TaggedData.Append(PCGDA->Data.TaggedData);
+		OutData.DataCrcs.Append(PCGDA->Data.DataCrcs);
 	}
 
-	// After all static mesh outputs finished
-	AsyncTask(ENamedThreads::GameThread, [PCGDAs]
+	return true;
+}
+
+
+// -------- Preview output --------
+static TAutoConsoleVariable<bool> CVarHoudiniPCGPreviewOutput(
+	TEXT("HoudiniPCG.PreviewOutput"),
+	false,
+	TEXT("Output PCG datas of HDAs to transient assets rather than packages, PCGDataAsset inputs and \"Houdini Load Output\" nodes will use these previews, ")
+	TEXT("run HoudiniPCG.BakePreviewOutputs to write them to assets"),
+	FConsoleVariableDelegate::CreateLambda([](IConsoleVariable*) { FHoudiniPCGComponentInput::MarkInputsChanged(false); }));  // Decimated inputs upload again in full
+
+bool FHoudiniPCGDataAssetOutputBuilder::IsPreviewEnabled()
+{
+	return CVarHoudiniPCGPreviewOutput.GetValueOnGameThread();
+}
+
+UPCGDataAsset* FHoudiniPCGDataAssetOutputBuilder::FindPreview(const FSoftObjectPath& AssetPath) const
+{
+	if (PreviewPCGDAs.IsEmpty() || AssetPath.IsNull())
+		return nullptr;
+
+	const TObjectPtr<UPCGDataAsset>* FoundPCGDAPtr = PreviewPCGDAs.Find(GetAssetObjectPath(AssetPath.ToString()));
+	return FoundPCGDAPtr ? FoundPCGDAPtr->Get() : nullptr;
+}
+
+bool FHoudiniPCGDataAssetOutputBuilder::BakePreviews()
+{
+	if (bPreviewsDecimated)  // Outputs of decimated inputs are NOT what a full cook produces, so never write them to assets
+		return false;
+
+	for (const TPair<FString, TObjectPtr<UPCGDataAsset>>& Preview : PreviewPCGDAs)
+	{
+		UPCGDataAsset* PreviewPCGDA = Preview.Value;
+		if (!IsValid(PreviewPCGDA))
+			continue;
+
+		UPCGDataAsset* PCGDA = PreviewPCGDA->IsA<UHoudiniPCGCompactDataAsset>() ? FHoudiniEngineUtils::FindOrCreateAsset<UHoudiniPCGCompactDataAsset>(Preview.Key) :
+			FHoudiniEngineUtils::FindOrCreateAsset<UPCGDataAsset>(Preview.Key);
+		PCGDA->Modify();
+		if (UHoudiniPCGCompactDataAsset* CompactPCGDA = Cast<UHoudiniPCGCompactDataAsset>(PCGDA))
+			CompactPCGDA->bPrebuildOctree = CastChecked<UHoudiniPCGCompactDataAsset>(PreviewPCGDA)->bPrebuildOctree;
+		PCGDA->Data.Reset();
+		PCGDA->Data.DataCrcs.Empty();
+		for (int32 DataIdx = 0; DataIdx < PreviewPCGDA->Data.TaggedData.Num(); ++DataIdx)
 		{
-			FStaticMeshCompilingManager::Get().FinishAllCompilation();
-			for (UPCGDataAsset* PCGDA : PCGDAs)
-				PCGDA->PostEditChange();
-		});
+			const FPCGTaggedData& TaggedData = PreviewPCGDA->Data.TaggedData[DataIdx];
+			const_cast<UPCGData*>(TaggedData.Data.Get())->Rename(nullptr, PCGDA, REN_DontCreateRedirectors | REN_NonTransactional);  // Move rather than copy, as previews will be cleared
+			const FPCGCrc DataCrc = PreviewPCGDA->Data.DataCrcs.IsValidIndex(DataIdx) ? PreviewPCGDA->Data.DataCrcs[DataIdx] : FPCGCrc();
+#if ((ENGINE_MAJOR_VERSION == 5) && (ENGINE_MINOR_VERSION >= 5)) || (ENGINE_MAJOR_VERSION > 5)
+			PCGDA->Data.AddData(TaggedData, DataCrc);
+#else
+			PCGDA->Data.AddData({ TaggedData }, { DataCrc });
+#endif
+		}
+		PendingNotifyAssets.FindOrAdd(PCGDA);  // Static meshes referenced have been compiled during preview
+	}
+
+	PreviewPCGDAs.Empty();
+	bPreviewsDecimated = false;
+
+	if (!PendingNotifyAssets.IsEmpty() && !NotifyTickerHandle.IsValid())
+		NotifyTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FHoudiniPCGDataAssetOutputBuilder::TickNotify));
+
+	return true;
+}
+
+static FAutoConsoleCommandWithOutputDevice GHoudiniPCGBakePreviewOutputsCmd(
+	TEXT("HoudiniPCG.BakePreviewOutputs"),
+	TEXT("Write all PCG datas output while HoudiniPCG.PreviewOutput = 1 to their PCGDataAssets, then clear the previews"),
+	FConsoleCommandWithOutputDeviceDelegate::CreateLambda([](FOutputDevice& Ar)
+		{
+			if (!FHoudiniPCGTranslator::Get().GetOutputBuilder()->BakePreviews())
+				Ar.Log(ELogVerbosity::Warning, TEXT("Previews were cooked from decimated PCG inputs (HoudiniPCG.InputPreviewRatio/InputPreviewGridSize), ")
+					TEXT("set HoudiniPCG.PreviewOutput 0 and recook, so that inputs are uploaded in full and outputs are written to assets"));
+		}));
+
+FHoudiniPCGDataAssetOutputBuilder::~FHoudiniPCGDataAssetOutputBuilder()
+{
+	if (NotifyTickerHandle.IsValid())
+		FTSTicker::GetCoreTicker().RemoveTicker(NotifyTickerHandle);
+}
+
+bool FHoudiniPCGDataAssetOutputBuilder::TickNotify(float DeltaTime)
+{
+	TArray<UPCGDataAsset*> ReadyPCGDAs;
+	for (auto PendingIter = PendingNotifyAssets.CreateIterator(); PendingIter; ++PendingIter)
+	{
+		UPCGDataAsset* PCGDA = PendingIter->Key.Get();
+		if (!IsValid(PCGDA))
+		{
+			PendingIter.RemoveCurrent();
+			continue;
+		}
+
+		bool bIsCompiling = false;
+		for (const FSoftObjectPath& ObjectPath : PendingIter->Value)
+		{
+			const UStaticMesh* SM = Cast<UStaticMesh>(ObjectPath.ResolveObject());  // Never load here, unloaded assets are NOT compiling
+			if (SM && SM->IsCompiling())
+			{
+				bIsCompiling = true;
+				break;
+			}
+		}
+
+		if (!bIsCompiling)
+		{
+			ReadyPCGDAs.Add(PCGDA);
+			PendingIter.RemoveCurrent();
+		}
+	}
+
+	HOUDINI_PCG_STAGE_SCOPE(OutputNotify, ReadyPCGDAs.Num());
+	for (UPCGDataAsset* PCGDA : ReadyPCGDAs)  // All assets ready in this frame are notified in one batch
+	{
+		PCGDA->PostEditChange();
+		FHoudiniEngineUtils::NotifyAssetChanged(PCGDA);  // Notify all HDAs' PCGDataAsset input this asset has been modified
+	}
+
+	if (PendingNotifyAssets.IsEmpty())
+	{
+		NotifyTickerHandle.Reset();
+		return false;
+	}
 
 	return true;
 }
@@ -0,0 +1,582 @@
+// Copyright Yuzhe Pan (childadrianpan@gmail.com). All Rights Reserved.
+
+#include "HoudiniPCGBatchCookCommandlet.h"
+
+#include "HoudiniApi.h"
+#include "HoudiniEngine.h"
+#include "HoudiniEngineUtils.h"
+
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeExit.h"
+#include "Algo/Unique.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "AssetCompilingManager.h"
+#include "FileHelpers.h"
+#include "EditorLoadingAndSavingUtils.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+
+#include "HoudiniInputPCGComponent.h"
+#include "HoudiniOutputPCGDataAsset.h"
+#include "HoudiniPCGUtils.h"
+
+#include "PCGDataAsset.h"
+
+
+DEFINE_LOG_CATEGORY_STATIC(LogHoudiniPCGBatchCook, Log, All);
+
+struct FHoudiniPCGBatchCookJob
+{
+	FString HdaPath;
+	FString AssetName;  // e.g., "Sop/foo::1.0", empty means all definitions in the HDA, each will be a job
+	FString Label;  // Outputs go to <Output>/<Asset label>/<Label>/, empty means <Output>/<Asset label>/
+	TSharedPtr<FJsonObject> Parms;  // { "ParmName": Value | [Tuple values] | "String" }
+	TArray<TArray<FSoftObjectPath>> Inputs;  // PCGDataAssets merged to each input of the HDA
+
+	FORCEINLINE FString GetAssetLabel() const { return FPaths::GetBaseFilename(AssetName.Replace(TEXT("::"), TEXT("_"))); }  // "Sop/foo::1.0" -> "foo_1.0"
+
+	FORCEINLINE FString GetFolderPath(const FString& OutputFolderPath) const { return OutputFolderPath + GetAssetLabel() + TEXT("/") + (Label.IsEmpty() ? FString() : (Label + TEXT("/"))); }
+
+	FORCEINLINE FString GetName() const { return HdaPath + TEXT(" ") + AssetName + (Label.IsEmpty() ? FString() : (TEXT(" (") + Label + TEXT(")"))); }
+};
+
+struct FHoudiniPCGBatchCookSession  // Cook one job at a time, all HAPI calls of a job, including uploads and retrievals, address this session explicitly
+{
+	HAPI_Session Session;
+	bool bOwned = false;  // Started by this commandlet, otherwise is the session of HoudiniEngine
+
+	int32 JobIdx = -1;  // -1 means idle
+	int32 NodeId = -1;
+	int32 RootNodeId = -1;
+	TArray<int32> InputGeoNodeIds;
+	int32 PrevCookCount = 0;
+	double StartTime = 0.0;
+
+	bool HapiStartJob(TArray<FHoudiniPCGBatchCookJob>& Jobs, const int32& InJobIdx);  // Definitions of an HDA without AssetName will be inserted as jobs right after it
+
+	// Outputs are skipped if the cook failed, as cook errors may lead to incomplete outputs, so we should NOT overwrite the baked assets
+	bool HapiFinishJob(const FHoudiniPCGBatchCookJob& Job, const bool& bCookSucceeded, const FString& OutputFolderPath,
+		FHoudiniPCGDataAssetOutputBuilder& OutputBuilder, int32& OutNumParts);
+
+	void HapiDestroyJob();
+};
+
+namespace HoudiniPCGBatchCookUtils
+{
+	static void GatherHdaPaths(const FString& HdasStr, TArray<FString>& OutHdaPaths);
+
+	static void GatherPCGDataAssetPaths(const FString& AssetsStr, TArray<FSoftObjectPath>& OutAssetPaths);  // Object paths, or folders like /Game/Folder/
+
+	static bool LoadJobs(const FString& JobsFilePath, TArray<FHoudiniPCGBatchCookJob>& OutJobs);
+
+	static bool HapiSetParms(const HAPI_Session* Session, const int32& NodeId, const TSharedPtr<FJsonObject>& Parms);
+
+	static bool HapiStartSession(const int32& SessionIdx, HAPI_Session& OutSession);  // A local named pipe session cooks on its own thread
+
+	static void SaveDirtyPackages(FHoudiniPCGDataAssetOutputBuilder& OutputBuilder, int32& InOutNumSaved);
+}
+
+static void HoudiniPCGBatchCookUtils::GatherHdaPaths(const FString& HdasStr, TArray<FString>& OutHdaPaths)
+{
+	TArray<FString> Entries;
+	HdasStr.ParseIntoArray(Entries, TEXT(";"));
+	for (FString Entry : Entries)
+	{
+		Entry.TrimStartAndEndInline();
+		FPaths::NormalizeFilename(Entry);
+		if (Entry.IsEmpty())
+			continue;
+
+		if (IFileManager::Get().DirectoryExists(*Entry))
+		{
+			for (const TCHAR* Ext : { TEXT("*.hda"), TEXT("*.otl"), TEXT("*.hdalc"), TEXT("*.hdanc") })
+			{
+				TArray<FString> FoundPaths;
+				IFileManager::Get().FindFilesRecursive(FoundPaths, *Entry, Ext, true, false);
+				OutHdaPaths.Append(FoundPaths);
+			}
+		}
+		else if (FPaths::FileExists(Entry))
+			OutHdaPaths.Add(Entry);
+		else
+			UE_LOG(LogHoudiniPCGBatchCook, Warning, TEXT("%s NOT exists"), *Entry);
+	}
+
+	OutHdaPaths.Sort();
+	OutHdaPaths.SetNum(Algo::Unique(OutHdaPaths));
+}
+
+static void HoudiniPCGBatchCookUtils::GatherPCGDataAssetPaths(const FString& AssetsStr, TArray<FSoftObjectPath>& OutAssetPaths)
+{
+	IAssetRegistry& AssetRegistry = IAssetRegistry::GetChecked();
+
+	TArray<FString> Entries;
+	AssetsStr.ParseIntoArray(Entries, TEXT(";"));
+	for (FString Entry : Entries)
+	{
+		Entry.TrimStartAndEndInline();
+		Entry.RemoveFromEnd(TEXT("/"));
+		if (Entry.IsEmpty())
+			continue;
+
+		if (AssetRegistry.PathExists(Entry))
+		{
+			FARFilter Filter;
+			Filter.PackagePaths.Add(FName(Entry));
+			Filter.bRecursivePaths = true;
+			Filter.ClassPaths.Add(UPCGDataAsset::StaticClass()->GetClassPathName());
+			Filter.bRecursiveClasses = true;
+			TArray<FAssetData> AssetDatas;
+			AssetRegistry.GetAssets(Filter, AssetDatas);
+			AssetDatas.Sort([](const FAssetData& A, const FAssetData& B) { return A.PackageName.LexicalLess(B.PackageName); });
+			for (const FAssetData& AssetData : AssetDatas)
+				OutAssetPaths.Add(AssetData.GetSoftObjectPath());
+		}
+		else
+			OutAssetPaths.Add(FSoftObjectPath(Entry));
+	}
+}
+
+static bool HoudiniPCGBatchCookUtils::LoadJobs(const FString& JobsFilePath, TArray<FHoudiniPCGBatchCookJob>& OutJobs)
+{
+	FString JsonStr;
+	TArray<TSharedPtr<FJsonValue>> JsonJobs;
+	if (!FFileHelper::LoadFileToString(JsonStr, *JobsFilePath) || !FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(JsonStr), JsonJobs))
+	{
+		UE_LOG(LogHoudiniPCGBatchCook, Error, TEXT("Failed to load jobs from %s, MUST be a json array"), *JobsFilePath);
+		return false;
+	}
+
+	for (int32 JobIdx = 0; JobIdx < JsonJobs.Num(); ++JobIdx)
+	{
+		const TSharedPtr<FJsonObject>* JsonJobPtr = nullptr;
+		FHoudiniPCGBatchCookJob Job;
+		if (!JsonJobs[JobIdx]->TryGetObject(JsonJobPtr) || !(*JsonJobPtr)->TryGetStringField(TEXT("Hda"), Job.HdaPath))
+		{
+			UE_LOG(LogHoudiniPCGBatchCook, Error, TEXT("Job %d in %s has no \"Hda\""), JobIdx, *JobsFilePath);
+			return false;
+		}
+		const TSharedPtr<FJsonObject>& JsonJob = *JsonJobPtr;
+
+		FPaths::NormalizeFilename(Job.HdaPath);
+		if (!FPaths::FileExists(Job.HdaPath))
+		{
+			UE_LOG(LogHoudiniPCGBatchCook, Error, TEXT("Job %d in %s: %s NOT exists"), JobIdx, *JobsFilePath, *Job.HdaPath);
+			return false;
+		}
+		JsonJob->TryGetStringField(TEXT("Asset"), Job.AssetName);
+		JsonJob->TryGetStringField(TEXT("Label"), Job.Label);
+
+		const TSharedPtr<FJsonObject>* ParmsPtr = nullptr;
+		if (JsonJob->TryGetObjectField(TEXT("Parms"), ParmsPtr))
+			Job.Parms = *ParmsPtr;
+
+		const TArray<TSharedPtr<FJsonValue>>* InputsPtr = nullptr;
+		if (JsonJob->TryGetArrayField(TEXT("Inputs"), InputsPtr))
+		{
+			for (const TSharedPtr<FJsonValue>& JsonInput : *InputsPtr)  // Each input is a PCGDataAsset or folder, or an array of them
+			{
+				TArray<FSoftObjectPath>& InputAssetPaths = Job.Inputs.AddDefaulted_GetRef();
+				const TArray<TSharedPtr<FJsonValue>>* JsonInputAssetsPtr = nullptr;
+				if (JsonInput->TryGetArray(JsonInputAssetsPtr))
+				{
+					for (const TSharedPtr<FJsonValue>& JsonInputAsset : *JsonInputAssetsPtr)
+						GatherPCGDataAssetPaths(JsonInputAsset->AsString(), InputAssetPaths);
+				}
+				else
+					GatherPCGDataAssetPaths(JsonInput->AsString(), InputAssetPaths);
+			}
+		}
+
+		OutJobs.Add(Job);
+	}
+
+	return true;
+}
+
+static bool HoudiniPCGBatchCookUtils::HapiSetParms(const HAPI_Session* Session, const int32& NodeId, const TSharedPtr<FJsonObject>& Parms)
+{
+	if (!Parms.IsValid())
+		return true;
+
+	for (const TPair<FString, TSharedPtr<FJsonValue>>& Parm : Parms->Values)
+	{
+		HAPI_ParmId ParmId = -1;
+		HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetParmIdFromName(Session, NodeId, TCHAR_TO_UTF8(*Parm.Key), &ParmId));
+		if (ParmId < 0)
+		{
+			UE_LOG(LogHoudiniPCGBatchCook, Warning, TEXT("Parm \"%s\" NOT found, skipped"), *Parm.Key);
+			continue;
+		}
+
+		HAPI_ParmInfo ParmInfo;
+		HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetParmInfo(Session, NodeId, ParmId, &ParmInfo));
+
+		TArray<TSharedPtr<FJsonValue>> Values;  // A single value or tuple values
+		if (Parm.Value->Type == EJson::Array)
+			Values = Parm.Value->AsArray();
+		else
+			Values.Add(Parm.Value);
+		const int32 NumValues = FMath::Min(Values.Num(), ParmInfo.size);
+		if (NumValues <= 0)
+			continue;
+
+		if (FHoudiniApi::ParmInfo_IsInt(&ParmInfo))
+		{
+			TArray<int32> IntValues;
+			for (int32 ValueIdx = 0; ValueIdx < NumValues; ++ValueIdx)
+				IntValues.Add((Values[ValueIdx]->Type == EJson::Boolean) ? int32(Values[ValueIdx]->AsBool()) : FMath::RoundToInt32(Values[ValueIdx]->AsNumber()));
+			HAPI_SESSION_FAIL_RETURN(FHoudiniApi::SetParmIntValues(Session, NodeId, IntValues.GetData(), ParmInfo.intValuesIndex, NumValues));
+		}
+		else if (FHoudiniApi::ParmInfo_IsFloat(&ParmInfo))
+		{
+			TArray<float> FloatValues;
+			for (int32 ValueIdx = 0; ValueIdx < NumValues; ++ValueIdx)
+				FloatValues.Add(float(Values[ValueIdx]->AsNumber()));
+			HAPI_SESSION_FAIL_RETURN(FHoudiniApi::SetParmFloatValues(Session, NodeId, FloatValues.GetData(), ParmInfo.floatValuesIndex, NumValues));
+		}
+		else if (FHoudiniApi::ParmInfo_IsString(&ParmInfo))
+		{
+			for (int32 ValueIdx = 0; ValueIdx < NumValues; ++ValueIdx)
+			{
+				HAPI_SESSION_FAIL_RETURN(FHoudiniApi::SetParmStringValue(Session, NodeId, TCHAR_TO_UTF8(*Values[ValueIdx]->AsString()), ParmId, ValueIdx));
+			}
+		}
+		else
+			UE_LOG(LogHoudiniPCGBatchCook, Warning, TEXT("Parm \"%s\" has no value, skipped"), *Parm.Key);
+	}
+
+	return true;
+}
+
+static bool HoudiniPCGBatchCookUtils::HapiStartSession(const int32& SessionIdx, HAPI_Session& OutSession)
+{
+	const std::string PipeName = TCHAR_TO_UTF8(*FString::Printf(TEXT("HoudiniPCGBatchCook_%d_%d"), FPlatformProcess::GetCurrentProcessId(), SessionIdx));
+
+	HAPI_ThriftServerOptions ServerOptions;
+	FHoudiniApi::ThriftServerOptions_Init(&ServerOptions);
+	ServerOptions.autoClose = true;  // Server exits when the session closed
+	ServerOptions.timeoutMs = 60000.0f;
+	HAPI_ProcessId ProcessId = 0;
+	if (FHoudiniApi::StartThriftNamedPipeServer(&ServerOptions, PipeName.c_str(), &ProcessId, nullptr) != HAPI_RESULT_SUCCESS)
+		return false;
+
+#if (HAPI_VERSION_HOUDINI_MAJOR > 20) || ((HAPI_VERSION_HOUDINI_MAJOR == 20) && (HAPI_VERSION_HOUDINI_MINOR >= 5))
+	HAPI_SessionInfo SessionInfo;
+	FHoudiniApi::SessionInfo_Init(&SessionInfo);
+	if (FHoudiniApi::CreateThriftNamedPipeSession(&OutSession, PipeName.c_str(), &SessionInfo) != HAPI_RESULT_SUCCESS)
+		return false;
+#else
+	if (FHoudiniApi::CreateThriftNamedPipeSession(&OutSession, PipeName.c_str()) != HAPI_RESULT_SUCCESS)
+		return false;
+#endif
+
+	HAPI_CookOptions CookOptions;
+	FHoudiniApi::CookOptions_Init(&CookOptions);
+	if (FHoudiniApi::Initialize(&OutSession, &CookOptions, true, -1, "", "", "", "", "") != HAPI_RESULT_SUCCESS)
+	{
+		FHoudiniApi::CloseSession(&OutSession);
+		return false;
+	}
+
+	return true;
+}
+
+static void HoudiniPCGBatchCookUtils::SaveDirtyPackages(FHoudiniPCGDataAssetOutputBuilder& OutputBuilder, int32& InOutNumSaved)
+{
+	FAssetCompilingManager::Get().FinishAllCompilation();  // PCGDataAssets will only be notified after referenced static meshes compiled
+	OutputBuilder.FlushNotify();
+
+	TArray<UPackage*> DirtyPackages;
+	FEditorFileUtils::GetDirtyContentPackages(DirtyPackages);
+	if (!DirtyPackages.IsEmpty())
+	{
+		UEditorLoadingAndSavingUtils::SavePackages(DirtyPackages, true);
+		InOutNumSaved += DirtyPackages.Num();
+	}
+
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);  // Keep memory flat during a long batch
+}
+
+
+bool FHoudiniPCGBatchCookSession::HapiStartJob(TArray<FHoudiniPCGBatchCookJob>& Jobs, const int32& InJobIdx)
+{
+	bool bStarted = false;
+	ON_SCOPE_EXIT
+	{
+		if (!bStarted)
+			HapiDestroyJob();
+	};
+
+	const HAPI_Session* Session = &this->Session;
+	StartTime = FPlatformTime::Seconds();
+
+	TArray<FString> AssetNames;
+	HOUDINI_FAIL_RETURN(FHoudiniPCGUtils::HapiLoadAssetLibrary(Session, Jobs[InJobIdx].HdaPath, AssetNames));  // Loaded once per session
+	if (Jobs[InJobIdx].AssetName.IsEmpty())
+	{
+		for (int32 AssetIdx = AssetNames.Num() - 1; AssetIdx >= 1; --AssetIdx)
+		{
+			FHoudiniPCGBatchCookJob DefinitionJob = Jobs[InJobIdx];
+			DefinitionJob.AssetName = AssetNames[AssetIdx];
+			Jobs.Insert(DefinitionJob, InJobIdx + 1);
+		}
+		if (!AssetNames.IsEmpty())
+			Jobs[InJobIdx].AssetName = AssetNames[0];
+	}
+
+	const FHoudiniPCGBatchCookJob& Job = Jobs[InJobIdx];
+	if (!AssetNames.Contains(Job.AssetName))
+	{
+		UE_LOG(LogHoudiniPCGBatchCook, Error, TEXT("\"%s\" NOT found in %s"), *Job.AssetName, *Job.HdaPath);
+		return false;
+	}
+
+	HOUDINI_FAIL_RETURN(FHoudiniPCGUtils::HapiInstantiateAsset(Session, Job.AssetName, Job.GetAssetLabel(), NodeId, RootNodeId));
+	HOUDINI_FAIL_RETURN(HoudiniPCGBatchCookUtils::HapiSetParms(Session, NodeId, Job.Parms));
+
+	const FHoudiniPCGCookStatsScope CookStatsScope(true);  // All inputs of this job are accumulated, and stats of previous jobs reset
+	for (int32 InputIdx = 0; InputIdx < Job.Inputs.Num(); ++InputIdx)
+	{
+		FPCGDataCollection Data;
+		for (const FSoftObjectPath& InputAssetPath : Job.Inputs[InputIdx])
+		{
+			if (const UPCGDataAsset* PCGDA = Cast<UPCGDataAsset>(InputAssetPath.TryLoad()))
+				Data.TaggedData.Append(PCGDA->Data.TaggedData);
+			else
+				UE_LOG(LogHoudiniPCGBatchCook, Warning, TEXT("PCGDataAsset %s NOT found, skipped"), *InputAssetPath.ToString());
+		}
+		if (Data.TaggedData.IsEmpty())
+			continue;
+
+		int32 InputGeoNodeId = -1;
+		const bool bConnected = FHoudiniPCGUtils::HapiConnectInputDatas(Session, NodeId, RootNodeId, InputIdx, Data, true, FHoudiniPCGAttributeFilter(), InputGeoNodeId);
+		if (InputGeoNodeId >= 0)
+			InputGeoNodeIds.Add(InputGeoNodeId);
+		HOUDINI_FAIL_RETURN(bConnected);
+	}
+
+	HOUDINI_FAIL_RETURN(FHoudiniPCGUtils::HapiGetCookCount(Session, NodeId, PrevCookCount));
+	HAPI_CookOptions CookOptions;
+	FHoudiniApi::CookOptions_Init(&CookOptions);
+	HAPI_SESSION_FAIL_RETURN(FHoudiniApi::CookNode(Session, NodeId, &CookOptions));  // Sessions started by this commandlet cook on their own threads, so other sessions could cook meanwhile
+
+	JobIdx = InJobIdx;
+	bStarted = true;
+	return true;
+}
+
+bool FHoudiniPCGBatchCookSession::HapiFinishJob(const FHoudiniPCGBatchCookJob& Job, const bool& bCookSucceeded, const FString& OutputFolderPath,
+	FHoudiniPCGDataAssetOutputBuilder& OutputBuilder, int32& OutNumParts)
+{
+	OutputBuilder.SetSession(&Session);
+	ON_SCOPE_EXIT
+	{
+		OutputBuilder.SetSession(nullptr);
+		HapiDestroyJob();
+	};
+
+	if (!bCookSucceeded)
+	{
+		UE_LOG(LogHoudiniPCGBatchCook, Error, TEXT("%s failed to cook, outputs skipped"), *Job.GetName());
+		return false;
+	}
+
+	HAPI_GeoInfo GeoInfo;
+	TArray<HAPI_PartInfo> PartInfos;
+	HOUDINI_FAIL_RETURN(FHoudiniPCGUtils::HapiGetOutputParts(&Session, NodeId, OutputBuilder, GeoInfo, PartInfos));
+	if (!PartInfos.IsEmpty())
+	{
+		OutputBuilder.SetDefaultCookFolderPath(Job.GetFolderPath(OutputFolderPath));
+		HOUDINI_FAIL_RETURN(OutputBuilder.HapiRetrieve(nullptr, Job.GetAssetLabel(), GeoInfo, PartInfos));
+		OutNumParts = PartInfos.Num();
+	}
+
+	return true;
+}
+
+void FHoudiniPCGBatchCookSession::HapiDestroyJob()
+{
+	if (RootNodeId >= 0)
+		FHoudiniApi::DeleteNode(&Session, RootNodeId);
+	for (const int32& InputGeoNodeId : InputGeoNodeIds)
+		FHoudiniApi::DeleteNode(&Session, InputGeoNodeId);
+
+	JobIdx = -1;
+	NodeId = -1;
+	RootNodeId = -1;
+	InputGeoNodeIds.Empty();
+}
+
+
+UHoudiniPCGBatchCookCommandlet::UHoudiniPCGBatchCookCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UHoudiniPCGBatchCookCommandlet::Main(const FString& Params)
+{
+	FString HdasStr;
+	FParse::Value(*Params, TEXT("Hdas="), HdasStr, false);  // NOT stop at ',', as paths may contain it
+	FString InputsStr;
+	FParse::Value(*Params, TEXT("Inputs="), InputsStr, false);
+	FString JobsFilePath;
+	FParse::Value(*Params, TEXT("Jobs="), JobsFilePath, false);
+	FString OutputFolderPath = TEXT("/Game/HoudiniPCG/");
+	FParse::Value(*Params, TEXT("Output="), OutputFolderPath);
+	if (!OutputFolderPath.EndsWith(TEXT("/")))
+		OutputFolderPath += TEXT("/");
+	int32 SaveBatchSize = 16;  // Save and GC every N jobs
+	FParse::Value(*Params, TEXT("SaveBatch="), SaveBatchSize);
+	SaveBatchSize = FMath::Max(SaveBatchSize, 1);
+	int32 NumSessions = 1;
+	FParse::Value(*Params, TEXT("Sessions="), NumSessions);
+	NumSessions = FMath::Clamp(NumSessions, 1, 64);
+
+	IAssetRegistry::GetChecked().SearchAllAssets(true);  // Input PCGDataAssets may be found by folders
+
+	TArray<FHoudiniPCGBatchCookJob> Jobs;
+	if (!JobsFilePath.IsEmpty() && !HoudiniPCGBatchCookUtils::LoadJobs(JobsFilePath, Jobs))
+		return 1;
+
+	TArray<FString> HdaPaths;
+	HoudiniPCGBatchCookUtils::GatherHdaPaths(HdasStr, HdaPaths);
+	TArray<FSoftObjectPath> InputAssetPaths;
+	HoudiniPCGBatchCookUtils::GatherPCGDataAssetPaths(InputsStr, InputAssetPaths);
+	for (const FString& HdaPath : HdaPaths)
+	{
+		if (InputAssetPaths.IsEmpty())
+		{
+			Jobs.AddDefaulted_GetRef().HdaPath = HdaPath;
+			continue;
+		}
+
+		for (const FSoftObjectPath& InputAssetPath : InputAssetPaths)  // Each PCGDataAsset is a job, uploaded to the first input
+		{
+			FHoudiniPCGBatchCookJob& Job = Jobs.AddDefaulted_GetRef();
+			Job.HdaPath = HdaPath;
+			Job.Label = InputAssetPath.GetAssetName();
+			Job.Inputs.AddDefaulted_GetRef().Add(InputAssetPath);
+		}
+	}
+
+	if (Jobs.IsEmpty())
+	{
+		UE_LOG(LogHoudiniPCGBatchCook, Error, TEXT("No job found, usage: -run=HoudiniPCGBatchCook <-Hdas=<Folder;File.hda> [-Inputs=</Game/Folder/;/Game/PCGDA.PCGDA>] | -Jobs=<Jobs.json>> ")
+			TEXT("-Output=/Game/Folder/ [-Sessions=1] [-SaveBatch=16]"));
+		return 1;
+	}
+
+	const HAPI_Session* EngineSession = FHoudiniEngine::Get().GetSession();
+	if (!EngineSession || (FHoudiniApi::IsSessionValid(EngineSession) != HAPI_RESULT_SUCCESS))
+	{
+		UE_LOG(LogHoudiniPCGBatchCook, Error, TEXT("No valid houdini session, please make sure HoudiniEngine could start a session on launch"));
+		return 1;
+	}
+
+	TArray<FHoudiniPCGBatchCookSession> Sessions;
+	Sessions.AddDefaulted_GetRef().Session = *EngineSession;
+	for (int32 SessionIdx = 1; SessionIdx < NumSessions; ++SessionIdx)
+	{
+		HAPI_Session Session;
+		if (HoudiniPCGBatchCookUtils::HapiStartSession(SessionIdx, Session))
+		{
+			FHoudiniPCGBatchCookSession& CookSession = Sessions.AddDefaulted_GetRef();
+			CookSession.Session = Session;
+			CookSession.bOwned = true;
+		}
+		else
+			UE_LOG(LogHoudiniPCGBatchCook, Warning, TEXT("Failed to start session %d, jobs will be distributed to %d sessions"), SessionIdx, Sessions.Num());
+	}
+
+	FHoudiniPCGDataAssetOutputBuilder OutputBuilder;  // Own part schemas and pending notifies, so will NOT disturb the builder registered for editor
+
+	const double StartTime = FPlatformTime::Seconds();
+	int32 NextJobIdx = 0;
+	int32 NumFinished = 0;
+	int32 NumFailed = 0;
+	int32 NumParts = 0;
+	int32 NumSaved = 0;
+	int32 NumUnsaved = 0;
+	while (true)
+	{
+		bool bBusy = false;
+		for (int32 SessionIdx = 0; SessionIdx < Sessions.Num(); ++SessionIdx)
+		{
+			FHoudiniPCGBatchCookSession& CookSession = Sessions[SessionIdx];
+			if (CookSession.JobIdx >= 0)
+			{
+				bool bFinished = false;
+				bool bSucceeded = false;
+				if (FHoudiniPCGUtils::HapiGetNodeCookState(&CookSession.Session, CookSession.NodeId, CookSession.PrevCookCount, bFinished, bSucceeded) && !bFinished)
+				{
+					bBusy = true;
+					continue;
+				}
+
+				const FHoudiniPCGBatchCookJob& Job = Jobs[CookSession.JobIdx];
+				const double JobStartTime = CookSession.StartTime;
+				int32 NumJobParts = 0;
+				++NumFinished;
+				++NumUnsaved;
+				if (CookSession.HapiFinishJob(Job, bSucceeded, OutputFolderPath, OutputBuilder, NumJobParts))
+				{
+					NumParts += NumJobParts;
+					UE_LOG(LogHoudiniPCGBatchCook, Display, TEXT("[%d/%d] %s, session %d, %d parts, %.1f ms"), NumFinished, Jobs.Num(),
+						*Job.GetName(), SessionIdx, NumJobParts, (FPlatformTime::Seconds() - JobStartTime) * 1000.0);
+				}
+				else
+				{
+					++NumFailed;
+					UE_LOG(LogHoudiniPCGBatchCook, Error, TEXT("[%d/%d] %s failed"), NumFinished, Jobs.Num(), *Job.GetName());
+				}
+			}
+
+			while ((CookSession.JobIdx < 0) && (NextJobIdx < Jobs.Num()))
+			{
+				const int32 JobIdx = NextJobIdx++;
+				if (CookSession.HapiStartJob(Jobs, JobIdx))
+					break;
+
+				++NumFinished;
+				++NumFailed;
+				UE_LOG(LogHoudiniPCGBatchCook, Error, TEXT("[%d/%d] %s failed to start"), NumFinished, Jobs.Num(), *Jobs[JobIdx].GetName());
+			}
+
+			if (CookSession.JobIdx >= 0)
+				bBusy = true;
+		}
+
+		if ((NumUnsaved >= SaveBatchSize) || (!bBusy && (NumUnsaved > 0)))  // Other sessions keep cooking while saving
+		{
+			HoudiniPCGBatchCookUtils::SaveDirtyPackages(OutputBuilder, NumSaved);
+			NumUnsaved = 0;
+		}
+
+		if (!bBusy)
+			break;
+
+		FPlatformProcess::Sleep(0.01f);
+	}
+
+	for (FHoudiniPCGBatchCookSession& CookSession : Sessions)
+	{
+		if (CookSession.bOwned)
+		{
+			FHoudiniApi::Cleanup(&CookSession.Session);
+			FHoudiniApi::CloseSession(&CookSession.Session);
+		}
+	}
+
+	const double TotalTime = FPlatformTime::Seconds() - StartTime;
+	UE_LOG(LogHoudiniPCGBatchCook, Display, TEXT("%d jobs on %d sessions (%d failed), %d parts, %d packages saved, %.2f s, %.2f jobs/s"),
+		Jobs.Num(), Sessions.Num(), NumFailed, NumParts, NumSaved, TotalTime, (TotalTime > 0.0) ? (Jobs.Num() / TotalTime) : 0.0);
+
+	return (NumFailed > 0) ? 1 : 0;
+}
@@ -0,0 +1,27 @@
+// Copyright Yuzhe Pan (childadrianpan@gmail.com). All Rights Reserved.
+
+#pragma once
+
+#include "Commandlets/Commandlet.h"
+
+#include "HoudiniPCGBatchCookCommandlet.generated.h"
+
+
+// Nightly rebuild of PCGDataAssets output by HDAs, without opening the editor:
+// UnrealEditor-Cmd.exe <Project>.uproject -run=HoudiniPCGBatchCook -Hdas=<D:/HDAs/;D:/Foo.hda> [-Inputs=</Game/PCG/Inputs/;/Game/Bar.Bar>] -Output=/Game/PCG/Baked/ [-Sessions=4] [-SaveBatch=16]
+// UnrealEditor-Cmd.exe <Project>.uproject -run=HoudiniPCGBatchCook -Jobs=<D:/Jobs.json> -Output=/Game/PCG/Baked/ [-Sessions=4] [-SaveBatch=16]
+// Each job instantiates an HDA definition, sets its parms, uploads PCGDataAssets to its inputs and cooks, then its display geo will be output by FHoudiniPCGDataAssetOutputBuilder,
+// parts without s@unreal_object_path go to <Output>/<HDA label>/[<Job label>/]. With -Inputs, each PCGDataAsset is a job uploaded to the first input of every HDA.
+// Jobs.json: [{ "Hda": "D:/Foo.hda", "Asset": "Sop/foo::1.0", "Label": "ForestA", "Parms": { "seed": 3, "size": [1, 2, 3], "mode": "fast" },
+//     "Inputs": [["/Game/PCG/Terrain.Terrain"], "/Game/PCG/Roads/"] }], "Asset" and "Label" are optional.
+// Jobs are distributed across the session of HoudiniEngine and Sessions - 1 local named pipe sessions started here, each cooks on its own thread
+UCLASS()
+class UHoudiniPCGBatchCookCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UHoudiniPCGBatchCookCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,554 @@
+// Copyright Yuzhe Pan (childadrianpan@gmail.com). All Rights Reserved.
+
+#include "HoudiniApi.h"
+#include "HoudiniEngine.h"
+#include "HoudiniAttribute.h"
+#include "HoudiniEngineUtils.h"
+
+#include "HAL/IConsoleManager.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/EngineVersion.h"
+#include "Interfaces/IPluginManager.h"
+#include "Math/RandomStream.h"
+#include "UObject/Package.h"
+
+#include "HoudiniPCGUtils.h"
+
+#include "Metadata/PCGMetadata.h"
+#include "Components/SplineComponent.h"
+#include "Data/PCGSplineData.h"
+#if ((ENGINE_MAJOR_VERSION == 5) && (ENGINE_MINOR_VERSION >= 5)) || (ENGINE_MAJOR_VERSION > 5)
+#include "DynamicMesh/DynamicMesh3.h"
+#endif
+
+
+// "HoudiniPCG.Benchmark Points=1000,100000,10000000 Attribs=4 StringCardinality=16 Splines=100 SplinePoints=64 Tris=100000 Runs=3 Out=D:/Bench.json"
+// Synthetic datasets are converted by the same pure conversions as the translators, and if a session is running,
+// also be uploaded to and retrieved from a temporary null sop, results are logged and written to Saved/HoudiniPCG/ as csv (or json if Out= ends with .json)
+struct FHoudiniPCGBenchmarkSettings
+{
+	TArray<int32> PointCounts = { 1000, 10000, 100000, 1000000 };
+	int32 NumAttribs = 4;  // float, vector, int32 and string in turn
+	int32 StringCardinality = 16;
+	int32 NumSplines = 100;
+	int32 NumSplinePoints = 64;
+	int32 NumTriangles = 100000;
+	int32 NumRuns = 3;
+	FString OutputPath;
+
+	void Parse(const FString& Cmd);
+};
+
+struct FHoudiniPCGBenchmarkResult
+{
+	FString Stage;
+	int32 NumPoints = 0;  // 0 means this stage is NOT driven by point count
+	int64 NumElems = 0;
+	double BestMs = 0.0;
+	double AvgMs = 0.0;
+
+	FORCEINLINE double GetElemsPerSecond() const { return (BestMs > 0.0) ? (NumElems * 1000.0 / BestMs) : 0.0; }
+};
+
+class FHoudiniPCGBenchmark
+{
+protected:
+	const FHoudiniPCGBenchmarkSettings& Settings;
+	FOutputDevice& Ar;
+	TArray<FHoudiniPCGBenchmarkResult> Results;
+
+	bool Measure(const FString& Stage, const int32& NumPoints, const int64& NumElems, TFunctionRef<bool()> RunFunc);
+
+	void RunPoints(const int32& NumPoints, const bool& bLiveSession);
+
+	void RunAttributes(const int32& NumPoints);
+
+	bool HapiRunTransfer(const int32& NumPoints, const TArray<float>& PosData, const TArray<float>& RotData, const TArray<float>& ScaleData);
+
+	void RunSplines();
+
+	void RunMeshes();
+
+	void Save() const;
+
+public:
+	FHoudiniPCGBenchmark(const FHoudiniPCGBenchmarkSettings& InSettings, FOutputDevice& InAr) : Settings(InSettings), Ar(InAr) {}
+
+	void Run();
+};
+
+
+void FHoudiniPCGBenchmarkSettings::Parse(const FString& Cmd)
+{
+	FString PointCountsStr;
+	if (FParse::Value(*Cmd, TEXT("Points="), PointCountsStr))
+	{
+		TArray<FString> PointCountStrs;
+		PointCountsStr.ParseIntoArray(PointCountStrs, TEXT(","));
+		PointCounts.Empty();
+		for (const FString& PointCountStr : PointCountStrs)
+		{
+			const int32 PointCount = FCString::Atoi(*PointCountStr);
+			if (PointCount >= 1)
+				PointCounts.Add(PointCount);
+		}
+	}
+
+	FParse::Value(*Cmd, TEXT("Attribs="), NumAttribs);
+	FParse::Value(*Cmd, TEXT("StringCardinality="), StringCardinality);
+	FParse::Value(*Cmd, TEXT("Splines="), NumSplines);
+	FParse::Value(*Cmd, TEXT("SplinePoints="), NumSplinePoints);
+	FParse::Value(*Cmd, TEXT("Tris="), NumTriangles);
+	FParse::Value(*Cmd, TEXT("Runs="), NumRuns);
+	FParse::Value(*Cmd, TEXT("Out="), OutputPath);
+
+	NumAttribs = FMath::Max(NumAttribs, 0);
+	StringCardinality = FMath::Max(StringCardinality, 1);
+	NumSplinePoints = FMath::Max(NumSplinePoints, 2);
+	NumRuns = FMath::Max(NumRuns, 1);
+	if (OutputPath.IsEmpty())
+		OutputPath = FPaths::ProjectSavedDir() / TEXT("HoudiniPCG") / FString::Printf(TEXT("Benchmark_%s.csv"), *FDateTime::Now().ToString());
+}
+
+bool FHoudiniPCGBenchmark::Measure(const FString& Stage, const int32& NumPoints, const int64& NumElems, TFunctionRef<bool()> RunFunc)
+{
+	FHoudiniPCGBenchmarkResult& Result = Results.AddDefaulted_GetRef();
+	Result.Stage = Stage;
+	Result.NumPoints = NumPoints;
+	Result.NumElems = NumElems;
+
+	uint64 BestCycles = MAX_uint64;
+	uint64 TotalCycles = 0;
+	for (int32 RunIdx = 0; RunIdx < Settings.NumRuns; ++RunIdx)
+	{
+		const uint64 StartCycles = FPlatformTime::Cycles64();
+		if (!RunFunc())
+		{
+			Ar.Logf(ELogVerbosity::Warning, TEXT("HoudiniPCG.Benchmark: %s failed"), *Stage);
+			Results.Pop();
+			return false;
+		}
+		const uint64 Cycles = FPlatformTime::Cycles64() - StartCycles;
+		BestCycles = FMath::Min(BestCycles, Cycles);
+		TotalCycles += Cycles;
+	}
+	Result.BestMs = FPlatformTime::ToMilliseconds64(BestCycles);
+	Result.AvgMs = FPlatformTime::ToMilliseconds64(TotalCycles) / Settings.NumRuns;
+
+	Ar.Logf(TEXT("    %-20s %10d points %12lld elems %10.2f ms (avg %.2f ms) %14.0f elems/s"),
+		*Result.Stage, Result.NumPoints, Result.NumElems, Result.BestMs, Result.AvgMs, Result.GetElemsPerSecond());
+	return true;
+}
+
+void FHoudiniPCGBenchmark::RunPoints(const int32& NumPoints, const bool& bLiveSession)
+{
+	FRandomStream Random(NumPoints);
+	TArray<FTransform> Transforms;
+	Transforms.SetNumUninitialized(NumPoints);
+	for (FTransform& Transform : Transforms)
+		Transform = FTransform(FRotator(Random.FRandRange(-180.0, 180.0), Random.FRandRange(-180.0, 180.0), Random.FRandRange(-180.0, 180.0)),
+			Random.GetUnitVector() * Random.FRandRange(0.0, 100000.0), FVector(Random.FRandRange(0.5, 2.0)));
+
+	TArray<float> PosData; PosData.SetNumUninitialized(NumPoints * 3);
+	TArray<float> RotData; RotData.SetNumUninitialized(NumPoints * 4);
+	TArray<float> ScaleData; ScaleData.SetNumUninitialized(NumPoints * 3);
+	Measure(TEXT("InputTransforms"), NumPoints, NumPoints, [&]()
+		{
+			FHoudiniPCGUtils::ConvertTransformsToHoudini(NumPoints, [&Transforms](const int32& PointIdx) -> const FTransform& { return Transforms[PointIdx]; },
+				PosData.GetData(), RotData.GetData(), ScaleData.GetData());
+			return true;
+		});
+
+	FHoudiniPCGTransformData Data;
+	Data.PositionData = PosData;
+	Data.PositionStride = 3;
+	Data.OrientData = RotData;
+	Data.OrientStride = 4;
+	Data.ScaleData = ScaleData;
+	Data.ScaleStride = 3;
+	Measure(TEXT("OutputTransforms"), NumPoints, NumPoints, [&]()
+		{
+			FHoudiniPCGUtils::ConvertTransformsToUnreal(NumPoints, Data, [&Transforms](const int32& PointIdx) -> FTransform& { return Transforms[PointIdx]; });
+			return true;
+		});
+
+	Transforms.Empty();
+	Data = FHoudiniPCGTransformData();
+
+	RunAttributes(NumPoints);
+
+	if (bLiveSession)
+		HapiRunTransfer(NumPoints, PosData, RotData, ScaleData);
+}
+
+void FHoudiniPCGBenchmark::RunAttributes(const int32& NumPoints)
+{
+	if (Settings.NumAttribs <= 0)
+		return;
+
+	FRandomStream Random(NumPoints);
+	TArray<float> FloatValues; FloatValues.SetNumUninitialized(NumPoints);
+	TArray<FVector> VectorValues; VectorValues.SetNumUninitialized(NumPoints);
+	TArray<int32> IntValues; IntValues.SetNumUninitialized(NumPoints);
+	TArray<int32> StrIndices; StrIndices.SetNumUninitialized(NumPoints);
+	for (int32 PointIdx = 0; PointIdx < NumPoints; ++PointIdx)
+	{
+		FloatValues[PointIdx] = Random.GetFraction();
+		VectorValues[PointIdx] = Random.GetUnitVector();
+		IntValues[PointIdx] = Random.RandHelper(MAX_int32);
+		StrIndices[PointIdx] = Random.RandHelper(Settings.StringCardinality);
+	}
+	TArray<FString> UniqueStrs;
+	for (int32 UniqueIdx = 0; UniqueIdx < Settings.StringCardinality; ++UniqueIdx)
+		UniqueStrs.Add(FString::Printf(TEXT("/Game/Benchmark/SM_Benchmark_%d.SM_Benchmark_%d"), UniqueIdx, UniqueIdx));
+
+	TArray<PCGMetadataEntryKey> EntryKeys;
+	EntryKeys.SetNumUninitialized(NumPoints);
+	for (int32 PointIdx = 0; PointIdx < NumPoints; ++PointIdx)
+		EntryKeys[PointIdx] = PointIdx;
+
+	UPCGMetadata* Metadata = nullptr;
+	// Same as HoudiniPCGDataOutputUtils::SetPCGAttributeValues and CreateStringPCGAttribute, values are set in bulk, and strings by unique value keys
+	Measure(TEXT("OutputAttributes"), NumPoints, int64(NumPoints) * Settings.NumAttribs, [&]()
+		{
+			Metadata = NewObject<UPCGMetadata>(GetTransientPackage());
+#if ((ENGINE_MAJOR_VERSION == 5) && (ENGINE_MINOR_VERSION >= 5)) || (ENGINE_MAJOR_VERSION > 5)
+			TArray<int64> ParentEntryKeys;
+			ParentEntryKeys.Init(-1, NumPoints);
+			Metadata->AddEntries(ParentEntryKeys);
+#else
+			for (int32 PointIdx = 0; PointIdx < NumPoints; ++PointIdx)
+				Metadata->AddEntry(-1);
+#endif
+			for (int32 AttribIdx = 0; AttribIdx < Settings.NumAttribs; ++AttribIdx)
+			{
+				const FName AttribName(*FString::Printf(TEXT("Attrib%d"), AttribIdx));
+				switch (AttribIdx % 4)
+				{
+				case 0: Metadata->CreateAttribute<float>(AttribName, 0.0f, true, true)->SetValues(EntryKeys, FloatValues); break;
+				case 1: Metadata->CreateAttribute<FVector>(AttribName, FVector::ZeroVector, true, true)->SetValues(EntryKeys, VectorValues); break;
+				case 2: Metadata->CreateAttribute<int32>(AttribName, 0, true, true)->SetValues(EntryKeys, IntValues); break;
+				case 3:
+				{
+					FPCGMetadataAttribute<FString>* Attrib = Metadata->CreateAttribute<FString>(AttribName, FString(), true, true);
+					TArray<PCGMetadataValueKey> UniqueValueKeys;
+					for (const FString& UniqueStr : UniqueStrs)
+						UniqueValueKeys.Add(Attrib->AddValue(UniqueStr));
+					TArray<PCGMetadataValueKey> ValueKeys;
+					ValueKeys.SetNumUninitialized(NumPoints);
+					FHoudiniPCGUtils::ParallelForBatch(NumPoints, [&](const int32& StartIdx, const int32& EndIdx)
+						{
+							for (int32 PointIdx = StartIdx; PointIdx < EndIdx; ++PointIdx)
+								ValueKeys[PointIdx] = UniqueValueKeys[StrIndices[PointIdx]];
+						});
+					Attrib->SetValuesFromValueKeys(EntryKeys, ValueKeys);
+				}
+				break;
+				}
+			}
+			return true;
+		});
+
+	// Same helpers as HoudiniPCGDataInputUtils::HapiUploadStringAttribValue and HapiUploadNumericAttribValue, but without HAPI calls
+	const TArray<int32> AllPointIndices;  // Empty means all points
+	Measure(TEXT("InputAttributes"), NumPoints, int64(NumPoints) * Settings.NumAttribs, [&]()
+		{
+			for (int32 AttribIdx = 0; AttribIdx < Settings.NumAttribs; ++AttribIdx)
+			{
+				const FName AttribName(*FString::Printf(TEXT("Attrib%d"), AttribIdx));
+				int32 NumValues = 0;
+				switch (AttribIdx % 4)
+				{
+				case 0:
+				{
+					TArray<float> Values;
+					FHoudiniPCGUtils::GatherAttribValues<float, float>(Metadata->GetConstTypedAttribute<float>(AttribName), NumPoints, AllPointIndices,
+						[](const float& SrcValue, TArray<float>& DstValues) { DstValues.Add(SrcValue); }, Values);
+					NumValues = Values.Num();
+				}
+				break;
+				case 1:
+				{
+					TArray<float> Values;
+					FHoudiniPCGUtils::GatherAttribValues<FVector, float>(Metadata->GetConstTypedAttribute<FVector>(AttribName), NumPoints, AllPointIndices,
+						[](const FVector& SrcValue, TArray<float>& DstValues) { DstValues.Add(SrcValue.X); DstValues.Add(SrcValue.Y); DstValues.Add(SrcValue.Z); }, Values);
+					NumValues = Values.Num() / 3;
+				}
+				break;
+				case 2:
+				{
+					TArray<int> Values;
+					FHoudiniPCGUtils::GatherAttribValues<int32, int>(Metadata->GetConstTypedAttribute<int32>(AttribName), NumPoints, AllPointIndices,
+						[](const int32& SrcValue, TArray<int>& DstValues) { DstValues.Add(SrcValue); }, Values);
+					NumValues = Values.Num();
+				}
+				break;
+				case 3:
+				{
+					TArray<std::string> UniqueStrs;
+					TArray<const char*> StrValues;
+					FHoudiniPCGUtils::GatherStringAttribValues<FString>(Metadata->GetConstTypedAttribute<FString>(AttribName), NumPoints, AllPointIndices,
+						[](const FString& Value) { return Value; }, UniqueStrs, StrValues);
+					NumValues = StrValues.Num();
+				}
+				break;
+				}
+				if (NumValues != NumPoints)
+					return false;
+			}
+			return true;
+		});
+}
+
+bool FHoudiniPCGBenchmark::HapiRunTransfer(const int32& NumPoints, const TArray<float>& PosData, const TArray<float>& RotData, const TArray<float>& ScaleData)
+{
+	const HAPI_Session* Session = FHoudiniEngine::Get().GetSession();
+
+	int32 NodeId = -1;
+	HAPI_SESSION_FAIL_RETURN(FHoudiniApi::CreateNode(Session, -1, "Sop/null",
+		TCHAR_TO_UTF8(*FString::Printf(TEXT("HoudiniPCGBenchmark_%08X"), FPlatformTime::Cycles())), false, &NodeId));
+
+	TArray<const char*> StrValues;
+	TArray<std::string> UniqueStrs;
+	for (int32 UniqueIdx = 0; UniqueIdx < Settings.StringCardinality; ++UniqueIdx)
+		UniqueStrs.Add(TCHAR_TO_UTF8(*FString::Printf(TEXT("/Game/Benchmark/SM_Benchmark_%d.SM_Benchmark_%d"), UniqueIdx, UniqueIdx)));
+	StrValues.SetNumUninitialized(NumPoints);
+	for (int32 PointIdx = 0; PointIdx < NumPoints; ++PointIdx)
+		StrValues[PointIdx] = UniqueStrs[PointIdx % UniqueStrs.Num()].c_str();
+
+	// Same HAPI calls as FHoudiniPCGComponentInput::HapiRetrieveData
+	const bool bUploaded = Measure(TEXT("HapiUpload"), NumPoints, NumPoints, [&]()
+		{
+			HAPI_PartInfo PartInfo;
+			FHoudiniApi::PartInfo_Init(&PartInfo);
+			PartInfo.type = HAPI_PARTTYPE_MESH;
+			PartInfo.pointCount = NumPoints;
+			HAPI_SESSION_FAIL_RETURN(FHoudiniApi::SetPartInfo(Session, NodeId, 0, &PartInfo));
+
+			HAPI_AttributeInfo AttribInfo;
+			FHoudiniApi::AttributeInfo_Init(&AttribInfo);
+			AttribInfo.count = NumPoints;
+			AttribInfo.owner = HAPI_ATTROWNER_POINT;
+			AttribInfo.storage = HAPI_STORAGETYPE_FLOAT;
+			for (const TPair<const char*, const TArray<float>*>& NameData : { TPair<const char*, const TArray<float>*>(HAPI_ATTRIB_POSITION, &PosData),
+				TPair<const char*, const TArray<float>*>(HAPI_ATTRIB_ROT, &RotData), TPair<const char*, const TArray<float>*>(HAPI_ATTRIB_SCALE, &ScaleData) })
+			{
+				AttribInfo.tupleSize = NameData.Value->Num() / NumPoints;
+				HAPI_SESSION_FAIL_RETURN(FHoudiniApi::AddAttribute(Session, NodeId, 0, NameData.Key, &AttribInfo));
+				HAPI_SESSION_FAIL_RETURN(FHoudiniApi::SetAttributeFloatData(Session, NodeId, 0, NameData.Key, &AttribInfo, NameData.Value->GetData(), 0, NumPoints));
+			}
+
+			AttribInfo.tupleSize = 1;
+			AttribInfo.storage = HAPI_STORAGETYPE_STRING;
+			HAPI_SESSION_FAIL_RETURN(FHoudiniApi::AddAttribute(Session, NodeId, 0, HAPI_ATTRIB_UNREAL_OBJECT_PATH, &AttribInfo));
+			HAPI_SESSION_FAIL_RETURN(FHoudiniApi::SetAttributeStringData(Session, NodeId, 0, HAPI_ATTRIB_UNREAL_OBJECT_PATH, &AttribInfo, StrValues.GetData(), 0, NumPoints));
+
+			HAPI_SESSION_FAIL_RETURN(FHoudiniApi::CommitGeo(Session, NodeId));
+			return true;
+		});
+
+	// Same HAPI calls as FHoudiniPCGDataAssetOutputBuilder::HapiRetrieve for a plain point cloud
+	if (bUploaded)
+	{
+		TArray<float> Data;
+		TArray<HAPI_StringHandle> SHs;
+		Measure(TEXT("HapiRetrieve"), NumPoints, NumPoints, [&]()
+			{
+				HAPI_AttributeInfo AttribInfo;
+				for (const char* AttribName : { HAPI_ATTRIB_POSITION, HAPI_ATTRIB_ROT, HAPI_ATTRIB_SCALE })
+				{
+					HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetAttributeInfo(Session, NodeId, 0, AttribName, HAPI_ATTROWNER_POINT, &AttribInfo));
+					Data.SetNumUninitialized(AttribInfo.count * AttribInfo.tupleSize);
+					HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetAttributeFloatData(Session, NodeId, 0, AttribName, &AttribInfo, -1, Data.GetData(), 0, AttribInfo.count));
+				}
+
+				HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetAttributeInfo(Session, NodeId, 0, HAPI_ATTRIB_UNREAL_OBJECT_PATH, HAPI_ATTROWNER_POINT, &AttribInfo));
+				SHs.SetNumUninitialized(AttribInfo.count);
+				HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetAttributeStringData(Session, NodeId, 0, HAPI_ATTRIB_UNREAL_OBJECT_PATH, &AttribInfo, SHs.GetData(), 0, AttribInfo.count));
+				TArray<HAPI_StringHandle> UniqueSHs = TSet<HAPI_StringHandle>(SHs).Array();
+				TArray<FString> Strs;
+				HOUDINI_FAIL_RETURN(FHoudiniEngineUtils::HapiConvertStringHandles(UniqueSHs, Strs));
+				return true;
+			});
+	}
+
+	HAPI_NodeInfo NodeInfo;
+	FHoudiniApi::NodeInfo_Init(&NodeInfo);
+	HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetNodeInfo(Session, NodeId, &NodeInfo));
+	HAPI_SESSION_FAIL_RETURN(FHoudiniApi::DeleteNode(Session, (NodeInfo.parentId >= 0) ? NodeInfo.parentId : NodeId));  // Also delete the obj created for this sop
+
+	return bUploaded;
+}
+
+void FHoudiniPCGBenchmark::RunSplines()
+{
+	if (Settings.NumSplines <= 0)
+		return;
+
+	FRandomStream Random(Settings.NumSplines);
+	TArray<TArray<FSplinePoint>> SplinesPoints;
+	SplinesPoints.SetNum(Settings.NumSplines);
+	for (TArray<FSplinePoint>& SplinePoints : SplinesPoints)
+	{
+		FVector Position = Random.GetUnitVector() * Random.FRandRange(0.0, 100000.0);
+		for (int32 PointIdx = 0; PointIdx < Settings.NumSplinePoints; ++PointIdx)
+		{
+			Position += Random.GetUnitVector() * 500.0;
+			SplinePoints.Add(FSplinePoint(float(PointIdx), Position, FVector::ZeroVector, FVector::ZeroVector,
+				FRotator::ZeroRotator, FVector::OneVector, ESplinePointType::Curve));
+		}
+	}
+
+	const int64 NumElems = int64(Settings.NumSplines) * Settings.NumSplinePoints;
+	TArray<UPCGSplineData*> SplineDatas;
+	Measure(TEXT("OutputSplines"), 0, NumElems, [&]()
+		{
+			SplineDatas.Reset();
+			for (const TArray<FSplinePoint>& SplinePoints : SplinesPoints)
+			{
+				UPCGSplineData* SplineData = NewObject<UPCGSplineData>(GetTransientPackage());
+				SplineData->Initialize(SplinePoints, false, FTransform::Identity);
+				SplineDatas.Add(SplineData);
+			}
+			return true;
+		});
+
+	// Same helper as FHoudiniPCGComponentInput::HapiUploadData, without HAPI calls
+	Measure(TEXT("InputSplines"), 0, NumElems, [&]()
+		{
+			TArray<float> PosData;
+			TArray<float> ArriveTangentData;
+			TArray<float> LeaveTangentData;
+			TArray<float> RotData;
+			TArray<float> ScaleData;
+			for (const UPCGSplineData* SplineData : SplineDatas)
+			{
+				const TArray<FInterpCurvePointVector>& Points = SplineData->SplineStruct.GetSplinePointsPosition().Points;
+#if ((ENGINE_MAJOR_VERSION == 5) && (ENGINE_MINOR_VERSION >= 6)) || (ENGINE_MAJOR_VERSION > 5)
+				const TArray<FInterpCurvePointQuat>& Rots = SplineData->SplineStruct.GetSplinePointsRotation().Points;
+				const TArray<FInterpCurvePointVector>& Scales = SplineData->SplineStruct.GetSplinePointsScale().Points;
+#else
+				const TArray<FInterpCurvePointQuat>& Rots = SplineData->SplineStruct.SplineCurves.Rotation.Points;
+				const TArray<FInterpCurvePointVector>& Scales = SplineData->SplineStruct.SplineCurves.Scale.Points;
+#endif
+				FHoudiniPCGUtils::ConvertSplineToHoudini(SplineData->SplineStruct.GetTransform(), Points, Rots, Scales,
+					PosData, ArriveTangentData, LeaveTangentData, RotData, ScaleData);
+				if (PosData.Num() != Settings.NumSplinePoints * 3)
+					return false;
+			}
+			return true;
+		});
+}
+
+void FHoudiniPCGBenchmark::RunMeshes()
+{
+#if ((ENGINE_MAJOR_VERSION == 5) && (ENGINE_MINOR_VERSION >= 5)) || (ENGINE_MAJOR_VERSION > 5)
+	if (Settings.NumTriangles <= 0)
+		return;
+
+	// A grid of quads, (GridSize - 1)^2 * 2 >= NumTriangles
+	const int32 GridSize = FMath::CeilToInt32(FMath::Sqrt(Settings.NumTriangles * 0.5)) + 1;
+	TArray<float> PosData;
+	PosData.SetNumUninitialized(GridSize * GridSize * 3);
+	for (int32 Y = 0; Y < GridSize; ++Y)
+	{
+		for (int32 X = 0; X < GridSize; ++X)
+		{
+			float* P = PosData.GetData() + (Y * GridSize + X) * 3;
+			P[0] = X; P[1] = FMath::Sin(X * 0.1f) * FMath::Cos(Y * 0.1f); P[2] = Y;
+		}
+	}
+
+	UE::Geometry::FDynamicMesh3 DM;
+	Measure(TEXT("OutputMeshes"), 0, Settings.NumTriangles, [&]()
+		{
+			DM.Clear();
+			for (int32 PointIdx = 0; PointIdx < GridSize * GridSize; ++PointIdx)
+				DM.AppendVertex(POSITION_SCALE_TO_UNREAL * FVector(PosData[PointIdx * 3], PosData[PointIdx * 3 + 2], PosData[PointIdx * 3 + 1]));
+			for (int32 TriIdx = 0; TriIdx < Settings.NumTriangles; ++TriIdx)
+			{
+				const int32 QuadIdx = TriIdx / 2;
+				const int32 V0 = (QuadIdx / (GridSize - 1)) * GridSize + (QuadIdx % (GridSize - 1));
+				if (TriIdx % 2)
+					DM.AppendTriangle(UE::Geometry::FIndex3i(V0 + 1, V0 + GridSize + 1, V0 + GridSize), 0);
+				else
+					DM.AppendTriangle(UE::Geometry::FIndex3i(V0, V0 + 1, V0 + GridSize), 0);
+			}
+			return true;
+		});
+
+	// Same helper as FHoudiniPCGComponentInput::HapiUploadData, without HAPI calls
+	Measure(TEXT("InputMeshes"), 0, Settings.NumTriangles, [&]()
+		{
+			TArray<float> OutPosData;
+			TArray<int32> Vertices;
+			FHoudiniPCGUtils::ConvertDynamicMeshToHoudini(DM, OutPosData, Vertices);
+			return (OutPosData.Num() == DM.VertexCount() * 3) && (Vertices.Num() == Settings.NumTriangles * 3);
+		});
+#endif
+}
+
+void FHoudiniPCGBenchmark::Save() const
+{
+	const TSharedPtr<IPlugin> Plugin = IPluginManager::Get().FindPlugin(TEXT("HoudiniPCGTranslator"));
+	const FString PluginVersion = Plugin.IsValid() ? Plugin->GetDescriptor().VersionName : FString();
+	const FString EngineVersion = FEngineVersion::Current().ToString(EVersionComponent::Patch);
+
+	FString Content;
+	if (Settings.OutputPath.EndsWith(TEXT(".json")))
+	{
+		Content = FString::Printf(TEXT("{\n\t\"PluginVersion\": \"%s\",\n\t\"EngineVersion\": \"%s\",\n\t\"Attribs\": %d,\n\t\"StringCardinality\": %d,\n\t\"SplinePoints\": %d,\n\t\"Runs\": %d,\n\t\"Results\": [\n"),
+			*PluginVersion, *EngineVersion, Settings.NumAttribs, Settings.StringCardinality, Settings.NumSplinePoints, Settings.NumRuns);
+		for (int32 ResultIdx = 0; ResultIdx < Results.Num(); ++ResultIdx)
+		{
+			const FHoudiniPCGBenchmarkResult& Result = Results[ResultIdx];
+			Content += FString::Printf(TEXT("\t\t{ \"Stage\": \"%s\", \"Points\": %d, \"Elems\": %lld, \"BestMs\": %.4f, \"AvgMs\": %.4f, \"ElemsPerSecond\": %.0f }%s\n"),
+				*Result.Stage, Result.NumPoints, Result.NumElems, Result.BestMs, Result.AvgMs, Result.GetElemsPerSecond(), (ResultIdx == Results.Num() - 1) ? TEXT("") : TEXT(","));
+		}
+		Content += TEXT("\t]\n}\n");
+	}
+	else
+	{
+		Content = TEXT("PluginVersion,EngineVersion,Stage,Points,Elems,Attribs,StringCardinality,SplinePoints,Runs,BestMs,AvgMs,ElemsPerSecond\n");
+		for (const FHoudiniPCGBenchmarkResult& Result : Results)
+			Content += FString::Printf(TEXT("%s,%s,%s,%d,%lld,%d,%d,%d,%d,%.4f,%.4f,%.0f\n"), *PluginVersion, *EngineVersion,
+				*Result.Stage, Result.NumPoints, Result.NumElems, Settings.NumAttribs, Settings.StringCardinality, Settings.NumSplinePoints, Settings.NumRuns,
+				Result.BestMs, Result.AvgMs, Result.GetElemsPerSecond());
+	}
+
+	IFileManager::Get().MakeDirectory(*FPaths::GetPath(Settings.OutputPath), true);
+	if (FFileHelper::SaveStringToFile(Content, *Settings.OutputPath))
+		Ar.Logf(TEXT("HoudiniPCG.Benchmark: Results saved to %s"), *Settings.OutputPath);
+	else
+		Ar.Logf(ELogVerbosity::Error, TEXT("HoudiniPCG.Benchmark: Failed to save %s"), *Settings.OutputPath);
+}
+
+void FHoudiniPCGBenchmark::Run()
+{
+	const HAPI_Session* Session = FHoudiniEngine::Get().GetSession();
+	const bool bLiveSession = Session && (FHoudiniApi::IsSessionValid(Session) == HAPI_RESULT_SUCCESS);
+	Ar.Logf(TEXT("HoudiniPCG.Benchmark: %d runs per stage, %s"), Settings.NumRuns,
+		bLiveSession ? TEXT("with HAPI transfers") : TEXT("no session, conversions only"));
+
+	for (const int32& NumPoints : Settings.PointCounts)
+		RunPoints(NumPoints, bLiveSession);
+
+	RunSplines();
+
+	RunMeshes();
+
+	Save();
+}
+
+static FAutoConsoleCommandWithArgsAndOutputDevice GHoudiniPCGBenchmarkCmd(
+	TEXT("HoudiniPCG.Benchmark"),
+	TEXT("Measure conversion throughput on synthetic PCG datas, and HAPI transfers if a session is running. ")
+	TEXT("Args: Points=1000,100000 Attribs=4 StringCardinality=16 Splines=100 SplinePoints=64 Tris=100000 Runs=3 Out=<*.csv|*.json>"),
+	FConsoleCommandWithArgsAndOutputDeviceDelegate::CreateLambda([](const TArray<FString>& Args, FOutputDevice& Ar)
+		{
+			FHoudiniPCGBenchmarkSettings Settings;
+			Settings.Parse(FString::Join(Args, TEXT(" ")));
+			FHoudiniPCGBenchmark(Settings, Ar).Run();
+		}));
@@ -0,0 +1,220 @@
+// Copyright Yuzhe Pan (childadrianpan@gmail.com). All Rights Reserved.
+
+#include "HoudiniEngineUtils.h"
+
+#include "Misc/AutomationTest.h"
+#include "Math/RandomStream.h"
+#include "UObject/Package.h"
+
+#include "HoudiniPCGUtils.h"
+
+#include "Metadata/PCGMetadata.h"
+#include "Components/SplineComponent.h"
+#include "Data/PCGSplineData.h"
+#if ((ENGINE_MAJOR_VERSION == 5) && (ENGINE_MINOR_VERSION >= 5)) || (ENGINE_MAJOR_VERSION > 5)
+#include "DynamicMesh/DynamicMesh3.h"
+#endif
+
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// Round trips of the pure conversions shared by the translators and "HoudiniPCG.Benchmark", need NOT a session, so could run in CI with -nullrhi
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHoudiniPCGConversionRoundTripTest, "HoudiniPCG.Conversions.RoundTrip",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+static FORCEINLINE FVector HoudiniPositionToUnreal(const float* P) { return FVector(P[0], P[2], P[1]) * POSITION_SCALE_TO_UNREAL; }
+
+bool FHoudiniPCGConversionRoundTripTest::RunTest(const FString& Parameters)
+{
+	constexpr int32 NumPoints = HOUDINI_PCG_PARALLEL_BATCH_SIZE * 2 + 7;  // Cover multiple batches and a partial one
+	FRandomStream Random(NumPoints);
+
+	// -------- Transforms --------
+	{
+		TArray<FTransform> SrcTransforms;
+		SrcTransforms.SetNumUninitialized(NumPoints);
+		for (FTransform& Transform : SrcTransforms)
+			Transform = FTransform(FRotator(Random.FRandRange(-180.0, 180.0), Random.FRandRange(-180.0, 180.0), Random.FRandRange(-180.0, 180.0)),
+				Random.GetUnitVector() * Random.FRandRange(0.0, 100000.0), FVector(Random.FRandRange(0.5, 2.0), Random.FRandRange(0.5, 2.0), Random.FRandRange(0.5, 2.0)));
+
+		TArray<float> PosData; PosData.SetNumUninitialized(NumPoints * 3);
+		TArray<float> RotData; RotData.SetNumUninitialized(NumPoints * 4);
+		TArray<float> ScaleData; ScaleData.SetNumUninitialized(NumPoints * 3);
+		FHoudiniPCGUtils::ConvertTransformsToHoudini(NumPoints, [&SrcTransforms](const int32& PointIdx) -> const FTransform& { return SrcTransforms[PointIdx]; },
+			PosData.GetData(), RotData.GetData(), ScaleData.GetData());
+
+		FHoudiniPCGTransformData Data;
+		Data.PositionData = PosData;
+		Data.PositionStride = 3;
+		Data.OrientData = RotData;
+		Data.OrientStride = 4;
+		Data.ScaleData = ScaleData;
+		Data.ScaleStride = 3;
+
+		TArray<FTransform> DstTransforms;
+		DstTransforms.SetNum(NumPoints);
+		FHoudiniPCGUtils::ConvertTransformsToUnreal(NumPoints, Data, [&DstTransforms](const int32& PointIdx) -> FTransform& { return DstTransforms[PointIdx]; });
+
+		int32 NumMismatched = 0;
+		for (int32 PointIdx = 0; PointIdx < NumPoints; ++PointIdx)
+		{
+			const FTransform& Src = SrcTransforms[PointIdx];
+			const FTransform& Dst = DstTransforms[PointIdx];
+			if (!Src.GetLocation().Equals(Dst.GetLocation(), 0.05) || !Src.GetRotation().Equals(Dst.GetRotation(), 1e-4) ||
+				!Src.GetScale3D().Equals(Dst.GetScale3D(), 1e-4))
+				++NumMismatched;
+		}
+		TestEqual(TEXT("Transforms mismatched after round trip"), NumMismatched, 0);
+	}
+
+	// -------- Attributes --------
+	{
+		UPCGMetadata* Metadata = NewObject<UPCGMetadata>(GetTransientPackage());
+		for (int32 PointIdx = 0; PointIdx < NumPoints; ++PointIdx)
+			Metadata->AddEntry(-1);
+
+		TArray<PCGMetadataEntryKey> EntryKeys;
+		TArray<float> FloatValues;
+		TArray<FVector> VectorValues;
+		TArray<FString> StrValues;
+		for (int32 PointIdx = 0; PointIdx < NumPoints - 1; ++PointIdx)  // Last point keeps default values
+		{
+			EntryKeys.Add(PointIdx);
+			FloatValues.Add(Random.GetFraction());
+			VectorValues.Add(Random.GetUnitVector() * 100.0);
+			StrValues.Add(FString::Printf(TEXT("/Game/Test/SM_Test_%d.SM_Test_%d"), PointIdx % 7, PointIdx % 7));
+		}
+		Metadata->CreateAttribute<float>(TEXT("Float"), -1.0f, true, true)->SetValues(EntryKeys, FloatValues);
+		Metadata->CreateAttribute<FVector>(TEXT("Vector"), FVector::ZeroVector, true, true)->SetValues(EntryKeys, VectorValues);
+		Metadata->CreateAttribute<FString>(TEXT("String"), TEXT("Default"), true, true)->SetValues(EntryKeys, StrValues);
+
+		for (const bool bDecimated : { false, true })
+		{
+			TArray<int32> PointIndices;  // Empty means all points, otherwise every 3rd point and the default one, as a decimated preview
+			if (bDecimated)
+			{
+				for (int32 PointIdx = 0; PointIdx < NumPoints; PointIdx += 3)
+					PointIndices.Add(PointIdx);
+				PointIndices.AddUnique(NumPoints - 1);
+			}
+			const int32 NumValues = bDecimated ? PointIndices.Num() : NumPoints;
+			auto GetPointIdxLambda = [&](const int32& ValueIdx) { return bDecimated ? PointIndices[ValueIdx] : ValueIdx; };
+
+			TArray<float> HoudiniFloats;
+			FHoudiniPCGUtils::GatherAttribValues<float, float>(Metadata->GetConstTypedAttribute<float>(TEXT("Float")), NumPoints, PointIndices,
+				[](const float& SrcValue, TArray<float>& DstValues) { DstValues.Add(SrcValue); }, HoudiniFloats);
+			TArray<float> HoudiniVectors;
+			FHoudiniPCGUtils::GatherAttribValues<FVector, float>(Metadata->GetConstTypedAttribute<FVector>(TEXT("Vector")), NumPoints, PointIndices,
+				[](const FVector& SrcValue, TArray<float>& DstValues) { DstValues.Add(SrcValue.X); DstValues.Add(SrcValue.Y); DstValues.Add(SrcValue.Z); }, HoudiniVectors);
+			TArray<std::string> UniqueStrs;
+			TArray<const char*> HoudiniStrs;
+			FHoudiniPCGUtils::GatherStringAttribValues<FString>(Metadata->GetConstTypedAttribute<FString>(TEXT("String")), NumPoints, PointIndices,
+				[](const FString& Value) { return Value; }, UniqueStrs, HoudiniStrs);
+
+			if (!TestEqual(TEXT("Float attribute value count"), HoudiniFloats.Num(), NumValues) ||
+				!TestEqual(TEXT("Vector attribute value count"), HoudiniVectors.Num(), NumValues * 3) ||
+				!TestEqual(TEXT("String attribute value count"), HoudiniStrs.Num(), NumValues))
+				continue;
+
+			TestEqual(TEXT("Unique strings"), UniqueStrs.Num(), 8);  // 7 paths and the default value
+
+			int32 NumMismatched = 0;
+			for (int32 ValueIdx = 0; ValueIdx < NumValues; ++ValueIdx)
+			{
+				const int32 PointIdx = GetPointIdxLambda(ValueIdx);
+				const bool bDefault = (PointIdx == NumPoints - 1);
+				const float ExpectedFloat = bDefault ? -1.0f : FloatValues[PointIdx];
+				const FVector ExpectedVector = bDefault ? FVector::ZeroVector : VectorValues[PointIdx];
+				const FString ExpectedStr = bDefault ? FString(TEXT("Default")) : StrValues[PointIdx];
+				if ((HoudiniFloats[ValueIdx] != ExpectedFloat) ||
+					!FVector(HoudiniVectors[ValueIdx * 3], HoudiniVectors[ValueIdx * 3 + 1], HoudiniVectors[ValueIdx * 3 + 2]).Equals(ExpectedVector, 1e-4) ||
+					(UTF8_TO_TCHAR(HoudiniStrs[ValueIdx]) != ExpectedStr))
+					++NumMismatched;
+			}
+			TestEqual(bDecimated ? TEXT("Attribute values mismatched of decimated points") : TEXT("Attribute values mismatched"), NumMismatched, 0);
+		}
+	}
+
+	// -------- Splines --------
+	{
+		TArray<FSplinePoint> SplinePoints;
+		FVector Position = FVector::ZeroVector;
+		for (int32 PointIdx = 0; PointIdx < 64; ++PointIdx)
+		{
+			Position += Random.GetUnitVector() * 500.0;
+			SplinePoints.Add(FSplinePoint(float(PointIdx), Position, FVector::ZeroVector, FVector::ZeroVector,
+				FRotator::ZeroRotator, FVector::OneVector, ESplinePointType::Curve));
+		}
+		const FTransform SplineTransform(FRotator(0.0, 30.0, 0.0), FVector(100.0, 200.0, 300.0), FVector(2.0));
+		UPCGSplineData* SplineData = NewObject<UPCGSplineData>(GetTransientPackage());
+		SplineData->Initialize(SplinePoints, false, SplineTransform);
+
+		const TArray<FInterpCurvePointVector>& Points = SplineData->SplineStruct.GetSplinePointsPosition().Points;
+		TArray<float> PosData;
+		TArray<float> ArriveTangentData;
+		TArray<float> LeaveTangentData;
+		TArray<float> RotData;
+		TArray<float> ScaleData;
+		FHoudiniPCGUtils::ConvertSplineToHoudini(SplineData->SplineStruct.GetTransform(), Points, TConstArrayView<FInterpCurvePointQuat>(),
+			TConstArrayView<FInterpCurvePointVector>(), PosData, ArriveTangentData, LeaveTangentData, RotData, ScaleData);
+
+		if (TestEqual(TEXT("Spline point count"), PosData.Num(), SplinePoints.Num() * 3))
+		{
+			TestTrue(TEXT("Spline rot and scale are NOT converted without source"), RotData.IsEmpty() && ScaleData.IsEmpty());
+
+			int32 NumMismatched = 0;
+			for (int32 PointIdx = 0; PointIdx < SplinePoints.Num(); ++PointIdx)
+			{
+				if (!HoudiniPositionToUnreal(PosData.GetData() + PointIdx * 3).Equals(SplineTransform.TransformPosition(SplinePoints[PointIdx].Position), 0.05))
+					++NumMismatched;
+			}
+			TestEqual(TEXT("Spline positions mismatched"), NumMismatched, 0);
+		}
+	}
+
+#if ((ENGINE_MAJOR_VERSION == 5) && (ENGINE_MINOR_VERSION >= 5)) || (ENGINE_MAJOR_VERSION > 5)
+	// -------- Meshes --------
+	{
+		constexpr int32 GridSize = 64;
+		UE::Geometry::FDynamicMesh3 DM;
+		for (int32 Y = 0; Y < GridSize; ++Y)
+		{
+			for (int32 X = 0; X < GridSize; ++X)
+				DM.AppendVertex(FVector(X * 100.0, Y * 100.0, FMath::Sin(X * 0.1) * 100.0));
+		}
+		for (int32 Y = 0; Y < GridSize - 1; ++Y)
+		{
+			for (int32 X = 0; X < GridSize - 1; ++X)
+			{
+				const int32 V0 = Y * GridSize + X;
+				DM.AppendTriangle(UE::Geometry::FIndex3i(V0, V0 + 1, V0 + GridSize));
+				DM.AppendTriangle(UE::Geometry::FIndex3i(V0 + 1, V0 + GridSize + 1, V0 + GridSize));
+			}
+		}
+
+		TArray<float> PosData;
+		TArray<int32> Vertices;
+		FHoudiniPCGUtils::ConvertDynamicMeshToHoudini(DM, PosData, Vertices);
+		if (TestEqual(TEXT("Mesh point count"), PosData.Num(), DM.VertexCount() * 3) &&
+			TestEqual(TEXT("Mesh vertex count"), Vertices.Num(), DM.TriangleCount() * 3))
+		{
+			int32 NumMismatched = 0;
+			for (int32 PointId = 0; PointId < DM.VertexCount(); ++PointId)
+			{
+				if (!HoudiniPositionToUnreal(PosData.GetData() + PointId * 3).Equals(DM.GetVertex(PointId), 0.01))
+					++NumMismatched;
+			}
+			for (int32 TriId = 0; TriId < DM.TriangleCount(); ++TriId)  // Houdini winding is reversed
+			{
+				if (DM.GetTriangle(TriId) != UE::Geometry::FIndex3i(Vertices[TriId * 3 + 2], Vertices[TriId * 3 + 1], Vertices[TriId * 3]))
+					++NumMismatched;
+			}
+			TestEqual(TEXT("Mesh points or triangles mismatched"), NumMismatched, 0);
+		}
+	}
+#endif
+
+	return true;
+}
+
+#endif
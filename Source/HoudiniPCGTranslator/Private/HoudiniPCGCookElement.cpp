@@ -0,0 +1,163 @@
+// Copyright Yuzhe Pan (childadrianpan@gmail.com). All Rights Reserved.
+
+#include "HoudiniPCGCookElement.h"
+
+#include "HoudiniApi.h"
+#include "HoudiniEngine.h"
+#include "HoudiniEngineUtils.h"
+
+#include "PCGContext.h"
+#include "PCGPin.h"
+
+#include "HoudiniInputPCGComponent.h"
+#include "HoudiniOutputPCGDataAsset.h"
+#include "HoudiniPCGUtils.h"
+
+
+#define LOCTEXT_NAMESPACE "HoudiniPCGCookElement"
+
+#if WITH_EDITOR
+FText UHoudiniPCGCookSettings::GetDefaultNodeTitle() const
+{
+	return LOCTEXT("NodeTitle", "Houdini Cook");
+}
+
+FText UHoudiniPCGCookSettings::GetNodeTooltipText() const
+{
+	return LOCTEXT("NodeTooltip", "Upload input datas to the first input of an HDA, cook it, and output its geo as PCG datas without saving any asset.");
+}
+#endif
+
+TArray<FPCGPinProperties> UHoudiniPCGCookSettings::InputPinProperties() const
+{
+	TArray<FPCGPinProperties> PinProperties;
+	PinProperties.Emplace(PCGPinConstants::DefaultInputLabel, EPCGDataType::Any);
+	return PinProperties;
+}
+
+TArray<FPCGPinProperties> UHoudiniPCGCookSettings::OutputPinProperties() const
+{
+	TArray<FPCGPinProperties> PinProperties;
+	PinProperties.Emplace(PCGPinConstants::DefaultOutputLabel, EPCGDataType::Any);
+	return PinProperties;
+}
+
+FPCGElementPtr UHoudiniPCGCookSettings::CreateElement() const
+{
+	return MakeShared<FHoudiniPCGCookElement>();
+}
+
+
+struct FHoudiniPCGCookContext : public FPCGContext  // Nodes alive during an execution, will be deleted when finished or cancelled
+{
+	int32 NodeId = -1;
+	int32 RootNodeId = -1;
+	int32 InputGeoNodeId = -1;
+	int32 PrevCookCount = 0;  // Before CookNode, so that we know when THIS node finished, as the cook state of the session may come from other nodes
+
+	virtual ~FHoudiniPCGCookContext() { HapiDestroy(); }
+
+	bool HapiStartCook(const UHoudiniPCGCookSettings* Settings);
+
+	void HapiDestroy();
+};
+
+bool FHoudiniPCGCookContext::HapiStartCook(const UHoudiniPCGCookSettings* Settings)
+{
+	const HAPI_Session* Session = FHoudiniEngine::Get().GetSession();
+
+	TArray<FString> AssetNames;
+	HOUDINI_FAIL_RETURN(FHoudiniPCGUtils::HapiLoadAssetLibrary(Session, Settings->HdaPath.FilePath, AssetNames));
+	const FString AssetName = Settings->AssetName.IsEmpty() ? (AssetNames.IsEmpty() ? FString() : AssetNames[0]) : Settings->AssetName;
+	if (!AssetNames.Contains(AssetName))
+		return false;
+
+	HOUDINI_FAIL_RETURN(FHoudiniPCGUtils::HapiInstantiateAsset(Session, AssetName, TEXT("HoudiniPCGCook"), NodeId, RootNodeId));
+
+	FPCGDataCollection InputCollection;
+	InputCollection.TaggedData = InputData.GetInputsByPin(PCGPinConstants::DefaultInputLabel);
+	if (!InputCollection.TaggedData.IsEmpty())  // Each data as a null, merged to the first input of the HDA
+	{
+		HOUDINI_FAIL_RETURN(FHoudiniPCGUtils::HapiConnectInputDatas(Session, NodeId, RootNodeId, 0, InputCollection, Settings->bImportRotAndScale,
+			FHoudiniPCGAttributeFilter(Settings->InputAttributeFilter), InputGeoNodeId));
+	}
+
+	HOUDINI_FAIL_RETURN(FHoudiniPCGUtils::HapiGetCookCount(Session, NodeId, PrevCookCount));
+	HAPI_CookOptions CookOptions;
+	FHoudiniApi::CookOptions_Init(&CookOptions);
+	HAPI_SESSION_FAIL_RETURN(FHoudiniApi::CookNode(Session, NodeId, &CookOptions));  // Returns immediately if the session cooks on its own thread, otherwise blocks until cooked
+
+	return true;
+}
+
+void FHoudiniPCGCookContext::HapiDestroy()
+{
+	const HAPI_Session* Session = FHoudiniEngine::Get().GetSession();
+	if (!Session)
+		return;
+
+	if (RootNodeId >= 0)
+		FHoudiniApi::DeleteNode(Session, RootNodeId);
+	if (InputGeoNodeId >= 0)
+		FHoudiniApi::DeleteNode(Session, InputGeoNodeId);
+
+	NodeId = -1;
+	RootNodeId = -1;
+	InputGeoNodeId = -1;
+}
+
+
+FPCGContext* FHoudiniPCGCookElement::CreateContext()
+{
+	return new FHoudiniPCGCookContext();
+}
+
+bool FHoudiniPCGCookElement::ExecuteInternal(FPCGContext* InContext) const
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(HoudiniPCGCookElement);
+
+	FHoudiniPCGCookContext* Context = static_cast<FHoudiniPCGCookContext*>(InContext);
+	const UHoudiniPCGCookSettings* Settings = Context->GetInputSettings<UHoudiniPCGCookSettings>();
+	check(Settings);
+
+	const HAPI_Session* Session = FHoudiniEngine::Get().GetSession();
+	if (!Session || (FHoudiniApi::IsSessionValid(Session) != HAPI_RESULT_SUCCESS))
+	{
+		PCGE_LOG(Error, GraphAndLog, LOCTEXT("NoSession", "No valid houdini session, please start a session first"));
+		return true;
+	}
+
+	if (Context->NodeId < 0)  // First execution, upload inputs and start to cook
+	{
+		if (!Context->HapiStartCook(Settings))
+		{
+			PCGE_LOG(Error, GraphAndLog, FText::Format(LOCTEXT("StartCookFailed", "Failed to instantiate or cook \"{0}\" {1}"),
+				FText::FromString(Settings->HdaPath.FilePath), FText::FromString(Settings->AssetName)));
+			Context->HapiDestroy();
+			return true;
+		}
+		// Sessions without a cooking thread have finished in CookNode, so check right away rather than at the next execution
+	}
+
+	bool bFinished = false;
+	bool bSucceeded = false;
+	if (FHoudiniPCGUtils::HapiGetNodeCookState(Session, Context->NodeId, Context->PrevCookCount, bFinished, bSucceeded) && !bFinished)
+		return false;  // Poll again at next execution
+
+	if (bSucceeded)
+	{
+		FHoudiniPCGDataAssetOutputBuilder OutputBuilder;  // Transient retrieval never notifies, so need NOT to share the one registered for HDAs
+		HAPI_GeoInfo GeoInfo;
+		TArray<HAPI_PartInfo> PartInfos;
+		if (!FHoudiniPCGUtils::HapiGetOutputParts(Session, Context->NodeId, OutputBuilder, GeoInfo, PartInfos) ||
+			(!PartInfos.IsEmpty() && !OutputBuilder.HapiRetrieveTransient(GeoInfo, PartInfos, Context->OutputData)))
+			PCGE_LOG(Error, GraphAndLog, LOCTEXT("RetrieveFailed", "Failed to retrieve the output geo"));
+	}
+	else
+		PCGE_LOG(Error, GraphAndLog, LOCTEXT("CookFailed", "Houdini cook failed, see houdini node errors"));
+
+	Context->HapiDestroy();
+	return true;
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,64 @@
+// Copyright Yuzhe Pan (childadrianpan@gmail.com). All Rights Reserved.
+
+#include "HoudiniPCGLoadOutputElement.h"
+
+#include "PCGContext.h"
+#include "PCGPin.h"
+#include "PCGDataAsset.h"
+
+#include "HoudiniOutputPCGDataAsset.h"
+#include "HoudiniPCGTranslator.h"
+
+
+#define LOCTEXT_NAMESPACE "HoudiniPCGLoadOutputElement"
+
+#if WITH_EDITOR
+FText UHoudiniPCGLoadOutputSettings::GetDefaultNodeTitle() const
+{
+	return LOCTEXT("NodeTitle", "Houdini Load Output");
+}
+
+FText UHoudiniPCGLoadOutputSettings::GetNodeTooltipText() const
+{
+	return LOCTEXT("NodeTooltip", "Load datas of a PCGDataAsset output by HDAs, or its preview if HoudiniPCG.PreviewOutput = 1.");
+}
+#endif
+
+TArray<FPCGPinProperties> UHoudiniPCGLoadOutputSettings::OutputPinProperties() const
+{
+	TArray<FPCGPinProperties> PinProperties;
+	PinProperties.Emplace(PCGPinConstants::DefaultOutputLabel, EPCGDataType::Any);
+	return PinProperties;
+}
+
+FPCGElementPtr UHoudiniPCGLoadOutputSettings::CreateElement() const
+{
+	return MakeShared<FHoudiniPCGLoadOutputElement>();
+}
+
+
+bool FHoudiniPCGLoadOutputElement::ExecuteInternal(FPCGContext* Context) const
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(HoudiniPCGLoadOutputElement);
+
+	const UHoudiniPCGLoadOutputSettings* Settings = Context->GetInputSettings<UHoudiniPCGLoadOutputSettings>();
+	check(Settings);
+
+	const UPCGDataAsset* PCGDA = FHoudiniPCGTranslator::Get().GetOutputBuilder()->FindPreview(Settings->PCGDataAsset.ToSoftObjectPath());
+	if (!PCGDA)
+		PCGDA = Settings->PCGDataAsset.LoadSynchronous();
+
+	if (!IsValid(PCGDA))
+	{
+		PCGE_LOG(Warning, GraphAndLog, FText::Format(LOCTEXT("AssetNotFound", "Neither asset nor preview found at \"{0}\""),
+			FText::FromString(Settings->PCGDataAsset.ToString())));
+		return true;
+	}
+
+	Context->OutputData.TaggedData.Append(PCGDA->Data.TaggedData);
+	Context->OutputData.DataCrcs.Append(PCGDA->Data.DataCrcs);
+
+	return true;
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,687 @@
+// Copyright Yuzhe Pan (childadrianpan@gmail.com). All Rights Reserved.
+
+#include "HoudiniPCGUtils.h"
+
+#include "HoudiniEngine.h"
+#include "HoudiniEngineUtils.h"
+
+#include "HoudiniInputPCGComponent.h"
+#include "HoudiniOutputPCGDataAsset.h"
+
+#include "Async/ParallelFor.h"
+#include "CoreGlobals.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+#include "ProfilingDebugging/CountersTrace.h"
+#if ((ENGINE_MAJOR_VERSION == 5) && (ENGINE_MINOR_VERSION >= 5)) || (ENGINE_MAJOR_VERSION > 5)
+#include "DynamicMesh/DynamicMesh3.h"
+#endif
+
+#include <atomic>
+
+
+void FHoudiniPCGUtils::ParallelForBatch(const int32& NumElems, TFunctionRef<void(const int32& StartIdx, const int32& EndIdx)> BatchFunc)
+{
+	if (NumElems <= 0)
+		return;
+
+	const int32 NumBatches = FMath::DivideAndRoundUp(NumElems, HOUDINI_PCG_PARALLEL_BATCH_SIZE);
+	if (NumBatches <= 1)  // Small data, task dispatch will cost more than conversion
+	{
+		BatchFunc(0, NumElems);
+		return;
+	}
+
+	ParallelFor(NumBatches, [&](int32 BatchIdx)
+		{
+			const int32 StartIdx = BatchIdx * HOUDINI_PCG_PARALLEL_BATCH_SIZE;
+			BatchFunc(StartIdx, FMath::Min(StartIdx + HOUDINI_PCG_PARALLEL_BATCH_SIZE, NumElems));
+		});
+}
+
+void FHoudiniPCGUtils::ConvertTransformsToHoudini(const int32& NumPoints, TFunctionRef<const FTransform&(const int32&)> GetTransformFunc,
+	float* OutPosData, float* OutRotData, float* OutScaleData)
+{
+	ParallelForBatch(NumPoints, [&](const int32& StartIdx, const int32& EndIdx)
+		{
+			for (int32 PointIdx = StartIdx; PointIdx < EndIdx; ++PointIdx)
+			{
+				const FTransform& Transform = GetTransformFunc(PointIdx);
+				{
+					const FVector3f Pos = FVector3f(Transform.GetLocation() * POSITION_SCALE_TO_HOUDINI);
+					OutPosData[PointIdx * 3] = Pos.X; OutPosData[PointIdx * 3 + 1] = Pos.Z; OutPosData[PointIdx * 3 + 2] = Pos.Y;
+				}
+				{
+					const FQuat Rot = Transform.GetRotation();
+					OutRotData[PointIdx * 4] = Rot.X; OutRotData[PointIdx * 4 + 1] = Rot.Z; OutRotData[PointIdx * 4 + 2] = Rot.Y; OutRotData[PointIdx * 4 + 3] = -Rot.W;
+				}
+				{
+					const FVector Scale = Transform.GetScale3D();
+					OutScaleData[PointIdx * 3] = Scale.X; OutScaleData[PointIdx * 3 + 1] = Scale.Z; OutScaleData[PointIdx * 3 + 2] = Scale.Y;
+				}
+			}
+		});
+}
+
+void FHoudiniPCGUtils::ConvertTransformsToUnreal(const int32& NumPoints, const FHoudiniPCGTransformData& Data, TFunctionRef<FTransform&(const int32&)> GetTransformFunc)
+{
+	ParallelForBatch(NumPoints, [&](const int32& StartIdx, const int32& EndIdx)
+		{
+			for (int32 PointIdx = StartIdx; PointIdx < EndIdx; ++PointIdx)
+			{
+				FTransform& Transform = GetTransformFunc(PointIdx);
+
+				const float* P = Data.PositionData.GetData() + PointIdx * Data.PositionStride;
+				Transform.SetLocation(FVector(P[0], P[2], P[1]) * POSITION_SCALE_TO_UNREAL_F);
+
+				FQuat Rotation = FQuat::Identity;
+				if (!Data.OrientData.IsEmpty())
+				{
+					const float* Orient = Data.OrientData.GetData() + PointIdx * Data.OrientStride;
+					Rotation = FQuat(Orient[0], Orient[2], Orient[1], -Orient[3]);
+				}
+				else if (!Data.NormalData.IsEmpty())  // Houdini +Z axis (unreal +Y) along N, and +Y axis (unreal +Z) towards up
+				{
+					const float* N = Data.NormalData.GetData() + PointIdx * Data.NormalStride;
+					const FVector Up = Data.UpData.IsEmpty() ? FVector::UpVector :
+						FVector(Data.UpData[PointIdx * Data.UpStride], Data.UpData[PointIdx * Data.UpStride + 2], Data.UpData[PointIdx * Data.UpStride + 1]);
+					const FVector Normal(N[0], N[2], N[1]);
+					if (!Normal.IsNearlyZero())
+						Rotation = FRotationMatrix::MakeFromYZ(Normal, Up).ToQuat();
+				}
+				if (!Data.RotData.IsEmpty())  // p@rot is applied after orient, N and up
+				{
+					const float* Rot = Data.RotData.GetData() + PointIdx * Data.RotStride;
+					Rotation = FQuat(Rot[0], Rot[2], Rot[1], -Rot[3]) * Rotation;
+				}
+				Transform.SetRotation(Rotation.GetNormalized());
+
+				FVector Scale = Data.ScaleData.IsEmpty() ? FVector::OneVector :
+					FVector(Data.ScaleData[PointIdx * Data.ScaleStride], Data.ScaleData[PointIdx * Data.ScaleStride + 2], Data.ScaleData[PointIdx * Data.ScaleStride + 1]);
+				if (!Data.PScaleData.IsEmpty())
+					Scale *= Data.PScaleData[PointIdx * Data.PScaleStride];
+				Transform.SetScale3D(Scale);
+			}
+		});
+}
+
+void FHoudiniPCGUtils::ConvertSplineToHoudini(const FTransform& Transform, TConstArrayView<FInterpCurvePointVector> Points,
+	TConstArrayView<FInterpCurvePointQuat> Rots, TConstArrayView<FInterpCurvePointVector> Scales,
+	TArray<float>& OutPosData, TArray<float>& OutArriveTangentData, TArray<float>& OutLeaveTangentData, TArray<float>& OutRotData, TArray<float>& OutScaleData)
+{
+	const bool bConvertRotAndScale = !Rots.IsEmpty() && !Scales.IsEmpty();
+	OutPosData.SetNumUninitialized(Points.Num() * 3);
+	OutArriveTangentData.SetNumUninitialized(Points.Num() * 3);
+	OutLeaveTangentData.SetNumUninitialized(Points.Num() * 3);
+	OutRotData.SetNumUninitialized(bConvertRotAndScale ? Points.Num() * 4 : 0);
+	OutScaleData.SetNumUninitialized(bConvertRotAndScale ? Points.Num() * 3 : 0);
+	for (int32 PointIdx = 0; PointIdx < Points.Num(); ++PointIdx)
+	{
+		const FInterpCurvePointVector& Point = Points[PointIdx];
+		{
+			const FVector3f Pos = FVector3f(Transform.TransformPosition(Point.OutVal) * POSITION_SCALE_TO_HOUDINI);
+			OutPosData[PointIdx * 3] = Pos.X; OutPosData[PointIdx * 3 + 1] = Pos.Z; OutPosData[PointIdx * 3 + 2] = Pos.Y;
+		}
+		{
+			const FVector3f Tangent = FVector3f(Transform.TransformVector(Point.ArriveTangent));
+			OutArriveTangentData[PointIdx * 3] = Tangent.X; OutArriveTangentData[PointIdx * 3 + 1] = Tangent.Z; OutArriveTangentData[PointIdx * 3 + 2] = Tangent.Y;
+		}
+		{
+			const FVector3f Tangent = FVector3f(Transform.TransformVector(Point.LeaveTangent));
+			OutLeaveTangentData[PointIdx * 3] = Tangent.X; OutLeaveTangentData[PointIdx * 3 + 1] = Tangent.Z; OutLeaveTangentData[PointIdx * 3 + 2] = Tangent.Y;
+		}
+		if (bConvertRotAndScale)
+		{
+			const FQuat4f Rot = Rots.IsValidIndex(PointIdx) ? FQuat4f(Transform.TransformRotation(Rots[PointIdx].OutVal)) : FQuat4f::Identity;
+			const FVector3f Scale = Scales.IsValidIndex(PointIdx) ? FVector3f(Transform.GetScale3D() * Scales[PointIdx].OutVal) : FVector3f::OneVector;
+			OutRotData[PointIdx * 4] = Rot.X; OutRotData[PointIdx * 4 + 1] = Rot.Z; OutRotData[PointIdx * 4 + 2] = Rot.Y; OutRotData[PointIdx * 4 + 3] = -Rot.W;
+			OutScaleData[PointIdx * 3] = Scale.X; OutScaleData[PointIdx * 3 + 1] = Scale.Z; OutScaleData[PointIdx * 3 + 2] = Scale.Y;
+		}
+	}
+}
+
+#if ((ENGINE_MAJOR_VERSION == 5) && (ENGINE_MINOR_VERSION >= 5)) || (ENGINE_MAJOR_VERSION > 5)
+void FHoudiniPCGUtils::ConvertDynamicMeshToHoudini(const UE::Geometry::FDynamicMesh3& DM, TArray<float>& OutPosData, TArray<int32>& OutVertices)
+{
+	const int32 NumPoints = DM.VertexCount();
+	OutPosData.SetNumUninitialized(NumPoints * 3);
+	ParallelForBatch(NumPoints, [&](const int32& StartIdx, const int32& EndIdx)
+		{
+			for (int32 PointId = StartIdx; PointId < EndIdx; ++PointId)
+			{
+				const FVector3f Position = FVector3f(DM.GetVertexRef(PointId) * POSITION_SCALE_TO_HOUDINI);
+				OutPosData[PointId * 3] = Position.X; OutPosData[PointId * 3 + 1] = Position.Z; OutPosData[PointId * 3 + 2] = Position.Y;
+			}
+		});
+
+	const int32 NumTris = DM.TriangleCount();
+	OutVertices.SetNumUninitialized(NumTris * 3);
+	ParallelForBatch(NumTris, [&](const int32& StartIdx, const int32& EndIdx)
+		{
+			for (int32 TriId = StartIdx; TriId < EndIdx; ++TriId)
+			{
+				const UE::Geometry::FIndex3i Triangle = DM.GetTriangle(TriId);
+				OutVertices[TriId * 3] = Triangle.C; OutVertices[TriId * 3 + 1] = Triangle.B; OutVertices[TriId * 3 + 2] = Triangle.A;
+			}
+		});
+}
+#endif
+
+struct FHoudiniPCGAssetLibrary
+{
+	HAPI_AssetLibraryId LibraryId = -1;
+	FDateTime TimeStamp;
+	TArray<FString> AssetNames;
+};
+
+static TMap<FString, FHoudiniPCGAssetLibrary> GHoudiniPCGAssetLibraries;  // "<Session type>:<Session id>|<HDA path>"
+
+bool FHoudiniPCGUtils::HapiConvertStringHandles(const HAPI_Session* Session, const TConstArrayView<HAPI_StringHandle>& SHs, TArray<std::string>& OutStrs)
+{
+	OutStrs.SetNum(SHs.Num());
+	if (SHs.IsEmpty())
+		return true;
+
+	int BufferSize = 0;
+	HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetStringBatchSize(Session, SHs.GetData(), SHs.Num(), &BufferSize));
+	if (BufferSize <= 0)
+		return true;
+
+	TArray<char> Buffer;  // Null-terminated strings one after another
+	Buffer.SetNumUninitialized(BufferSize);
+	HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetStringBatch(Session, Buffer.GetData(), BufferSize));
+
+	const char* Str = Buffer.GetData();
+	const char* const BufferEnd = Str + BufferSize;
+	for (std::string& OutStr : OutStrs)
+	{
+		if (Str >= BufferEnd)
+			break;
+
+		const size_t Length = strnlen(Str, BufferEnd - Str);
+		OutStr.assign(Str, Length);
+		Str += Length + 1;
+	}
+
+	return true;
+}
+
+bool FHoudiniPCGUtils::HapiConvertStringHandles(const HAPI_Session* Session, const TConstArrayView<HAPI_StringHandle>& SHs, TArray<FString>& OutStrs)
+{
+	TArray<std::string> Strs;
+	HOUDINI_FAIL_RETURN(HapiConvertStringHandles(Session, SHs, Strs));
+
+	OutStrs.SetNum(Strs.Num());
+	for (int32 StrIdx = 0; StrIdx < Strs.Num(); ++StrIdx)
+		OutStrs[StrIdx] = UTF8_TO_TCHAR(Strs[StrIdx].c_str());
+
+	return true;
+}
+
+bool FHoudiniPCGUtils::HapiLoadAssetLibrary(const HAPI_Session* Session, const FString& HdaPath, TArray<FString>& OutAssetNames)
+{
+	const FString LibraryKey = FString::Printf(TEXT("%d:%lld|%s"), int32(Session->type), int64(Session->id), *HdaPath);
+	const FDateTime TimeStamp = IFileManager::Get().GetTimeStamp(*HdaPath);
+	if (const FHoudiniPCGAssetLibrary* Library = GHoudiniPCGAssetLibraries.Find(LibraryKey))
+	{
+		int NumAssets = 0;  // Session may restart with the same id, so check the library still exists
+		if ((Library->TimeStamp == TimeStamp) && (FHoudiniApi::GetAvailableAssetCount(Session, Library->LibraryId, &NumAssets) == HAPI_RESULT_SUCCESS) &&
+			(NumAssets == Library->AssetNames.Num()))
+		{
+			OutAssetNames = Library->AssetNames;
+			return true;
+		}
+		GHoudiniPCGAssetLibraries.Remove(LibraryKey);
+	}
+
+	HAPI_AssetLibraryId LibraryId = -1;
+	HAPI_SESSION_FAIL_RETURN(FHoudiniApi::LoadAssetLibraryFromFile(Session, TCHAR_TO_UTF8(*HdaPath), true, &LibraryId));
+
+	int NumAssets = 0;
+	HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetAvailableAssetCount(Session, LibraryId, &NumAssets));
+	if (NumAssets > 0)
+	{
+		TArray<HAPI_StringHandle> AssetNameSHs;
+		AssetNameSHs.SetNumUninitialized(NumAssets);
+		HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetAvailableAssets(Session, LibraryId, AssetNameSHs.GetData(), NumAssets));
+		HOUDINI_FAIL_RETURN(HapiConvertStringHandles(Session, AssetNameSHs, OutAssetNames));
+	}
+
+	GHoudiniPCGAssetLibraries.Add(LibraryKey, FHoudiniPCGAssetLibrary{ LibraryId, TimeStamp, OutAssetNames });
+	return true;
+}
+
+bool FHoudiniPCGUtils::HapiInstantiateAsset(const HAPI_Session* Session, const FString& AssetName, const FString& NodeLabel, int32& OutNodeId, int32& OutRootNodeId)
+{
+	HAPI_SESSION_FAIL_RETURN(FHoudiniApi::CreateNode(Session, -1, TCHAR_TO_UTF8(*AssetName), TCHAR_TO_UTF8(*NodeLabel), false, &OutNodeId));
+	HAPI_NodeInfo NodeInfo;
+	HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetNodeInfo(Session, OutNodeId, &NodeInfo));
+	OutRootNodeId = (NodeInfo.type == HAPI_NODETYPE_SOP) ? NodeInfo.parentId : OutNodeId;
+	return true;
+}
+
+bool FHoudiniPCGUtils::HapiConnectInputDatas(const HAPI_Session* Session, const int32& NodeId, const int32& RootNodeId, const int32& InputIdx, const FPCGDataCollection& Data,
+	const bool& bImportRotAndScale, const FHoudiniPCGAttributeFilter& AttribFilter, int32& OutInputGeoNodeId)
+{
+	HAPI_SESSION_FAIL_RETURN(FHoudiniApi::CreateNode(Session, -1, "Object/geo", TCHAR_TO_UTF8(*FString::Printf(TEXT("HoudiniPCGInput%d"), InputIdx)), false, &OutInputGeoNodeId));
+	int32 MergeNodeId = -1;
+	HAPI_SESSION_FAIL_RETURN(FHoudiniApi::CreateNode(Session, OutInputGeoNodeId, "merge", "merge", false, &MergeNodeId));
+
+	TArray<int32> InputNodeIds;
+	int32 NumDatas = 0;
+	HOUDINI_FAIL_RETURN(FHoudiniPCGComponentInput::HapiUploadData(OutInputGeoNodeId, bImportRotAndScale,
+		[&](const int32& InputNodeId)
+		{
+			HAPI_SESSION_FAIL_RETURN(FHoudiniApi::ConnectNodeInput(Session, MergeNodeId, InputNodeIds.Num(), InputNodeId, 0));
+			return true;
+		}, nullptr, Data, InputNodeIds, NumDatas, AttribFilter, false, Session));
+
+	// Obj asset takes the geo obj as input, whose display sop is the merge
+	HAPI_SESSION_FAIL_RETURN(FHoudiniApi::ConnectNodeInput(Session, NodeId, InputIdx, (RootNodeId == NodeId) ? OutInputGeoNodeId : MergeNodeId, 0));
+	return true;
+}
+
+bool FHoudiniPCGUtils::HapiGetCookCount(const HAPI_Session* Session, const int32& NodeId, int32& OutCookCount)
+{
+	HAPI_NodeInfo NodeInfo;
+	HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetNodeInfo(Session, NodeId, &NodeInfo));
+	OutCookCount = NodeInfo.totalCookCount;
+	return true;
+}
+
+bool FHoudiniPCGUtils::HapiGetNodeCookState(const HAPI_Session* Session, const int32& NodeId, const int32& PrevCookCount, bool& bOutFinished, bool& bOutSucceeded)
+{
+	int Status = HAPI_STATE_STARTING_COOK;
+	HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetStatus(Session, HAPI_STATUS_COOK_STATE, &Status));
+	bOutFinished = (Status <= HAPI_STATE_MAX_READY_STATE);
+	bOutSucceeded = false;
+	if (!bOutFinished)
+		return true;
+
+	int32 CookCount = PrevCookCount;
+	HOUDINI_FAIL_RETURN(HapiGetCookCount(Session, NodeId, CookCount));
+	if (CookCount <= PrevCookCount)  // Session is idle but the node never cooked
+		return true;
+
+	int ErrorsLength = 0;  // Errors of this node only, cook errors may lead to incomplete outputs
+	HAPI_SESSION_FAIL_RETURN(FHoudiniApi::ComposeNodeCookResult(Session, NodeId, HAPI_STATUSVERBOSITY_ERRORS, &ErrorsLength));
+	bOutSucceeded = (ErrorsLength <= 1);  // Only the null terminator
+	return true;
+}
+
+bool FHoudiniPCGUtils::HapiGetOutputParts(const HAPI_Session* Session, const int32& NodeId, FHoudiniPCGDataAssetOutputBuilder& OutputBuilder,
+	HAPI_GeoInfo& OutGeoInfo, TArray<HAPI_PartInfo>& OutPartInfos)
+{
+	HAPI_NodeInfo NodeInfo;
+	HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetNodeInfo(Session, NodeId, &NodeInfo));
+	if (NodeInfo.type == HAPI_NODETYPE_SOP)
+	{
+		HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetGeoInfo(Session, NodeId, &OutGeoInfo));
+	}
+	else
+	{
+		HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetDisplayGeoInfo(Session, NodeId, &OutGeoInfo));
+	}
+
+	for (int32 PartId = 0; PartId < OutGeoInfo.partCount; ++PartId)
+	{
+		HAPI_PartInfo PartInfo;
+		HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetPartInfo(Session, OutGeoInfo.nodeId, PartId, &PartInfo));
+		bool bIsValid = false;
+		bool bShouldHoldByOutput = false;
+		HOUDINI_FAIL_RETURN(OutputBuilder.HapiIsPartValid(OutGeoInfo.nodeId, PartInfo, bIsValid, bShouldHoldByOutput));
+		if (bIsValid)
+			OutPartInfos.Add(PartInfo);
+	}
+
+	return true;
+}
+
+
+// -------- LLM tags --------
+LLM_DEFINE_TAG(HoudiniPCG);
+LLM_DEFINE_TAG(HoudiniPCG_InputStaging);
+LLM_DEFINE_TAG(HoudiniPCG_MetadataConversion);
+LLM_DEFINE_TAG(HoudiniPCG_OutputScratch);
+LLM_DEFINE_TAG(HoudiniPCG_PCGData);
+LLM_DEFINE_TAG(HoudiniPCG_Cache);
+
+
+// -------- Cook stats --------
+TRACE_DECLARE_INT_COUNTER(HoudiniPCGInputPoints, TEXT("HoudiniPCG/Input/Points"));
+TRACE_DECLARE_INT_COUNTER(HoudiniPCGInputAttributes, TEXT("HoudiniPCG/Input/Attributes"));
+TRACE_DECLARE_INT_COUNTER(HoudiniPCGInputBytes, TEXT("HoudiniPCG/Input/Bytes"));
+TRACE_DECLARE_INT_COUNTER(HoudiniPCGInputHapiCalls, TEXT("HoudiniPCG/Input/HapiCalls"));
+TRACE_DECLARE_INT_COUNTER(HoudiniPCGInputTransientBytes, TEXT("HoudiniPCG/Input/TransientBytes"));
+TRACE_DECLARE_INT_COUNTER(HoudiniPCGOutputPoints, TEXT("HoudiniPCG/Output/Points"));
+TRACE_DECLARE_INT_COUNTER(HoudiniPCGOutputAttributes, TEXT("HoudiniPCG/Output/Attributes"));
+TRACE_DECLARE_INT_COUNTER(HoudiniPCGOutputBytes, TEXT("HoudiniPCG/Output/Bytes"));
+TRACE_DECLARE_INT_COUNTER(HoudiniPCGOutputHapiCalls, TEXT("HoudiniPCG/Output/HapiCalls"));
+TRACE_DECLARE_INT_COUNTER(HoudiniPCGOutputTransientBytes, TEXT("HoudiniPCG/Output/TransientBytes"));
+
+static const TCHAR* const GHoudiniPCGCookStageNames[] = { TEXT("Points"), TEXT("Splines"), TEXT("Meshes"), TEXT("Attributes"), TEXT("CommitGeo"),
+	TEXT("Schema"), TEXT("Points"), TEXT("Splines"), TEXT("Meshes"), TEXT("Attributes"), TEXT("Crc"), TEXT("PostEditChange"), TEXT("PrefetchWait") };
+static_assert(UE_ARRAY_COUNT(GHoudiniPCGCookStageNames) == int32(EHoudiniPCGCookStage::Num), "Name of each cook stage must be defined");
+
+struct FHoudiniPCGDirectionStats  // Written by game thread and prefetch workers, so all atomic
+{
+	std::atomic<int32> CookDepth = 0;  // Of FHoudiniPCGCookStatsScope
+	std::atomic<uint64> NumCooks = 0;
+	std::atomic<int64> NumHapiCalls = 0;
+	std::atomic<uint64> HapiCycles = 0;
+	std::atomic<uint64> MaxHapiCycles = 0;
+	std::atomic<int64> NumBytes = 0;
+	std::atomic<int64> NumAttribs = 0;
+	std::atomic<int64> TransientBytes = 0;  // Currently alive, NOT reset between cooks
+	std::atomic<int64> PeakTransientBytes = 0;
+};
+
+static FHoudiniPCGDirectionStats GHoudiniPCGDirectionStats[2];  // Output, Input
+static std::atomic<uint64> GHoudiniPCGStageCycles[int32(EHoudiniPCGCookStage::Num)];
+static std::atomic<int64> GHoudiniPCGStageElems[int32(EHoudiniPCGCookStage::Num)];
+
+static FORCEINLINE bool IsInputStage(const int32& StageIdx) { return StageIdx <= int32(EHoudiniPCGCookStage::InputCommit); }
+
+static thread_local FHoudiniPCGStageScope* GHoudiniPCGCurrentStageScope = nullptr;
+
+// -------- HAPI transfer log --------
+// Only timing and payload size of each bulk transfer are logged, NOT the API name and arguments, so a log could be compared but NOT replayed
+// Replay is NOT supported: HAPI calls go straight through FHoudiniApi, there is no session layer in this plugin to serve them from a log
+struct FHoudiniPCGTransferLogEntry
+{
+	uint64 StartCycles = 0;  // Since logging started
+	uint64 Cycles = 0;
+	int64 NumBytes = 0;
+	EHoudiniPCGCookStage Stage = EHoudiniPCGCookStage::Num;  // Num means out of any stage, e.g., prefetch on workers
+	bool bInput = false;
+};
+
+static std::atomic<bool> GHoudiniPCGIsLoggingTransfers = false;
+static uint64 GHoudiniPCGTransferLogStartCycles = 0;
+static FCriticalSection GHoudiniPCGTransferLogLock;
+static TArray<FHoudiniPCGTransferLogEntry> GHoudiniPCGTransferLog;
+
+FHoudiniPCGCookStatsScope::FHoudiniPCGCookStatsScope(const bool& bInInput) : bInput(bInInput)
+{
+	FHoudiniPCGDirectionStats& Stats = GHoudiniPCGDirectionStats[bInput];
+	if (Stats.CookDepth++ >= 1)  // Nested in a cook already begun
+		return;
+
+	++Stats.NumCooks;
+	Stats.NumHapiCalls = 0;
+	Stats.HapiCycles = 0;
+	Stats.MaxHapiCycles = 0;
+	Stats.NumBytes = 0;
+	Stats.NumAttribs = 0;
+	Stats.PeakTransientBytes = int64(Stats.TransientBytes);
+	for (int32 StageIdx = 0; StageIdx < int32(EHoudiniPCGCookStage::Num); ++StageIdx)
+	{
+		if (IsInputStage(StageIdx) == bInput)
+		{
+			GHoudiniPCGStageCycles[StageIdx] = 0;
+			GHoudiniPCGStageElems[StageIdx] = 0;
+		}
+	}
+
+	if (bInput)
+	{
+		TRACE_COUNTER_SET(HoudiniPCGInputPoints, 0);
+		TRACE_COUNTER_SET(HoudiniPCGInputAttributes, 0);
+		TRACE_COUNTER_SET(HoudiniPCGInputBytes, 0);
+		TRACE_COUNTER_SET(HoudiniPCGInputHapiCalls, 0);
+	}
+	else
+	{
+		TRACE_COUNTER_SET(HoudiniPCGOutputPoints, 0);
+		TRACE_COUNTER_SET(HoudiniPCGOutputAttributes, 0);
+		TRACE_COUNTER_SET(HoudiniPCGOutputBytes, 0);
+		TRACE_COUNTER_SET(HoudiniPCGOutputHapiCalls, 0);
+	}
+}
+
+FHoudiniPCGCookStatsScope::~FHoudiniPCGCookStatsScope()
+{
+	--GHoudiniPCGDirectionStats[bInput].CookDepth;
+}
+
+void FHoudiniPCGCookStats::AddStage(const EHoudiniPCGCookStage& Stage, const uint64& Cycles, const int64& NumElems)
+{
+	GHoudiniPCGStageCycles[int32(Stage)] += Cycles;
+	GHoudiniPCGStageElems[int32(Stage)] += NumElems;
+
+	if (Stage == EHoudiniPCGCookStage::InputPoints)
+		TRACE_COUNTER_ADD(HoudiniPCGInputPoints, NumElems);
+	else if (Stage == EHoudiniPCGCookStage::OutputPoints)
+		TRACE_COUNTER_ADD(HoudiniPCGOutputPoints, NumElems);
+}
+
+void FHoudiniPCGCookStats::AddHapiCall(const bool& bInput, const uint64& Cycles, const int64& NumBytes)
+{
+	FHoudiniPCGDirectionStats& Stats = GHoudiniPCGDirectionStats[bInput];
+	++Stats.NumHapiCalls;
+	Stats.HapiCycles += Cycles;
+	Stats.NumBytes += NumBytes;
+	uint64 MaxCycles = Stats.MaxHapiCycles;
+	while ((MaxCycles < Cycles) && !Stats.MaxHapiCycles.compare_exchange_weak(MaxCycles, Cycles)) {}
+
+	if (GHoudiniPCGIsLoggingTransfers)
+	{
+		FHoudiniPCGTransferLogEntry Entry;
+		Entry.StartCycles = FPlatformTime::Cycles64() - Cycles - GHoudiniPCGTransferLogStartCycles;
+		Entry.Cycles = Cycles;
+		Entry.NumBytes = NumBytes;
+		Entry.Stage = GHoudiniPCGCurrentStageScope ? GHoudiniPCGCurrentStageScope->GetStage() : EHoudiniPCGCookStage::Num;
+		Entry.bInput = bInput;
+
+		FScopeLock ScopeLock(&GHoudiniPCGTransferLogLock);
+		GHoudiniPCGTransferLog.Add(Entry);
+	}
+
+	if (bInput)
+	{
+		TRACE_COUNTER_INCREMENT(HoudiniPCGInputHapiCalls);
+		TRACE_COUNTER_ADD(HoudiniPCGInputBytes, NumBytes);
+	}
+	else
+	{
+		TRACE_COUNTER_INCREMENT(HoudiniPCGOutputHapiCalls);
+		TRACE_COUNTER_ADD(HoudiniPCGOutputBytes, NumBytes);
+	}
+}
+
+void FHoudiniPCGCookStats::AddAttributes(const bool& bInput, const int32& NumAttribs)
+{
+	GHoudiniPCGDirectionStats[bInput].NumAttribs += NumAttribs;
+
+	if (bInput)
+		TRACE_COUNTER_ADD(HoudiniPCGInputAttributes, NumAttribs);
+	else
+		TRACE_COUNTER_ADD(HoudiniPCGOutputAttributes, NumAttribs);
+}
+
+void FHoudiniPCGCookStats::AddTransientBytes(const bool& bInput, const int64& NumBytes)
+{
+	FHoudiniPCGDirectionStats& Stats = GHoudiniPCGDirectionStats[bInput];
+	const int64 TransientBytes = (Stats.TransientBytes += NumBytes);
+	int64 PeakBytes = Stats.PeakTransientBytes;
+	while ((PeakBytes < TransientBytes) && !Stats.PeakTransientBytes.compare_exchange_weak(PeakBytes, TransientBytes)) {}
+
+	if (bInput)
+		TRACE_COUNTER_SET(HoudiniPCGInputTransientBytes, TransientBytes);
+	else
+		TRACE_COUNTER_SET(HoudiniPCGOutputTransientBytes, TransientBytes);
+}
+
+void FHoudiniPCGCookStats::Dump(FOutputDevice& Ar)
+{
+	for (const bool bInput : { true, false })
+	{
+		const FHoudiniPCGDirectionStats& Stats = GHoudiniPCGDirectionStats[bInput];
+		if (Stats.NumCooks == 0)
+		{
+			Ar.Logf(TEXT("HoudiniPCG %s: No cook yet"), bInput ? TEXT("Input") : TEXT("Output"));
+			continue;
+		}
+
+		const int64 NumHapiCalls = Stats.NumHapiCalls;
+		const double HapiMs = FPlatformTime::ToMilliseconds64(Stats.HapiCycles);
+		Ar.Logf(TEXT("HoudiniPCG %s (cook %llu): %lld attribs, %lld HAPI calls, %.2f ms in HAPI (avg %.3f ms, max %.3f ms), %.2f MB transferred, %.2f MB peak transient"),
+			bInput ? TEXT("Input") : TEXT("Output"), uint64(Stats.NumCooks), int64(Stats.NumAttribs), NumHapiCalls, HapiMs,
+			(NumHapiCalls >= 1) ? (HapiMs / NumHapiCalls) : 0.0, FPlatformTime::ToMilliseconds64(Stats.MaxHapiCycles), Stats.NumBytes / (1024.0 * 1024.0),
+			Stats.PeakTransientBytes / (1024.0 * 1024.0));
+
+		double TotalMs = 0.0;
+		for (int32 StageIdx = 0; StageIdx < int32(EHoudiniPCGCookStage::Num); ++StageIdx)
+		{
+			if (IsInputStage(StageIdx) != bInput)
+				continue;
+
+			const double StageMs = FPlatformTime::ToMilliseconds64(GHoudiniPCGStageCycles[StageIdx]);
+			const int64 NumElems = GHoudiniPCGStageElems[StageIdx];
+			TotalMs += StageMs;
+			Ar.Logf(TEXT("    %-16s %10.2f ms %12lld elems %14.0f elems/s"), GHoudiniPCGCookStageNames[StageIdx], StageMs, NumElems,
+				(StageMs > 0.0) ? (NumElems * 1000.0 / StageMs) : 0.0);
+		}
+		Ar.Logf(TEXT("    %-16s %10.2f ms"), TEXT("Total"), TotalMs);
+	}
+}
+
+static FAutoConsoleCommandWithOutputDevice GHoudiniPCGDumpCookStatsCmd(
+	TEXT("HoudiniPCG.DumpCookStats"),
+	TEXT("Dump the stage breakdown, HAPI calls and transferred bytes of the last PCG input upload and output retrieval"),
+	FConsoleCommandWithOutputDeviceDelegate::CreateStatic(&FHoudiniPCGCookStats::Dump));
+
+
+static FORCEINLINE const TCHAR* GetCookStageName(const EHoudiniPCGCookStage& Stage)
+{
+	return (Stage == EHoudiniPCGCookStage::Num) ? TEXT("Other") : GHoudiniPCGCookStageNames[int32(Stage)];
+}
+
+static void HoudiniPCGTransferLog(const TArray<FString>& Args, FOutputDevice& Ar)
+{
+	if (Args.IsValidIndex(0) && (Args[0] == TEXT("Start")))
+	{
+		{
+			FScopeLock ScopeLock(&GHoudiniPCGTransferLogLock);
+			GHoudiniPCGTransferLog.Empty();
+		}
+		GHoudiniPCGTransferLogStartCycles = FPlatformTime::Cycles64();
+		GHoudiniPCGIsLoggingTransfers = true;
+		Ar.Logf(TEXT("HoudiniPCG.TransferLog: Logging"));
+		return;
+	}
+	else if (!Args.IsValidIndex(0) || (Args[0] != TEXT("Stop")))
+	{
+		Ar.Logf(ELogVerbosity::Warning, TEXT("Usage: HoudiniPCG.TransferLog Start | Stop [<File>.csv]"));
+		return;
+	}
+
+	GHoudiniPCGIsLoggingTransfers = false;
+	TArray<FHoudiniPCGTransferLogEntry> Entries;
+	{
+		FScopeLock ScopeLock(&GHoudiniPCGTransferLogLock);
+		Entries = MoveTemp(GHoudiniPCGTransferLog);
+	}
+
+	const FString FilePath = Args.IsValidIndex(1) ? Args[1] :
+		(FPaths::ProjectSavedDir() / TEXT("HoudiniPCG") / FString::Printf(TEXT("TransferLog_%s.csv"), *FDateTime::Now().ToString()));
+	FString Content = TEXT("Seq,Direction,Stage,StartMs,Ms,Bytes\n");
+	for (int32 EntryIdx = 0; EntryIdx < Entries.Num(); ++EntryIdx)
+	{
+		const FHoudiniPCGTransferLogEntry& Entry = Entries[EntryIdx];
+		Content += FString::Printf(TEXT("%d,%s,%s,%.4f,%.4f,%lld\n"), EntryIdx, Entry.bInput ? TEXT("Input") : TEXT("Output"), GetCookStageName(Entry.Stage),
+			FPlatformTime::ToMilliseconds64(Entry.StartCycles), FPlatformTime::ToMilliseconds64(Entry.Cycles), Entry.NumBytes);
+	}
+
+	IFileManager::Get().MakeDirectory(*FPaths::GetPath(FilePath), true);
+	if (FFileHelper::SaveStringToFile(Content, *FilePath))
+		Ar.Logf(TEXT("HoudiniPCG.TransferLog: %d HAPI transfers saved to %s"), Entries.Num(), *FilePath);
+	else
+		Ar.Logf(ELogVerbosity::Error, TEXT("HoudiniPCG.TransferLog: Failed to save %s"), *FilePath);
+}
+
+static FAutoConsoleCommandWithArgsAndOutputDevice GHoudiniPCGTransferLogCmd(
+	TEXT("HoudiniPCG.TransferLog"),
+	TEXT("\"Start\" logging bulk HAPI transfers of PCG input and output, \"Stop [<File>.csv]\" to save stage, latency and payload size of each transfer (NOT replayable)"),
+	FConsoleCommandWithArgsAndOutputDeviceDelegate::CreateStatic(&HoudiniPCGTransferLog));
+
+static bool LoadTransferLogSummary(const FString& FilePath, TMap<FString, TPair<int64, int64>>& OutSummary)  // { Direction/Stage, { NumCalls, NumBytes } }
+{
+	TArray<FString> Lines;
+	if (!FFileHelper::LoadFileToStringArray(Lines, *FilePath))
+		return false;
+
+	for (int32 LineIdx = 1; LineIdx < Lines.Num(); ++LineIdx)  // Skip header
+	{
+		TArray<FString> Values;
+		if (Lines[LineIdx].ParseIntoArray(Values, TEXT(","), false) < 6)
+			continue;
+
+		TPair<int64, int64>& Summary = OutSummary.FindOrAdd(Values[1] + TEXT("/") + Values[2], TPair<int64, int64>(0, 0));
+		++Summary.Key;
+		Summary.Value += FCString::Atoi64(*Values[5]);
+	}
+	return true;
+}
+
+static void HoudiniPCGTransferLogCompare(const TArray<FString>& Args, FOutputDevice& Ar)
+{
+	if (Args.Num() < 2)
+	{
+		Ar.Logf(ELogVerbosity::Warning, TEXT("Usage: HoudiniPCG.TransferLogCompare <Baseline>.csv <Current>.csv"));
+		return;
+	}
+
+	TMap<FString, TPair<int64, int64>> BaselineSummary;
+	TMap<FString, TPair<int64, int64>> CurrentSummary;
+	for (int32 FileIdx = 0; FileIdx < 2; ++FileIdx)
+	{
+		if (!LoadTransferLogSummary(Args[FileIdx], FileIdx ? CurrentSummary : BaselineSummary))
+		{
+			Ar.Logf(ELogVerbosity::Error, TEXT("HoudiniPCG.TransferLogCompare: Failed to load %s"), *Args[FileIdx]);
+			return;
+		}
+	}
+
+	TArray<FString> Keys;
+	BaselineSummary.GetKeys(Keys);
+	for (const TPair<FString, TPair<int64, int64>>& Current : CurrentSummary)
+		Keys.AddUnique(Current.Key);
+	Keys.Sort();
+
+	int32 NumRegressions = 0;
+	for (const FString& Key : Keys)
+	{
+		const TPair<int64, int64> Baseline = BaselineSummary.FindRef(Key);
+		const TPair<int64, int64> Current = CurrentSummary.FindRef(Key);
+		const bool bRegressed = (Current.Key > Baseline.Key);
+		if (bRegressed)
+			++NumRegressions;
+		Ar.Logf(bRegressed ? ELogVerbosity::Warning : ELogVerbosity::Log, TEXT("    %-24s %8lld -> %8lld calls %14lld -> %14lld bytes"),
+			*Key, Baseline.Key, Current.Key, Baseline.Value, Current.Value);
+	}
+	Ar.Logf(TEXT("HoudiniPCG.TransferLogCompare: %d stages with more HAPI transfers than baseline"), NumRegressions);
+}
+
+static FAutoConsoleCommandWithArgsAndOutputDevice GHoudiniPCGTransferLogCompareCmd(
+	TEXT("HoudiniPCG.TransferLogCompare"),
+	TEXT("Compare HAPI transfer counts and payload bytes per stage of two files saved by HoudiniPCG.TransferLog"),
+	FConsoleCommandWithArgsAndOutputDeviceDelegate::CreateStatic(&HoudiniPCGTransferLogCompare));
+
+FHoudiniPCGStageScope::FHoudiniPCGStageScope(const EHoudiniPCGCookStage& InStage, const int64& InNumElems) :
+	Stage(InStage), StartCycles(FPlatformTime::Cycles64()), NumElems(InNumElems), Parent(GHoudiniPCGCurrentStageScope)
+{
+	GHoudiniPCGCurrentStageScope = this;
+}
+
+FHoudiniPCGStageScope::~FHoudiniPCGStageScope()
+{
+	const uint64 Cycles = FPlatformTime::Cycles64() - StartCycles;
+	FHoudiniPCGCookStats::AddStage(Stage, Cycles - FMath::Min(ChildCycles, Cycles), NumElems);
+	if (Parent)
+		Parent->ChildCycles += Cycles;
+	GHoudiniPCGCurrentStageScope = Parent;
+}
@@ -0,0 +1,291 @@
+// Copyright Yuzhe Pan (childadrianpan@gmail.com). All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/LowLevelMemTracker.h"
+
+#include "HoudiniApi.h"
+
+#include "Metadata/PCGMetadataAttributeTpl.h"
+
+#include <string>
+
+
+class FHoudiniPCGDataAssetOutputBuilder;
+class FHoudiniPCGAttributeFilter;
+struct FPCGDataCollection;
+#if ((ENGINE_MAJOR_VERSION == 5) && (ENGINE_MINOR_VERSION >= 5)) || (ENGINE_MAJOR_VERSION > 5)
+namespace UE::Geometry { class FDynamicMesh3; }
+#endif
+
+#define HOUDINI_PCG_PARALLEL_BATCH_SIZE  16384  // Elements less than this count will be converted on the calling thread
+
+struct FHoudiniPCGTransformData  // Views of houdini point attributes that make up the instance transforms, empty data means the attribute not exists
+{
+	TConstArrayView<float> PositionData;
+	int32 PositionStride = 0;
+	TConstArrayView<float> OrientData;
+	int32 OrientStride = 0;
+	TConstArrayView<float> NormalData;
+	int32 NormalStride = 0;
+	TConstArrayView<float> UpData;
+	int32 UpStride = 0;
+	TConstArrayView<float> RotData;
+	int32 RotStride = 0;
+	TConstArrayView<float> PScaleData;
+	int32 PScaleStride = 0;
+	TConstArrayView<float> ScaleData;
+	int32 ScaleStride = 0;
+};
+
+struct FHoudiniPCGUtils
+{
+	// Split [0, NumElems) into batches and run BatchFunc(StartIdx, EndIdx) on task graph workers, BatchFunc MUST only write to its own range
+	static void ParallelForBatch(const int32& NumElems, TFunctionRef<void(const int32& StartIdx, const int32& EndIdx)> BatchFunc);
+
+	// -------- Pure conversions, need NOT a session, so that could also be measured by "HoudiniPCG.Benchmark" --------
+	// OutPosData and OutScaleData are NumPoints * 3, OutRotData is NumPoints * 4
+	static void ConvertTransformsToHoudini(const int32& NumPoints, TFunctionRef<const FTransform&(const int32&)> GetTransformFunc,
+		float* OutPosData, float* OutRotData, float* OutScaleData);
+
+	// p@orient, or v@N and v@up, then p@rot, f@pscale and v@scale, PositionData MUST NOT be empty
+	static void ConvertTransformsToUnreal(const int32& NumPoints, const FHoudiniPCGTransformData& Data, TFunctionRef<FTransform&(const int32&)> GetTransformFunc);
+
+	// Values of points PointIndices, or [0, NumPoints) if empty, ConvertFunc appends the houdini tuple of a value
+	template<typename ValueType, typename HapiValueType>
+	static void GatherAttribValues(const FPCGMetadataAttribute<ValueType>* Attrib, const int32& NumPoints, const TArray<int32>& PointIndices,
+		TFunctionRef<void(const ValueType&, TArray<HapiValueType>&)> ConvertFunc, TArray<HapiValueType>& OutValues);
+
+	// Same as GatherAttribValues, but each unique value is converted only once, OutStrValues point to OutUniqueStrs
+	template<typename StrValueType>
+	static void GatherStringAttribValues(const FPCGMetadataAttribute<StrValueType>* Attrib, const int32& NumPoints, const TArray<int32>& PointIndices,
+		TFunctionRef<FString(const StrValueType&)> ConvertFunc, TArray<std::string>& OutUniqueStrs, TArray<const char*>& OutStrValues);
+
+	// Control points in world space to @P, v@unreal_spline_point_arrive/leave_tangent, and p@rot, v@scale only if Rots and Scales are NOT empty
+	static void ConvertSplineToHoudini(const FTransform& Transform, TConstArrayView<FInterpCurvePointVector> Points,
+		TConstArrayView<FInterpCurvePointQuat> Rots, TConstArrayView<FInterpCurvePointVector> Scales,
+		TArray<float>& OutPosData, TArray<float>& OutArriveTangentData, TArray<float>& OutLeaveTangentData, TArray<float>& OutRotData, TArray<float>& OutScaleData);
+
+#if ((ENGINE_MAJOR_VERSION == 5) && (ENGINE_MINOR_VERSION >= 5)) || (ENGINE_MAJOR_VERSION > 5)
+	// Vertices to @P, triangles to the vertex list with houdini winding, every face has 3 vertices
+	static void ConvertDynamicMeshToHoudini(const UE::Geometry::FDynamicMesh3& DM, TArray<float>& OutPosData, TArray<int32>& OutVertices);
+#endif
+
+	// -------- HDAs cooked without AHoudiniNode, by "HoudiniPCGBatchCook" commandlet and "Houdini Cook" PCG element --------
+	// Session is passed explicitly rather than read from HoudiniEngine, as the commandlet drives several sessions at once
+
+	// Same as FHoudiniEngineUtils::HapiConvertStringHandles, but on Session, converted by a single batched call
+	static bool HapiConvertStringHandles(const HAPI_Session* Session, const TConstArrayView<HAPI_StringHandle>& SHs, TArray<std::string>& OutStrs);
+
+	static bool HapiConvertStringHandles(const HAPI_Session* Session, const TConstArrayView<HAPI_StringHandle>& SHs, TArray<FString>& OutStrs);
+
+	// Loaded once per session and file timestamp, later calls only validate the cached library id, game thread only
+	static bool HapiLoadAssetLibrary(const HAPI_Session* Session, const FString& HdaPath, TArray<FString>& OutAssetNames);
+
+	// OutRootNodeId is the obj created for a sop asset, or the obj asset itself, delete it to clean up all
+	static bool HapiInstantiateAsset(const HAPI_Session* Session, const FString& AssetName, const FString& NodeLabel, int32& OutNodeId, int32& OutRootNodeId);
+
+	// Datas are uploaded under a new geo obj and merged, then connected to InputIdx of the asset,
+	// OutInputGeoNodeId is set before uploading, so MUST be deleted with the asset even if failed
+	static bool HapiConnectInputDatas(const HAPI_Session* Session, const int32& NodeId, const int32& RootNodeId, const int32& InputIdx, const FPCGDataCollection& Data,
+		const bool& bImportRotAndScale, const FHoudiniPCGAttributeFilter& AttribFilter, int32& OutInputGeoNodeId);
+
+	static bool HapiGetCookCount(const HAPI_Session* Session, const int32& NodeId, int32& OutCookCount);  // Before CookNode, then pass to HapiGetNodeCookState
+
+	// Never wait, bOutFinished once the session has nothing to cook, as other HAPI calls will block until the cooking thread finished.
+	// bOutSucceeded only if the node cooked after PrevCookCount without errors, as the cook state of the session may come from other nodes
+	static bool HapiGetNodeCookState(const HAPI_Session* Session, const int32& NodeId, const int32& PrevCookCount, bool& bOutFinished, bool& bOutSucceeded);
+
+	// The output geo of a sop asset, or the display geo of an obj asset, and parts accepted by OutputBuilder, whose session MUST be the same
+	static bool HapiGetOutputParts(const HAPI_Session* Session, const int32& NodeId, FHoudiniPCGDataAssetOutputBuilder& OutputBuilder,
+		HAPI_GeoInfo& OutGeoInfo, TArray<HAPI_PartInfo>& OutPartInfos);
+};
+
+template<typename ValueType, typename HapiValueType>
+void FHoudiniPCGUtils::GatherAttribValues(const FPCGMetadataAttribute<ValueType>* Attrib, const int32& NumPoints, const TArray<int32>& PointIndices,
+	TFunctionRef<void(const ValueType&, TArray<HapiValueType>&)> ConvertFunc, TArray<HapiValueType>& OutValues)
+{
+#if ((ENGINE_MAJOR_VERSION == 5) && (ENGINE_MINOR_VERSION >= 5)) || (ENGINE_MAJOR_VERSION > 5)
+	TArray<const PCGMetadataEntryKey> EntryKeys;
+#else
+	TArray<PCGMetadataEntryKey> EntryKeys;
+#endif
+	if (!PointIndices.IsEmpty())  // Decimated preview, point indices are the entry keys
+		EntryKeys.Append(PointIndices);
+	else
+	{
+		EntryKeys.Reserve(NumPoints);
+		for (PCGMetadataEntryKey EntryKey = 0; EntryKey < NumPoints; ++EntryKey)
+			EntryKeys.Add(EntryKey);
+	}
+	TArray<PCGMetadataValueKey> ValueKeys;
+	Attrib->GetValueKeys(EntryKeys, ValueKeys);
+
+	TArray<HapiValueType> DefaultValues;
+	ConvertFunc(Attrib->GetValue(PCGDefaultValueKey), DefaultValues);
+	OutValues.Reset(ValueKeys.Num() * DefaultValues.Num());
+	for (const PCGMetadataValueKey& ValueKey : ValueKeys)
+	{
+		if (ValueKey < 0)
+			OutValues.Append(DefaultValues);
+		else
+			ConvertFunc(Attrib->GetValue(ValueKey), OutValues);
+	}
+}
+
+template<typename StrValueType>
+void FHoudiniPCGUtils::GatherStringAttribValues(const FPCGMetadataAttribute<StrValueType>* Attrib, const int32& NumPoints, const TArray<int32>& PointIndices,
+	TFunctionRef<FString(const StrValueType&)> ConvertFunc, TArray<std::string>& OutUniqueStrs, TArray<const char*>& OutStrValues)
+{
+#if ((ENGINE_MAJOR_VERSION == 5) && (ENGINE_MINOR_VERSION >= 5)) || (ENGINE_MAJOR_VERSION > 5)
+	TArray<const PCGMetadataEntryKey> EntryKeys;
+#else
+	TArray<PCGMetadataEntryKey> EntryKeys;
+#endif
+	if (!PointIndices.IsEmpty())  // Decimated preview, point indices are the entry keys
+		EntryKeys.Append(PointIndices);
+	else
+	{
+		EntryKeys.Reserve(NumPoints);
+		for (PCGMetadataEntryKey EntryKey = 0; EntryKey < NumPoints; ++EntryKey)
+			EntryKeys.Add(EntryKey);
+	}
+	TArray<PCGMetadataValueKey> ValueKeys;
+	Attrib->GetValueKeys(EntryKeys, ValueKeys);
+
+	TArray<PCGMetadataValueKey> UniqueKeys = TSet<PCGMetadataValueKey>(ValueKeys).Array();
+	const bool bHasDefaultValue = (UniqueKeys.RemoveAll([](const PCGMetadataValueKey& Key) { return (Key < 0); }) >= 1);
+	TMap<PCGMetadataValueKey, int32> KeyStrIdxMap;
+	OutUniqueStrs.Reset(UniqueKeys.Num() + 1);
+	if (!UniqueKeys.IsEmpty())
+	{
+		TArray<StrValueType> UniqueValues;
+		UniqueValues.SetNum(UniqueKeys.Num());
+#if ((ENGINE_MAJOR_VERSION == 5) && (ENGINE_MINOR_VERSION >= 5)) || (ENGINE_MAJOR_VERSION > 5)
+		Attrib->GetValues(UniqueKeys, UniqueValues);
+#else
+		for (int32 UniqueIdx = 0; UniqueIdx < UniqueKeys.Num(); ++UniqueIdx)
+			UniqueValues[UniqueIdx] = Attrib->GetValue(UniqueKeys[UniqueIdx]);
+#endif
+		for (int32 UniqueIdx = 0; UniqueIdx < UniqueKeys.Num(); ++UniqueIdx)
+		{
+			KeyStrIdxMap.Add(UniqueKeys[UniqueIdx], OutUniqueStrs.Num());
+			OutUniqueStrs.Add(std::string(TCHAR_TO_UTF8(*ConvertFunc(UniqueValues[UniqueIdx]))));
+		}
+	}
+
+	const int32 DefaultStrIdx = OutUniqueStrs.Num();
+	if (bHasDefaultValue)
+		OutUniqueStrs.Add(std::string(TCHAR_TO_UTF8(*ConvertFunc(Attrib->GetValue(PCGDefaultValueKey)))));
+
+	OutStrValues.SetNumUninitialized(ValueKeys.Num());  // After all unique strings added, as short strings are stored inline
+	for (int32 ValueIdx = 0; ValueIdx < ValueKeys.Num(); ++ValueIdx)
+		OutStrValues[ValueIdx] = OutUniqueStrs[(ValueKeys[ValueIdx] < 0) ? DefaultStrIdx : KeyStrIdxMap[ValueKeys[ValueIdx]]].c_str();
+}
+
+
+// LLM tags, shown under HoudiniPCG when run with -llm
+LLM_DECLARE_TAG(HoudiniPCG);
+LLM_DECLARE_TAG(HoudiniPCG_InputStaging);  // Buffers of PCG datas to upload
+LLM_DECLARE_TAG(HoudiniPCG_MetadataConversion);  // PCG attribute values converted to/from houdini
+LLM_DECLARE_TAG(HoudiniPCG_OutputScratch);  // Raw houdini data retrieved, and FHoudiniPCGOutputScratch
+LLM_DECLARE_TAG(HoudiniPCG_PCGData);  // PCG data objects, points and metadata created by output
+LLM_DECLARE_TAG(HoudiniPCG_Cache);  // Part schemas, prefetched data and string cache kept during a cook
+
+
+enum class EHoudiniPCGCookStage : uint8
+{
+	InputPoints = 0,  // Gather and upload point datas
+	InputSplines,
+	InputMeshes,
+	InputAttributes,  // PCG attributes as unreal_pcg_attribute_*
+	InputCommit,  // CommitGeo
+
+	OutputSchema,  // Attribute names and infos
+	OutputPoints,
+	OutputSplines,
+	OutputMeshes,
+	OutputAttributes,  // unreal_pcg_attribute_* as PCG attributes
+	OutputCrc,
+	OutputNotify,  // PostEditChange after referenced static meshes compiled
+	OutputPrefetchWait,  // Game thread waiting for the worker retrieving the next part
+
+	Num
+};
+
+struct FHoudiniPCGCookStats  // Breakdown of the last input upload and output retrieval, also traced as counters, could be dumped by console command "HoudiniPCG.DumpCookStats"
+{
+	static void AddStage(const EHoudiniPCGCookStage& Stage, const uint64& Cycles, const int64& NumElems);  // Exclusive cycles, NOT include nested stages
+
+	static void AddHapiCall(const bool& bInput, const uint64& Cycles, const int64& NumBytes);
+
+	static void AddAttributes(const bool& bInput, const int32& NumAttribs);
+
+	static void AddTransientBytes(const bool& bInput, const int64& NumBytes);  // Negative to release, peak of each cook will be recorded
+
+	static void Dump(FOutputDevice& Ar);
+};
+
+class FHoudiniPCGCookStatsScope  // Re-entrant, stats of this direction are reset when the outermost scope entered, so enter it around all uploads or retrievals of one cook to accumulate them together
+{
+protected:
+	const bool bInput;
+
+public:
+	FHoudiniPCGCookStatsScope(const bool& bInInput);
+
+	~FHoudiniPCGCookStatsScope();
+};
+
+class FHoudiniPCGStageScope  // Accumulate time of a stage to FHoudiniPCGCookStats, time of nested stages will be excluded
+{
+protected:
+	const EHoudiniPCGCookStage Stage;
+	const uint64 StartCycles;
+	uint64 ChildCycles = 0;
+	int64 NumElems = 0;
+	FHoudiniPCGStageScope* Parent = nullptr;
+
+public:
+	FHoudiniPCGStageScope(const EHoudiniPCGCookStage& InStage, const int64& InNumElems);
+
+	~FHoudiniPCGStageScope();
+
+	FORCEINLINE void AddElems(const int64& Num) { NumElems += Num; }
+
+	FORCEINLINE const EHoudiniPCGCookStage& GetStage() const { return Stage; }
+};
+
+class FHoudiniPCGHapiCallScope  // Count a bulk HAPI transfer, and its round trip latency, also logged with the current stage by "HoudiniPCG.TransferLog"
+{
+protected:
+	const bool bInput;
+	const int64 NumBytes;
+	const uint64 StartCycles;
+
+public:
+	FHoudiniPCGHapiCallScope(const bool& bInInput, const int64& InNumBytes) : bInput(bInInput), NumBytes(InNumBytes), StartCycles(FPlatformTime::Cycles64()) {}
+
+	~FHoudiniPCGHapiCallScope() { FHoudiniPCGCookStats::AddHapiCall(bInput, FPlatformTime::Cycles64() - StartCycles, NumBytes); }
+};
+
+class FHoudiniPCGTransientBytesScope  // Count buffers alive in this scope to the peak transient memory of the cook
+{
+protected:
+	const bool bInput;
+	const int64 NumBytes;
+
+public:
+	FHoudiniPCGTransientBytesScope(const bool& bInInput, const int64& InNumBytes) : bInput(bInInput), NumBytes(InNumBytes) { FHoudiniPCGCookStats::AddTransientBytes(bInput, NumBytes); }
+
+	~FHoudiniPCGTransientBytesScope() { FHoudiniPCGCookStats::AddTransientBytes(bInput, -NumBytes); }
+};
+
+// Nested insights event named HoudiniPCG_<Stage>, and the stage time
+#define HOUDINI_PCG_STAGE_SCOPE(Stage, NumElems) \
+	TRACE_CPUPROFILER_EVENT_SCOPE(HoudiniPCG_##Stage); \
+	FHoudiniPCGStageScope HoudiniPCGStageScope(EHoudiniPCGCookStage::Stage, NumElems)
+
+#define HOUDINI_PCG_HAPI_CALL_SCOPE(bInput, NumBytes) \
+	FHoudiniPCGHapiCallScope PREPROCESSOR_JOIN(HoudiniPCGHapiCallScope, __LINE__)(bInput, NumBytes)
@@ -6,19 +6,70 @@
 
 
 struct FPCGDataCollection;
+class UPCGComponent;
+class UHoudiniInputPCGDataAsset;
+
+// Houdini style attribute pattern, e.g., "height* seed ^_*", later patterns override earlier ones, "^" to exclude, empty means all.
+// Native point properties are only filtered by patterns starting with "$", e.g., "^$Color", so "height*" still uploads them, transforms are always uploaded
+class HOUDINIPCGTRANSLATOR_API FHoudiniPCGAttributeFilter
+{
+protected:
+	TArray<TPair<FString, bool>> Patterns;  // { Wildcard, bInclude }
+
+	bool MatchesPatterns(const FString& Name, const bool& bProperty) const;
+
+public:
+	FHoudiniPCGAttributeFilter() {}
+
+	FHoudiniPCGAttributeFilter(const FString& PatternStr);
+
+	static FHoudiniPCGAttributeFilter GetDefault();  // "HoudiniPCG.InputAttributeFilter"
+
+	FORCEINLINE bool IsEmpty() const { return Patterns.IsEmpty(); }
+
+	bool Matches(const FString& Name) const;
+
+	bool MatchesProperty(const FString& Name) const;  // Name is "$Density" or "$Color", only "$" patterns are considered, so uploaded if none
+};
 
 class FHoudiniPCGComponentInput : public FHoudiniComponentInput
 {
 public:
 	TArray<int32> NodeIds;
 
+	TWeakObjectPtr<UHoudiniInput> OwnerInput;  // To find decimated inputs of a node
+	TArray<TWeakObjectPtr<const UPCGComponent>> Components;  // Uploaded by the last upload, will be notified to upload again
+	bool bDecimated = false;  // Points were decimated by the last upload
+
 	virtual void Invalidate() const override {}  // Will then delete this, so we need NOT empty NodeIds
 
 	virtual bool HapiDestroy(UHoudiniInput* Input) const override;  // Will then delete this, so we need NOT empty NodeIds
 
 	// TODO: should use my shared memory input API like other input translators in my houdini engine, to import data faster
+	// Attributes NOT match AttribFilter will be skipped before any conversion, empty AttribFilter will use "HoudiniPCG.InputAttributeFilter"
 	HOUDINIPCGTRANSLATOR_API static bool HapiRetrieveData(UHoudiniInput* Input, const UObject* InputObject,
-		const FPCGDataCollection& Data, TArray<int32>& InOutNodeIds, int32& InOutDataIdx);
+		const FPCGDataCollection& Data, TArray<int32>& InOutNodeIds, int32& InOutDataIdx, const FHoudiniPCGAttributeFilter& AttribFilter = FHoudiniPCGAttributeFilter());
+
+	// Same as HapiRetrieveData, but without a UHoudiniInput, new nodes are created under ParentNodeId then passed to ConnectFunc, InputObject could be nullptr.
+	// bDecimatePreview uploads only a stable subset of points by "HoudiniPCG.InputPreviewRatio" and "HoudiniPCG.InputPreviewGridSize",
+	// HapiRetrieveData decimates by ShouldDecimatePreview. Uploads to InSession, or the session of HoudiniEngine if nullptr
+	HOUDINIPCGTRANSLATOR_API static bool HapiUploadData(const int32& ParentNodeId, const bool& bInImportRotAndScale, TFunctionRef<bool(const int32&)> ConnectFunc,
+		const UObject* InputObject, const FPCGDataCollection& Data, TArray<int32>& InOutNodeIds, int32& InOutDataIdx,
+		const FHoudiniPCGAttributeFilter& AttribFilter = FHoudiniPCGAttributeFilter(), const bool& bDecimatePreview = false, const HAPI_Session* InSession = nullptr);
+
+	HOUDINIPCGTRANSLATOR_API static bool IsPreviewDecimationEnabled();  // Whether inputs uploaded while previewing are decimated
+
+	HOUDINIPCGTRANSLATOR_API static bool ShouldDecimatePreview();  // "HoudiniPCG.PreviewOutput" = 1 and IsPreviewDecimationEnabled
+
+	// -------- Inputs record whether they were decimated at each upload, and will be marked changed when preview or decimation console variables change --------
+	static void RecordUpload(const TSharedPtr<FHoudiniPCGComponentInput>& CompInput);
+
+	static void RecordUpload(UHoudiniInputPCGDataAsset* Holder);
+
+	HOUDINIPCGTRANSLATOR_API static bool HasDecimatedInputs(const UObject* Node = nullptr);  // Inputs of this node, nullptr means all inputs
+
+	// Mark inputs changed whose last upload does NOT match ShouldDecimatePreview, and all decimated inputs if bDecimationChanged, Node nullptr means all inputs
+	HOUDINIPCGTRANSLATOR_API static void MarkInputsChanged(const bool& bDecimationChanged, const UObject* Node = nullptr);
 };
 
 class FHoudiniPCGComponentInputBuilder : public IHoudiniComponentInputBuilder
@@ -20,9 +20,15 @@ protected:
 
 	TArray<int32> NodeIds;
 
+	bool bDecimated = false;  // Points were decimated by the last upload
+
 public:
 	void SetAsset(UPCGDataAsset* NewPCGDataAsset);  // Used by IHoudiniContentInputBuilder::CreateOrUpdateHolder, must have a method name called "SetAsset"
 
+	FORCEINLINE bool IsDecimated() const { return bDecimated; }
+
+	FORCEINLINE void RequestReupload() { RequestReimport(); }  // Used by FHoudiniPCGComponentInput::MarkInputsChanged
+
 	virtual TSoftObjectPtr<UObject> GetObject() const override;
 
 	virtual bool IsObjectExists() const override;
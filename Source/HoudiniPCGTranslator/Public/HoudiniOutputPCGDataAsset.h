@@ -4,11 +4,62 @@
 
 #include "HoudiniOutput.h"
 
+#include "Containers/Ticker.h"
+#include "UObject/GCObject.h"
 
-class FHoudiniPCGDataAssetOutputBuilder : public IHoudiniOutputBuilder
+
+class UPCGDataAsset;
+struct FPCGDataCollection;
+class FHoudiniPCGPartSchema;
+
+class FHoudiniPCGDataAssetOutputBuilder : public IHoudiniOutputBuilder, public FGCObject
 {
+protected:
+	TMap<TWeakObjectPtr<UPCGDataAsset>, TSet<FSoftObjectPath>> PendingNotifyAssets;  // Will PostEditChange after the referenced static meshes compiled
+	FTSTicker::FDelegateHandle NotifyTickerHandle;
+
+	TMap<TPair<int32, int32>, TSharedPtr<FHoudiniPCGPartSchema>> PartSchemas;  // { NodeId, PartId }, built by HapiIsPartValid and consumed by HapiRetrieve
+
+	FString DefaultCookFolderPath;  // Used when HapiRetrieve without a node, e.g., by HoudiniPCGBatchCook commandlet
+
+	const HAPI_Session* Session = nullptr;  // nullptr means the session of HoudiniEngine
+
+	TMap<FString, TObjectPtr<UPCGDataAsset>> PreviewPCGDAs;  // "HoudiniPCG.PreviewOutput" = 1, object path -> transient asset, until baked
+	bool bPreviewsDecimated = false;  // Some previews were cooked from decimated inputs, so they must NOT be baked
+
+	bool TickNotify(float DeltaTime);
+
+	// Assets will be found or created in TransientPCGDAs rather than packages if specified, OutObjectPaths are the static meshes referenced
+	bool HapiRetrievePCGDatas(const int32& NodeId, const FString& DefaultObjectPathPrefix, const TArray<HAPI_PartInfo>& PartInfos,
+		TMap<FString, TObjectPtr<UPCGDataAsset>>* TransientPCGDAs, TArray<UPCGDataAsset*>& OutPCGDAs, TArray<FSoftObjectPath>& OutObjectPaths);
+
 public:
+	virtual ~FHoudiniPCGDataAssetOutputBuilder();
+
 	virtual bool HapiIsPartValid(const int32& NodeId, const HAPI_PartInfo& PartInfo, bool& bOutIsValid, bool& bOutShouldHoldByOutput) override;
 
 	virtual bool HapiRetrieve(AHoudiniNode* Node, const FString& OutputName, const HAPI_GeoInfo& GeoInfo, const TArray<HAPI_PartInfo>& PartInfos) override;
+
+	FORCEINLINE void SetDefaultCookFolderPath(const FString& InCookFolderPath) { DefaultCookFolderPath = InCookFolderPath; }  // MUST end with "/"
+
+	// Retrieve from InSession rather than the session of HoudiniEngine, e.g., by HoudiniPCGBatchCook commandlet, MUST outlive the next HapiRetrieve
+	FORCEINLINE void SetSession(const HAPI_Session* InSession) { Session = InSession; }
+
+	const HAPI_Session* GetSession() const;
+
+	// Parts as in-memory PCG datas in transient package, nothing will be saved or notified, used by the "Houdini Cook" PCG element
+	bool HapiRetrieveTransient(const HAPI_GeoInfo& GeoInfo, const TArray<HAPI_PartInfo>& PartInfos, FPCGDataCollection& OutData);
+
+	FORCEINLINE void FlushNotify() { TickNotify(0.0f); }  // PostEditChange assets whose referenced static meshes compiled, without waiting for the next tick
+
+	// -------- Preview output, HDAs write to transient assets rather than packages, so that tweaking parms never create or dirty packages --------
+	static bool IsPreviewEnabled();  // "HoudiniPCG.PreviewOutput"
+
+	UPCGDataAsset* FindPreview(const FSoftObjectPath& AssetPath) const;  // Used by PCGDataAsset input and "Houdini Load Output" PCG element before loading the asset
+
+	bool BakePreviews();  // Write all previews to their assets, then clear them, by "HoudiniPCG.BakePreviewOutputs", return false if previews are decimated
+
+	virtual void AddReferencedObjects(FReferenceCollector& Collector) override { Collector.AddReferencedObjects(PreviewPCGDAs); }
+
+	virtual FString GetReferencerName() const override { return TEXT("FHoudiniPCGDataAssetOutputBuilder"); }
 };
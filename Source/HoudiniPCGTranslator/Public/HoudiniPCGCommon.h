@@ -6,3 +6,23 @@
 #define HAPI_ATTRIB_DENSITY                          "density"
 #define HAPI_ATTRIB_UNREAL_PCG_TAGS                  "unreal_pcg_tags"  // Could be either s[]@unreal_pcg_tags or s@unreal_pcg_tags
 #define HAPI_ATTRIB_PREFIX_UNREAL_PCG_ATTRIBUTE      "unreal_pcg_attribute_"
+#define HAPI_ATTRIB_UNREAL_PCG_DATA_SPLIT            "unreal_pcg_data_split"  // s@unreal_pcg_data_split on points, split a point cloud into multiple datas
+#define HAPI_ATTRIB_UNREAL_PCG_COMPACT               "unreal_pcg_compact"  // i@unreal_pcg_compact = 1 on detail, output as UHoudiniPCGCompactDataAsset
+
+// World partition tiled output, both on detail
+#define HAPI_ATTRIB_UNREAL_PCG_PARTITION_GRID_SIZE   "unreal_pcg_partition_grid_size"  // f@unreal_pcg_partition_grid_size > 0, tile points and splines by 2D grid cells
+#define HAPI_ATTRIB_UNREAL_PCG_PARTITION_CELL_ASSETS "unreal_pcg_partition_cell_assets"  // i@unreal_pcg_partition_cell_assets = 1, each cell as a separate asset, and the part asset becomes the cell index
+
+// Instance attributes, used to build point transforms directly rather than evaluate HAPI_Transform in houdini
+#define HAPI_ATTRIB_ORIENT                           "orient"
+#define HAPI_ATTRIB_PSCALE                           "pscale"
+#define HAPI_ATTRIB_UP                               "up"
+#define HAPI_ATTRIB_VELOCITY                         "v"
+#define HAPI_ATTRIB_TRANS                            "trans"
+#define HAPI_ATTRIB_PIVOT                            "pivot"
+#define HAPI_ATTRIB_TRANSFORM                        "transform"
+
+// Dynamic mesh output, may also be defined by houdini engine
+#ifndef HAPI_ATTRIB_UNREAL_MATERIAL
+#define HAPI_ATTRIB_UNREAL_MATERIAL                  "unreal_material"
+#endif
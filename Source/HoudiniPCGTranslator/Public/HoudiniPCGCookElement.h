@@ -0,0 +1,55 @@
+// Copyright Yuzhe Pan (childadrianpan@gmail.com). All Rights Reserved.
+
+#pragma once
+
+#include "PCGSettings.h"
+
+#include "HoudiniPCGCookElement.generated.h"
+
+
+// Cook an HDA inside a PCG graph, datas on the input pin are uploaded to the first input of the HDA, and the output geo is retrieved as in-memory PCG datas,
+// the same as what would be output to PCGDataAssets, but nothing will be saved or notified
+UCLASS(BlueprintType, ClassGroup = (Procedural))
+class UHoudiniPCGCookSettings : public UPCGSettings
+{
+	GENERATED_BODY()
+
+public:
+#if WITH_EDITOR
+	virtual FName GetDefaultNodeName() const override { return FName(TEXT("HoudiniCook")); }
+	virtual FText GetDefaultNodeTitle() const override;
+	virtual FText GetNodeTooltipText() const override;
+	virtual EPCGSettingsType GetType() const override { return EPCGSettingsType::Spatial; }
+#endif
+
+protected:
+	virtual TArray<FPCGPinProperties> InputPinProperties() const override;
+	virtual TArray<FPCGPinProperties> OutputPinProperties() const override;
+	virtual FPCGElementPtr CreateElement() const override;
+
+public:
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Settings, meta = (FilePathFilter = "Houdini Digital Asset (*.hda;*.hdalc;*.hdanc;*.otl)|*.hda;*.hdalc;*.hdanc;*.otl"))
+	FFilePath HdaPath;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Settings, meta = (PCG_Overridable))
+	FString AssetName;  // e.g., "Sop/foo::1.0", empty means the first definition in the HDA
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Settings, meta = (PCG_Overridable))
+	bool bImportRotAndScale = true;  // Of spline points
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Settings, meta = (PCG_Overridable))
+	FString InputAttributeFilter;  // e.g., "height* seed ^_*", "^$Density ^$Color" to skip native point properties, empty will use "HoudiniPCG.InputAttributeFilter"
+};
+
+class FHoudiniPCGCookElement : public IPCGElement
+{
+public:
+	virtual bool CanExecuteOnlyOnMainThread(FPCGContext* Context) const override { return true; }  // The session is shared with HoudiniEngine, which drives it on game thread
+
+	virtual bool IsCacheable(const UPCGSettings* InSettings) const override { return false; }  // Outputs also depend on the HDA file and the session, NOT only on settings and inputs
+
+protected:
+	virtual FPCGContext* CreateContext() override;
+
+	virtual bool ExecuteInternal(FPCGContext* Context) const override;  // Return false while houdini is cooking on its own thread, so that never block the graph
+};
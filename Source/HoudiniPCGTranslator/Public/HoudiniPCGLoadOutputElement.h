@@ -0,0 +1,45 @@
+// Copyright Yuzhe Pan (childadrianpan@gmail.com). All Rights Reserved.
+
+#pragma once
+
+#include "PCGSettings.h"
+
+#include "HoudiniPCGLoadOutputElement.generated.h"
+
+
+class UPCGDataAsset;
+
+// Load datas of a PCGDataAsset output by HDAs, or its transient preview when "HoudiniPCG.PreviewOutput" = 1, so that graphs could iterate without saving assets
+UCLASS(BlueprintType, ClassGroup = (Procedural))
+class UHoudiniPCGLoadOutputSettings : public UPCGSettings
+{
+	GENERATED_BODY()
+
+public:
+#if WITH_EDITOR
+	virtual FName GetDefaultNodeName() const override { return FName(TEXT("HoudiniLoadOutput")); }
+	virtual FText GetDefaultNodeTitle() const override;
+	virtual FText GetNodeTooltipText() const override;
+	virtual EPCGSettingsType GetType() const override { return EPCGSettingsType::InputOutput; }
+#endif
+
+protected:
+	virtual TArray<FPCGPinProperties> InputPinProperties() const override { return TArray<FPCGPinProperties>(); }
+	virtual TArray<FPCGPinProperties> OutputPinProperties() const override;
+	virtual FPCGElementPtr CreateElement() const override;
+
+public:
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Settings, meta = (PCG_Overridable))
+	TSoftObjectPtr<UPCGDataAsset> PCGDataAsset;
+};
+
+class FHoudiniPCGLoadOutputElement : public IPCGElement
+{
+public:
+	virtual bool CanExecuteOnlyOnMainThread(FPCGContext* Context) const override { return true; }  // May load the asset
+
+	virtual bool IsCacheable(const UPCGSettings* InSettings) const override { return false; }  // Previews change without changing settings
+
+protected:
+	virtual bool ExecuteInternal(FPCGContext* Context) const override;
+};
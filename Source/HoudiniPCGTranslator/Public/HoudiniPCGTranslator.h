@@ -21,4 +21,8 @@ public:
 	/** IModuleInterface implementation */
 	virtual void StartupModule() override;
 	virtual void ShutdownModule() override;
+
+	FORCEINLINE static FHoudiniPCGTranslator& Get() { return FModuleManager::GetModuleChecked<FHoudiniPCGTranslator>("HoudiniPCGTranslator"); }
+
+	FORCEINLINE const TSharedPtr<FHoudiniPCGDataAssetOutputBuilder>& GetOutputBuilder() const { return OutputBuilder; }  // Owns preview outputs
 };
@@ -0,0 +1,753 @@
+// Copyright Yuzhe Pan (childadrianpan@gmail.com). All Rights Reserved.
+
+#include "HoudiniPCGCompactDataAsset.h"
+
+#include "Async/ParallelFor.h"
+#include "Math/Float16.h"
+#include "Misc/Compression.h"
+#include "Serialization/CustomVersion.h"
+#include "UObject/ObjectSaveContext.h"
+
+#if ((ENGINE_MAJOR_VERSION == 5) && (ENGINE_MINOR_VERSION >= 6)) || (ENGINE_MAJOR_VERSION > 5)
+#include "Data/PCGBasePointData.h"
+#else
+#include "Data/PCGPointData.h"
+#endif
+
+
+DEFINE_LOG_CATEGORY_STATIC(LogHoudiniPCGCompact, Log, All);
+
+struct FHoudiniPCGCompactCustomVersion  // Layout of CompactPoints, bump when columns or their encodings change
+{
+	enum Type
+	{
+		BeforeCustomVersionWasAdded = 0,  // An int32 format version was saved per data, always 1
+		CustomVersionAdded,
+
+		// -----<new versions can be added above this line>-----
+		VersionPlusOne,
+		LatestVersion = VersionPlusOne - 1
+	};
+
+	static const FGuid GUID;
+};
+
+const FGuid FHoudiniPCGCompactCustomVersion::GUID(0xFAD11470, 0x33FC4939, 0x96B05EF0, 0x286DE749);
+
+static FCustomVersionRegistration GRegisterHoudiniPCGCompactCustomVersion(FHoudiniPCGCompactCustomVersion::GUID,
+	FHoudiniPCGCompactCustomVersion::LatestVersion, TEXT("HoudiniPCGCompactVer"));
+
+enum class EHoudiniPCGCompactColumn : int32
+{
+	Position = 0,  // Quantized by PositionPrecision, delta to the previous point, zigzag varint
+	Rotation,  // Smallest three, 20 bits per component, uint64
+	Scale,  // FVector3f
+	Density,  // FFloat16
+	Color,  // FFloat16 x4
+	BoundsMin,  // FVector3f
+	BoundsMax,  // FVector3f
+	Steepness,  // FFloat16
+	Seed,  // Delta to the previous point, zigzag varint
+	MetadataEntry,  // Delta to the previous point, zigzag varint
+
+	Num
+};
+
+#define HOUDINI_PCG_COMPACT_QUAT_BITS  20
+
+FArchive& operator<<(FArchive& Ar, FHoudiniPCGCompactColumn& Column)
+{
+	Ar << Column.UncompressedSize;
+	Ar << Column.bCompressed;
+	Column.Bytes.BulkSerialize(Ar);
+	return Ar;
+}
+
+FArchive& operator<<(FArchive& Ar, FHoudiniPCGCompactPoints& CompactPoints)
+{
+	if (Ar.IsLoading() && (Ar.CustomVer(FHoudiniPCGCompactCustomVersion::GUID) < FHoudiniPCGCompactCustomVersion::CustomVersionAdded))
+	{
+		int32 LegacyFormatVersion = 1;
+		Ar << LegacyFormatVersion;
+	}
+	Ar << CompactPoints.DataIdx;
+	Ar << CompactPoints.NumPoints;
+	Ar << CompactPoints.PositionPrecision;
+	Ar << CompactPoints.Columns;
+	return Ar;
+}
+
+#if ((ENGINE_MAJOR_VERSION == 5) && (ENGINE_MINOR_VERSION >= 6)) || (ENGINE_MAJOR_VERSION > 5)
+typedef UPCGBasePointData FHoudiniPCGCompactPointData;
+#else
+typedef UPCGPointData FHoudiniPCGCompactPointData;
+#endif
+
+struct FHoudiniPCGConstPointColumns  // Read point properties in the same way across engine versions
+{
+#if ((ENGINE_MAJOR_VERSION == 5) && (ENGINE_MINOR_VERSION >= 6)) || (ENGINE_MAJOR_VERSION > 5)
+	FHoudiniPCGConstPointColumns(const UPCGBasePointData* PointData) :
+		Transforms(PointData->GetConstTransformValueRange()), Densities(PointData->GetConstDensityValueRange()), Colors(PointData->GetConstColorValueRange()),
+		BoundsMins(PointData->GetConstBoundsMinValueRange()), BoundsMaxs(PointData->GetConstBoundsMaxValueRange()),
+		Steepnesses(PointData->GetConstSteepnessValueRange()), Seeds(PointData->GetConstSeedValueRange()), Entries(PointData->GetConstMetadataEntryValueRange()) {}
+
+	TConstPCGValueRange<FTransform> Transforms;
+	TConstPCGValueRange<float> Densities;
+	TConstPCGValueRange<FVector4> Colors;
+	TConstPCGValueRange<FVector> BoundsMins;
+	TConstPCGValueRange<FVector> BoundsMaxs;
+	TConstPCGValueRange<float> Steepnesses;
+	TConstPCGValueRange<int32> Seeds;
+	TConstPCGValueRange<int64> Entries;
+
+	FORCEINLINE const FTransform& GetTransform(const int32& PointIdx) const { return Transforms[PointIdx]; }
+	FORCEINLINE float GetDensity(const int32& PointIdx) const { return Densities[PointIdx]; }
+	FORCEINLINE const FVector4& GetColor(const int32& PointIdx) const { return Colors[PointIdx]; }
+	FORCEINLINE const FVector& GetBoundsMin(const int32& PointIdx) const { return BoundsMins[PointIdx]; }
+	FORCEINLINE const FVector& GetBoundsMax(const int32& PointIdx) const { return BoundsMaxs[PointIdx]; }
+	FORCEINLINE float GetSteepness(const int32& PointIdx) const { return Steepnesses[PointIdx]; }
+	FORCEINLINE int32 GetSeed(const int32& PointIdx) const { return Seeds[PointIdx]; }
+	FORCEINLINE int64 GetMetadataEntry(const int32& PointIdx) const { return Entries[PointIdx]; }
+#else
+	FHoudiniPCGConstPointColumns(const UPCGPointData* PointData) : Points(PointData->GetPoints()) {}
+
+	const TArray<FPCGPoint>& Points;
+
+	FORCEINLINE const FTransform& GetTransform(const int32& PointIdx) const { return Points[PointIdx].Transform; }
+	FORCEINLINE float GetDensity(const int32& PointIdx) const { return Points[PointIdx].Density; }
+	FORCEINLINE const FVector4& GetColor(const int32& PointIdx) const { return Points[PointIdx].Color; }
+	FORCEINLINE const FVector& GetBoundsMin(const int32& PointIdx) const { return Points[PointIdx].BoundsMin; }
+	FORCEINLINE const FVector& GetBoundsMax(const int32& PointIdx) const { return Points[PointIdx].BoundsMax; }
+	FORCEINLINE float GetSteepness(const int32& PointIdx) const { return Points[PointIdx].Steepness; }
+	FORCEINLINE int32 GetSeed(const int32& PointIdx) const { return Points[PointIdx].Seed; }
+	FORCEINLINE int64 GetMetadataEntry(const int32& PointIdx) const { return Points[PointIdx].MetadataEntry; }
+#endif
+};
+
+struct FHoudiniPCGPointColumns  // Write point properties in the same way across engine versions, MUST be constructed on the calling thread, as ranges will be allocated
+{
+#if ((ENGINE_MAJOR_VERSION == 5) && (ENGINE_MINOR_VERSION >= 6)) || (ENGINE_MAJOR_VERSION > 5)
+	FHoudiniPCGPointColumns(UPCGBasePointData* PointData) :
+		Transforms(PointData->GetTransformValueRange()), Densities(PointData->GetDensityValueRange()), Colors(PointData->GetColorValueRange()),
+		BoundsMins(PointData->GetBoundsMinValueRange()), BoundsMaxs(PointData->GetBoundsMaxValueRange()),
+		Steepnesses(PointData->GetSteepnessValueRange()), Seeds(PointData->GetSeedValueRange()), Entries(PointData->GetMetadataEntryValueRange()) {}
+
+	TPCGValueRange<FTransform> Transforms;
+	TPCGValueRange<float> Densities;
+	TPCGValueRange<FVector4> Colors;
+	TPCGValueRange<FVector> BoundsMins;
+	TPCGValueRange<FVector> BoundsMaxs;
+	TPCGValueRange<float> Steepnesses;
+	TPCGValueRange<int32> Seeds;
+	TPCGValueRange<int64> Entries;
+
+	FORCEINLINE FTransform& GetTransform(const int32& PointIdx) { return Transforms[PointIdx]; }
+	FORCEINLINE float& GetDensity(const int32& PointIdx) { return Densities[PointIdx]; }
+	FORCEINLINE FVector4& GetColor(const int32& PointIdx) { return Colors[PointIdx]; }
+	FORCEINLINE FVector& GetBoundsMin(const int32& PointIdx) { return BoundsMins[PointIdx]; }
+	FORCEINLINE FVector& GetBoundsMax(const int32& PointIdx) { return BoundsMaxs[PointIdx]; }
+	FORCEINLINE float& GetSteepness(const int32& PointIdx) { return Steepnesses[PointIdx]; }
+	FORCEINLINE int32& GetSeed(const int32& PointIdx) { return Seeds[PointIdx]; }
+	FORCEINLINE int64& GetMetadataEntry(const int32& PointIdx) { return Entries[PointIdx]; }
+#else
+	FHoudiniPCGPointColumns(UPCGPointData* PointData) : Points(PointData->GetMutablePoints()) {}
+
+	TArray<FPCGPoint>& Points;
+
+	FORCEINLINE FTransform& GetTransform(const int32& PointIdx) { return Points[PointIdx].Transform; }
+	FORCEINLINE float& GetDensity(const int32& PointIdx) { return Points[PointIdx].Density; }
+	FORCEINLINE FVector4& GetColor(const int32& PointIdx) { return Points[PointIdx].Color; }
+	FORCEINLINE FVector& GetBoundsMin(const int32& PointIdx) { return Points[PointIdx].BoundsMin; }
+	FORCEINLINE FVector& GetBoundsMax(const int32& PointIdx) { return Points[PointIdx].BoundsMax; }
+	FORCEINLINE float& GetSteepness(const int32& PointIdx) { return Points[PointIdx].Steepness; }
+	FORCEINLINE int32& GetSeed(const int32& PointIdx) { return Points[PointIdx].Seed; }
+	FORCEINLINE int64& GetMetadataEntry(const int32& PointIdx) { return Points[PointIdx].MetadataEntry; }
+#endif
+};
+
+namespace HoudiniPCGCompactUtils
+{
+	FORCEINLINE static uint64 ZigZag(const int64& Value) { return (uint64(Value) << 1) ^ uint64(Value >> 63); }
+
+	FORCEINLINE static int64 UnZigZag(const uint64& Value) { return int64(Value >> 1) ^ -int64(Value & 1); }
+
+	FORCEINLINE static void WriteVarUInt(TArray<uint8>& Bytes, uint64 Value)
+	{
+		while (Value >= 0x80)
+		{
+			Bytes.Add(uint8(Value) | 0x80);
+			Value >>= 7;
+		}
+		Bytes.Add(uint8(Value));
+	}
+
+	FORCEINLINE static bool ReadVarUInt(const uint8*& Ptr, const uint8* End, uint64& OutValue)  // Fail if the bytes end before the value, or the value overflows
+	{
+		OutValue = 0;
+		for (int32 Shift = 0; Shift < 64; Shift += 7)
+		{
+			if (Ptr >= End)
+				return false;
+
+			const uint8 Byte = *Ptr++;
+			OutValue |= uint64(Byte & 0x7F) << Shift;
+			if (!(Byte & 0x80))
+				return true;
+		}
+		return false;
+	}
+
+	template<typename ValueType>
+	FORCEINLINE static void WriteRaw(TArray<uint8>& Bytes, const ValueType& Value) { Bytes.Append((const uint8*)&Value, sizeof(ValueType)); }
+
+	template<typename ValueType>
+	FORCEINLINE static ValueType ReadRaw(const uint8*& Ptr)
+	{
+		ValueType Value;
+		FMemory::Memcpy(&Value, Ptr, sizeof(ValueType));
+		Ptr += sizeof(ValueType);
+		return Value;
+	}
+
+	static uint64 PackQuat(const FQuat& Rotation)  // Drop the largest component, then quantize the others, which are in [-1/sqrt(2), 1/sqrt(2)]
+	{
+		const FQuat Quat = Rotation.GetNormalized();
+		const double Components[4] = { Quat.X, Quat.Y, Quat.Z, Quat.W };
+		int32 LargestIdx = 0;
+		for (int32 Idx = 1; Idx < 4; ++Idx)
+		{
+			if (FMath::Abs(Components[Idx]) > FMath::Abs(Components[LargestIdx]))
+				LargestIdx = Idx;
+		}
+		const double Sign = (Components[LargestIdx] < 0.0) ? -1.0 : 1.0;  // q and -q are the same rotation
+
+		constexpr double MaxQuantized = double((1 << HOUDINI_PCG_COMPACT_QUAT_BITS) - 1);
+		uint64 Packed = uint64(LargestIdx);
+		int32 Shift = 2;
+		for (int32 Idx = 0; Idx < 4; ++Idx)
+		{
+			if (Idx == LargestIdx)
+				continue;
+
+			const double Normalized = FMath::Clamp(Components[Idx] * Sign * UE_DOUBLE_HALF_SQRT_2 + 0.5, 0.0, 1.0);
+			Packed |= uint64(FMath::RoundToInt64(Normalized * MaxQuantized)) << Shift;
+			Shift += HOUDINI_PCG_COMPACT_QUAT_BITS;
+		}
+		return Packed;
+	}
+
+	static FQuat UnpackQuat(const uint64& Packed)
+	{
+		constexpr double MaxQuantized = double((1 << HOUDINI_PCG_COMPACT_QUAT_BITS) - 1);
+		constexpr uint64 Mask = (uint64(1) << HOUDINI_PCG_COMPACT_QUAT_BITS) - 1;
+		const int32 LargestIdx = int32(Packed & 3);
+		double Components[4];
+		double SquaredSum = 0.0;
+		int32 Shift = 2;
+		for (int32 Idx = 0; Idx < 4; ++Idx)
+		{
+			if (Idx == LargestIdx)
+				continue;
+
+			Components[Idx] = (double((Packed >> Shift) & Mask) / MaxQuantized - 0.5) * UE_DOUBLE_SQRT_2;
+			SquaredSum += Components[Idx] * Components[Idx];
+			Shift += HOUDINI_PCG_COMPACT_QUAT_BITS;
+		}
+		Components[LargestIdx] = FMath::Sqrt(FMath::Max(1.0 - SquaredSum, 0.0));
+		return FQuat(Components[0], Components[1], Components[2], Components[3]).GetNormalized();
+	}
+
+	static void EncodeColumn(const EHoudiniPCGCompactColumn& Column, const FHoudiniPCGConstPointColumns& Points, const int32& NumPoints,
+		const double& PositionPrecision, TArray<uint8>& OutBytes);
+
+	// Fail if the column size does NOT match NumPoints, then the points will be incomplete
+	static bool DecodeColumn(const EHoudiniPCGCompactColumn& Column, const TArray<uint8>& Bytes, const int32& NumPoints,
+		const double& PositionPrecision, FHoudiniPCGPointColumns& OutPoints);
+
+	static void Compress(TArray<uint8>&& Bytes, FHoudiniPCGCompactColumn& OutColumn);
+
+	static bool Decompress(const FHoudiniPCGCompactColumn& Column, TArray<uint8>& OutBytes);
+
+	static void StashFullPoints(const FHoudiniPCGConstPointColumns& Points, const int32& NumPoints, FHoudiniPCGFullPoints& OutFullPoints);
+
+	static void RestoreFullPoints(FHoudiniPCGFullPoints& FullPoints, FHoudiniPCGCompactPointData* PointData);
+}
+
+static void HoudiniPCGCompactUtils::EncodeColumn(const EHoudiniPCGCompactColumn& Column, const FHoudiniPCGConstPointColumns& Points, const int32& NumPoints,
+	const double& PositionPrecision, TArray<uint8>& OutBytes)
+{
+	switch (Column)
+	{
+	case EHoudiniPCGCompactColumn::Position:
+	{
+		OutBytes.Reserve(NumPoints * 6);  // Usually 1~3 bytes per axis
+		FInt64Vector PrevQuantized(0, 0, 0);
+		for (int32 PointIdx = 0; PointIdx < NumPoints; ++PointIdx)
+		{
+			const FVector Position = Points.GetTransform(PointIdx).GetLocation();
+			const FInt64Vector Quantized(FMath::RoundToInt64(Position.X / PositionPrecision),
+				FMath::RoundToInt64(Position.Y / PositionPrecision), FMath::RoundToInt64(Position.Z / PositionPrecision));
+			WriteVarUInt(OutBytes, ZigZag(Quantized.X - PrevQuantized.X));
+			WriteVarUInt(OutBytes, ZigZag(Quantized.Y - PrevQuantized.Y));
+			WriteVarUInt(OutBytes, ZigZag(Quantized.Z - PrevQuantized.Z));
+			PrevQuantized = Quantized;
+		}
+	}
+	break;
+	case EHoudiniPCGCompactColumn::Rotation:
+	{
+		OutBytes.Reserve(NumPoints * sizeof(uint64));
+		for (int32 PointIdx = 0; PointIdx < NumPoints; ++PointIdx)
+			WriteRaw(OutBytes, PackQuat(Points.GetTransform(PointIdx).GetRotation()));
+	}
+	break;
+	case EHoudiniPCGCompactColumn::Scale:
+	{
+		OutBytes.Reserve(NumPoints * sizeof(FVector3f));
+		for (int32 PointIdx = 0; PointIdx < NumPoints; ++PointIdx)
+			WriteRaw(OutBytes, FVector3f(Points.GetTransform(PointIdx).GetScale3D()));
+	}
+	break;
+	case EHoudiniPCGCompactColumn::Density:
+	{
+		OutBytes.Reserve(NumPoints * sizeof(FFloat16));
+		for (int32 PointIdx = 0; PointIdx < NumPoints; ++PointIdx)
+			WriteRaw(OutBytes, FFloat16(Points.GetDensity(PointIdx)));
+	}
+	break;
+	case EHoudiniPCGCompactColumn::Color:
+	{
+		OutBytes.Reserve(NumPoints * sizeof(FFloat16) * 4);
+		for (int32 PointIdx = 0; PointIdx < NumPoints; ++PointIdx)
+		{
+			const FVector4& Color = Points.GetColor(PointIdx);
+			WriteRaw(OutBytes, FFloat16(float(Color.X)));
+			WriteRaw(OutBytes, FFloat16(float(Color.Y)));
+			WriteRaw(OutBytes, FFloat16(float(Color.Z)));
+			WriteRaw(OutBytes, FFloat16(float(Color.W)));
+		}
+	}
+	break;
+	case EHoudiniPCGCompactColumn::BoundsMin:
+	{
+		OutBytes.Reserve(NumPoints * sizeof(FVector3f));
+		for (int32 PointIdx = 0; PointIdx < NumPoints; ++PointIdx)
+			WriteRaw(OutBytes, FVector3f(Points.GetBoundsMin(PointIdx)));
+	}
+	break;
+	case EHoudiniPCGCompactColumn::BoundsMax:
+	{
+		OutBytes.Reserve(NumPoints * sizeof(FVector3f));
+		for (int32 PointIdx = 0; PointIdx < NumPoints; ++PointIdx)
+			WriteRaw(OutBytes, FVector3f(Points.GetBoundsMax(PointIdx)));
+	}
+	break;
+	case EHoudiniPCGCompactColumn::Steepness:
+	{
+		OutBytes.Reserve(NumPoints * sizeof(FFloat16));
+		for (int32 PointIdx = 0; PointIdx < NumPoints; ++PointIdx)
+			WriteRaw(OutBytes, FFloat16(Points.GetSteepness(PointIdx)));
+	}
+	break;
+	case EHoudiniPCGCompactColumn::Seed:
+	{
+		int64 PrevSeed = 0;
+		for (int32 PointIdx = 0; PointIdx < NumPoints; ++PointIdx)
+		{
+			const int64 Seed = Points.GetSeed(PointIdx);
+			WriteVarUInt(OutBytes, ZigZag(Seed - PrevSeed));
+			PrevSeed = Seed;
+		}
+	}
+	break;
+	case EHoudiniPCGCompactColumn::MetadataEntry:
+	{
+		OutBytes.Reserve(NumPoints);  // Usually identity, so 1 byte per point
+		int64 PrevEntry = 0;
+		for (int32 PointIdx = 0; PointIdx < NumPoints; ++PointIdx)
+		{
+			const int64 Entry = Points.GetMetadataEntry(PointIdx);
+			WriteVarUInt(OutBytes, ZigZag(Entry - PrevEntry));
+			PrevEntry = Entry;
+		}
+	}
+	break;
+	default: break;
+	}
+}
+
+static bool HoudiniPCGCompactUtils::DecodeColumn(const EHoudiniPCGCompactColumn& Column, const TArray<uint8>& Bytes, const int32& NumPoints,
+	const double& PositionPrecision, FHoudiniPCGPointColumns& OutPoints)
+{
+	const uint8* Ptr = Bytes.GetData();
+	const uint8* End = Ptr + Bytes.Num();
+	auto IsFixedSizeLambda = [&](const int32& ValueSize) { return int64(Bytes.Num()) == int64(NumPoints) * ValueSize; };
+
+	switch (Column)
+	{
+	case EHoudiniPCGCompactColumn::Position:
+	{
+		FInt64Vector Quantized(0, 0, 0);
+		uint64 Delta[3];
+		for (int32 PointIdx = 0; PointIdx < NumPoints; ++PointIdx)
+		{
+			if (!ReadVarUInt(Ptr, End, Delta[0]) || !ReadVarUInt(Ptr, End, Delta[1]) || !ReadVarUInt(Ptr, End, Delta[2]))
+				return false;
+
+			Quantized.X += UnZigZag(Delta[0]);
+			Quantized.Y += UnZigZag(Delta[1]);
+			Quantized.Z += UnZigZag(Delta[2]);
+			OutPoints.GetTransform(PointIdx).SetLocation(FVector(Quantized.X * PositionPrecision, Quantized.Y * PositionPrecision, Quantized.Z * PositionPrecision));
+		}
+	}
+	break;
+	case EHoudiniPCGCompactColumn::Rotation:
+	{
+		if (!IsFixedSizeLambda(sizeof(uint64)))
+			return false;
+
+		for (int32 PointIdx = 0; PointIdx < NumPoints; ++PointIdx)
+			OutPoints.GetTransform(PointIdx).SetRotation(UnpackQuat(ReadRaw<uint64>(Ptr)));
+	}
+	break;
+	case EHoudiniPCGCompactColumn::Scale:
+	{
+		if (!IsFixedSizeLambda(sizeof(FVector3f)))
+			return false;
+
+		for (int32 PointIdx = 0; PointIdx < NumPoints; ++PointIdx)
+			OutPoints.GetTransform(PointIdx).SetScale3D(FVector(ReadRaw<FVector3f>(Ptr)));
+	}
+	break;
+	case EHoudiniPCGCompactColumn::Density:
+	{
+		if (!IsFixedSizeLambda(sizeof(FFloat16)))
+			return false;
+
+		for (int32 PointIdx = 0; PointIdx < NumPoints; ++PointIdx)
+			OutPoints.GetDensity(PointIdx) = ReadRaw<FFloat16>(Ptr).GetFloat();
+	}
+	break;
+	case EHoudiniPCGCompactColumn::Color:
+	{
+		if (!IsFixedSizeLambda(sizeof(FFloat16) * 4))
+			return false;
+
+		for (int32 PointIdx = 0; PointIdx < NumPoints; ++PointIdx)
+		{
+			FVector4& Color = OutPoints.GetColor(PointIdx);
+			Color.X = ReadRaw<FFloat16>(Ptr).GetFloat();
+			Color.Y = ReadRaw<FFloat16>(Ptr).GetFloat();
+			Color.Z = ReadRaw<FFloat16>(Ptr).GetFloat();
+			Color.W = ReadRaw<FFloat16>(Ptr).GetFloat();
+		}
+	}
+	break;
+	case EHoudiniPCGCompactColumn::BoundsMin:
+	{
+		if (!IsFixedSizeLambda(sizeof(FVector3f)))
+			return false;
+
+		for (int32 PointIdx = 0; PointIdx < NumPoints; ++PointIdx)
+			OutPoints.GetBoundsMin(PointIdx) = FVector(ReadRaw<FVector3f>(Ptr));
+	}
+	break;
+	case EHoudiniPCGCompactColumn::BoundsMax:
+	{
+		if (!IsFixedSizeLambda(sizeof(FVector3f)))
+			return false;
+
+		for (int32 PointIdx = 0; PointIdx < NumPoints; ++PointIdx)
+			OutPoints.GetBoundsMax(PointIdx) = FVector(ReadRaw<FVector3f>(Ptr));
+	}
+	break;
+	case EHoudiniPCGCompactColumn::Steepness:
+	{
+		if (!IsFixedSizeLambda(sizeof(FFloat16)))
+			return false;
+
+		for (int32 PointIdx = 0; PointIdx < NumPoints; ++PointIdx)
+			OutPoints.GetSteepness(PointIdx) = ReadRaw<FFloat16>(Ptr).GetFloat();
+	}
+	break;
+	case EHoudiniPCGCompactColumn::Seed:
+	{
+		int64 Seed = 0;
+		uint64 Delta = 0;
+		for (int32 PointIdx = 0; PointIdx < NumPoints; ++PointIdx)
+		{
+			if (!ReadVarUInt(Ptr, End, Delta))
+				return false;
+
+			Seed += UnZigZag(Delta);
+			OutPoints.GetSeed(PointIdx) = int32(Seed);
+		}
+	}
+	break;
+	case EHoudiniPCGCompactColumn::MetadataEntry:
+	{
+		int64 Entry = 0;
+		uint64 Delta = 0;
+		for (int32 PointIdx = 0; PointIdx < NumPoints; ++PointIdx)
+		{
+			if (!ReadVarUInt(Ptr, End, Delta))
+				return false;
+
+			Entry += UnZigZag(Delta);
+			OutPoints.GetMetadataEntry(PointIdx) = Entry;
+		}
+	}
+	break;
+	default: return false;
+	}
+
+	return Ptr == End;  // Varint columns also MUST be fully consumed
+}
+
+static void HoudiniPCGCompactUtils::Compress(TArray<uint8>&& Bytes, FHoudiniPCGCompactColumn& OutColumn)
+{
+	OutColumn.UncompressedSize = Bytes.Num();
+	OutColumn.bCompressed = false;
+	if (!Bytes.IsEmpty())
+	{
+		int32 CompressedSize = FCompression::CompressMemoryBound(NAME_Oodle, Bytes.Num());
+		OutColumn.Bytes.SetNumUninitialized(CompressedSize);
+		if (FCompression::CompressMemory(NAME_Oodle, OutColumn.Bytes.GetData(), CompressedSize, Bytes.GetData(), Bytes.Num()) &&
+			(CompressedSize < Bytes.Num()))
+		{
+			OutColumn.Bytes.SetNum(CompressedSize);
+			OutColumn.bCompressed = true;
+			return;
+		}
+	}
+
+	OutColumn.Bytes = MoveTemp(Bytes);  // Not compressible, such as random rotations
+}
+
+static bool HoudiniPCGCompactUtils::Decompress(const FHoudiniPCGCompactColumn& Column, TArray<uint8>& OutBytes)
+{
+	if (Column.UncompressedSize < 0)
+		return false;
+
+	if (!Column.bCompressed)
+	{
+		OutBytes = Column.Bytes;
+		return OutBytes.Num() == Column.UncompressedSize;
+	}
+
+	OutBytes.SetNumUninitialized(Column.UncompressedSize);
+	return FCompression::UncompressMemory(NAME_Oodle, OutBytes.GetData(), Column.UncompressedSize, Column.Bytes.GetData(), Column.Bytes.Num());
+}
+
+static void HoudiniPCGCompactUtils::StashFullPoints(const FHoudiniPCGConstPointColumns& Points, const int32& NumPoints, FHoudiniPCGFullPoints& OutFullPoints)
+{
+	OutFullPoints.Transforms.SetNumUninitialized(NumPoints);
+	OutFullPoints.Densities.SetNumUninitialized(NumPoints);
+	OutFullPoints.Colors.SetNumUninitialized(NumPoints);
+	OutFullPoints.BoundsMins.SetNumUninitialized(NumPoints);
+	OutFullPoints.BoundsMaxs.SetNumUninitialized(NumPoints);
+	OutFullPoints.Steepnesses.SetNumUninitialized(NumPoints);
+	OutFullPoints.Seeds.SetNumUninitialized(NumPoints);
+	OutFullPoints.Entries.SetNumUninitialized(NumPoints);
+	for (int32 PointIdx = 0; PointIdx < NumPoints; ++PointIdx)
+	{
+		OutFullPoints.Transforms[PointIdx] = Points.GetTransform(PointIdx);
+		OutFullPoints.Densities[PointIdx] = Points.GetDensity(PointIdx);
+		OutFullPoints.Colors[PointIdx] = Points.GetColor(PointIdx);
+		OutFullPoints.BoundsMins[PointIdx] = Points.GetBoundsMin(PointIdx);
+		OutFullPoints.BoundsMaxs[PointIdx] = Points.GetBoundsMax(PointIdx);
+		OutFullPoints.Steepnesses[PointIdx] = Points.GetSteepness(PointIdx);
+		OutFullPoints.Seeds[PointIdx] = Points.GetSeed(PointIdx);
+		OutFullPoints.Entries[PointIdx] = Points.GetMetadataEntry(PointIdx);
+	}
+}
+
+static void HoudiniPCGCompactUtils::RestoreFullPoints(FHoudiniPCGFullPoints& FullPoints, FHoudiniPCGCompactPointData* PointData)
+{
+	const int32 NumPoints = FullPoints.Transforms.Num();
+#if ((ENGINE_MAJOR_VERSION == 5) && (ENGINE_MINOR_VERSION >= 6)) || (ENGINE_MAJOR_VERSION > 5)
+	PointData->SetNumPoints(NumPoints);
+#else
+	PointData->GetMutablePoints().SetNum(NumPoints);
+#endif
+	FHoudiniPCGPointColumns Points(PointData);
+	for (int32 PointIdx = 0; PointIdx < NumPoints; ++PointIdx)
+	{
+		Points.GetTransform(PointIdx) = FullPoints.Transforms[PointIdx];
+		Points.GetDensity(PointIdx) = FullPoints.Densities[PointIdx];
+		Points.GetColor(PointIdx) = FullPoints.Colors[PointIdx];
+		Points.GetBoundsMin(PointIdx) = FullPoints.BoundsMins[PointIdx];
+		Points.GetBoundsMax(PointIdx) = FullPoints.BoundsMaxs[PointIdx];
+		Points.GetSteepness(PointIdx) = FullPoints.Steepnesses[PointIdx];
+		Points.GetSeed(PointIdx) = FullPoints.Seeds[PointIdx];
+		Points.GetMetadataEntry(PointIdx) = FullPoints.Entries[PointIdx];
+	}
+}
+
+using namespace HoudiniPCGCompactUtils;
+
+
+void UHoudiniPCGCompactDataAsset::Serialize(FArchive& Ar)
+{
+	Super::Serialize(Ar);
+
+	Ar.UsingCustomVersion(FHoudiniPCGCompactCustomVersion::GUID);
+	if (Ar.IsPersistent() && !Ar.IsTransacting())  // Only for packages, duplication and undo keep the full points
+		Ar << CompactPoints;
+}
+
+void UHoudiniPCGCompactDataAsset::PrebuildPointOctree(const UPCGData* Data)
+{
+	if (const FHoudiniPCGCompactPointData* PointData = Cast<FHoudiniPCGCompactPointData>(Data))
+	{
+#if ((ENGINE_MAJOR_VERSION == 5) && (ENGINE_MINOR_VERSION >= 6)) || (ENGINE_MAJOR_VERSION > 5)
+		PointData->GetPointOctree();
+#else
+		PointData->GetOctree();
+#endif
+		PointData->GetBounds();
+	}
+}
+
+void UHoudiniPCGCompactDataAsset::PostLoad()
+{
+	Super::PostLoad();
+
+	DecodeCompactPoints();
+}
+
+#if WITH_EDITOR
+void UHoudiniPCGCompactDataAsset::PreSave(FObjectPreSaveContext ObjectSaveContext)
+{
+	Super::PreSave(ObjectSaveContext);
+
+	if (!CompactPoints.IsEmpty())  // Already encoded, PreSave may be called multiple times before PostSaveRoot
+		return;
+
+	for (int32 DataIdx = 0; DataIdx < Data.TaggedData.Num(); ++DataIdx)
+	{
+		FHoudiniPCGCompactPointData* PointData = Cast<FHoudiniPCGCompactPointData>(const_cast<UPCGData*>(Data.TaggedData[DataIdx].Data.Get()));
+		if (!PointData)
+			continue;
+
+		FHoudiniPCGCompactPoints& NewCompactPoints = CompactPoints.AddDefaulted_GetRef();
+		NewCompactPoints.DataIdx = DataIdx;
+#if ((ENGINE_MAJOR_VERSION == 5) && (ENGINE_MINOR_VERSION >= 6)) || (ENGINE_MAJOR_VERSION > 5)
+		NewCompactPoints.NumPoints = PointData->GetNumPoints();
+#else
+		NewCompactPoints.NumPoints = PointData->GetPoints().Num();
+#endif
+		NewCompactPoints.PositionPrecision = FMath::Max(PositionPrecision, UE_DOUBLE_KINDA_SMALL_NUMBER);
+		NewCompactPoints.Columns.SetNum(int32(EHoudiniPCGCompactColumn::Num));
+
+		const FHoudiniPCGConstPointColumns Points(PointData);
+		ParallelFor(int32(EHoudiniPCGCompactColumn::Num), [&](int32 ColumnIdx)
+			{
+				TArray<uint8> Bytes;
+				EncodeColumn(EHoudiniPCGCompactColumn(ColumnIdx), Points, NewCompactPoints.NumPoints, NewCompactPoints.PositionPrecision, Bytes);
+				Compress(MoveTemp(Bytes), NewCompactPoints.Columns[ColumnIdx]);
+			});
+		StashFullPoints(Points, NewCompactPoints.NumPoints, FullPoints.AddDefaulted_GetRef());
+		FullPoints.Last().DataIdx = DataIdx;
+
+		// Points will be saved by CompactPoints, metadata is still saved by the point data itself
+#if ((ENGINE_MAJOR_VERSION == 5) && (ENGINE_MINOR_VERSION >= 6)) || (ENGINE_MAJOR_VERSION > 5)
+		PointData->SetNumPoints(0);
+#else
+		PointData->GetMutablePoints().Empty();
+#endif
+	}
+}
+
+void UHoudiniPCGCompactDataAsset::PostSaveRoot(FObjectPostSaveRootContext ObjectSaveContext)
+{
+	Super::PostSaveRoot(ObjectSaveContext);
+
+	if (FullPoints.IsEmpty())  // Should NOT happen, but the decoded points are still better than none
+	{
+		DecodeCompactPoints();
+		return;
+	}
+
+	// Restore the full precision points, rather than decode the saved ones, so that saving again will NOT quantize them twice, and crcs still match
+	for (FHoudiniPCGFullPoints& StashedPoints : FullPoints)
+	{
+		FHoudiniPCGCompactPointData* PointData = Data.TaggedData.IsValidIndex(StashedPoints.DataIdx) ?
+			Cast<FHoudiniPCGCompactPointData>(const_cast<UPCGData*>(Data.TaggedData[StashedPoints.DataIdx].Data.Get())) : nullptr;
+		if (PointData)
+			RestoreFullPoints(StashedPoints, PointData);
+	}
+	FullPoints.Empty();
+	CompactPoints.Empty();
+
+	if (bPrebuildOctree)
+		ParallelFor(Data.TaggedData.Num(), [this](int32 DataIdx) { PrebuildPointOctree(Data.TaggedData[DataIdx].Data); });
+}
+#endif
+
+void UHoudiniPCGCompactDataAsset::DecodeCompactPoints()
+{
+	TArray<int32> DecodedDataIndices;
+	for (const FHoudiniPCGCompactPoints& CompactPoint : CompactPoints)
+	{
+		if (!Data.TaggedData.IsValidIndex(CompactPoint.DataIdx) || (CompactPoint.NumPoints < 0) || (CompactPoint.Columns.Num() != int32(EHoudiniPCGCompactColumn::Num)))
+			continue;
+
+		FHoudiniPCGCompactPointData* PointData = Cast<FHoudiniPCGCompactPointData>(const_cast<UPCGData*>(Data.TaggedData[CompactPoint.DataIdx].Data.Get()));
+		if (!PointData)
+			continue;
+
+		PointData->ConditionalPostLoad();  // Subobjects may NOT be post loaded yet, their PostLoad MUST NOT run after, or overwrite, the decoded points
+
+		TArray<TArray<uint8>> ColumnBytes;
+		ColumnBytes.SetNum(CompactPoint.Columns.Num());
+		bool bSucceed = true;
+		for (int32 ColumnIdx = 0; ColumnIdx < CompactPoint.Columns.Num(); ++ColumnIdx)
+			bSucceed &= Decompress(CompactPoint.Columns[ColumnIdx], ColumnBytes[ColumnIdx]);
+		if (!bSucceed)
+		{
+			UE_LOG(LogHoudiniPCGCompact, Warning, TEXT("%s: Failed to decompress points of data %d"), *GetPathName(), CompactPoint.DataIdx);
+			continue;
+		}
+
+#if ((ENGINE_MAJOR_VERSION == 5) && (ENGINE_MINOR_VERSION >= 6)) || (ENGINE_MAJOR_VERSION > 5)
+		PointData->SetNumPoints(CompactPoint.NumPoints);
+#else
+		PointData->GetMutablePoints().SetNum(CompactPoint.NumPoints);
+#endif
+		TArray<bool> ColumnsSucceeded;
+		ColumnsSucceeded.SetNumZeroed(ColumnBytes.Num());
+		{
+			FHoudiniPCGPointColumns Points(PointData);  // Allocate all ranges before parallel decoding
+			ParallelFor(ColumnBytes.Num(), [&](int32 ColumnIdx)  // Each column writes its own property only
+				{
+					ColumnsSucceeded[ColumnIdx] = DecodeColumn(EHoudiniPCGCompactColumn(ColumnIdx), ColumnBytes[ColumnIdx], CompactPoint.NumPoints, CompactPoint.PositionPrecision, Points);
+				});
+		}
+		if (ColumnsSucceeded.Contains(false))  // Corrupted columns, so points are incomplete, better to output none
+		{
+			UE_LOG(LogHoudiniPCGCompact, Warning, TEXT("%s: Corrupted point columns of data %d"), *GetPathName(), CompactPoint.DataIdx);
+#if ((ENGINE_MAJOR_VERSION == 5) && (ENGINE_MINOR_VERSION >= 6)) || (ENGINE_MAJOR_VERSION > 5)
+			PointData->SetNumPoints(0);
+#else
+			PointData->GetMutablePoints().Empty();
+#endif
+		}
+		DecodedDataIndices.Add(CompactPoint.DataIdx);  // Content changed either way
+	}
+
+	CompactPoints.Empty();  // Decoded points are in point datas now
+
+	// Crcs were computed from the full precision points when output, so recompute them from the decoded content, otherwise the PCG graph cache will be hit by a different data
+	if (Data.DataCrcs.Num() == Data.TaggedData.Num())
+	{
+		ParallelFor(DecodedDataIndices.Num(), [&](int32 Idx)
+			{
+				const int32& DataIdx = DecodedDataIndices[Idx];
+				Data.DataCrcs[DataIdx] = Data.TaggedData[DataIdx].ComputeCrc(true);
+			});
+	}
+
+	if (bPrebuildOctree)
+		ParallelFor(Data.TaggedData.Num(), [this](int32 DataIdx) { PrebuildPointOctree(Data.TaggedData[DataIdx].Data); });
+}
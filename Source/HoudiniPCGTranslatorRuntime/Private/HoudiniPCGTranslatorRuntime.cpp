@@ -0,0 +1,7 @@
+// Copyright Yuzhe Pan (childadrianpan@gmail.com). All Rights Reserved.
+
+#include "Modules/ModuleManager.h"
+
+
+// Runtime decoders of assets output by HoudiniPCGTranslator, so that cooked games could load them without houdini engine
+IMPLEMENT_MODULE(FDefaultModuleImpl, HoudiniPCGTranslatorRuntime)
@@ -0,0 +1,75 @@
+// Copyright Yuzhe Pan (childadrianpan@gmail.com). All Rights Reserved.
+
+#pragma once
+
+#include "PCGDataAsset.h"
+
+#include "HoudiniPCGCompactDataAsset.generated.h"
+
+
+struct FHoudiniPCGCompactColumn  // A single point property of all points, compressed separately so that could be decoded in parallel
+{
+	int32 UncompressedSize = 0;
+	bool bCompressed = false;
+	TArray<uint8> Bytes;
+
+	friend FArchive& operator<<(FArchive& Ar, FHoudiniPCGCompactColumn& Column);
+};
+
+struct FHoudiniPCGCompactPoints  // Quantized points of Data.TaggedData[DataIdx], versioned by FHoudiniPCGCompactCustomVersion
+{
+	int32 DataIdx = INDEX_NONE;
+	int32 NumPoints = 0;
+	double PositionPrecision = 0.01;
+	TArray<FHoudiniPCGCompactColumn> Columns;
+
+	friend FArchive& operator<<(FArchive& Ar, FHoudiniPCGCompactPoints& CompactPoints);
+};
+
+struct FHoudiniPCGFullPoints  // Full precision points of Data.TaggedData[DataIdx], kept in memory while the stripped datas are being saved
+{
+	int32 DataIdx = INDEX_NONE;
+	TArray<FTransform> Transforms;
+	TArray<float> Densities;
+	TArray<FVector4> Colors;
+	TArray<FVector> BoundsMins;
+	TArray<FVector> BoundsMaxs;
+	TArray<float> Steepnesses;
+	TArray<int32> Seeds;
+	TArray<int64> Entries;
+};
+
+// Point datas will be quantized and compressed when saved: delta-encoded positions, packed quaternions and half-float colors, densities and steepness.
+// Metadata and other datas (splines, meshes, etc.) are saved as is. Points are decoded when loaded, as PCG elements read Data directly
+UCLASS(BlueprintType)
+class HOUDINIPCGTRANSLATORRUNTIME_API UHoudiniPCGCompactDataAsset : public UPCGDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(EditAnywhere, Category = "Compact", meta = (ClampMin = "0.0001", Units = "Centimeters"))
+	double PositionPrecision = 0.01;  // Positions will be quantized to this precision when saved
+
+	UPROPERTY(EditAnywhere, Category = "Compact")
+	bool bPrebuildOctree = false;  // Build point octrees and bounds right after loaded, rather than on the first spatial query, set by outputs with HoudiniPCG.OutputSpatialSort = 1
+
+	// Build the point octree and bounds that PCG otherwise builds lazily on the first spatial query, they are NOT serialized, so loaded datas have to build again
+	static void PrebuildPointOctree(const UPCGData* Data);
+
+	virtual void Serialize(FArchive& Ar) override;
+
+	virtual void PostLoad() override;
+
+#if WITH_EDITOR
+	virtual void PreSave(FObjectPreSaveContext ObjectSaveContext) override;
+
+	virtual void PostSaveRoot(FObjectPostSaveRootContext ObjectSaveContext) override;
+#endif
+
+protected:
+	TArray<FHoudiniPCGCompactPoints> CompactPoints;  // Encoded in PreSave, points of datas are stripped until saved, decoded and released after loaded
+
+	TArray<FHoudiniPCGFullPoints> FullPoints;  // Stripped in PreSave and restored in PostSaveRoot, so that the asset in editor is never re-quantized by saves
+
+	void DecodeCompactPoints();  // Decoded datas are lossy, so their crcs will be recomputed
+};